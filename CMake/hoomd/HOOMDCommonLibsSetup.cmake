@@ -13,6 +13,31 @@ find_package(ZLIB REQUIRED)
 include_directories(${ZLIB_INCLUDE_DIR})
 endif (ENABLE_ZLIB)
 
+# find FFTW, the library matching the precision of Scalar is required. To use MKL instead, set FFTW_INCLUDE_DIR to the
+# directory of its fftw3.h and FFTW_LIBRARY to the MKL libraries
+if (ENABLE_FFTW)
+if (SINGLE_PRECISION)
+    set(_fftw_name fftw3f)
+else (SINGLE_PRECISION)
+    set(_fftw_name fftw3)
+endif (SINGLE_PRECISION)
+
+find_path(FFTW_INCLUDE_DIR fftw3.h)
+find_library(FFTW_LIBRARY NAMES ${_fftw_name})
+find_library(FFTW_THREADS_LIBRARY NAMES ${_fftw_name}_threads)
+
+if (NOT FFTW_INCLUDE_DIR OR NOT FFTW_LIBRARY)
+    message(FATAL_ERROR "ENABLE_FFTW is set, but ${_fftw_name} was not found")
+endif (NOT FFTW_INCLUDE_DIR OR NOT FFTW_LIBRARY)
+
+include_directories(${FFTW_INCLUDE_DIR})
+set(FFTW_LIBRARIES ${FFTW_LIBRARY})
+if (FFTW_THREADS_LIBRARY)
+    set(FFTW_LIBRARIES ${FFTW_THREADS_LIBRARY} ${FFTW_LIBRARIES})
+endif (FFTW_THREADS_LIBRARY)
+mark_as_advanced(FFTW_INCLUDE_DIR FFTW_LIBRARY FFTW_THREADS_LIBRARY)
+endif (ENABLE_FFTW)
+
 if (ENABLE_OCELOT)
 find_library(OCELOT_LIBRARY NAMES ocelot)
 # override the CUDART library
@@ -67,6 +92,7 @@ else (WIN32)
             ${BOOST_LIBS}
             ${CMAKE_THREAD_LIBS_INIT}
             ${ZLIB_LIBRARIES}
+            ${FFTW_LIBRARIES}
             ${ADDITIONAL_LIBS}
             )
 endif (WIN32)
@@ -8,6 +8,10 @@ else (WIN32)
 option(ENABLE_ZLIB "When set to ON, a gzip compression option for binary output files is available" ON)
 endif (WIN32)
 
+#################################
+## Optional use of FFTW (or a library providing its interface, such as MKL) for the PPPM transforms on the CPU
+option(ENABLE_FFTW "When set to ON, FFTW is used for the PPPM transforms on the CPU instead of kiss_fft" OFF)
+
 #################################
 ## Optional static build
 ## ENABLE_STATIC is an option to control whether HOOMD is built as a statically linked exe or as a python module.
@@ -5,6 +5,14 @@ if (ENABLE_ZLIB)
     add_definitions(-DENABLE_ZLIB)
 endif(ENABLE_ZLIB)
 
+if (ENABLE_FFTW)
+    add_definitions(-DENABLE_FFTW)
+
+    if (FFTW_THREADS_LIBRARY)
+        add_definitions(-DENABLE_FFTW_THREADS)
+    endif (FFTW_THREADS_LIBRARY)
+endif(ENABLE_FFTW)
+
 if (ENABLE_STATIC)
     add_definitions(-DENABLE_STATIC)
 endif(ENABLE_STATIC)
@@ -67,6 +67,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Communicator.h"
 #endif
 
+#include <algorithm>
+
 #include <boost/python.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
@@ -120,16 +122,22 @@ DCDDumpWriter::DCDDumpWriter(boost::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_start_timestep(0), m_period(period), m_group(group),
     m_rigid_data(sysdef->getRigidData()), m_num_frames_written(0), m_last_written_step(0), m_appending(false),
       m_unwrap_full(false), m_unwrap_rigid(false), m_angle(false),
-      m_overwrite(overwrite), m_is_initialized(false)
+      m_overwrite(overwrite), m_is_initialized(false), m_staging_buffer(NULL)
+#ifdef ENABLE_MPI
+      , m_mpi_file_open(false), m_frame_offset(0)
+#endif
     {
     m_exec_conf->msg->notice(5) << "Constructing DCDDumpWriter: " << fname << " " << period << " " << overwrite << endl;
     }
 
-//! Initializes the output file for writing
+/*! In MPI simulations, the header of an existing file is read on the root rank and broadcast to all ranks.
+*/
 void DCDDumpWriter::initFileIO()
     {
+    bool read_error = false;
+
     // handle appending to an existing file if it is requested
-    if (!m_overwrite && exists(m_fname))
+    if (m_exec_conf->getRank() == 0 && !m_overwrite && exists(m_fname))
         {
         m_exec_conf->msg->notice(3) << "dump.dcd: Appending to existing DCD file \"" << m_fname << "\"" << endl;
 
@@ -149,16 +157,35 @@ void DCDDumpWriter::initFileIO()
         m_last_written_step = read_int(file);
 
         // check for errors
-        if (!file.good())
-            {
-            m_exec_conf->msg->error() << "dump.dcd: I/O error while reading DCD header data" << endl;
-            throw runtime_error("Error appending to DCD file");
-            }
-
+        read_error = !file.good();
         m_appending = true;
         }
 
-    m_staging_buffer = new float[m_pdata->getNGlobal()];
+#ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        unsigned int header[5] = {m_num_frames_written, m_start_timestep, m_last_written_step, m_appending, read_error};
+        MPI_Bcast(header, 5, MPI_UNSIGNED, 0, m_exec_conf->getMPICommunicator());
+        m_num_frames_written = header[0];
+        m_start_timestep = header[1];
+        m_last_written_step = header[2];
+        m_appending = header[3];
+        read_error = header[4];
+        }
+#endif
+
+    if (read_error)
+        {
+        m_exec_conf->msg->error() << "dump.dcd: I/O error while reading DCD header data" << endl;
+        throw runtime_error("Error appending to DCD file");
+        }
+
+    // the frames are staged in tag order, which is not needed when writing with MPI-IO
+#ifdef ENABLE_MPI
+    if (!m_comm)
+#endif
+        m_staging_buffer = new float[m_pdata->getNGlobal()];
+
     m_is_initialized = true;
     }
 
@@ -166,8 +193,13 @@ DCDDumpWriter::~DCDDumpWriter()
     {
     m_exec_conf->msg->notice(5) << "Destroying DCDDumpWriter" << endl;
 
-    if (m_is_initialized)
+    if (m_staging_buffer)
         delete[] m_staging_buffer;
+
+#ifdef ENABLE_MPI
+    if (m_mpi_file_open)
+        MPI_File_close(&m_mpi_file);
+#endif
     }
 
 /*! \param timestep Current time step of the simulation
@@ -180,35 +212,36 @@ void DCDDumpWriter::analyze(unsigned int timestep)
     if (m_prof)
         m_prof->push("Dump DCD");
 
-    // take particle data snapshot
-    SnapshotParticleData snapshot(m_pdata->getNGlobal());
-
-    m_pdata->takeSnapshot(snapshot);
-
 #ifdef ENABLE_MPI
-    // if we are not the root processor, do not perform file I/O
-    if (m_comm && !m_exec_conf->isRoot())
+    // every rank writes its own particles
+    if (m_comm)
         {
+        write_frame_mpi(timestep);
+
         if (m_prof) m_prof->pop();
         return;
         }
 #endif
 
+    // take particle data snapshot
+    SnapshotParticleData snapshot(m_pdata->getNGlobal());
+
+    m_pdata->takeSnapshot(snapshot);
+
     if (! m_is_initialized)
         initFileIO();
 
-    // the file object
-    fstream file;
-
     // initialize the file on the first frame written
     if (m_num_frames_written == 0)
         {
         // open the file and truncate it
-        file.open(m_fname.c_str(), ios::trunc | ios::out | ios::binary);
+        if (m_file.is_open())
+            m_file.close();
+        m_file.open(m_fname.c_str(), ios::trunc | ios::out | ios::binary);
 
         // write the file header
         m_start_timestep = timestep;
-        write_file_header(file);
+        write_file_header(m_file);
         }
     else
         {
@@ -221,8 +254,10 @@ void DCDDumpWriter::analyze(unsigned int timestep)
             return;
             }
 
-        // open the file and move the file pointer to the end
-        file.open(m_fname.c_str(), ios::ate | ios::in | ios::out | ios::binary);
+        // the file stays open between frames, move the file pointer to the end
+        if (!m_file.is_open())
+            m_file.open(m_fname.c_str(), ios::in | ios::out | ios::binary);
+        m_file.seekp(0, ios::end);
 
         // verify the period on subsequent frames
         if ( (timestep - m_start_timestep) % m_period != 0)
@@ -230,13 +265,13 @@ void DCDDumpWriter::analyze(unsigned int timestep)
         }
 
     // write the data for the current time step
-    write_frame_header(file);
-    write_frame_data(file, snapshot);
+    write_frame_header(m_file);
+    write_frame_data(m_file, snapshot);
 
     // update the header with the number of frames written
     m_num_frames_written++;
-    write_updated_header(file, timestep);
-    file.close();
+    write_updated_header(m_file, timestep);
+    m_file.flush();
 
     if (m_prof)
         m_prof->pop();
@@ -313,6 +348,24 @@ void DCDDumpWriter::write_file_header(std::fstream &file)
 void DCDDumpWriter::write_frame_header(std::fstream &file)
     {
     double unitcell[6];
+    get_unit_cell(unitcell);
+
+    write_int(file, 48);
+    file.write((char *)unitcell, 48);
+    write_int(file, 48);
+
+    // check for errors
+    if (!file.good())
+        {
+        m_exec_conf->msg->error() << "dump.dcd: I/O rrror while writing DCD frame header" << endl;
+        throw runtime_error("Error writing DCD file");
+        }
+    }
+
+/*! \param unitcell Array of 6 values to hold the unit cell in the order expected by the DCD frame header
+*/
+void DCDDumpWriter::get_unit_cell(double *unitcell)
+    {
     BoxDim box = m_pdata->getGlobalBox();
     // set box dimensions
     Scalar a,b,c,alpha,beta,gamma;
@@ -333,17 +386,6 @@ void DCDDumpWriter::write_frame_header(std::fstream &file)
     unitcell[1] = gamma;
     unitcell[3] = beta;
     unitcell[4] = alpha;
-
-    write_int(file, 48);
-    file.write((char *)unitcell, 48);
-    write_int(file, 48);
-
-    // check for errors
-    if (!file.good())
-        {
-        m_exec_conf->msg->error() << "dump.dcd: I/O rrror while writing DCD frame header" << endl;
-        throw runtime_error("Error writing DCD file");
-        }
     }
 
 /*! \param file File to write to
@@ -355,14 +397,6 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
     // we need to unsort the positions and write in tag order
     assert(m_staging_buffer);
 
-#ifdef ENABLE_MPI
-    if (m_comm && m_unwrap_rigid)
-        {
-        m_exec_conf->msg->error() << "dump.dcd: Unwrap of rigid bodies in DCD files is currently not supported in MPI simulations" << endl;
-        throw runtime_error("Error writing DCD file");
-        }
-#endif
-
     ArrayHandle<int3> body_image_handle(m_rigid_data->getBodyImage(),access_location::host,access_mode::read);
     BoxDim box = m_pdata->getGlobalBox();
 
@@ -462,6 +496,196 @@ void DCDDumpWriter::write_updated_header(std::fstream &file, unsigned int timest
     write_int(file, timestep);
     }
 
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step of the simulation
+
+    A frame consists of the frame header and three records with the x, y and z coordinates of all group members,
+    each enclosed by 4 byte record markers. The position of a member in a record is its index in the group, which is
+    found by a binary search in the sorted list of member tags. Every rank writes the coordinates of its local
+    members with a collective write through an indexed file view. The root rank writes everything else.
+*/
+void DCDDumpWriter::write_frame_mpi(unsigned int timestep)
+    {
+    if (m_unwrap_rigid)
+        {
+        m_exec_conf->msg->error() << "dump.dcd: Unwrap of rigid bodies in DCD files is currently not supported in MPI simulations" << endl;
+        throw runtime_error("Error writing DCD file");
+        }
+
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    bool is_root = m_exec_conf->getRank() == 0;
+
+    if (! m_is_initialized)
+        initFileIO();
+
+    if (m_num_frames_written == 0)
+        {
+        // the root rank creates the file and writes the file header
+        m_start_timestep = timestep;
+        if (is_root)
+            {
+            fstream file;
+            file.open(m_fname.c_str(), ios::trunc | ios::out | ios::binary);
+            write_file_header(file);
+            }
+
+        if (m_mpi_file_open)
+            {
+            MPI_File_close(&m_mpi_file);
+            m_mpi_file_open = false;
+            }
+        }
+    else
+        {
+        if (m_appending && timestep <= m_last_written_step)
+            {
+            m_exec_conf->msg->warning() << "dump.dcd: not writing output at timestep " << timestep << " because the file reports that it already has data up to step " << m_last_written_step << endl;
+            return;
+            }
+
+        // verify the period on subsequent frames
+        if ( (timestep - m_start_timestep) % m_period != 0)
+            m_exec_conf->msg->warning() << "dump.dcd: writing time step " << timestep << " which is not specified in the period of the DCD file: " << m_start_timestep << " + i * " << m_period << endl;
+        }
+
+    if (!m_mpi_file_open)
+        {
+        // the file must exist before it is opened on the other ranks
+        MPI_Barrier(mpi_comm);
+        int ret = MPI_File_open(mpi_comm, (char *)m_fname.c_str(), MPI_MODE_WRONLY, MPI_INFO_NULL, &m_mpi_file);
+        if (ret != MPI_SUCCESS)
+            {
+            m_exec_conf->msg->error() << "dump.dcd: Error opening DCD file " << m_fname << endl;
+            throw runtime_error("Error writing DCD file");
+            }
+        m_mpi_file_open = true;
+
+        // frames are appended at the end of the file
+        long long size = 0;
+        if (is_root)
+            {
+            MPI_Offset offset;
+            MPI_File_get_size(m_mpi_file, &offset);
+            size = offset;
+            }
+        MPI_Bcast(&size, 1, MPI_LONG_LONG, 0, mpi_comm);
+        m_frame_offset = size;
+        }
+
+    unsigned int nparticles = m_group->getNumMembersGlobal();
+    unsigned int n_local = m_group->getNumMembers();
+
+    // the member indices must be looked up before the tag array is accessed
+    std::vector<unsigned int> member_idx(n_local);
+    for (unsigned int j = 0; j < n_local; j++)
+        member_idx[j] = m_group->getMemberIndex(j);
+
+    std::vector< std::pair<int, unsigned int> > order(n_local);
+        {
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_member_tags(m_group->getMemberTagArray(), access_location::host, access_mode::read);
+        for (unsigned int j = 0; j < n_local; j++)
+            {
+            unsigned int idx = member_idx[j];
+            unsigned int group_idx = std::lower_bound(h_member_tags.data, h_member_tags.data + nparticles, h_tag.data[idx])
+                                     - h_member_tags.data;
+            order[j] = std::make_pair(int(group_idx), idx);
+            }
+        }
+    std::sort(order.begin(), order.end());
+
+    // stage the coordinates of the local members in group order
+    m_frame_displs.resize(n_local);
+    m_frame_buf.resize(3*n_local);
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        const BoxDim& box = m_pdata->getGlobalBox();
+
+        for (unsigned int j = 0; j < n_local; j++)
+            {
+            unsigned int idx = order[j].second;
+            Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+            if (m_unwrap_full)
+                pos = box.shift(pos, h_image.data[idx]);
+
+            m_frame_displs[j] = order[j].first;
+            m_frame_buf[j] = float(pos.x);
+            m_frame_buf[n_local + j] = float(pos.y);
+            m_frame_buf[2*n_local + j] = float(pos.z);
+
+            // m_angle set to True turns on a hack where the particle orientation angle is written out to the z component
+            if (m_angle)
+                {
+                Scalar s = 1;
+                if (h_orientation.data[idx].w < 0)
+                    s = -1;
+
+                m_frame_buf[2*n_local + j] = acosf(h_orientation.data[idx].x) * 2 * s;
+                }
+            }
+        }
+
+    // offsets of the frame header and the coordinate records
+    const MPI_Offset frame_header_size = 56;
+    const MPI_Offset record_size = 8 + MPI_Offset(nparticles)*sizeof(float);
+
+    MPI_Datatype filetype;
+    MPI_Type_create_indexed_block(n_local, 1, n_local ? &m_frame_displs.front() : NULL, MPI_FLOAT, &filetype);
+    MPI_Type_commit(&filetype);
+
+    int ret = MPI_SUCCESS;
+    for (unsigned int k = 0; k < 3; k++)
+        {
+        MPI_Offset record_offset = m_frame_offset + frame_header_size + k*record_size + 4;
+        MPI_Status status;
+        ret |= MPI_File_set_view(m_mpi_file, record_offset, MPI_FLOAT, filetype, (char *)"native", MPI_INFO_NULL);
+        ret |= MPI_File_write_all(m_mpi_file, n_local ? &m_frame_buf[k*n_local] : NULL, n_local, MPI_FLOAT, &status);
+        }
+    MPI_Type_free(&filetype);
+
+    ret |= MPI_File_set_view(m_mpi_file, 0, MPI_BYTE, MPI_BYTE, (char *)"native", MPI_INFO_NULL);
+
+    if (is_root)
+        {
+        MPI_Status status;
+        char frame_header[56];
+        unsigned int marker = 48;
+        double unitcell[6];
+        get_unit_cell(unitcell);
+        memcpy(frame_header, &marker, 4);
+        memcpy(frame_header + 4, unitcell, 48);
+        memcpy(frame_header + 52, &marker, 4);
+        ret |= MPI_File_write_at(m_mpi_file, m_frame_offset, frame_header, 56, MPI_BYTE, &status);
+
+        marker = nparticles * sizeof(float);
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            MPI_Offset record_offset = m_frame_offset + frame_header_size + k*record_size;
+            ret |= MPI_File_write_at(m_mpi_file, record_offset, &marker, 4, MPI_BYTE, &status);
+            ret |= MPI_File_write_at(m_mpi_file, record_offset + record_size - 4, &marker, 4, MPI_BYTE, &status);
+            }
+
+        // update the header with the number of frames written
+        unsigned int n_frames = m_num_frames_written + 1;
+        ret |= MPI_File_write_at(m_mpi_file, NFILE_POS, &n_frames, 4, MPI_BYTE, &status);
+        ret |= MPI_File_write_at(m_mpi_file, NSTEP_POS, &timestep, 4, MPI_BYTE, &status);
+        }
+
+    // all ranks agree on the outcome of the write
+    MPI_Allreduce(MPI_IN_PLACE, &ret, 1, MPI_INT, MPI_BOR, mpi_comm);
+    if (ret != MPI_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "dump.dcd: I/O error while writing DCD frame data" << endl;
+        throw runtime_error("Error writing DCD file");
+        }
+
+    m_frame_offset += frame_header_size + 3*record_size;
+    m_num_frames_written++;
+    }
+#endif
+
 void export_DCDDumpWriter()
     {
     class_<DCDDumpWriter, boost::shared_ptr<DCDDumpWriter>, bases<Analyzer>, boost::noncopyable>
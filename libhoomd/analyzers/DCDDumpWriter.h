@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <boost/shared_ptr.hpp>
 #include <fstream>
+#include <vector>
 #include "Analyzer.h"
 #include "ParticleGroup.h"
 
@@ -88,6 +89,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     Due to a limitation in the DCD format, the time step period between calls to
     analyze() \b must be specified up front. If analyze() detects that this period is
     not being maintained, it will print a warning but continue.
+
+    The file is kept open between frames. In MPI simulations, the frames are written collectively with MPI-IO: every
+    rank sorts its local group members by their index in the group and writes their coordinates directly to their
+    offsets in the frame, described by an indexed file view. Only the root rank writes the file header, the frame
+    headers and the record markers. No rank ever holds the full set of coordinates.
     \ingroup analyzers
 */
 class DCDDumpWriter : public Analyzer
@@ -141,11 +147,22 @@ class DCDDumpWriter : public Analyzer
         bool m_is_initialized;              //!< True if file IO has been initialized
 
         float *m_staging_buffer;            //!< Buffer for staging particle positions in tag order
+        std::fstream m_file;                //!< The open file
+
+#ifdef ENABLE_MPI
+        MPI_File m_mpi_file;                //!< The file opened collectively in MPI simulations
+        bool m_mpi_file_open;               //!< True if m_mpi_file is open
+        MPI_Offset m_frame_offset;          //!< File offset of the next frame in MPI simulations
+        std::vector<int> m_frame_displs;    //!< Group indices of the local members in increasing order
+        std::vector<float> m_frame_buf;     //!< Coordinates of the local members, ordered like m_frame_displs
+#endif
 
         // helper functions
 
         //! Initalizes the file header
         void write_file_header(std::fstream &file);
+        //! Computes the unit cell parameters of the frame header
+        void get_unit_cell(double *unitcell);
         //! Writes the frame header
         void write_frame_header(std::fstream &file);
         //! Writes the particle positions for a frame
@@ -155,6 +172,11 @@ class DCDDumpWriter : public Analyzer
         //! Initializes the output file for writing
         void initFileIO();
 
+#ifdef ENABLE_MPI
+        //! Writes a frame collectively with MPI-IO
+        void write_frame_mpi(unsigned int timestep);
+#endif
+
     };
 
 //! Exports the DCDDumpWriter class to python
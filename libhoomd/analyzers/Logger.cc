@@ -68,6 +68,7 @@ using namespace boost::filesystem;
 
 #include <stdexcept>
 #include <iomanip>
+#include <boost/bind.hpp>
 using namespace std;
 
 #ifdef ENABLE_MPI
@@ -85,7 +86,8 @@ Logger::Logger(boost::shared_ptr<SystemDefinition> sysdef,
                const std::string& fname,
                const std::string& header_prefix,
                bool overwrite)
-    : Analyzer(sysdef), m_delimiter("\t"), m_filename(fname), m_header_prefix(header_prefix), m_appending(!overwrite), m_is_initialized(false)
+    : Analyzer(sysdef), m_delimiter("\t"), m_filename(fname), m_header_prefix(header_prefix), m_appending(!overwrite), m_is_initialized(false),
+      m_binary(false), m_flush_period(1), m_write_queue(4), m_writer_running(false), m_write_error(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Logger: " << fname << " " << header_prefix << " " << overwrite << endl;
     }
@@ -98,17 +100,26 @@ void Logger::openOutputFiles()
         if (! m_exec_conf->isRoot())
             return;
 #endif
+    ios_base::openmode binary_mode = m_binary ? ios_base::binary : ios_base::openmode(0);
+
     // open the file
     if (exists(m_filename) && m_appending)
         {
         m_exec_conf->msg->notice(3) << "analyze.log: Appending log to existing file \"" << m_filename << "\"" << endl;
-        m_file.open(m_filename.c_str(), ios_base::in | ios_base::out | ios_base::ate);
+        m_file.open(m_filename.c_str(), ios_base::in | ios_base::out | ios_base::ate | binary_mode);
         }
     else
         {
         m_exec_conf->msg->notice(3) << "analyze.log: Creating new log in file \"" << m_filename << "\"" << endl;
-        m_file.open(m_filename.c_str(), ios_base::out);
+        m_file.open(m_filename.c_str(), ios_base::out | binary_mode);
         m_appending = false;
+
+        if (m_binary)
+            {
+            uint32_t version = 1;
+            m_file.write("HLOG", 4);
+            m_file.write((const char *)&version, sizeof(uint32_t));
+            }
         }
 
     if (!m_file.good())
@@ -121,6 +132,15 @@ void Logger::openOutputFiles()
 Logger::~Logger()
     {
     m_exec_conf->msg->notice(5) << "Destroying Logger" << endl;
+
+    // write out any rows still in memory, errors can no longer be reported by exception
+    try
+        {
+        flush();
+        }
+    catch (const std::exception& e)
+        {
+        }
     }
 
 /*! \param compute The Compute to register
@@ -182,6 +202,10 @@ void Logger::removeAll()
 */
 void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
     {
+    // rows buffered so far belong to the previous quantities
+    flush();
+    m_block = boost::shared_ptr<LogBlock>();
+
     m_logged_quantities = quantities;
 
     // prepare or adjust storage for caching the logger properties.
@@ -201,6 +225,26 @@ void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
 
     m_is_initialized = true;
 
+    // the binary format records every change of the quantities, also when appending
+    if (m_binary)
+        {
+        uint32_t tag = 1;
+        uint32_t n = (uint32_t)quantities.size();
+        m_file.write((const char *)&tag, sizeof(uint32_t));
+        m_file.write((const char *)&n, sizeof(uint32_t));
+        for (unsigned int i = 0; i < quantities.size(); i++)
+            {
+            uint32_t len = (uint32_t)quantities[i].size();
+            m_file.write((const char *)&len, sizeof(uint32_t));
+            m_file.write(quantities[i].data(), len);
+            }
+        m_file.flush();
+
+        if (quantities.size() == 0)
+            m_exec_conf->msg->warning() << "analyze.log: No quantities specified for logging" << endl;
+        return;
+        }
+
     // only write the header if this is a new file
     if (!m_appending)
         {
@@ -237,9 +281,140 @@ void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
 */
 void Logger::setDelimiter(const std::string& delimiter)
     {
+    // buffered rows keep the delimiter they were logged with
+    if (m_block && m_block->n_rows > 0)
+        submitBlock();
+    else
+        m_block = boost::shared_ptr<LogBlock>();
+
     m_delimiter = delimiter;
     }
 
+/*! \param binary True to write the binary format (see Logger)
+
+    Must be called before the logged quantities are set for the first time, when the file is opened.
+*/
+void Logger::setBinary(bool binary)
+    {
+    if (m_is_initialized && binary != m_binary)
+        {
+        m_exec_conf->msg->error() << "analyze.log: The format cannot be changed after the file has been opened" << endl;
+        throw runtime_error("Error setting log format");
+        }
+    m_binary = binary;
+    }
+
+/*! \param rows Number of rows to collect before they are written to the file
+
+    With \a rows equal to 1, every row is written and flushed in analyze() (in text mode).
+*/
+void Logger::setFlushPeriod(unsigned int rows)
+    {
+    if (rows == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log: The flush period must be at least 1 row" << endl;
+        throw runtime_error("Error setting log flush period");
+        }
+
+    // the block size is fixed when it is allocated
+    flush();
+    m_block = boost::shared_ptr<LogBlock>();
+    m_flush_period = rows;
+    }
+
+/*! Hands the partially filled block to the writer thread and waits until everything has been written.
+*/
+void Logger::flush()
+    {
+    if (m_block && m_block->n_rows > 0)
+        submitBlock();
+
+    if (m_writer_running)
+        {
+        // the empty block stops the writer thread after all previous blocks are written
+        m_write_queue.push(boost::shared_ptr<LogBlock>());
+        m_writer_thread.join();
+        m_writer_running = false;
+        }
+
+    checkWriteError();
+    }
+
+/*! The block is replaced by a new one, the writer thread is started if needed. If the writer falls behind by more
+    than a few blocks, this call waits.
+*/
+void Logger::submitBlock()
+    {
+    if (!m_writer_running)
+        {
+        m_writer_thread = boost::thread(boost::bind(&Logger::writerLoop, this));
+        m_writer_running = true;
+        }
+
+    m_write_queue.push(m_block);
+    m_block = boost::shared_ptr<LogBlock>();
+    }
+
+/*! Writes blocks from m_write_queue until an empty block is received.
+*/
+void Logger::writerLoop()
+    {
+    while (true)
+        {
+        boost::shared_ptr<LogBlock> block = m_write_queue.wait_and_pop();
+        if (!block)
+            return;
+
+        writeBlock(*block);
+        m_file.flush();
+
+        if (!m_file.good())
+            {
+            boost::mutex::scoped_lock lock(m_write_error_mutex);
+            m_write_error = true;
+            }
+        }
+    }
+
+/*! \param block Block to write
+
+    Called from the writer thread.
+*/
+void Logger::writeBlock(const LogBlock& block)
+    {
+    unsigned int capacity = (unsigned int)block.timesteps.size();
+
+    if (m_binary)
+        {
+        uint32_t header[3] = { 2, block.n_rows, block.n_columns };
+        m_file.write((const char *)header, sizeof(header));
+        m_file.write((const char *)&block.timesteps[0], sizeof(unsigned int)*block.n_rows);
+        for (unsigned int i = 0; i < block.n_columns; i++)
+            m_file.write((const char *)&block.values[i*capacity], sizeof(double)*block.n_rows);
+        return;
+        }
+
+    // the same format as the unbuffered output
+    for (unsigned int row = 0; row < block.n_rows; row++)
+        {
+        m_file << setprecision(10) << block.timesteps[row];
+        for (unsigned int i = 0; i < block.n_columns; i++)
+            m_file << block.delimiter << setprecision(10) << Scalar(block.values[i*capacity+row]);
+        m_file << "\n";
+        }
+    }
+
+void Logger::checkWriteError()
+    {
+    boost::mutex::scoped_lock lock(m_write_error_mutex);
+    if (m_write_error)
+        {
+        m_write_error = false;
+        m_exec_conf->msg->error() << "analyze.log: I/O error while writing log file" << endl;
+        throw runtime_error("Error writting log file");
+        }
+    }
+
 /*! \param timestep Time step to write out data for
 
     Writes a single line of output to the log file with each specified quantity separated by
@@ -249,9 +424,26 @@ void Logger::analyze(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Log");
 
-    // update info in cache for later use and for immediate output.
-    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
-        cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
+#ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        // collect the partial sums of all computes first, so that one MPI_Allreduce resolves all of them
+        ReductionBufferScope reduction(m_comm->getReductionBuffer());
+        for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+            if (m_compute_quantities.count(m_logged_quantities[i]))
+                getValue(m_logged_quantities[i], timestep);
+        reduction.reduce();
+
+        for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+            cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
+        }
+    else
+#endif
+        {
+        // update info in cache for later use and for immediate output.
+        for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+            cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
+        }
 
 #ifdef ENABLE_MPI
     // only output to file on root processor
@@ -263,6 +455,35 @@ void Logger::analyze(unsigned int timestep)
             }
 #endif
 
+    if (isBuffered())
+        {
+        cached_timestep = timestep;
+
+        // append the row to the current block
+        if (!m_block)
+            {
+            m_block = boost::shared_ptr<LogBlock>(new LogBlock);
+            m_block->n_rows = 0;
+            m_block->n_columns = (unsigned int)m_logged_quantities.size();
+            m_block->timesteps.resize(m_flush_period);
+            m_block->values.resize(m_flush_period*m_logged_quantities.size());
+            m_block->delimiter = m_delimiter;
+            }
+
+        unsigned int row = m_block->n_rows++;
+        m_block->timesteps[row] = timestep;
+        for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+            m_block->values[i*m_flush_period+row] = cached_quantities[i];
+
+        if (m_block->n_rows == m_flush_period)
+            submitBlock();
+
+        checkWriteError();
+
+        if (m_prof) m_prof->pop();
+        return;
+        }
+
     // The timestep is always output
     m_file << setprecision(10) << timestep;
     cached_timestep = timestep;
@@ -353,6 +574,9 @@ void export_Logger()
     .def("setLoggedQuantities", &Logger::setLoggedQuantities)
     .def("setDelimiter", &Logger::setDelimiter)
     .def("getCachedQuantity", &Logger::getCachedQuantity)
+    .def("setBinary", &Logger::setBinary)
+    .def("setFlushPeriod", &Logger::setFlushPeriod)
+    .def("flush", &Logger::flush)
     ;
     }
 
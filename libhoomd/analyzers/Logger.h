@@ -63,11 +63,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fstream>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include "ClockSource.h"
 #include "Analyzer.h"
 #include "Compute.h"
 #include "Updater.h"
+#include "WorkQueue.h"
 
 #ifndef __LOGGER_H__
 #define __LOGGER_H__
@@ -88,6 +91,23 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     The removeAll method can be used to clear all registered computes and updaters. hoomd_script will
     removeAll() and re-register all active computes and updaters before every run()
 
+    In MPI simulations, analyze() requests the quantities provided by computes twice. During the first pass, the
+    ReductionBuffer of the Communicator collects the partial sums that the computes would otherwise reduce one by
+    one, and a single MPI_Allreduce resolves them before the second pass reads the values.
+
+    <b>Buffered output</b>
+
+    By default, every call to analyze() formats one line of text and flushes the file. With setFlushPeriod(), rows
+    are instead collected column by column in memory, and every \a n rows the full block is handed to a background
+    thread that formats and writes it, so the simulation does not wait on the file system. flush() writes the
+    pending rows immediately; it is called when the logged quantities change and when the Logger is destroyed.
+
+    setBinary() selects a compact binary format, which is always buffered. The file starts with the 4 characters
+    \c HLOG and the uint32 format version (1), followed by records in native endianness. Each record starts with a
+    uint32 tag. A header record (tag 1) has the uint32 number of quantities and each name as a uint32 length and its
+    characters; it is written whenever the logged quantities are set. A data record (tag 2) has the uint32 number of
+    rows \a n and columns \a m, the \a n uint32 time steps and then the \a m columns of \a n doubles each.
+
     \ingroup analyzers
 */
 class Logger : public Analyzer
@@ -123,6 +143,15 @@ class Logger : public Analyzer
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Selects the binary output format
+        void setBinary(bool binary);
+
+        //! Sets the number of rows buffered before they are written
+        void setFlushPeriod(unsigned int rows);
+
+        //! Writes all buffered rows to the file
+        void flush();
+
         //! Get needed pdata flags
         /*! Logger may potentially log any of the optional quantities, enable all of the bits.
         */
@@ -136,6 +165,16 @@ class Logger : public Analyzer
             }
 
     private:
+        //! Block of buffered rows, stored by column
+        struct LogBlock
+            {
+            unsigned int n_rows;                    //!< Number of valid rows
+            unsigned int n_columns;                 //!< Number of logged quantities
+            std::vector<unsigned int> timesteps;    //!< Time step of each row
+            std::vector<double> values;             //!< Values, the column of quantity i starts at i*timesteps.size()
+            std::string delimiter;                  //!< Delimiter at the time the block was filled
+            };
+
         //! The delimiter to put between columns in the file
         std::string m_delimiter;
         //! The output file name
@@ -160,12 +199,46 @@ class Logger : public Analyzer
         std::vector< Scalar > cached_quantities;
         //! Flag to indicate whether we have initialized the file IO
         bool m_is_initialized;
+        //! True if the file is written in the binary format
+        bool m_binary;
+        //! Number of rows per block, 1 writes every row immediately
+        unsigned int m_flush_period;
+        //! Block currently being filled
+        boost::shared_ptr<LogBlock> m_block;
+        //! Full blocks waiting to be written, an empty pointer stops the writer thread
+        WorkQueue< boost::shared_ptr<LogBlock> > m_write_queue;
+        //! Thread writing blocks to the file
+        boost::thread m_writer_thread;
+        //! True while m_writer_thread is running
+        bool m_writer_running;
+        //! Set by the writer thread if an I/O error occured
+        bool m_write_error;
+        //! Protects m_write_error
+        boost::mutex m_write_error_mutex;
 
         //! Helper function to get a value for a given quantity
         Scalar getValue(const std::string &quantity, int timestep);
 
         //! Helper function to open output files
         void openOutputFiles();
+
+        //! Returns true if rows are buffered and written by the writer thread
+        bool isBuffered() const
+            {
+            return m_binary || m_flush_period > 1;
+            }
+
+        //! Hands the current block to the writer thread
+        void submitBlock();
+
+        //! Main loop of the writer thread
+        void writerLoop();
+
+        //! Writes a block to the file
+        void writeBlock(const LogBlock& block);
+
+        //! Throws if the writer thread encountered an error
+        void checkWriteError();
     };
 
 //! exports the Logger class to python
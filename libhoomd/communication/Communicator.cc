@@ -812,17 +812,12 @@ Communicator::Communicator(boost::shared_ptr<SystemDefinition> sysdef,
             m_exec_conf(m_pdata->getExecConf()),
             m_mpi_comm(m_exec_conf->getMPICommunicator()),
             m_decomposition(decomposition),
+            m_reduction_buffer(m_exec_conf),
             m_is_communicating(false),
             m_force_migrate(false),
             m_nneigh(0),
             m_n_unique_neigh(0),
-            m_pos_copybuf(m_exec_conf),
-            m_charge_copybuf(m_exec_conf),
-            m_diameter_copybuf(m_exec_conf),
-            m_velocity_copybuf(m_exec_conf),
-            m_orientation_copybuf(m_exec_conf),
-            m_plan_copybuf(m_exec_conf),
-            m_tag_copybuf(m_exec_conf),
+            m_ghost_send_tags(m_exec_conf),
             m_r_ghost(Scalar(0.0)),
             m_r_buff(Scalar(0.0)),
             m_plan(m_exec_conf),
@@ -845,12 +840,12 @@ Communicator::Communicator(boost::shared_ptr<SystemDefinition> sysdef,
         m_is_at_boundary[dir] = m_decomposition->isAtBoundary(dir) ? 1 : 0;
         }
 
-    for (unsigned int dir = 0; dir < 6; dir ++)
+    for (unsigned int ineigh = 0; ineigh < NEIGH_MAX; ineigh++)
         {
-        GPUVector<unsigned int> copy_ghosts(m_exec_conf);
-        m_copy_ghosts[dir].swap(copy_ghosts);
-        m_num_copy_ghosts[dir] = 0;
-        m_num_recv_ghosts[dir] = 0;
+        m_n_ghost_send[ineigh] = 0;
+        m_n_ghost_recv[ineigh] = 0;
+        m_ghost_send_offs[ineigh] = 0;
+        m_ghost_recv_offs[ineigh] = 0;
         }
 
     // connect to particle sort signal
@@ -1031,6 +1026,44 @@ void Communicator::communicate(unsigned int timestep)
 
     bool update = !m_is_first_step && !m_force_migrate;
 
+    if (! m_tuner_precompute)
+        {
+        /*
+         * On the CPU, the ghost update is always started first. The migration check (which involves
+         * global synchronization) and the computation on local particles are overlapped with the
+         * messages in flight.
+         */
+        if (update)
+            beginUpdateGhosts(timestep);
+
+        bool migrate = m_force_migrate || m_migrate_requests(timestep) || m_is_first_step;
+
+        if (!migrate)
+            m_local_compute_callbacks(timestep);
+
+        // the pending requests need to be completed even if the ghosts are rebuilt
+        if (update)
+            finishUpdateGhosts(timestep);
+
+        if (!migrate)
+            m_compute_callbacks(timestep);
+
+        // other functions involving syncing
+        m_comm_callbacks(timestep);
+
+        if (migrate)
+            {
+            m_force_migrate = false;
+            m_is_first_step = false;
+
+            migrateParticles();
+            exchangeGhosts();
+            }
+
+        m_is_communicating = false;
+        return;
+        }
+
     bool precompute = m_tuner_precompute ? m_tuner_precompute->getParam() : false;
 
     update &= precompute;
@@ -1243,7 +1276,7 @@ void Communicator::exchangeGhosts()
     // Sending ghosts proceeds in two stages:
     // Stage 1: mark ghost atoms for sending (for covalently bonded particles, and non-bonded interactions)
     //          construct plans (= itineraries for ghost particles)
-    // Stage 2: fill send buffers, exchange ghosts according to plans (sending the plan along with the particle)
+    // Stage 2: fill send buffers, send every ghost directly to all neighbors in its plan (one message per neighbor)
 
     // resize and reset plans
     m_plan.resize(m_pdata->getN());
@@ -1316,299 +1349,126 @@ void Communicator::exchangeGhosts()
     m_improper_comm.markGhostParticles(m_plan,mask);
 
     /*
-     * Fill send buffers, exchange particles according to plans
+     * Build the list of ghosts to send to every unique neighbor
      */
-
-    // resize buffers
-    m_plan_copybuf.resize(m_pdata->getN());
-    m_pos_copybuf.resize(m_pdata->getN());
-    m_charge_copybuf.resize(m_pdata->getN());
-    m_diameter_copybuf.resize(m_pdata->getN());
-    m_velocity_copybuf.resize(m_pdata->getN());
-    m_orientation_copybuf.resize(m_pdata->getN());
-
-    // ghost particle flags
     CommFlags flags = getFlags();
 
-    for (unsigned int dir = 0; dir < 6; dir ++)
         {
-        if (! isCommunicating(dir) ) continue;
-
-        m_num_copy_ghosts[dir] = 0;
-
-        // resize array of ghost particle tags
-        unsigned int max_copy_ghosts = m_pdata->getN() + m_pdata->getNGhosts();
-        m_copy_ghosts[dir].resize(max_copy_ghosts);
-
-        // resize buffers
-        m_plan_copybuf.resize(max_copy_ghosts);
-        m_pos_copybuf.resize(max_copy_ghosts);
-        m_charge_copybuf.resize(max_copy_ghosts);
-        m_diameter_copybuf.resize(max_copy_ghosts);
-        m_velocity_copybuf.resize(max_copy_ghosts);
-        m_orientation_copybuf.resize(max_copy_ghosts);
-
+        ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_adj_mask(m_adj_mask, access_location::host, access_mode::read);
 
+        // convert the plans into adjacency masks of the neighbors that receive the particle
+        std::vector<unsigned int> ghost_idx;
+        std::vector<unsigned int> ghost_adj;
+        for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
             {
-            // we fill all fields, but send only those that are requested by the CommFlags bitset
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int>  h_plan(m_plan, access_location::host, access_mode::read);
-
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_plan_copybuf(m_plan_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar> h_charge_copybuf(m_charge_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar> h_diameter_copybuf(m_diameter_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
-
-            for (unsigned int idx = 0; idx < m_pdata->getN() + m_pdata->getNGhosts(); idx++)
+            unsigned int plan = h_plan.data[idx] & mask;
+            if (plan)
                 {
-
-                if (h_plan.data[idx] & (1 << dir))
-                    {
-                    // send with next message
-                    h_pos_copybuf.data[m_num_copy_ghosts[dir]] = h_pos.data[idx];
-                    h_charge_copybuf.data[m_num_copy_ghosts[dir]] = h_charge.data[idx];
-                    h_diameter_copybuf.data[m_num_copy_ghosts[dir]] = h_diameter.data[idx];
-                    h_velocity_copybuf.data[m_num_copy_ghosts[dir]] = h_vel.data[idx];
-                    h_orientation_copybuf.data[m_num_copy_ghosts[dir]] = h_orientation.data[idx];
-                    h_plan_copybuf.data[m_num_copy_ghosts[dir]] = h_plan.data[idx];
-
-                    h_copy_ghosts.data[m_num_copy_ghosts[dir]] = h_tag.data[idx];
-                    m_num_copy_ghosts[dir]++;
-                    }
+                ghost_idx.push_back(idx);
+                ghost_adj.push_back(getAdjacencyMask(plan));
                 }
             }
-        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
-
-        // we receive from the direction opposite to the one we send to
-        unsigned int recv_neighbor;
-        if (dir % 2 == 0)
-            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
-        else
-            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
-
-        if (m_prof)
-            m_prof->push("MPI send/recv");
 
-        // communicate size of the message that will contain the particle data
-        MPI_Request reqs[14];
-        MPI_Status status[14];
-
-        MPI_Isend(&m_num_copy_ghosts[dir],
-            sizeof(unsigned int),
-            MPI_BYTE,
-            send_neighbor,
-            0,
-            m_mpi_comm,
-            &reqs[0]);
-        MPI_Irecv(&m_num_recv_ghosts[dir],
-            sizeof(unsigned int),
-            MPI_BYTE,
-            recv_neighbor,
-            0,
-            m_mpi_comm,
-            &reqs[1]);
-        MPI_Waitall(2, reqs, status);
-
-        if (m_prof)
-            m_prof->pop();
-
-        // append ghosts at the end of particle data array
-        unsigned int start_idx = m_pdata->getN() + m_pdata->getNGhosts();
-
-        // accommodate new ghost particles
-        m_pdata->addGhostParticles(m_num_recv_ghosts[dir]);
-
-        // resize plan array
-        m_plan.resize(m_pdata->getN() + m_pdata->getNGhosts());
+        // count the ghosts for every neighbor, every ghost is sent only once to the same rank
+        unsigned int n_send_tot = 0;
+        for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+            {
+            m_ghost_send_offs[ineigh] = n_send_tot;
+            m_n_ghost_send[ineigh] = 0;
+            for (unsigned int i = 0; i < ghost_adj.size(); ++i)
+                if (ghost_adj[i] & h_adj_mask.data[ineigh])
+                    m_n_ghost_send[ineigh]++;
+            n_send_tot += m_n_ghost_send[ineigh];
+            }
 
-        // exchange particle data, write directly to the particle data arrays
-        if (m_prof)
-            m_prof->push("MPI send/recv");
+        m_ghost_send_tags.resize(n_send_tot);
 
+        ArrayHandle<unsigned int> h_ghost_send_tags(m_ghost_send_tags, access_location::host, access_mode::overwrite);
+        for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
             {
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_plan_copybuf(m_plan_copybuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_charge_copybuf(m_charge_copybuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_diameter_copybuf(m_diameter_copybuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
-
-            ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
+            unsigned int n = m_ghost_send_offs[ineigh];
+            for (unsigned int i = 0; i < ghost_adj.size(); ++i)
+                if (ghost_adj[i] & h_adj_mask.data[ineigh])
+                    h_ghost_send_tags.data[n++] = h_tag.data[ghost_idx[i]];
+            }
+        }
 
-            unsigned int nreq = 0;
+    /*
+     * Exchange the number of ghosts with every neighbor
+     */
+    if (m_prof)
+        m_prof->push("MPI send/recv");
 
-            MPI_Isend(h_plan_copybuf.data,
-                m_num_copy_ghosts[dir]*sizeof(unsigned int),
-                MPI_BYTE,
-                send_neighbor,
-                1,
-                m_mpi_comm,
-                &reqs[nreq++]);
-            MPI_Irecv(h_plan.data + start_idx,
-                m_num_recv_ghosts[dir]*sizeof(unsigned int),
-                MPI_BYTE,
-                recv_neighbor,
-                1,
-                m_mpi_comm,
-                &reqs[nreq++]);
+    unsigned int n_recv_tot = 0;
 
-            MPI_Isend(h_copy_ghosts.data,
-                m_num_copy_ghosts[dir]*sizeof(unsigned int),
-                MPI_BYTE,
-                send_neighbor,
-                2,
-                m_mpi_comm,
-                &reqs[nreq++]);
-            MPI_Irecv(h_tag.data + start_idx,
-                m_num_recv_ghosts[dir]*sizeof(unsigned int),
-                MPI_BYTE,
-                recv_neighbor,
-                2,
-                m_mpi_comm,
-                &reqs[nreq++]);
+        {
+        ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
 
-            if (flags[comm_flag::position])
-                {
-                MPI_Isend(h_pos_copybuf.data,
-                    m_num_copy_ghosts[dir]*sizeof(Scalar4),
-                    MPI_BYTE,
-                    send_neighbor,
-                    3,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                MPI_Irecv(h_pos.data + start_idx,
-                    m_num_recv_ghosts[dir]*sizeof(Scalar4),
-                    MPI_BYTE,
-                    recv_neighbor,
-                    3,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                }
+        std::vector<MPI_Request> reqs(2*m_n_unique_neigh);
+        std::vector<MPI_Status> stats(2*m_n_unique_neigh);
+        unsigned int nreq = 0;
+        for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+            {
+            unsigned int neighbor = h_unique_neighbors.data[ineigh];
+            MPI_Isend(&m_n_ghost_send[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, &reqs[nreq++]);
+            MPI_Irecv(&m_n_ghost_recv[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, &reqs[nreq++]);
+            }
+        if (nreq)
+            MPI_Waitall(nreq, &reqs.front(), &stats.front());
 
-            if (flags[comm_flag::charge])
-                {
-                MPI_Isend(h_charge_copybuf.data,
-                    m_num_copy_ghosts[dir]*sizeof(Scalar),
-                    MPI_BYTE,
-                    send_neighbor,
-                    4,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                MPI_Irecv(h_charge.data + start_idx,
-                    m_num_recv_ghosts[dir]*sizeof(Scalar),
-                    MPI_BYTE,
-                    recv_neighbor,
-                    4,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                }
+        for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+            {
+            m_ghost_recv_offs[ineigh] = n_recv_tot;
+            n_recv_tot += m_n_ghost_recv[ineigh];
+            }
+        }
 
-            if (flags[comm_flag::diameter])
-                {
-                MPI_Isend(h_diameter_copybuf.data,
-                    m_num_copy_ghosts[dir]*sizeof(Scalar),
-                    MPI_BYTE,
-                    send_neighbor,
-                    5,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                MPI_Irecv(h_diameter.data + start_idx,
-                    m_num_recv_ghosts[dir]*sizeof(Scalar),
-                    MPI_BYTE,
-                    recv_neighbor,
-                    5,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                }
+    if (m_prof)
+        m_prof->pop();
 
-            if (flags[comm_flag::velocity])
-                {
-                MPI_Isend(h_velocity_copybuf.data,
-                    m_num_copy_ghosts[dir]*sizeof(Scalar4),
-                    MPI_BYTE,
-                    send_neighbor,
-                    6,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                MPI_Irecv(h_vel.data + start_idx,
-                    m_num_recv_ghosts[dir]*sizeof(Scalar4),
-                    MPI_BYTE,
-                    recv_neighbor,
-                    6,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                }
+    /*
+     * Exchange the ghost particle data, one message per neighbor
+     */
 
+    // the tags are always sent along with newly exchanged ghosts
+    CommFlags exchange_flags = flags;
+    exchange_flags[comm_flag::tag] = 1;
 
-            if (flags[comm_flag::orientation])
-                {
-                MPI_Isend(h_orientation_copybuf.data,
-                    m_num_copy_ghosts[dir]*sizeof(Scalar4),
-                    MPI_BYTE,
-                    send_neighbor,
-                    7,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                MPI_Irecv(h_orientation.data + start_idx,
-                    m_num_recv_ghosts[dir]*sizeof(Scalar4),
-                    MPI_BYTE,
-                    recv_neighbor,
-                    7,
-                    m_mpi_comm,
-                    &reqs[nreq++]);
-                }
+    packGhosts(exchange_flags);
+    postGhostMessages(exchange_flags, 1);
 
-            MPI_Waitall(nreq, reqs, status);
-            }
+    // append ghosts at the end of the particle data arrays (while the messages are in flight)
+    unsigned int start_idx = m_pdata->getN() + m_pdata->getNGhosts();
+    m_pdata->addGhostParticles(n_recv_tot);
 
-        if (m_prof)
-            m_prof->pop();
+    if (m_prof)
+        m_prof->push("MPI send/recv");
 
-        // wrap particle positions
-        if (flags[comm_flag::position])
-            {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    if (m_reqs.size())
+        {
+        std::vector<MPI_Status> stats(m_reqs.size());
+        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &stats.front());
+        }
 
-            const BoxDim shifted_box = getShiftedBox();
+    if (m_prof)
+        m_prof->pop(0, (n_recv_tot+m_ghost_send_tags.size())*getGhostElementSize(exchange_flags));
 
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
-                {
-                Scalar4& pos = h_pos.data[idx];
+    unpackGhosts(exchange_flags, start_idx);
 
-                // wrap particles received across a global boundary
-                int3 img = make_int3(0,0,0);
-                shifted_box.wrap(pos,img);
-                }
-            }
+        {
+        // set reverse-lookup tag -> idx
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
 
+        for (unsigned int idx = start_idx; idx < start_idx + n_recv_tot; idx++)
             {
-            // set reverse-lookup tag -> idx
-            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
-
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
-                {
-                assert(h_tag.data[idx] <= m_pdata->getNGlobal());
-                assert(h_rtag.data[h_tag.data[idx]] == NOT_LOCAL);
-                h_rtag.data[h_tag.data[idx]] = idx;
-                }
+            assert(h_tag.data[idx] <= m_pdata->getNGlobal());
+            assert(h_rtag.data[h_tag.data[idx]] == NOT_LOCAL);
+            h_rtag.data[h_tag.data[idx]] = idx;
             }
-        } // end dir loop
+        }
 
     // we have updated ghost particles, so inform ParticleData about this
     m_pdata->notifyGhostParticleNumberChange();
@@ -1619,178 +1479,230 @@ void Communicator::exchangeGhosts()
         m_prof->pop();
     }
 
-//! update positions of ghost particles
+//! Start the update of the ghost particle fields
 void Communicator::beginUpdateGhosts(unsigned int timestep)
     {
-    // we have a current m_copy_ghosts liss which contain the indices of particles
-    // to send to neighboring processors
+    // we have a current list of ghost tags for every neighbor, pack the fields of these
+    // particles and post one message per neighbor
     if (m_prof)
         m_prof->push("comm_ghost_update");
 
     m_exec_conf->msg->notice(7) << "Communicator: update ghosts" << std::endl;
 
-    // update data in these arrays
-
-    unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
+    // only non-permanent fields (position, velocity, orientation) need to be considered here
+    // charge and diameter are not updated during a run
+    CommFlags flags = getFlags();
+    m_update_flags = CommFlags(0);
+    m_update_flags[comm_flag::position] = flags[comm_flag::position];
+    m_update_flags[comm_flag::velocity] = flags[comm_flag::velocity];
+    m_update_flags[comm_flag::orientation] = flags[comm_flag::orientation];
 
-    for (unsigned int dir = 0; dir < 6; dir ++)
-        {
-        if (! isCommunicating(dir) ) continue;
+    packGhosts(m_update_flags);
+    postGhostMessages(m_update_flags, 2);
 
-        CommFlags flags = getFlags();
+    m_comm_pending = true;
 
-        if (flags[comm_flag::position])
-            {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    if (m_prof)
+        m_prof->pop();
+    }
 
-            // copy positions of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+//! Complete the update of the ghost particle fields
+void Communicator::finishUpdateGhosts(unsigned int timestep)
+    {
+    if (! m_comm_pending)
+        return;
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+    m_comm_pending = false;
 
-                // copy position into send buffer
-                h_pos_copybuf.data[ghost_idx] = h_pos.data[idx];
-                }
-            }
+    if (m_prof)
+        m_prof->push("comm_ghost_update");
 
-        if (flags[comm_flag::velocity])
-            {
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    if (m_prof)
+        m_prof->push("MPI send/recv");
 
-            // copy velocity of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+    if (m_reqs.size())
+        {
+        std::vector<MPI_Status> stats(m_reqs.size());
+        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &stats.front());
+        }
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+    if (m_prof)
+        m_prof->pop(0, m_ghost_sendbuf.size() + m_ghost_recvbuf.size());
 
-                // copy velocityition into send buffer
-                h_velocity_copybuf.data[ghost_idx] = h_vel.data[idx];
-                }
-            }
+    // the ghosts received with the last exchange start right after the local particles
+    unpackGhosts(m_update_flags, m_pdata->getN());
 
-        if (flags[comm_flag::orientation])
-            {
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    if (m_prof)
+        m_prof->pop();
+    }
 
-            // copy orientation of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+/*! \param flags The fields to pack
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+    Every ghost is packed as one element of getGhostElementSize() bytes, and the elements of one
+    neighbor are contiguous in the send buffer.
+*/
+void Communicator::packGhosts(const CommFlags& flags)
+    {
+    unsigned int elem_size = getGhostElementSize(flags);
+    unsigned int n_send_tot = m_ghost_send_tags.size();
+
+    if (m_ghost_sendbuf.size() < n_send_tot*elem_size)
+        m_ghost_sendbuf.resize(n_send_tot*elem_size);
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ghost_send_tags(m_ghost_send_tags, access_location::host, access_mode::read);
+
+    char *buf = n_send_tot ? &m_ghost_sendbuf.front() : NULL;
+    for (unsigned int i = 0; i < n_send_tot; i++)
+        {
+        unsigned int tag = h_ghost_send_tags.data[i];
+        unsigned int idx = h_rtag.data[tag];
+        assert(idx < m_pdata->getN());
 
-                // copy orientation into send buffer
-                h_orientation_copybuf.data[ghost_idx] = h_orientation.data[idx];
-                }
+        if (flags[comm_flag::tag])
+            {
+            memcpy(buf, &tag, sizeof(unsigned int));
+            buf += sizeof(unsigned int);
             }
+        if (flags[comm_flag::position])
+            {
+            memcpy(buf, &h_pos.data[idx], sizeof(Scalar4));
+            buf += sizeof(Scalar4);
+            }
+        if (flags[comm_flag::charge])
+            {
+            memcpy(buf, &h_charge.data[idx], sizeof(Scalar));
+            buf += sizeof(Scalar);
+            }
+        if (flags[comm_flag::diameter])
+            {
+            memcpy(buf, &h_diameter.data[idx], sizeof(Scalar));
+            buf += sizeof(Scalar);
+            }
+        if (flags[comm_flag::velocity])
+            {
+            memcpy(buf, &h_vel.data[idx], sizeof(Scalar4));
+            buf += sizeof(Scalar4);
+            }
+        if (flags[comm_flag::orientation])
+            {
+            memcpy(buf, &h_orientation.data[idx], sizeof(Scalar4));
+            buf += sizeof(Scalar4);
+            }
+        }
+    }
 
+/*! \param flags The packed fields
+    \param mpi_tag Tag of the messages
 
-        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
-
-        // we receive from the direction opposite to the one we send to
-        unsigned int recv_neighbor;
-        if (dir % 2 == 0)
-            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
-        else
-            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
-
+    Posts one send and one receive per unique neighbor and stores the requests in m_reqs.
+*/
+void Communicator::postGhostMessages(const CommFlags& flags, int mpi_tag)
+    {
+    unsigned int elem_size = getGhostElementSize(flags);
 
-        unsigned int start_idx;
+    unsigned int n_recv_tot = 0;
+    for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+        n_recv_tot += m_n_ghost_recv[ineigh];
 
-        if (m_prof)
-            m_prof->push("MPI send/recv");
+    if (m_ghost_recvbuf.size() < n_recv_tot*elem_size)
+        m_ghost_recvbuf.resize(n_recv_tot*elem_size);
 
-        start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+    ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
 
-        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+    m_reqs.clear();
+    MPI_Request req;
+    for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+        {
+        unsigned int neighbor = h_unique_neighbors.data[ineigh];
 
-        size_t sz = 0;
-        // only non-permanent fields (position, velocity, orientation) need to be considered here
-        // charge and diameter are not updated during a run
-        if (flags[comm_flag::position])
+        if (m_n_ghost_send[ineigh])
             {
-            MPI_Request reqs[2];
-            MPI_Status status[2];
-
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
-
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &reqs[0]);
-            MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &reqs[1]);
-            MPI_Waitall(2, reqs, status);
-
-            sz += sizeof(Scalar4);
+            MPI_Isend(&m_ghost_sendbuf.front() + m_ghost_send_offs[ineigh]*elem_size,
+                m_n_ghost_send[ineigh]*elem_size,
+                MPI_BYTE,
+                neighbor,
+                mpi_tag,
+                m_mpi_comm,
+                &req);
+            m_reqs.push_back(req);
             }
 
-        if (flags[comm_flag::velocity])
+        if (m_n_ghost_recv[ineigh])
             {
-            MPI_Request reqs[2];
-            MPI_Status status[2];
-
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
-
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &reqs[0]);
-            MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &reqs[1]);
-            MPI_Waitall(2, reqs, status);
-
-            sz += sizeof(Scalar4);
+            MPI_Irecv(&m_ghost_recvbuf.front() + m_ghost_recv_offs[ineigh]*elem_size,
+                m_n_ghost_recv[ineigh]*elem_size,
+                MPI_BYTE,
+                neighbor,
+                mpi_tag,
+                m_mpi_comm,
+                &req);
+            m_reqs.push_back(req);
             }
+        }
+    }
 
-        if (flags[comm_flag::orientation])
-            {
-            MPI_Request reqs[2];
-            MPI_Status status[2];
+/*! \param flags The packed fields
+    \param start_idx Index of the first ghost particle to write to
+*/
+void Communicator::unpackGhosts(const CommFlags& flags, unsigned int start_idx)
+    {
+    unsigned int n_recv_tot = 0;
+    for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+        n_recv_tot += m_n_ghost_recv[ineigh];
 
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &reqs[0]);
-            MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &reqs[1]);
-            MPI_Waitall(2, reqs, status);
+    const BoxDim shifted_box = getShiftedBox();
 
-            sz += sizeof(Scalar4);
+    const char *buf = n_recv_tot ? &m_ghost_recvbuf.front() : NULL;
+    for (unsigned int idx = start_idx; idx < start_idx + n_recv_tot; idx++)
+        {
+        if (flags[comm_flag::tag])
+            {
+            memcpy(&h_tag.data[idx], buf, sizeof(unsigned int));
+            buf += sizeof(unsigned int);
             }
-
-        if (m_prof)
-            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
-
-
-        // wrap particle positions (only if copying positions)
         if (flags[comm_flag::position])
             {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-
-            const BoxDim shifted_box = getShiftedBox();
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
-                {
-                Scalar4& pos = h_pos.data[idx];
+            memcpy(&h_pos.data[idx], buf, sizeof(Scalar4));
+            buf += sizeof(Scalar4);
 
-                // wrap particles received across a global boundary
-                int3 img = make_int3(0,0,0);
-                shifted_box.wrap(pos, img);
-                }
+            // wrap particles received across a global boundary
+            int3 img = make_int3(0,0,0);
+            shifted_box.wrap(h_pos.data[idx], img);
             }
-
-        } // end dir loop
-
-        if (m_prof)
-            m_prof->pop();
+        if (flags[comm_flag::charge])
+            {
+            memcpy(&h_charge.data[idx], buf, sizeof(Scalar));
+            buf += sizeof(Scalar);
+            }
+        if (flags[comm_flag::diameter])
+            {
+            memcpy(&h_diameter.data[idx], buf, sizeof(Scalar));
+            buf += sizeof(Scalar);
+            }
+        if (flags[comm_flag::velocity])
+            {
+            memcpy(&h_vel.data[idx], buf, sizeof(Scalar4));
+            buf += sizeof(Scalar4);
+            }
+        if (flags[comm_flag::orientation])
+            {
+            memcpy(&h_orientation.data[idx], buf, sizeof(Scalar4));
+            buf += sizeof(Scalar4);
+            }
+        }
     }
 
 const BoxDim Communicator::getShiftedBox() const
@@ -68,6 +68,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ParticleData.h"
 #include "BondedGroupData.h"
 #include "DomainDecomposition.h"
+#include "ReductionBuffer.h"
 
 #include <boost/shared_ptr.hpp>
 #include <boost/signals2.hpp>
@@ -225,9 +226,11 @@ struct rank_element
  * to send the particle to is always made by one and only one processor. This ensure that the total number of particles remains
  * constant (no particle can get lost).
  *
- * In stage two and three, ghost atoms received from a neighboring processor are always included in the local
- * ghost atom lists, and they maybe replicated to more neighboring processors by the communication pattern
- * described above.
+ * In stage two and three, ghost atoms are not relayed. Instead, every local particle is sent directly to all of
+ * the (up to 26) neighboring processors whose domains lie within the ghost layer width of it, and all
+ * requested fields of the ghosts destined to a neighbor are packed into one contiguous message. In stage three,
+ * the messages are posted in beginUpdateGhosts() and completed in finishUpdateGhosts(), so that computation
+ * involving only local particles can proceed while they are in flight.
  * \ingroup communication
  */
 class Communicator
@@ -287,6 +290,13 @@ class Communicator
             }
 
         //! Subscribe to list of call-backs for overlapping computation
+        /*!
+         * On the CPU, the subscribers are called while the ghost update messages are in flight, and
+         * only in time steps without particle migration. They may therefore only use data of local particles.
+         *
+         * \param subscriber The callback
+         * \returns a connection to this class
+         */
         boost::signals2::connection addLocalComputeCallback(
             const boost::function<void (unsigned int timestep)>& subscriber)
             {
@@ -331,6 +341,12 @@ class Communicator
             m_r_ghost = ghost_width;
             }
 
+        //! Get the width of the ghost layer
+        Scalar getGhostLayerWidth() const
+            {
+            return m_r_ghost;
+            }
+
         //! Set skin layer width
         /*! \param r_buff The width of the skin buffer
          */
@@ -350,6 +366,12 @@ class Communicator
         //! Get the ghost communication flags
         CommFlags getFlags() { return m_flags; }
 
+        //! Get the buffer for fused reductions of global sums
+        ReductionBuffer& getReductionBuffer()
+            {
+            return m_reduction_buffer;
+            }
+
         //! Set the ghost communication flags
         /*! \note Flags will be available after the next call to communicate().
          */
@@ -392,14 +414,12 @@ class Communicator
         virtual void beginUpdateGhosts(unsigned int timestep);
 
         /*! Finish ghost update
+         *
+         * Waits for the messages posted by beginUpdateGhosts() and unpacks them into the ghost particle data.
          *
          * \param timestep The time step
          */
-        virtual void finishUpdateGhosts(unsigned int timestep)
-            {
-            // the base class implementation is currently empty
-            m_comm_pending = false;
-            }
+        virtual void finishUpdateGhosts(unsigned int timestep);
 
         /*! This methods finds all the particles that are no longer inside the domain
          * boundaries and transfers them to neighboring processors.
@@ -533,12 +553,62 @@ class Communicator
         //! Helper function to update the shifted box for ghost particle PBC
         const BoxDim getShiftedBox() const;
 
+        //! Returns the size of a packed ghost particle in bytes
+        /*! \param flags The fields that are communicated
+         */
+        static unsigned int getGhostElementSize(const CommFlags& flags)
+            {
+            unsigned int sz = 0;
+            if (flags[comm_flag::tag]) sz += sizeof(unsigned int);
+            if (flags[comm_flag::position]) sz += sizeof(Scalar4);
+            if (flags[comm_flag::charge]) sz += sizeof(Scalar);
+            if (flags[comm_flag::diameter]) sz += sizeof(Scalar);
+            if (flags[comm_flag::velocity]) sz += sizeof(Scalar4);
+            if (flags[comm_flag::orientation]) sz += sizeof(Scalar4);
+            return sz;
+            }
+
+        //! Returns the adjacency mask of all neighbors a particle with a given plan is sent to
+        /*! \param plan The itinerary of the particle (combination of send_* flags)
+
+            The bit of a neighbor is (iz+1)*9+(iy+1)*3+(ix+1), where (ix,iy,iz) is its offset on the processor grid.
+         */
+        static unsigned int getAdjacencyMask(unsigned int plan)
+            {
+            unsigned int mask = 0;
+            for (int ix = -1; ix <= 1; ix++)
+                {
+                if ((ix == 1 && !(plan & send_east)) || (ix == -1 && !(plan & send_west))) continue;
+                for (int iy = -1; iy <= 1; iy++)
+                    {
+                    if ((iy == 1 && !(plan & send_north)) || (iy == -1 && !(plan & send_south))) continue;
+                    for (int iz = -1; iz <= 1; iz++)
+                        {
+                        if ((iz == 1 && !(plan & send_up)) || (iz == -1 && !(plan & send_down))) continue;
+                        if (!ix && !iy && !iz) continue;
+                        mask |= 1 << (((iz+1)*3+(iy+1))*3+(ix+1));
+                        }
+                    }
+                }
+            return mask;
+            }
+
+        //! Pack the fields of the ghosts in the send list into the send buffer
+        void packGhosts(const CommFlags& flags);
+
+        //! Post the non-blocking sends and receives of packed ghosts with every unique neighbor
+        void postGhostMessages(const CommFlags& flags, int mpi_tag);
+
+        //! Unpack the fields of the received ghosts into the particle data
+        void unpackGhosts(const CommFlags& flags, unsigned int start_idx);
+
         boost::shared_ptr<SystemDefinition> m_sysdef;                 //!< System definition
         boost::shared_ptr<ParticleData> m_pdata;                      //!< Particle data
         boost::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< Execution configuration
         const MPI_Comm m_mpi_comm; //!< MPI communciator
         boost::shared_ptr<DomainDecomposition> m_decomposition;       //!< Domain decomposition information
         boost::shared_ptr<Profiler> m_prof;                           //!< Profiler
+        ReductionBuffer m_reduction_buffer;                           //!< Fused reductions of log quantities
 
         bool m_is_communicating;               //!< Whether we are currently communicating
         bool m_force_migrate;                  //!< True if particle migration is forced
@@ -553,17 +623,14 @@ class Communicator
         GPUArray<unsigned int> m_begin;                //!< Begin index for every neighbor in send buf
         GPUArray<unsigned int> m_end;                  //!< End index for every neighbor in send buf
 
-        GPUVector<Scalar4> m_pos_copybuf;         //!< Buffer for particle positions to be copied
-        GPUVector<Scalar> m_charge_copybuf;       //!< Buffer for particle charges to be copied
-        GPUVector<Scalar> m_diameter_copybuf;     //!< Buffer for particle diameters to be copied
-        GPUVector<Scalar4> m_velocity_copybuf;    //!< Buffer for particle velocities to be copied
-        GPUVector<Scalar4> m_orientation_copybuf; //!< Buffer for particle orientation to be copied
-        GPUVector<unsigned int> m_plan_copybuf;  //!< Buffer for particle plans
-        GPUVector<unsigned int> m_tag_copybuf;    //!< Buffer for particle tags
-
-        GPUVector<unsigned int> m_copy_ghosts[6]; //!< Per-direction list of indices of particles to send as ghosts
-        unsigned int m_num_copy_ghosts[6];       //!< Number of local particles that are sent to neighboring processors
-        unsigned int m_num_recv_ghosts[6];       //!< Number of ghosts received per direction
+        GPUVector<unsigned int> m_ghost_send_tags;     //!< Tags of the ghosts to send, grouped by unique neighbor
+        unsigned int m_n_ghost_send[NEIGH_MAX];        //!< Number of ghosts sent to every unique neighbor
+        unsigned int m_n_ghost_recv[NEIGH_MAX];        //!< Number of ghosts received from every unique neighbor
+        unsigned int m_ghost_send_offs[NEIGH_MAX];     //!< Offset of every unique neighbor in the ghost send list
+        unsigned int m_ghost_recv_offs[NEIGH_MAX];     //!< Offset of every unique neighbor in the received ghosts
+        std::vector<char> m_ghost_sendbuf;             //!< Packed ghost fields to send
+        std::vector<char> m_ghost_recvbuf;             //!< Packed ghost fields received
+        CommFlags m_update_flags;                      //!< Fields communicated by the pending ghost update
 
         BoxDim m_global_box;                     //!< Global simulation box
         Scalar m_r_ghost;                        //!< Width of ghost layer
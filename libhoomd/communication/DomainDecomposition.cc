@@ -64,6 +64,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/serialization/set.hpp>
 
+#include <algorithm>
+
 using namespace boost::python;
 
 //! Constructor
@@ -144,6 +146,16 @@ DomainDecomposition::DomainDecomposition(boost::shared_ptr<ExecutionConfiguratio
     // Initialize domain indexer
     m_index = Index3D(m_nx,m_ny,m_nz);
 
+    // initially, the split planes are spaced uniformly
+    unsigned int n_domains[3] = {m_nx, m_ny, m_nz};
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        m_cumulative_frac[dir].resize(n_domains[dir]+1);
+        for (unsigned int i = 0; i <= n_domains[dir]; ++i)
+            m_cumulative_frac[dir][i] = Scalar(i)/Scalar(n_domains[dir]);
+        }
+    m_is_uniform = true;
+
     // map cartesian grid onto ranks
     GPUArray<unsigned int> cart_ranks(nranks, m_exec_conf);
     m_cart_ranks.swap(cart_ranks);
@@ -363,18 +375,17 @@ const BoxDim DomainDecomposition::calculateLocalBox(const BoxDim & global_box)
     // initialize local box with all properties of global box
     BoxDim box = global_box;
 
-    // calculate the local box dimensions by sub-dividing the cartesian lattice
+    // the local box extends between the split planes enclosing this domain
     Scalar3 L = global_box.getL();
-    Scalar3 L_local = L / make_scalar3(m_nx, m_ny, m_nz);
-
-    // position of this domain in the grid
     Scalar3 lo_g = global_box.getLo();
     Scalar3 lo, hi;
-    lo.x = lo_g.x + (double)m_grid_pos.x * L_local.x;
-    lo.y = lo_g.y + (double)m_grid_pos.y * L_local.y;
-    lo.z = lo_g.z + (double)m_grid_pos.z * L_local.z;
+    lo.x = lo_g.x + m_cumulative_frac[0][m_grid_pos.x] * L.x;
+    lo.y = lo_g.y + m_cumulative_frac[1][m_grid_pos.y] * L.y;
+    lo.z = lo_g.z + m_cumulative_frac[2][m_grid_pos.z] * L.z;
 
-    hi = lo + L_local;
+    hi.x = lo_g.x + m_cumulative_frac[0][m_grid_pos.x+1] * L.x;
+    hi.y = lo_g.y + m_cumulative_frac[1][m_grid_pos.y+1] * L.y;
+    hi.z = lo_g.z + m_cumulative_frac[2][m_grid_pos.z+1] * L.z;
 
     // set periodic flags
     // we are periodic in a direction along which there is only one box
@@ -387,6 +398,62 @@ const BoxDim DomainDecomposition::calculateLocalBox(const BoxDim & global_box)
     return box;
     }
 
+/*! \param dir Direction (0: x, 1: y, 2: z)
+ * \param cum_frac The n+1 fractional coordinates of the domain boundaries, beginning with 0 and ending with 1
+ *
+ * This method must be called on all ranks, the split planes of the root rank are broadcast. The local box of the ParticleData is not updated,
+ * the caller needs to reset the global box afterwards and migrate the particles to their new domains.
+ */
+void DomainDecomposition::setCumulativeFractions(unsigned int dir, const std::vector<Scalar>& cum_frac)
+    {
+    assert(dir < 3);
+
+    std::vector<Scalar> frac = cum_frac;
+    bcast(frac, 0, m_mpi_comm);
+
+    unsigned int n_domains = m_cumulative_frac[dir].size() - 1;
+    bool valid = (frac.size() == n_domains+1 && frac.front() == Scalar(0.0) && frac.back() == Scalar(1.0));
+    for (unsigned int i = 0; valid && i < n_domains; ++i)
+        valid = frac[i] < frac[i+1];
+
+    if (! valid)
+        {
+        m_exec_conf->msg->error() << "comm: Invalid split planes along " << (char)('x'+dir)
+                                  << ", expected " << n_domains+1 << " increasing values from 0 to 1" << std::endl;
+        throw std::runtime_error("Error setting domain boundaries");
+        }
+
+    m_cumulative_frac[dir] = frac;
+
+    // check if the split planes are still spaced uniformly along all directions
+    m_is_uniform = true;
+    for (unsigned int d = 0; d < 3; ++d)
+        {
+        unsigned int n = m_cumulative_frac[d].size() - 1;
+        for (unsigned int i = 0; i <= n; ++i)
+            if (fabs(m_cumulative_frac[d][i] - Scalar(i)/Scalar(n)) > Scalar(1e-6))
+                m_is_uniform = false;
+        }
+    }
+
+/*! \param f Fractional coordinates of the point in the global box
+ * \returns The grid position of the domain. Coordinates below 0 are mapped onto the first domain, coordinates
+ *          at or above 1 onto the number of domains along that direction, so that the caller can wrap them.
+ */
+uint3 DomainDecomposition::findGridPos(Scalar3 f) const
+    {
+    Scalar fs[3] = {f.x, f.y, f.z};
+    unsigned int pos[3];
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        // the domain is the last split plane at or below the coordinate
+        const std::vector<Scalar>& frac = m_cumulative_frac[dir];
+        unsigned int i = std::upper_bound(frac.begin(), frac.end(), fs[dir]) - frac.begin();
+        pos[dir] = (i > 0) ? i - 1 : 0;
+        }
+    return make_uint3(pos[0], pos[1], pos[2]);
+    }
+
 unsigned int DomainDecomposition::placeParticle(const BoxDim& global_box, Scalar3 pos)
     {
     // get fractional coordinates in the global box
@@ -403,13 +470,15 @@ unsigned int DomainDecomposition::placeParticle(const BoxDim& global_box, Scalar
         }
 
     // compute the box the particle should be placed into
-    unsigned ix = f.x*m_nx;
+    uint3 grid_pos = findGridPos(f);
+
+    unsigned ix = grid_pos.x;
     if (ix == m_nx) ix = 0;
 
-    unsigned iy = f.y*m_ny;
+    unsigned iy = grid_pos.y;
     if (iy == m_ny) iy = 0;
 
-    unsigned iz = f.z*m_nz;
+    unsigned iz = grid_pos.z;
     if (iz == m_nz) iz = 0;
 
     ArrayHandle<unsigned int> h_cart_ranks(m_cart_ranks, access_location::host, access_mode::read);
@@ -63,6 +63,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "GPUArray.h"
 
 #include <set>
+#include <vector>
 
 /*! \ingroup communication
 */
@@ -78,6 +79,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  such as to minimize surface area between domains, while utilizing all processors in the MPI communicator.
  *
  *  The initialization of the domain decomposition scheme is performed in the constructor.
+ *
+ *  The domain boundaries along every direction are stored as cumulative fractions of the global box, i.e.
+ *  n+1 split planes ranging from 0 to 1 for n domains. Initially, they are spaced uniformly. They can be moved
+ *  with setCumulativeFractions() to balance the load between the ranks (see LoadBalancer). Since the split planes
+ *  are shared by all domains in a slab, the grid of domains stays rectilinear and the neighbor relations
+ *  between domains do not change.
  */
 class DomainDecomposition
     {
@@ -131,6 +138,28 @@ class DomainDecomposition
         //! Get the dimensions of the local simulation box
         const BoxDim calculateLocalBox(const BoxDim& global_box);
 
+        //! Get the cumulative fractions of the split planes along a direction
+        /*! \param dir Direction (0: x, 1: y, 2: z)
+         * \returns The n+1 fractional coordinates of the domain boundaries, beginning with 0 and ending with 1
+         */
+        const std::vector<Scalar>& getCumulativeFractions(unsigned int dir) const
+            {
+            assert(dir < 3);
+            return m_cumulative_frac[dir];
+            }
+
+        //! Set the cumulative fractions of the split planes along a direction
+        void setCumulativeFractions(unsigned int dir, const std::vector<Scalar>& cum_frac);
+
+        //! Returns true if the split planes are spaced uniformly along all directions
+        bool isUniform() const
+            {
+            return m_is_uniform;
+            }
+
+        //! Find the position in the grid of the domain containing a point
+        uint3 findGridPos(Scalar3 f) const;
+
         //! Get the rank for a particle to be placed
         /*! \param pos Particle position
          * \returns the rank of the processor that should receive the particle
@@ -152,6 +181,9 @@ class DomainDecomposition
         unsigned int m_max_n_node;   //!< Maximum number of ranks on a node
         bool m_twolevel;             //!< Whether we use a two-level decomposition
 
+        std::vector<Scalar> m_cumulative_frac[3]; //!< Fractional coordinates of the split planes along every direction
+        bool m_is_uniform;           //!< True if the split planes are spaced uniformly
+
         GPUArray<unsigned int> m_cart_ranks; //!< A lookup-table to map the cartesian grid index onto ranks
         GPUArray<unsigned int> m_cart_ranks_inv; //!< Inverse permutation of grid index lookup table
 
@@ -0,0 +1,160 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: jglaser
+
+/*! \file ReductionBuffer.cc
+    \brief Implements the ReductionBuffer class
+*/
+
+#ifdef ENABLE_MPI
+#include "ReductionBuffer.h"
+
+#include <stdexcept>
+using namespace std;
+
+/*! \param exec_conf Execution configuration providing the MPI communicator
+*/
+ReductionBuffer::ReductionBuffer(boost::shared_ptr<const ExecutionConfiguration> exec_conf)
+    : m_exec_conf(exec_conf), m_collecting(false), m_reduced(false), m_n_reductions(0)
+    {
+    }
+
+/*! Any results of a previous reduction are discarded.
+*/
+void ReductionBuffer::begin()
+    {
+    m_entries.clear();
+    m_values.clear();
+    m_collecting = true;
+    m_reduced = false;
+    }
+
+/*! \param key Identifies the source of the values
+    \param values Partial sums of this rank
+    \param n Number of values
+    \param callback Function called with the global sums in reduce()
+*/
+void ReductionBuffer::post(const void *key, const double *values, unsigned int n, const callback_type& callback)
+    {
+    if (!m_collecting)
+        {
+        m_exec_conf->msg->error() << "ReductionBuffer: values posted outside of begin() and reduce()" << endl;
+        throw runtime_error("Error posting values for reduction");
+        }
+
+    if (findEntry(key) != m_entries.size())
+        return;
+
+    Entry entry;
+    entry.key = key;
+    entry.offset = (unsigned int)m_values.size();
+    entry.n = n;
+    entry.callback = callback;
+    m_entries.push_back(entry);
+
+    m_values.insert(m_values.end(), values, values + n);
+    }
+
+/*! This is a collective call. Sources that posted values can retrieve them with getResult() afterwards.
+*/
+void ReductionBuffer::reduce()
+    {
+    m_collecting = false;
+    m_reduced = true;
+
+    if (m_values.size() == 0)
+        return;
+
+    MPI_Allreduce(MPI_IN_PLACE, &m_values.front(), (int)m_values.size(), MPI_DOUBLE, MPI_SUM,
+                  m_exec_conf->getMPICommunicator());
+    m_n_reductions++;
+
+    for (unsigned int i = 0; i < m_entries.size(); i++)
+        if (m_entries[i].callback)
+            m_entries[i].callback(&m_values[m_entries[i].offset]);
+    }
+
+/*! \param key Identifies the source of the values
+    \returns The global sums posted under \a key, or NULL if there are none or they have not been reduced yet
+*/
+const double *ReductionBuffer::getResult(const void *key) const
+    {
+    if (!m_reduced)
+        return NULL;
+
+    unsigned int idx = findEntry(key);
+    if (idx == m_entries.size())
+        return NULL;
+
+    return &m_values[m_entries[idx].offset];
+    }
+
+/*! After end(), sources perform their own reductions again.
+*/
+void ReductionBuffer::end()
+    {
+    m_collecting = false;
+    m_reduced = false;
+    m_entries.clear();
+    m_values.clear();
+    }
+
+/*! \param key Key to look for
+*/
+unsigned int ReductionBuffer::findEntry(const void *key) const
+    {
+    // there are only a handful of sources, a linear search is fastest
+    for (unsigned int i = 0; i < m_entries.size(); i++)
+        if (m_entries[i].key == key)
+            return i;
+    return (unsigned int)m_entries.size();
+    }
+
+#endif // ENABLE_MPI
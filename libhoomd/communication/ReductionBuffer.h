@@ -0,0 +1,174 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: jglaser
+
+/*! \file ReductionBuffer.h
+    \brief Defines the ReductionBuffer class
+*/
+
+#ifdef ENABLE_MPI
+
+#ifndef __REDUCTION_BUFFER_H__
+#define __REDUCTION_BUFFER_H__
+
+#include "ExecutionConfiguration.h"
+
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+//! Combines the global sums of many computes into a single MPI_Allreduce
+/*! Each log quantity that is a global sum (potential energies, thermodynamic properties) normally performs its own
+    MPI_Allreduce when it is requested. When many quantities are logged, these latency bound collectives dominate the
+    cost of logging on many ranks. The ReductionBuffer lets the Logger resolve all of them at once:
+
+    1. begin() starts collecting. Sources that would reduce a partial sum post() it instead, under a key that
+       identifies the source (usually its this pointer), and use a placeholder value for now.
+    2. reduce() sums all posted values over all ranks with one MPI_Allreduce and calls the callbacks given to post().
+    3. Until end() is called, sources look up their global sums with getResult() instead of reducing again.
+
+    All ranks must post the same keys in the same order, which holds as long as posting depends only on state that is
+    identical on all ranks. Posting a key a second time is ignored. Values are reduced in double precision.
+
+    \ingroup communication
+*/
+class ReductionBuffer
+    {
+    public:
+        //! Type of the function called with the reduced values
+        typedef boost::function<void (const double *values)> callback_type;
+
+        //! Constructor
+        ReductionBuffer(boost::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Starts collecting partial sums
+        void begin();
+
+        //! Returns true while partial sums are collected
+        bool isCollecting() const
+            {
+            return m_collecting;
+            }
+
+        //! Adds partial sums to the buffer
+        void post(const void *key, const double *values, unsigned int n, const callback_type& callback = callback_type());
+
+        //! Reduces all posted partial sums
+        void reduce();
+
+        //! Returns the reduced values of a source, or NULL if it has none
+        const double *getResult(const void *key) const;
+
+        //! Discards all results
+        void end();
+
+        //! Returns the number of MPI_Allreduce calls made so far
+        unsigned int getNumReductions() const
+            {
+            return m_n_reductions;
+            }
+
+    private:
+        //! Partial sums posted by one source
+        struct Entry
+            {
+            const void *key;            //!< Identifies the source
+            unsigned int offset;        //!< Offset of the values in m_values
+            unsigned int n;             //!< Number of values
+            callback_type callback;     //!< Called after the reduction (may be empty)
+            };
+
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        bool m_collecting;                  //!< True between begin() and reduce()
+        bool m_reduced;                     //!< True between reduce() and end()
+        std::vector<Entry> m_entries;       //!< Posted sources, in order
+        std::vector<double> m_values;       //!< Packed partial sums
+        unsigned int m_n_reductions;        //!< Number of reductions performed
+
+        //! Returns the index of the entry of a key, or m_entries.size() if there is none
+        unsigned int findEntry(const void *key) const;
+    };
+
+//! Collects partial sums in a ReductionBuffer for the lifetime of the object
+/*! The constructor calls begin() and the destructor calls end(), so the buffer is released even when a source throws
+    between begin() and reduce(). Otherwise it would stay in collecting mode and every later request of a global sum
+    would silently return the unreduced placeholder.
+
+    \ingroup communication
+*/
+class ReductionBufferScope : boost::noncopyable
+    {
+    public:
+        //! Starts collecting partial sums in \a buffer
+        ReductionBufferScope(ReductionBuffer& buffer)
+            : m_buffer(buffer)
+            {
+            m_buffer.begin();
+            }
+
+        //! Discards the results
+        ~ReductionBufferScope()
+            {
+            m_buffer.end();
+            }
+
+        //! Reduces all posted partial sums
+        void reduce()
+            {
+            m_buffer.reduce();
+            }
+
+    private:
+        ReductionBuffer& m_buffer;  //!< The buffer collecting the partial sums
+    };
+
+#endif // __REDUCTION_BUFFER_H__
+#endif // ENABLE_MPI
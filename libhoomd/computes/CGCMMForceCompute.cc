@@ -274,7 +274,8 @@ void CGCMMForceCompute::computeForces(unsigned int timestep)
     // access the neighbor list
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-    Index2D nli = m_nlist->getNListIndexer();
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+    const unsigned int nlist_stride = m_nlist->getNListStride();
 
     // access the particle data
     ArrayHandle< Scalar4 > h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
@@ -320,7 +321,7 @@ void CGCMMForceCompute::computeForces(unsigned int timestep)
             n_calc++;
 
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int k = h_nlist.data[nli(i, j)];
+            unsigned int k = h_nlist.data[h_head_list.data[i] + j*nlist_stride];
             // sanity check
             assert(k < m_pdata->getN());
 
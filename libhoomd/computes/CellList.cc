@@ -63,11 +63,14 @@ using namespace boost;
 using namespace boost::python;
 using namespace std;
 
+//! Value of the cell index of a particle that is not placed in the cell list
+const unsigned int CELLLIST_NOT_BINNED = 0xffffffff;
+
 /*! \param sysdef system to compute the cell list of
 */
 CellList::CellList(boost::shared_ptr<SystemDefinition> sysdef)
     : Compute(sysdef),  m_nominal_width(Scalar(1.0)), m_radius(1), m_max_cells(UINT_MAX), m_compute_tdb(false),
-      m_compute_orientation(false), m_compute_idx(false), m_flag_charge(false), m_flag_type(false)
+      m_compute_orientation(false), m_compute_idx(false), m_flag_charge(false), m_flag_type(false), m_compact(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing CellList" << endl;
 
@@ -357,12 +360,26 @@ void CellList::initializeMemory()
     GPUArray<unsigned int> cell_adj(m_cell_adj_indexer.getNumElements(), exec_conf);
     m_cell_adj.swap(cell_adj);
 
-    GPUArray<Scalar4> xyzf(m_cell_list_indexer.getNumElements(), exec_conf);
+    GPUArray<unsigned int> cell_start(m_cell_indexer.getNumElements()+1, exec_conf);
+    m_cell_start.swap(cell_start);
+
+    if (!m_compact)
+        {
+        // in the default layout, every cell starts at a fixed offset
+        ArrayHandle<unsigned int> h_cell_start(m_cell_start, access_location::host, access_mode::overwrite);
+        for (unsigned int cell = 0; cell <= m_cell_indexer.getNumElements(); cell++)
+            h_cell_start.data[cell] = cell*m_Nmax;
+        }
+
+    // in the compact layout, the cell list arrays are sized from the cell occupancy in computeCellListCompact()
+    unsigned int n_elements = m_compact ? 0 : m_cell_list_indexer.getNumElements();
+
+    GPUArray<Scalar4> xyzf(n_elements, exec_conf);
     m_xyzf.swap(xyzf);
 
     if (m_compute_tdb)
         {
-        GPUArray<Scalar4> tdb(m_cell_list_indexer.getNumElements(), exec_conf);
+        GPUArray<Scalar4> tdb(n_elements, exec_conf);
         m_tdb.swap(tdb);
         }
     else
@@ -374,7 +391,7 @@ void CellList::initializeMemory()
 
     if (m_compute_orientation)
         {
-        GPUArray<Scalar4> orientation(m_cell_list_indexer.getNumElements(), exec_conf);
+        GPUArray<Scalar4> orientation(n_elements, exec_conf);
         m_orientation.swap(orientation);
         }
     else
@@ -386,7 +403,7 @@ void CellList::initializeMemory()
 
     if (m_compute_idx)
         {
-        GPUArray<unsigned int> idx(m_cell_list_indexer.getNumElements(), exec_conf);
+        GPUArray<unsigned int> idx(n_elements, exec_conf);
         m_idx.swap(idx);
         }
     else
@@ -467,8 +484,75 @@ void CellList::initializeCellAdj()
         m_prof->pop();
     }
 
+/*! \param postype Position (and type) of the particle
+    \param n Index of the particle
+    \param box Local simulation box
+    \param ghost_width Width of the ghost layer
+    \param conditions Condition flags to set if the particle cannot be placed in a cell
+    \returns The index of the cell the particle belongs in, or CELLLIST_NOT_BINNED if it is not to be placed in the list
+*/
+inline unsigned int CellList::binParticle(const Scalar4& postype,
+                                          unsigned int n,
+                                          const BoxDim& box,
+                                          const Scalar3& ghost_width,
+                                          uint3& conditions) const
+    {
+    Scalar3 p = make_scalar3(postype.x, postype.y, postype.z);
+    if (isnan(p.x) || isnan(p.y) || isnan(p.z))
+        {
+        conditions.y = n+1;
+        return CELLLIST_NOT_BINNED;
+        }
+
+    // find the bin each particle belongs in
+    Scalar3 f = box.makeFraction(p,ghost_width);
+    int ib = (int)(f.x * m_dim.x);
+    int jb = (int)(f.y * m_dim.y);
+    int kb = (int)(f.z * m_dim.z);
+
+    // check if the particle is inside the unit cell + ghost layer in all dimensions
+    if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
+        (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
+        (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
+        {
+        // if a ghost particle is out of bounds, silently ignore it
+        if (n < m_pdata->getN())
+            conditions.z = n+1;
+        return CELLLIST_NOT_BINNED;
+        }
+
+    // need to handle the case where the particle is exactly at the box hi
+    uchar3 periodic = box.getPeriodic();
+    if (ib == (int)m_dim.x && periodic.x)
+        ib = 0;
+    if (jb == (int)m_dim.y && periodic.y)
+        jb = 0;
+    if (kb == (int)m_dim.z && periodic.z)
+        kb = 0;
+
+    // sanity check
+    assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z)) || n>=m_pdata->getN());
+
+    // all particles should be in a valid cell
+    if (ib >= (int)m_dim.x || jb >= (int)m_dim.y || kb >= (int)m_dim.z)
+        {
+        // but ghost particles that are out of range should not produce an error
+        if (n < m_pdata->getN())
+            conditions.z = n+1;
+        return CELLLIST_NOT_BINNED;
+        }
+
+    return m_cell_indexer(ib, jb, kb);
+    }
+
 void CellList::computeCellList()
     {
+    if (m_compact)
+        {
+        computeCellListCompact();
+        return;
+        }
+
     if (m_prof)
         m_prof->push("compute");
 
@@ -489,7 +573,6 @@ void CellList::computeCellList()
     uint3 conditions = make_uint3(0,0,0);
 
     // shorthand copies of the indexers
-    Index3D ci = m_cell_indexer;
     Index2D cli = m_cell_list_indexer;
 
     // clear the bin sizes to 0
@@ -497,61 +580,15 @@ void CellList::computeCellList()
 
     Scalar3 ghost_width = getGhostWidth();
 
-    // get periodic flags
-    uchar3 periodic = box.getPeriodic();
-
     // for each particle
     unsigned n_tot_particles = m_pdata->getN() + m_pdata->getNGhosts();
 
     for (unsigned int n = 0; n < n_tot_particles; n++)
         {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        if (isnan(p.x) || isnan(p.y) || isnan(p.z))
-            {
-            conditions.y = n+1;
-            continue;
-            }
-
-
-        // find the bin each particle belongs in
-        Scalar3 f = box.makeFraction(p,ghost_width);
-        int ib = (int)(f.x * m_dim.x);
-        int jb = (int)(f.y * m_dim.y);
-        int kb = (int)(f.z * m_dim.z);
-
-        // check if the particle is inside the unit cell + ghost layer in all dimensions
-        if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
-            (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
-            (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
-            {
-            // if a ghost particle is out of bounds, silently ignore it
-            if (n < m_pdata->getN())
-                conditions.z = n+1;
-            continue;
-            }
-
-        // need to handle the case where the particle is exactly at the box hi
-        if (ib == (int)m_dim.x && periodic.x)
-            ib = 0;
-        if (jb == (int)m_dim.y && periodic.y)
-            jb = 0;
-        if (kb == (int)m_dim.z && periodic.z)
-            kb = 0;
-
-        // sanity check
-        assert((ib < (int)(m_dim.x) && jb < (int)(m_dim.y) && kb < (int)(m_dim.z)) || n>=m_pdata->getN());
-
         // record its bin
-        unsigned int bin = ci(ib, jb, kb);
-
-        // all particles should be in a valid cell
-        if (ib >= (int)m_dim.x || jb >= (int)m_dim.y || kb >= (int)m_dim.z)
-            {
-            // but ghost particles that are out of range should not produce an error
-            if (n < m_pdata->getN())
-                conditions.z = n+1;
+        unsigned int bin = binParticle(h_pos.data[n], n, box, ghost_width, conditions);
+        if (bin == CELLLIST_NOT_BINNED)
             continue;
-            }
 
         // setup the flag value to store
         Scalar flag;
@@ -602,6 +639,189 @@ void CellList::computeCellList()
         m_prof->pop();
     }
 
+/*! The compact cell list is built in two passes over the particles, each distributed over the threads of the
+    ExecutionConfiguration. countCellsThread() bins the particles and counts the members of each cell for each thread.
+    An exclusive prefix sum over the cells, and within each cell over the threads, then yields the first member of
+    every cell and the offset at which each thread writes its members of that cell. fillCellsThread() finally writes
+    all requested cell list arrays in a single sweep.
+
+    Since the particle ranges are assigned to the threads in order, the members of each cell are ordered by particle
+    index, exactly as in the serial build.
+*/
+void CellList::computeCellListCompact()
+    {
+    if (m_prof)
+        m_prof->push("compute");
+
+    // acquire the particle data
+    ArrayHandle< Scalar4 > h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 > h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle< unsigned int > h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    unsigned int n_cells = m_cell_indexer.getNumElements();
+    std::vector<uint3> conditions(n_threads, make_uint3(0,0,0));
+
+    compact_args args;
+    args.pos = h_pos.data;
+    args.orientation = h_orientation.data;
+    args.charge = h_charge.data;
+    args.body = h_body.data;
+    args.diameter = h_diameter.data;
+    args.conditions = &conditions[0];
+    args.n_tot = m_pdata->getN() + m_pdata->getNGhosts();
+    args.n_cells = n_cells;
+    args.box = m_pdata->getBox();
+    args.ghost_width = getGhostWidth();
+
+    if (m_particle_bin.size() < args.n_tot)
+        m_particle_bin.resize(args.n_tot);
+    m_thread_cell_count.resize(n_threads*n_cells);
+
+    // first pass: count the members of each cell
+    m_exec_conf->getThreadPool().run(bind(&CellList::countCellsThread, this, _1, boost::cref(args)));
+
+    // prefix sum over cells and threads
+    unsigned int n_binned = 0;
+        {
+        ArrayHandle<unsigned int> h_cell_size(m_cell_size, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_cell_start(m_cell_start, access_location::host, access_mode::overwrite);
+
+        for (unsigned int cell = 0; cell < n_cells; cell++)
+            {
+            h_cell_start.data[cell] = n_binned;
+            for (unsigned int thread_idx = 0; thread_idx < n_threads; thread_idx++)
+                {
+                unsigned int& count = m_thread_cell_count[thread_idx*n_cells + cell];
+                unsigned int n = count;
+                count = n_binned;
+                n_binned += n;
+                }
+            h_cell_size.data[cell] = n_binned - h_cell_start.data[cell];
+            }
+        h_cell_start.data[n_cells] = n_binned;
+        }
+
+    // grow the cell list arrays if needed, with some room for fluctuations in the number of ghost particles
+    if (n_binned > m_xyzf.getNumElements())
+        {
+        unsigned int n_alloc = n_binned + n_binned/8;
+        m_exec_conf->msg->notice(6) << "cell list: allocating " << n_alloc << " compact entries" << endl;
+
+        GPUArray<Scalar4> xyzf(n_alloc, exec_conf);
+        m_xyzf.swap(xyzf);
+
+        if (m_compute_tdb)
+            {
+            GPUArray<Scalar4> tdb(n_alloc, exec_conf);
+            m_tdb.swap(tdb);
+            }
+
+        if (m_compute_orientation)
+            {
+            GPUArray<Scalar4> orientation(n_alloc, exec_conf);
+            m_orientation.swap(orientation);
+            }
+
+        if (m_compute_idx)
+            {
+            GPUArray<unsigned int> idx(n_alloc, exec_conf);
+            m_idx.swap(idx);
+            }
+        }
+
+    // second pass: fill the cells
+        {
+        ArrayHandle<Scalar4> h_xyzf(m_xyzf, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_cell_orientation(m_orientation, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_cell_idx(m_idx, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_tdb(m_tdb, access_location::host, access_mode::overwrite);
+
+        args.xyzf = h_xyzf.data;
+        args.tdb = h_tdb.data;
+        args.cell_orientation = h_cell_orientation.data;
+        args.cell_idx = h_cell_idx.data;
+
+        m_exec_conf->getThreadPool().run(bind(&CellList::fillCellsThread, this, _1, boost::cref(args)));
+        }
+
+    // write out conditions, the compact layout never overflows
+    uint3 all_conditions = make_uint3(0,0,0);
+    for (unsigned int thread_idx = 0; thread_idx < n_threads; thread_idx++)
+        {
+        all_conditions.y = max(all_conditions.y, conditions[thread_idx].y);
+        all_conditions.z = max(all_conditions.z, conditions[thread_idx].z);
+        }
+    m_conditions.resetFlags(all_conditions);
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void CellList::countCellsThread(unsigned int thread_idx, const compact_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.n_tot, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    unsigned int *count = &m_thread_cell_count[thread_idx*args.n_cells];
+    memset(count, 0, sizeof(unsigned int)*args.n_cells);
+
+    uint3 conditions = make_uint3(0,0,0);
+    for (unsigned int n = first; n < last; n++)
+        {
+        unsigned int bin = binParticle(args.pos[n], n, args.box, args.ghost_width, conditions);
+        m_particle_bin[n] = bin;
+        if (bin != CELLLIST_NOT_BINNED)
+            count[bin]++;
+        }
+
+    args.conditions[thread_idx] = conditions;
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void CellList::fillCellsThread(unsigned int thread_idx, const compact_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.n_tot, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    unsigned int *offset = &m_thread_cell_count[thread_idx*args.n_cells];
+
+    for (unsigned int n = first; n < last; n++)
+        {
+        unsigned int bin = m_particle_bin[n];
+        if (bin == CELLLIST_NOT_BINNED)
+            continue;
+
+        unsigned int k = offset[bin]++;
+
+        // setup the flag value to store
+        Scalar flag;
+        if (m_flag_charge)
+            flag = args.charge[n];
+        else if (m_flag_type)
+            flag = args.pos[n].w;
+        else
+            flag = __int_as_scalar(n);
+
+        args.xyzf[k] = make_scalar4(args.pos[n].x, args.pos[n].y, args.pos[n].z, flag);
+        if (m_compute_tdb)
+            args.tdb[k] = make_scalar4(args.pos[n].w, args.diameter[n], __int_as_scalar(args.body[n]), Scalar(0.0));
+
+        if (m_compute_orientation)
+            args.cell_orientation[k] = args.orientation[n];
+
+        if (m_compute_idx)
+            args.cell_idx[k] = n;
+        }
+    }
+
 bool CellList::checkConditions()
     {
     bool result = false;
@@ -709,6 +929,7 @@ void export_CellList()
         .def("setComputeTDB", &CellList::setComputeTDB)
         .def("setFlagCharge", &CellList::setFlagCharge)
         .def("setFlagIndex", &CellList::setFlagIndex)
+        .def("setCompact", &CellList::setCompact)
         .def("getDim", &CellList::getDim, return_internal_reference<>())
         .def("getNmax", &CellList::getNmax)
         .def("benchmark", &CellList::benchmark)
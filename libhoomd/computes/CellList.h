@@ -51,6 +51,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/shared_ptr.hpp>
 #include <boost/signals2.hpp>
+#include <vector>
 #include "GPUArray.h"
 #include "GPUFlags.h"
 
@@ -117,6 +118,24 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
      - <code>cell_adj[cell_adj_indexer(offset,cidx)]</code> is the cell index for neighboring cell \c offset to \c cidx.
        \c offset can vary from 0 to (radius*2+1)^3-1 (typically 26 with radius 1)
 
+    <b>Compact layout:</b>
+
+    Reserving Nmax slots per cell wastes memory in inhomogeneous systems, and every time a cell exceeds Nmax the
+    whole list must be recomputed. When the compact layout is enabled with setCompact(), the members of each cell are
+    instead stored contiguously, starting at <code>cell_start[cidx]</code>. The list is then built in two passes over
+    the particles that are distributed over the threads of the ExecutionConfiguration: the first pass bins the
+    particles and counts the members of each cell per thread, a prefix sum over cells and threads gives every thread
+    its own write offset in each cell, and the second pass fills \c xyzf, \c tdb, \c orientation and \c idx in a
+    single sweep. The members of a cell are ordered by particle index, independent of the number of threads. The
+    memory is sized from the counts, so the compact layout never overflows.
+
+    Code that is to work with both layouts accesses the cells through the \c cell_start array (getCellStartArray()):
+     - <code>xyzf[cell_start[cidx] + offset]</code> is the data stored for particle \c offset in cell \c cidx
+
+    In the default layout <code>cell_start[cidx] = cell_list_indexer(0,cidx)</code>, so this addresses the same
+    element. The cell list indexer and Nmax are only meaningful in the default layout. The compact layout is only
+    implemented on the CPU.
+
     <b>Parameters:</b>
      - \c width - minimum width of a cell in any x,y,z direction
      - \c radius - integer radius of cells to generate in \c cell_adj (1,2,3,4,...)
@@ -191,6 +210,13 @@ class CellList : public Compute
             m_params_changed = true;
             }
 
+        //! Specify if the compact layout is to be used
+        virtual void setCompact(bool compact)
+            {
+            m_compact = compact;
+            m_params_changed = true;
+            }
+
         //! Specify that the flag is to be filled with the particle charge
         void setFlagCharge()
             {
@@ -270,6 +296,12 @@ class CellList : public Compute
             return m_cell_adj_indexer;
             }
 
+        //! Test if the compact layout is used
+        bool getCompact() const
+            {
+            return m_compact;
+            }
+
         //! Get number of memory slots allocated for each cell
         const unsigned int getNmax() const
             {
@@ -298,6 +330,12 @@ class CellList : public Compute
             return m_cell_size;
             }
 
+        //! Get the array of offsets of the first member of each cell
+        const GPUArray<unsigned int>& getCellStartArray() const
+            {
+            return m_cell_start;
+            }
+
         //! Get the adjacency list
         const GPUArray<unsigned int>& getCellAdjArray() const
             {
@@ -350,6 +388,7 @@ class CellList : public Compute
         bool m_compute_idx;          //!< true if the idx list should be computed
         bool m_flag_charge;          //!< true if the flag should be set to the charge, it will be index (or type) otherwise
         bool m_flag_type;            //!< true if the flag should be set to type, it will be index otherwise
+        bool m_compact;              //!< true if the compact layout is used
         bool m_params_changed;       //!< Set to true when parameters are changed
         bool m_particles_sorted;     //!< Set to true when the particles have been sorted
         bool m_box_changed;          //!< Set to ttrue when the box size has changed
@@ -366,6 +405,7 @@ class CellList : public Compute
 
         // values computed by compute()
         GPUArray<unsigned int> m_cell_size;  //!< Number of members in each cell
+        GPUArray<unsigned int> m_cell_start; //!< Offset of the first member of each cell
         GPUArray<unsigned int> m_cell_adj;   //!< Cell adjacency list
         GPUArray<Scalar4> m_xyzf;            //!< Cell list with position and flags
         GPUArray<Scalar4> m_tdb;             //!< Cell list with type,diameter,body
@@ -375,6 +415,35 @@ class CellList : public Compute
         boost::signals2::connection m_sort_connection;        //!< Connection to the ParticleData sort signal
         boost::signals2::connection m_boxchange_connection;   //!< Connection to the ParticleData box size change signal
 
+        // scratch space for the compact build
+        std::vector<unsigned int> m_particle_bin;       //!< Cell of each particle
+        std::vector<unsigned int> m_thread_cell_count;  //!< Per thread count (later write offset) of each cell
+
+        //! Pointers to the input and output arrays of the compact build, shared by all threads
+        struct compact_args
+            {
+            const Scalar4 *pos;             //!< Particle positions and types
+            const Scalar4 *orientation;     //!< Particle orientations
+            const Scalar *charge;           //!< Particle charges
+            const unsigned int *body;       //!< Particle body indices
+            const Scalar *diameter;         //!< Particle diameters
+            Scalar4 *xyzf;                  //!< Cell list with position and flags (output)
+            Scalar4 *tdb;                   //!< Cell list with type,diameter,body (output)
+            Scalar4 *cell_orientation;      //!< Cell list with orientation (output)
+            unsigned int *cell_idx;         //!< Cell list with index (output)
+            uint3 *conditions;              //!< Condition flags of each thread (output)
+            unsigned int n_tot;             //!< Number of local and ghost particles
+            unsigned int n_cells;           //!< Total number of cells
+            BoxDim box;                     //!< Local simulation box
+            Scalar3 ghost_width;            //!< Width of the ghost layer
+            };
+
+        //! Bin the particles and count the members of each cell (first pass of the compact build)
+        void countCellsThread(unsigned int thread_idx, const compact_args& args);
+
+        //! Write the particles into their cells (second pass of the compact build)
+        void fillCellsThread(unsigned int thread_idx, const compact_args& args);
+
         //! Computes what the dimensions should me
         uint3 computeDimensions();
 
@@ -393,6 +462,13 @@ class CellList : public Compute
         //! Compute the cell list
         virtual void computeCellList();
 
+        //! Compute the cell list in the compact layout
+        void computeCellListCompact();
+
+        //! Find the cell a particle belongs in
+        unsigned int binParticle(const Scalar4& postype, unsigned int n, const BoxDim& box, const Scalar3& ghost_width,
+                                 uint3& conditions) const;
+
         //! Check the status of the conditions
         bool checkConditions();
 
@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ComputeThermo.h"
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #ifdef ENABLE_MPI
@@ -373,11 +374,45 @@ void ComputeThermo::reduceProperties()
 
     // reduce properties
     ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::readwrite);
+    if (postProperties(h_properties.data))
+        return;
+
     MPI_Allreduce(MPI_IN_PLACE, h_properties.data, thermo_index::num_quantities, MPI_HOOMD_SCALAR,
             MPI_SUM, m_exec_conf->getMPICommunicator());
 
     m_properties_reduced = true;
     }
+
+/*! \param properties Properties of the local particles
+    \returns True if the properties were posted, they are reduced later by the Logger and passed to
+             setReducedProperties()
+*/
+bool ComputeThermo::postProperties(const Scalar *properties)
+    {
+    if (!m_comm || !m_comm->getReductionBuffer().isCollecting())
+        return false;
+
+    double partial[thermo_index::num_quantities];
+    for (unsigned int i = 0; i < thermo_index::num_quantities; i++)
+        partial[i] = properties[i];
+
+    m_comm->getReductionBuffer().post(this,
+                                      partial,
+                                      thermo_index::num_quantities,
+                                      boost::bind(&ComputeThermo::setReducedProperties, this, _1));
+    return true;
+    }
+
+/*! \param values Global sums of the properties
+*/
+void ComputeThermo::setReducedProperties(const double *values)
+    {
+    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::overwrite);
+    for (unsigned int i = 0; i < thermo_index::num_quantities; i++)
+        h_properties.data[i] = Scalar(values[i]);
+
+    m_properties_reduced = true;
+    }
 #endif
 
 void export_ComputeThermo()
@@ -254,6 +254,12 @@ class ComputeThermo : public Compute
 
         //! Reduce properties over MPI
         virtual void reduceProperties();
+
+        //! Posts the properties to the ReductionBuffer of the Communicator if it is collecting
+        bool postProperties(const Scalar *properties);
+
+        //! Stores the properties reduced by the ReductionBuffer
+        void setReducedProperties(const double *values);
         #endif
     };
 
@@ -0,0 +1,383 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file FFTBackend.cc
+    \brief Defines the FFTBackend class and its implementations
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4244 )
+#endif
+
+#include "FFTBackend.h"
+
+#include <boost/bind.hpp>
+
+#include <stdexcept>
+
+using namespace boost;
+using namespace std;
+
+/*! \param exec_conf The execution configuration
+    \param Nx Number of mesh points along x
+    \param Ny Number of mesh points along y
+    \param Nz Number of mesh points along z
+    \param max_batch Maximum number of meshes transformed at once
+*/
+FFTBackend::FFTBackend(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                       unsigned int Nx,
+                       unsigned int Ny,
+                       unsigned int Nz,
+                       unsigned int max_batch)
+    : m_exec_conf(exec_conf), m_Nx(Nx), m_Ny(Ny), m_Nz(Nz), m_Nz_half(Nz/2+1), m_max_batch(max_batch)
+    {
+    if (Nx == 0 || Ny == 0 || Nz == 0 || max_batch == 0)
+        {
+        m_exec_conf->msg->error() << "fft: Cannot transform an empty mesh" << endl;
+        throw runtime_error("Error initializing FFTBackend");
+        }
+
+    m_n_real = m_Nx*m_Ny*m_Nz;
+    m_n_complex = m_Nx*m_Ny*m_Nz_half;
+    m_real.resize(m_n_real*m_max_batch);
+    m_complex.resize(m_n_complex*m_max_batch);
+    }
+
+FFTBackendKiss::FFTBackendKiss(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                               unsigned int Nx,
+                               unsigned int Ny,
+                               unsigned int Nz,
+                               unsigned int max_batch)
+    : FFTBackend(exec_conf, Nx, Ny, Nz, max_batch)
+    {
+    unsigned int N[3] = {m_Nx, m_Ny, m_Nz};
+    for (unsigned int dir = 0; dir < 3; dir++)
+        {
+        m_cfg_forward[dir] = kiss_fft_alloc(N[dir], 0, NULL, NULL);
+        m_cfg_inverse[dir] = kiss_fft_alloc(N[dir], 1, NULL, NULL);
+        }
+
+    m_max_N = max(m_Nx, max(m_Ny, m_Nz));
+    }
+
+FFTBackendKiss::~FFTBackendKiss()
+    {
+    for (unsigned int dir = 0; dir < 3; dir++)
+        {
+        kiss_fft_free(m_cfg_forward[dir]);
+        kiss_fft_free(m_cfg_inverse[dir]);
+        }
+    }
+
+/*! \param n_batch Number of meshes to transform
+
+    The real transform along z is performed first, the complex transforms along y and x then only act on the
+    half spectra.
+*/
+void FFTBackendKiss::forward(unsigned int n_batch)
+    {
+    assert(n_batch <= m_max_batch);
+    runPass(n_batch, 2, false);
+    runPass(n_batch, 1, false);
+    runPass(n_batch, 0, false);
+    }
+
+/*! \param n_batch Number of meshes to transform
+*/
+void FFTBackendKiss::inverse(unsigned int n_batch)
+    {
+    assert(n_batch <= m_max_batch);
+    runPass(n_batch, 0, true);
+    runPass(n_batch, 1, true);
+    runPass(n_batch, 2, true);
+    }
+
+/*! \param n_batch Number of meshes to transform
+    \param dir Direction of the mesh lines
+    \param inverse True for the inverse transform
+*/
+void FFTBackendKiss::runPass(unsigned int n_batch, unsigned int dir, bool inverse)
+    {
+    // the number of threads may change between calls
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    if (m_line_buf.size() < 2*m_max_N*n_threads)
+        m_line_buf.resize(2*m_max_N*n_threads);
+
+    pass_args args;
+    args.n_batch = n_batch;
+    args.dir = dir;
+    args.inverse = inverse;
+
+    if (dir == 2)
+        m_exec_conf->getThreadPool().run(bind(&FFTBackendKiss::realPassThread, this, _1, boost::cref(args)));
+    else
+        m_exec_conf->getThreadPool().run(bind(&FFTBackendKiss::complexPassThread, this, _1, boost::cref(args)));
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Parameters of the pass
+
+    The lines along y are enumerated by (batch, x, kz), those along x by (batch, y, kz). Consecutive lines are
+    adjacent in memory, so the threads read and write contiguous chunks of every line.
+*/
+void FFTBackendKiss::complexPassThread(unsigned int thread_idx, const pass_args& args)
+    {
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+
+    // mesh lines of one half spectrum: their number, length and the stride between their elements
+    unsigned int n_lines, N, stride;
+    if (args.dir == 0)
+        {
+        n_lines = m_Ny*m_Nz_half;
+        N = m_Nx;
+        stride = m_Ny*m_Nz_half;
+        }
+    else
+        {
+        n_lines = m_Nx*m_Nz_half;
+        N = m_Ny;
+        stride = m_Nz_half;
+        }
+
+    kiss_fft_cfg cfg = args.inverse ? m_cfg_inverse[args.dir] : m_cfg_forward[args.dir];
+    kiss_fft_cpx *in = &m_line_buf[2*m_max_N*thread_idx];
+    kiss_fft_cpx *out = in + m_max_N;
+
+    unsigned int first, last;
+    ThreadPool::getRange(n_lines*args.n_batch, thread_idx, n_threads, first, last);
+
+    for (unsigned int line = first; line < last; line++)
+        {
+        unsigned int batch = line / n_lines;
+        unsigned int l = line % n_lines;
+
+        // offset of the first element of the line, the slowest index of the line is multiplied by the length of
+        // the faster dimensions
+        unsigned int outer = l / m_Nz_half;
+        unsigned int kz = l % m_Nz_half;
+        unsigned int offset = batch*m_n_complex + kz + ((args.dir == 0) ? outer*m_Nz_half : outer*m_Ny*m_Nz_half);
+        kiss_fft_cpx *data = &m_complex[offset];
+
+        for (unsigned int i = 0; i < N; i++)
+            in[i] = data[i*stride];
+
+        kiss_fft(cfg, in, out);
+
+        for (unsigned int i = 0; i < N; i++)
+            data[i*stride] = out[i];
+        }
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Parameters of the pass
+
+    The real lines along z are processed in pairs (2l, 2l+1) of the same mesh. If the number of lines is odd, the
+    last pair only has one member.
+*/
+void FFTBackendKiss::realPassThread(unsigned int thread_idx, const pass_args& args)
+    {
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    unsigned int n_lines = m_Nx*m_Ny;
+    unsigned int n_pairs = (n_lines + 1)/2;
+
+    kiss_fft_cfg cfg = args.inverse ? m_cfg_inverse[2] : m_cfg_forward[2];
+    kiss_fft_cpx *in = &m_line_buf[2*m_max_N*thread_idx];
+    kiss_fft_cpx *out = in + m_max_N;
+
+    unsigned int first, last;
+    ThreadPool::getRange(n_pairs*args.n_batch, thread_idx, n_threads, first, last);
+
+    for (unsigned int pair = first; pair < last; pair++)
+        {
+        unsigned int batch = pair / n_pairs;
+        unsigned int line_a = 2*(pair % n_pairs);
+        bool has_b = line_a + 1 < n_lines;
+
+        Scalar *real_a = &m_real[batch*m_n_real + line_a*m_Nz];
+        Scalar *real_b = real_a + m_Nz;
+        kiss_fft_cpx *half_a = &m_complex[batch*m_n_complex + line_a*m_Nz_half];
+        kiss_fft_cpx *half_b = half_a + m_Nz_half;
+
+        if (!args.inverse)
+            {
+            for (unsigned int k = 0; k < m_Nz; k++)
+                {
+                in[k].r = real_a[k];
+                in[k].i = has_b ? real_b[k] : Scalar(0.0);
+                }
+
+            kiss_fft(cfg, in, out);
+
+            // Z = A + iB with hermitian A and B, so A_k = (Z_k + conj(Z_-k))/2 and B_k = (Z_k - conj(Z_-k))/2i
+            for (unsigned int k = 0; k < m_Nz_half; k++)
+                {
+                kiss_fft_cpx z = out[k];
+                kiss_fft_cpx m = out[(m_Nz - k) % m_Nz];
+                half_a[k].r = Scalar(0.5)*(z.r + m.r);
+                half_a[k].i = Scalar(0.5)*(z.i - m.i);
+                if (has_b)
+                    {
+                    half_b[k].r = Scalar(0.5)*(z.i + m.i);
+                    half_b[k].i = Scalar(0.5)*(m.r - z.r);
+                    }
+                }
+            }
+        else
+            {
+            for (unsigned int k = 0; k < m_Nz_half; k++)
+                {
+                kiss_fft_cpx a = half_a[k];
+                kiss_fft_cpx b;
+                b.r = b.i = Scalar(0.0);
+                if (has_b)
+                    b = half_b[k];
+
+                // the coefficients at k=0 and the Nyquist frequency are real for hermitian input
+                if (k == 0 || 2*k == m_Nz)
+                    a.i = b.i = Scalar(0.0);
+
+                // Z_k = A_k + iB_k, and Z_-k = conj(A_k) + i conj(B_k)
+                in[k].r = a.r - b.i;
+                in[k].i = a.i + b.r;
+                if (k > 0 && 2*k != m_Nz)
+                    {
+                    in[m_Nz - k].r = a.r + b.i;
+                    in[m_Nz - k].i = b.r - a.i;
+                    }
+                }
+
+            kiss_fft(cfg, in, out);
+
+            for (unsigned int k = 0; k < m_Nz; k++)
+                {
+                real_a[k] = out[k].r;
+                if (has_b)
+                    real_b[k] = out[k].i;
+                }
+            }
+        }
+    }
+
+#ifdef ENABLE_FFTW
+FFTBackendFFTW::FFTBackendFFTW(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                               unsigned int Nx,
+                               unsigned int Ny,
+                               unsigned int Nz,
+                               unsigned int max_batch)
+    : FFTBackend(exec_conf, Nx, Ny, Nz, max_batch)
+    {
+    #ifdef ENABLE_FFTW_THREADS
+    // FFTW keeps its threading state globally, it only needs to be initialized once
+    static bool fftw_threads_initialized = false;
+    if (!fftw_threads_initialized)
+        {
+        if (!FFTW(init_threads)())
+            {
+            m_exec_conf->msg->error() << "fft: Error initializing the FFTW threads" << endl;
+            throw runtime_error("Error initializing FFTBackendFFTW");
+            }
+        fftw_threads_initialized = true;
+        }
+    FFTW(plan_with_nthreads)(m_exec_conf->getNumThreads());
+    #endif
+
+    int n[3] = {int(m_Nx), int(m_Ny), int(m_Nz)};
+    Scalar *real = &m_real.front();
+    FFTW(complex) *cplx = reinterpret_cast<FFTW(complex) *>(&m_complex.front());
+
+    // FFTW_ESTIMATE does not touch the data during planning
+    for (unsigned int batch = 1; batch <= m_max_batch; batch++)
+        {
+        m_plan_forward.push_back(FFTW(plan_many_dft_r2c)(3, n, batch, real, NULL, 1, m_n_real,
+                                                         cplx, NULL, 1, m_n_complex, FFTW_ESTIMATE));
+        m_plan_inverse.push_back(FFTW(plan_many_dft_c2r)(3, n, batch, cplx, NULL, 1, m_n_complex,
+                                                         real, NULL, 1, m_n_real, FFTW_ESTIMATE));
+
+        if (!m_plan_forward.back() || !m_plan_inverse.back())
+            {
+            m_exec_conf->msg->error() << "fft: FFTW could not create a plan for a " << m_Nx << "x" << m_Ny << "x"
+                                      << m_Nz << " mesh" << endl;
+            throw runtime_error("Error initializing FFTBackendFFTW");
+            }
+        }
+    }
+
+FFTBackendFFTW::~FFTBackendFFTW()
+    {
+    for (unsigned int i = 0; i < m_plan_forward.size(); i++)
+        if (m_plan_forward[i])
+            FFTW(destroy_plan)(m_plan_forward[i]);
+    for (unsigned int i = 0; i < m_plan_inverse.size(); i++)
+        if (m_plan_inverse[i])
+            FFTW(destroy_plan)(m_plan_inverse[i]);
+    }
+
+/*! \param n_batch Number of meshes to transform
+*/
+void FFTBackendFFTW::forward(unsigned int n_batch)
+    {
+    assert(n_batch > 0 && n_batch <= m_max_batch);
+    FFTW(execute)(m_plan_forward[n_batch-1]);
+    }
+
+/*! \param n_batch Number of meshes to transform
+*/
+void FFTBackendFFTW::inverse(unsigned int n_batch)
+    {
+    assert(n_batch > 0 && n_batch <= m_max_batch);
+    FFTW(execute)(m_plan_inverse[n_batch-1]);
+    }
+#endif
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
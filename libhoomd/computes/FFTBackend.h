@@ -0,0 +1,262 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+#include "ExecutionConfiguration.h"
+#include "HOOMDMath.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+#include <vector>
+#include <string>
+#include <cassert>
+
+// slave KISS data type to HOOMD Scalar
+#ifndef kiss_fft_scalar
+#define kiss_fft_scalar Scalar
+#endif
+#include "kiss_fft.h"
+
+#ifdef ENABLE_FFTW
+#include <fftw3.h>
+
+// FFTW(name) selects the FFTW routine or type matching the precision of Scalar
+#ifdef SINGLE_PRECISION
+#define FFTW(name) fftwf_ ## name
+#else
+#define FFTW(name) fftw_ ## name
+#endif
+#endif
+
+/*! \file FFTBackend.h
+    \brief Declares the FFTBackend class and its implementations
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __FFTBACKEND_H__
+#define __FFTBACKEND_H__
+
+//! Real to complex 3D FFTs on the CPU
+/*! FFTBackend transforms real valued meshes of Nx*Ny*Nz points to their Fourier coefficients and back. Because the
+    transform of a real mesh is hermitian, only the Nx*Ny*(Nz/2+1) coefficients with kz <= Nz/2 are stored, which
+    halves both the work and the memory of a complex transform.
+
+    The backend owns the data it transforms. Up to max_batch real meshes (getRealData()) and the same number of
+    half spectra (getComplexData()) are allocated on construction and transformed in a single batch by forward() and
+    inverse(). Real meshes are indexed with z + Nz*(y + Ny*x), half spectra with kz + (Nz/2+1)*(ky + Ny*kx).
+
+    The transforms use the same conventions as kiss_fftnd: the forward transform has the sign -1 in the exponent,
+    and neither direction is normalized, so a forward followed by an inverse transform multiplies the data by
+    Nx*Ny*Nz. The inverse transform assumes that its input is hermitian, i.e. the imaginary parts of the
+    self-conjugate coefficients are ignored. The complex data is overwritten by inverse().
+
+    FFTBackendKiss is always available. FFTBackendFFTW is compiled in when hoomd is built with ENABLE_FFTW, which
+    links either FFTW3 or a library providing the FFTW3 interface, such as MKL.
+    \ingroup computes
+*/
+class FFTBackend : boost::noncopyable
+    {
+    public:
+        //! Constructs the backend and allocates the data
+        FFTBackend(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                   unsigned int Nx,
+                   unsigned int Ny,
+                   unsigned int Nz,
+                   unsigned int max_batch);
+
+        //! Destructor
+        virtual ~FFTBackend() {}
+
+        //! Get the i-th real mesh
+        Scalar *getRealData(unsigned int i)
+            {
+            assert(i < m_max_batch);
+            return &m_real[i*m_n_real];
+            }
+
+        //! Get the i-th half spectrum
+        kiss_fft_cpx *getComplexData(unsigned int i)
+            {
+            assert(i < m_max_batch);
+            return &m_complex[i*m_n_complex];
+            }
+
+        //! Get the number of coefficients in a half spectrum
+        unsigned int getNumComplex() const
+            {
+            return m_n_complex;
+            }
+
+        //! Get the name of the implementation
+        virtual std::string getName() const = 0;
+
+        //! Transform the first n_batch real meshes to their half spectra
+        virtual void forward(unsigned int n_batch) = 0;
+
+        //! Transform the first n_batch half spectra back to real meshes
+        virtual void inverse(unsigned int n_batch) = 0;
+
+    protected:
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
+        unsigned int m_Nx;                      //!< Number of mesh points along x
+        unsigned int m_Ny;                      //!< Number of mesh points along y
+        unsigned int m_Nz;                      //!< Number of mesh points along z
+        unsigned int m_Nz_half;                 //!< Number of stored coefficients along z (Nz/2+1)
+        unsigned int m_max_batch;               //!< Number of meshes that can be transformed at once
+        unsigned int m_n_real;                  //!< Number of points in a real mesh
+        unsigned int m_n_complex;               //!< Number of coefficients in a half spectrum
+        std::vector<Scalar> m_real;             //!< The real meshes
+        std::vector<kiss_fft_cpx> m_complex;    //!< The half spectra
+    };
+
+//! FFTBackend using kiss_fft and the ThreadPool
+/*! The 3D transform is carried out as three passes of 1D transforms along z, y and x (in reverse order for the
+    inverse). The mesh lines of every pass are independent and divided among the threads of the ThreadPool, each
+    thread gathers a line into its own buffer, transforms it, and scatters the result back.
+
+    The real transform along z packs two real lines a and b into the complex line a + ib, so that one complex
+    transform of length Nz yields both half spectra, which are separated using the hermitian symmetry of the
+    transforms of a and b. The inverse transform assembles the line A + iB from the two half spectra and takes
+    a and b from the real and imaginary parts of the result.
+    \ingroup computes
+*/
+class FFTBackendKiss : public FFTBackend
+    {
+    public:
+        //! Constructs the backend
+        FFTBackendKiss(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                       unsigned int Nx,
+                       unsigned int Ny,
+                       unsigned int Nz,
+                       unsigned int max_batch);
+
+        //! Destructor
+        virtual ~FFTBackendKiss();
+
+        //! Get the name of the implementation
+        virtual std::string getName() const
+            {
+            return "kiss_fft";
+            }
+
+        //! Transform the first n_batch real meshes to their half spectra
+        virtual void forward(unsigned int n_batch);
+
+        //! Transform the first n_batch half spectra back to real meshes
+        virtual void inverse(unsigned int n_batch);
+
+    private:
+        kiss_fft_cfg m_cfg_forward[3];          //!< Forward 1D transforms along x,y,z
+        kiss_fft_cfg m_cfg_inverse[3];          //!< Inverse 1D transforms along x,y,z
+        unsigned int m_max_N;                   //!< Length of the longest mesh line
+        std::vector<kiss_fft_cpx> m_line_buf;   //!< Two line buffers per thread
+
+        //! Parameters of a pass of 1D transforms, shared by all threads
+        struct pass_args
+            {
+            unsigned int n_batch;               //!< Number of meshes to transform
+            unsigned int dir;                   //!< Direction of the mesh lines (0=x, 1=y, 2=z)
+            bool inverse;                       //!< True for the inverse transform
+            };
+
+        //! Run a pass of 1D transforms on all threads
+        void runPass(unsigned int n_batch, unsigned int dir, bool inverse);
+
+        //! Transform the lines along x or y of the half spectra assigned to one thread
+        void complexPassThread(unsigned int thread_idx, const pass_args& args);
+
+        //! Transform the real lines along z assigned to one thread
+        void realPassThread(unsigned int thread_idx, const pass_args& args);
+    };
+
+#ifdef ENABLE_FFTW
+//! FFTBackend using FFTW3
+/*! One r2c and one c2r plan is created for every batch size up to max_batch with the advanced FFTW interface, so
+    that the transforms of a batch are performed by a single call to FFTW. When the FFTW threads library is
+    available (ENABLE_FFTW_THREADS), the plans use as many threads as the ThreadPool. FFTW starts its own threads
+    for this, the ThreadPool is not used.
+    \ingroup computes
+*/
+class FFTBackendFFTW : public FFTBackend
+    {
+    public:
+        //! Constructs the backend and plans the transforms
+        FFTBackendFFTW(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                       unsigned int Nx,
+                       unsigned int Ny,
+                       unsigned int Nz,
+                       unsigned int max_batch);
+
+        //! Destructor
+        virtual ~FFTBackendFFTW();
+
+        //! Get the name of the implementation
+        virtual std::string getName() const
+            {
+            return "FFTW";
+            }
+
+        //! Transform the first n_batch real meshes to their half spectra
+        virtual void forward(unsigned int n_batch);
+
+        //! Transform the first n_batch half spectra back to real meshes
+        virtual void inverse(unsigned int n_batch);
+
+    private:
+        std::vector<FFTW(plan)> m_plan_forward; //!< Forward plans for each batch size
+        std::vector<FFTW(plan)> m_plan_inverse; //!< Inverse plans for each batch size
+    };
+#endif
+
+#endif
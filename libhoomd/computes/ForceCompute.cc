@@ -114,10 +114,168 @@ void ForceCompute::reallocate()
     m_virial.resize(m_pdata->getMaxN(),6);
     m_torque.resize(m_pdata->getMaxN());
 
+    // keep the per-thread arrays in sync if they are in use
+    if (!m_thread_force.isNull())
+        allocateThreadPartial();
+
     // the pitch of the virial array may have changed
     m_virial_pitch = m_virial.getPitch();
     }
 
+/*! \post m_thread_force and m_thread_virial have room for all threads in the pool of the execution configuration
+    and the current maximum particle number
+
+    The arrays are only allocated when first needed, so single threaded runs never pay for them.
+*/
+void ForceCompute::allocateThreadPartial()
+    {
+    unsigned int n_rows = m_exec_conf->getNumThreads() - 1;
+    if (n_rows == 0)
+        return;
+
+    unsigned int max_n = m_pdata->getMaxN();
+    if (m_thread_force.isNull())
+        {
+        GPUArray<Scalar4> thread_force(max_n, n_rows, exec_conf);
+        m_thread_force.swap(thread_force);
+        GPUArray<Scalar> thread_virial(max_n, 6*n_rows, exec_conf);
+        m_thread_virial.swap(thread_virial);
+        }
+    else if (m_thread_force.getPitch() < max_n || m_thread_force.getHeight() < n_rows)
+        {
+        m_thread_force.resize(max_n, n_rows);
+        m_thread_virial.resize(max_n, 6*n_rows);
+        }
+    }
+
+/*! \param h_force Force array to add the partial forces to
+    \param h_virial Virial array (with pitch m_virial_pitch) to add the partial virials to
+    \param compute_virial True if the partial virials should be summed as well
+
+    \pre The partial arrays of threads 1..n-1 have been filled for all local particles
+*/
+void ForceCompute::reduceThreadPartial(Scalar4 *h_force, Scalar *h_virial, bool compute_virial)
+    {
+    if (m_exec_conf->getNumThreads() == 1)
+        return;
+
+    ArrayHandle<Scalar4> h_thread_force(m_thread_force, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_thread_virial(m_thread_virial, access_location::host, access_mode::read);
+
+    m_exec_conf->getThreadPool().run(bind(&ForceCompute::reduceThreadPartialRange,
+                                          this,
+                                          _1,
+                                          h_force,
+                                          h_virial,
+                                          h_thread_force.data,
+                                          h_thread_virial.data,
+                                          compute_virial));
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param h_force Force array to add the partial forces to
+    \param h_virial Virial array to add the partial virials to
+    \param h_thread_force Per-thread partial forces
+    \param h_thread_virial Per-thread partial virials
+    \param compute_virial True if the partial virials should be summed as well
+
+    Each thread sums a contiguous range of particles over all partial arrays, so there are no write conflicts.
+*/
+void ForceCompute::reduceThreadPartialRange(unsigned int thread_idx,
+                                            Scalar4 *h_force,
+                                            Scalar *h_virial,
+                                            const Scalar4 *h_thread_force,
+                                            const Scalar *h_thread_virial,
+                                            bool compute_virial)
+    {
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    unsigned int first, last;
+    ThreadPool::getRange(m_pdata->getN(), thread_idx, n_threads, first, last);
+
+    unsigned int force_pitch = m_thread_force.getPitch();
+    unsigned int virial_pitch = m_thread_virial.getPitch();
+
+    for (unsigned int t = 0; t < n_threads-1; t++)
+        {
+        const Scalar4 *thread_force = h_thread_force + t*force_pitch;
+        for (unsigned int i = first; i < last; i++)
+            {
+            h_force[i].x += thread_force[i].x;
+            h_force[i].y += thread_force[i].y;
+            h_force[i].z += thread_force[i].z;
+            h_force[i].w += thread_force[i].w;
+            }
+
+        if (compute_virial)
+            {
+            const Scalar *thread_virial = h_thread_virial + 6*t*virial_pitch;
+            for (unsigned int l = 0; l < 6; l++)
+                for (unsigned int i = first; i < last; i++)
+                    h_virial[l*m_virial_pitch+i] += thread_virial[l*virial_pitch+i];
+            }
+        }
+    }
+
+/*! \post There is an empty spill list for every thread in the pool of the execution configuration
+*/
+void ForceCompute::resetThreadSpill()
+    {
+    m_thread_spill.resize(m_exec_conf->getNumThreads());
+    for (unsigned int t = 0; t < m_thread_spill.size(); t++)
+        m_thread_spill[t].clear();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param h_force Force array
+    \param h_virial Virial array (with pitch m_virial_pitch)
+    \param compute_virial True if the virial is computed
+    \returns The output of the thread, owning the same range of particles as in reduceThreadPartialRange()
+
+    \pre resetThreadSpill() has been called
+*/
+ForceCompute::bonded_output ForceCompute::getBondedOutput(unsigned int thread_idx,
+                                                          Scalar4 *h_force,
+                                                          Scalar *h_virial,
+                                                          bool compute_virial)
+    {
+    assert(thread_idx < m_thread_spill.size());
+
+    bonded_output out;
+    out.force = h_force;
+    out.virial = compute_virial ? h_virial : NULL;
+    out.virial_pitch = m_virial_pitch;
+    out.N = m_pdata->getN();
+    ThreadPool::getRange(out.N, thread_idx, m_exec_conf->getNumThreads(), out.first, out.last);
+    out.spill = &m_thread_spill[thread_idx];
+    return out;
+    }
+
+/*! \param h_force Force array
+    \param h_virial Virial array (with pitch m_virial_pitch)
+    \param compute_virial True if the virial is computed
+
+    The spill lists are short (only groups crossing a thread boundary contribute), so they are applied serially and
+    in thread order, which keeps the result independent of the scheduling of the threads.
+*/
+void ForceCompute::applyThreadSpill(Scalar4 *h_force, Scalar *h_virial, bool compute_virial)
+    {
+    for (unsigned int t = 0; t < m_thread_spill.size(); t++)
+        {
+        const std::vector<thread_spill>& spill = m_thread_spill[t];
+        for (unsigned int k = 0; k < spill.size(); k++)
+            {
+            unsigned int i = spill[k].idx;
+            h_force[i].x += spill[k].force.x;
+            h_force[i].y += spill[k].force.y;
+            h_force[i].z += spill[k].force.z;
+            h_force[i].w += spill[k].force.w;
+            if (compute_virial)
+                for (unsigned int l = 0; l < 6; l++)
+                    h_virial[l*m_virial_pitch+i] += spill[k].virial[l];
+            }
+        }
+    }
+
 /*! Frees allocated memory
 */
 ForceCompute::~ForceCompute()
@@ -127,9 +285,21 @@ ForceCompute::~ForceCompute()
     }
 
 /*! Sums the total potential energy calculated by the last call to compute() and returns it.
+
+    In MPI simulations, the partial sum is posted to the ReductionBuffer of the Communicator while it collects, and
+    the global sum is taken from there after the fused reduction.
 */
 Scalar ForceCompute::calcEnergySum()
     {
+#ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        const double *reduced = m_comm->getReductionBuffer().getResult(this);
+        if (reduced)
+            return Scalar(*reduced);
+        }
+#endif
+
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
     // always perform the sum in double precision for better accuracy
     // this is cheating and is really just a temporary hack to get logging up and running
@@ -143,6 +313,14 @@ Scalar ForceCompute::calcEnergySum()
 #ifdef ENABLE_MPI
     if (m_comm)
         {
+        // let the Logger reduce it together with the other log quantities, the return value is a placeholder
+        ReductionBuffer& reduction_buffer = m_comm->getReductionBuffer();
+        if (reduction_buffer.isCollecting())
+            {
+            reduction_buffer.post(this, &pe_total, 1);
+            return Scalar(0.0);
+            }
+
         // reduce potential energy on all processors
         MPI_Allreduce(MPI_IN_PLACE, &pe_total, 1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
         }
@@ -57,6 +57,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/shared_ptr.hpp>
 #include <boost/signals2.hpp>
 
+#include <vector>
+
 #include "Compute.h"
 #include "Index1D.h"
 
@@ -114,6 +116,13 @@ class ForceCompute : public Compute
          * and can be used to overlap computation with communication
          */
         virtual void preCompute(unsigned int timestep) { }
+
+        //! Pre-compute the forces between local particles
+        /*! This method is called in MPI simulations on the CPU while the ghost particle data is being
+         * communicated. It may only use data of local particles, and the following call to compute()
+         * must add the remaining contributions.
+         */
+        virtual void preComputeLocal(unsigned int timestep) { }
         #endif
 
         //! Computes the forces
@@ -207,6 +216,84 @@ class ForceCompute : public Compute
 
         Scalar m_external_virial[6]; //!< Stores external contribution to virial
 
+        /*! Partial forces accumulated by threads 1..n-1 of a multithreaded computation that scatters forces
+            to particles other than the one being processed. A 2D GPUArray with width=maximum number of particles
+            and one row per thread. Thread 0 accumulates directly into m_force.
+        */
+        GPUArray<Scalar4> m_thread_force;
+        //! Partial virials of threads 1..n-1, laid out like m_virial with six consecutive rows per thread
+        GPUArray<Scalar> m_thread_virial;
+
+        //! Make sure the per-thread partial force and virial arrays are large enough
+        void allocateThreadPartial();
+
+        //! Sum the per-thread partial forces and virials into the given force and virial arrays
+        void reduceThreadPartial(Scalar4 *h_force, Scalar *h_virial, bool compute_virial);
+
+        //! Contribution of a bonded group to a particle owned by another thread
+        struct thread_spill
+            {
+            unsigned int idx;                //!< Index of the particle
+            Scalar4 force;                   //!< Force (x,y,z) and energy (w)
+            Scalar virial[6];                //!< Virial
+            };
+
+        //! Destination of the forces computed by one thread of a bonded force computation
+        /*! Bonded computes process the groups in the order of their lowest member index (BondedGroupData::getCPUTable()),
+            which follows the particle order in memory and is rebuilt after every sort. Every thread of the
+            ExecutionConfiguration's ThreadPool owns a contiguous range of particles and computes the groups whose lowest
+            member it owns. Contributions to the owned particles are added to the force and virial arrays directly. The
+            other members of a group always have a larger index, so the few contributions to particles of later threads
+            are deferred to a spill list and added by applyThreadSpill(). Ghost particles receive no forces.
+        */
+        struct bonded_output
+            {
+            Scalar4 *force;                  //!< Force array
+            Scalar *virial;                  //!< Virial array (NULL if the virial is not computed)
+            unsigned int virial_pitch;       //!< Pitch of the virial array
+            unsigned int first;              //!< First particle owned by the thread
+            unsigned int last;               //!< One past the last particle owned by the thread
+            unsigned int N;                  //!< Number of local particles
+            std::vector<thread_spill> *spill;    //!< Contributions to particles owned by other threads
+
+            //! Add a force, energy and virial to a particle
+            /*! \param idx Index of the particle
+                \param f Force (x,y,z) and energy (w)
+                \param v Virial (ignored if the virial is not computed)
+            */
+            void add(unsigned int idx, const Scalar4& f, const Scalar *v) const
+                {
+                if (idx >= first && idx < last)
+                    {
+                    force[idx].x += f.x;
+                    force[idx].y += f.y;
+                    force[idx].z += f.z;
+                    force[idx].w += f.w;
+                    if (virial)
+                        for (unsigned int l = 0; l < 6; l++)
+                            virial[l*virial_pitch+idx] += v[l];
+                    }
+                else if (idx < N)
+                    {
+                    thread_spill s;
+                    s.idx = idx;
+                    s.force = f;
+                    for (unsigned int l = 0; l < 6; l++)
+                        s.virial[l] = virial ? v[l] : Scalar(0.0);
+                    spill->push_back(s);
+                    }
+                }
+            };
+
+        //! Prepare the spill lists for a bonded force computation on all threads
+        void resetThreadSpill();
+
+        //! Set up the output of one thread of a bonded force computation
+        bonded_output getBondedOutput(unsigned int thread_idx, Scalar4 *h_force, Scalar *h_virial, bool compute_virial);
+
+        //! Add the contributions deferred by the threads of a bonded force computation
+        void applyThreadSpill(Scalar4 *h_force, Scalar *h_virial, bool compute_virial);
+
         //! Connection to the signal notifying when particles are resorted
         boost::signals2::connection m_sort_connection;
 
@@ -219,6 +306,17 @@ class ForceCompute : public Compute
             \param timestep Current time step
         */
         virtual void computeForces(unsigned int timestep)=0;
+
+    private:
+        std::vector< std::vector<thread_spill> > m_thread_spill;   //!< Deferred bonded contributions of each thread
+
+        //! Sum the per-thread partial results for the range of particles assigned to one thread
+        void reduceThreadPartialRange(unsigned int thread_idx,
+                                      Scalar4 *h_force,
+                                      Scalar *h_virial,
+                                      const Scalar4 *h_thread_force,
+                                      const Scalar *h_thread_virial,
+                                      bool compute_virial);
     };
 
 //! Exports the ForceCompute class to python
@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include "HarmonicAngleForceCompute.h"
@@ -160,56 +161,70 @@ Scalar HarmonicAngleForceCompute::getLogValue(const std::string& quantity, unsig
 
 /*! Actually perform the force computation
     \param timestep Current time step
+
+    The angles are divided among the threads as described for ForceCompute::bonded_output.
  */
 void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Harmonic Angle");
 
     assert(m_pdata);
+
+    // the table is rebuilt here if the particles have been sorted since the last call
+    const GPUVector<AngleData::members_t>& angle_table = m_angle_data->getCPUTable();
+    const GPUVector<unsigned int>& angle_type = m_angle_data->getCPUTableTypes();
+    const GPUVector<unsigned int>& angle_offset = m_angle_data->getCPUTableOffsets();
+
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
-    unsigned int virial_pitch = m_virial.getPitch();
+
+    ArrayHandle<AngleData::members_t> h_angles(angle_table, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_type(angle_type, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_offset(angle_offset, access_location::host, access_mode::read);
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
     assert(h_pos.data);
-    assert(h_rtag.data);
 
     // Zero data for force calculation.
     memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
     memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
 
-    // get a local copy of the simulation box too
-    const BoxDim& box = m_pdata->getGlobalBox();
+    cpu_args args;
+    args.pos = h_pos.data;
+    args.angles = h_angles.data;
+    args.type = h_type.data;
+    args.offset = h_offset.data;
+    args.box = m_pdata->getGlobalBox();
+    args.force = h_force.data;
+    args.virial = h_virial.data;
 
-    // for each of the angles
-    const unsigned int size = (unsigned int)m_angle_data->getN();
-    for (unsigned int i = 0; i < size; i++)
+    resetThreadSpill();
+    m_exec_conf->getThreadPool().run(bind(&HarmonicAngleForceCompute::computeForcesThread, this, _1, boost::cref(args)));
+    applyThreadSpill(h_force.data, h_virial.data, true);
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void HarmonicAngleForceCompute::computeForcesThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    bonded_output out = getBondedOutput(thread_idx, args.force, args.virial, true);
+
+    // for each of the angles whose lowest member is owned by this thread
+    for (unsigned int i = args.offset[out.first]; i < args.offset[out.last]; i++)
         {
-        // lookup the tag of each of the particles participating in the angle
-        const AngleData::members_t& angle = m_angle_data->getMembersByIndex(i);
-        assert(angle.tag[0] < m_pdata->getNGlobal());
-        assert(angle.tag[1] < m_pdata->getNGlobal());
-        assert(angle.tag[2] < m_pdata->getNGlobal());
-
-        // transform a, b, and c into indices into the particle data arrays
-        // MEM TRANSFER: 6 ints
-        unsigned int idx_a = h_rtag.data[angle.tag[0]];
-        unsigned int idx_b = h_rtag.data[angle.tag[1]];
-        unsigned int idx_c = h_rtag.data[angle.tag[2]];
-
-        // throw an error if this angle is incomplete
-        if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL)
-            {
-            this->m_exec_conf->msg->error() << "angle.harmonic: angle " <<
-                angle.tag[0] << " " << angle.tag[1] << " " << angle.tag[2] << " incomplete." << endl << endl;
-            throw std::runtime_error("Error in angle calculation");
-            }
+        // the indices of the particles participating in the angle
+        const AngleData::members_t& angle = args.angles[i];
+        unsigned int idx_a = angle.idx[0];
+        unsigned int idx_b = angle.idx[1];
+        unsigned int idx_c = angle.idx[2];
 
         assert(idx_a < m_pdata->getN()+m_pdata->getNGhosts());
         assert(idx_b < m_pdata->getN()+m_pdata->getNGhosts());
@@ -217,24 +232,24 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
 
         // calculate d\vec{r}
         Scalar3 dab;
-        dab.x = h_pos.data[idx_a].x - h_pos.data[idx_b].x;
-        dab.y = h_pos.data[idx_a].y - h_pos.data[idx_b].y;
-        dab.z = h_pos.data[idx_a].z - h_pos.data[idx_b].z;
+        dab.x = args.pos[idx_a].x - args.pos[idx_b].x;
+        dab.y = args.pos[idx_a].y - args.pos[idx_b].y;
+        dab.z = args.pos[idx_a].z - args.pos[idx_b].z;
 
         Scalar3 dcb;
-        dcb.x = h_pos.data[idx_c].x - h_pos.data[idx_b].x;
-        dcb.y = h_pos.data[idx_c].y - h_pos.data[idx_b].y;
-        dcb.z = h_pos.data[idx_c].z - h_pos.data[idx_b].z;
+        dcb.x = args.pos[idx_c].x - args.pos[idx_b].x;
+        dcb.y = args.pos[idx_c].y - args.pos[idx_b].y;
+        dcb.z = args.pos[idx_c].z - args.pos[idx_b].z;
 
         Scalar3 dac;
-        dac.x = h_pos.data[idx_a].x - h_pos.data[idx_c].x; // used for the 1-3 JL interaction
-        dac.y = h_pos.data[idx_a].y - h_pos.data[idx_c].y;
-        dac.z = h_pos.data[idx_a].z - h_pos.data[idx_c].z;
+        dac.x = args.pos[idx_a].x - args.pos[idx_c].x; // used for the 1-3 JL interaction
+        dac.y = args.pos[idx_a].y - args.pos[idx_c].y;
+        dac.z = args.pos[idx_a].z - args.pos[idx_c].z;
 
         // apply minimum image conventions to all 3 vectors
-        dab = box.minImage(dab);
-        dcb = box.minImage(dcb);
-        dac = box.minImage(dac);
+        dab = args.box.minImage(dab);
+        dcb = args.box.minImage(dcb);
+        dac = args.box.minImage(dac);
 
         // on paper, the formula turns out to be: F = K*\vec{r} * (r_0/r - 1)
         // FLOPS: 14 / MEM TRANSFER: 2 Scalars
@@ -257,7 +272,7 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
         s_abbc = 1.0/s_abbc;
 
         // actually calculate the force
-        unsigned int angle_type = m_angle_data->getTypeByIndex(i);
+        unsigned int angle_type = args.type[i];
         Scalar dth = acos(c_abbc) - m_t_0[angle_type];
         Scalar tk = m_K[angle_type]*dth;
 
@@ -291,38 +306,10 @@ void HarmonicAngleForceCompute::computeForces(unsigned int timestep)
 
         // Now, apply the force to each individual atom a,b,c, and accumlate the energy/virial
         // do not update ghost particles
-        if (idx_a < m_pdata->getN())
-            {
-            h_force.data[idx_a].x += fab[0];
-            h_force.data[idx_a].y += fab[1];
-            h_force.data[idx_a].z += fab[2];
-            h_force.data[idx_a].w += angle_eng;
-            for (int j = 0; j < 6; j++)
-                h_virial.data[j*virial_pitch+idx_a]  += angle_virial[j];
-            }
-
-        if (idx_b < m_pdata->getN())
-            {
-            h_force.data[idx_b].x -= fab[0] + fcb[0];
-            h_force.data[idx_b].y -= fab[1] + fcb[1];
-            h_force.data[idx_b].z -= fab[2] + fcb[2];
-            h_force.data[idx_b].w += angle_eng;
-            for (int j = 0; j < 6; j++)
-                h_virial.data[j*virial_pitch+idx_b]  += angle_virial[j];
-            }
-
-        if (idx_c < m_pdata->getN())
-            {
-            h_force.data[idx_c].x += fcb[0];
-            h_force.data[idx_c].y += fcb[1];
-            h_force.data[idx_c].z += fcb[2];
-            h_force.data[idx_c].w += angle_eng;
-            for (int j = 0; j < 6; j++)
-                h_virial.data[j*virial_pitch+idx_c]  += angle_virial[j];
-            }
+        out.add(idx_a, make_scalar4(fab[0], fab[1], fab[2], angle_eng), angle_virial);
+        out.add(idx_b, make_scalar4(-fab[0] - fcb[0], -fab[1] - fcb[1], -fab[2] - fcb[2], angle_eng), angle_virial);
+        out.add(idx_c, make_scalar4(fcb[0], fcb[1], fcb[2], angle_eng), angle_virial);
         }
-
-    if (m_prof) m_prof->pop();
     }
 
 void export_HarmonicAngleForceCompute()
@@ -110,8 +110,23 @@ class HarmonicAngleForceCompute : public ForceCompute
 
         boost::shared_ptr<AngleData> m_angle_data;  //!< Angle data to use in computing angles
 
+        //! Pointers to the input and output arrays of the CPU force computation, shared by all threads
+        struct cpu_args
+            {
+            const Scalar4 *pos;                     //!< Particle positions
+            const AngleData::members_t *angles;     //!< Angles ordered by their lowest member index
+            const unsigned int *type;               //!< Types of the angles
+            const unsigned int *offset;             //!< Offsets of the angles by lowest member index
+            BoxDim box;                             //!< Global simulation box
+            Scalar4 *force;                         //!< Forces (output)
+            Scalar *virial;                         //!< Virials (output)
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! Compute the forces of the angles assigned to one thread
+        void computeForcesThread(unsigned int thread_idx, const cpu_args& args);
     };
 
 //! Exports the AngleForceCompute class to python
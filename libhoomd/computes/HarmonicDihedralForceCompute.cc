@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include "HarmonicDihedralForceCompute.h"
@@ -166,93 +167,104 @@ Scalar HarmonicDihedralForceCompute::getLogValue(const std::string& quantity, un
 
 /*! Actually perform the force computation
     \param timestep Current time step
+
+    The dihedrals are divided among the threads as described for ForceCompute::bonded_output.
  */
 void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Harmonic Dihedral");
 
     assert(m_pdata);
+
+    // the table is rebuilt here if the particles have been sorted since the last call
+    const GPUVector<DihedralData::members_t>& dihedral_table = m_dihedral_data->getCPUTable();
+    const GPUVector<unsigned int>& dihedral_type = m_dihedral_data->getCPUTableTypes();
+    const GPUVector<unsigned int>& dihedral_offset = m_dihedral_data->getCPUTableOffsets();
+
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
 
-    // Zero data for force calculation.
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    ArrayHandle<DihedralData::members_t> h_dihedrals(dihedral_table, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_type(dihedral_type, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_offset(dihedral_offset, access_location::host, access_mode::read);
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
     assert(h_pos.data);
-    assert(h_rtag.data);
 
-    unsigned int virial_pitch = m_virial.getPitch();
+    // Zero data for force calculation.
+    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
 
-    // get a local copy of the simulation box too
-    const BoxDim& box = m_pdata->getBox();
+    cpu_args args;
+    args.pos = h_pos.data;
+    args.dihedrals = h_dihedrals.data;
+    args.type = h_type.data;
+    args.offset = h_offset.data;
+    args.box = m_pdata->getBox();
+    args.force = h_force.data;
+    args.virial = h_virial.data;
 
-    // for each of the dihedrals
-    const unsigned int size = (unsigned int)m_dihedral_data->getN();
-    for (unsigned int i = 0; i < size; i++)
-        {
-        // lookup the tag of each of the particles participating in the dihedral
-        const ImproperData::members_t& dihedral = m_dihedral_data->getMembersByIndex(i);
-        assert(dihedral.tag[0] < m_pdata->getNGlobal());
-        assert(dihedral.tag[1] < m_pdata->getNGlobal());
-        assert(dihedral.tag[2] < m_pdata->getNGlobal());
-        assert(dihedral.tag[3] < m_pdata->getNGlobal());
-
-        // transform a, b, and c into indicies into the particle data arrays
-        // MEM TRANSFER: 6 ints
-        unsigned int idx_a = h_rtag.data[dihedral.tag[0]];
-        unsigned int idx_b = h_rtag.data[dihedral.tag[1]];
-        unsigned int idx_c = h_rtag.data[dihedral.tag[2]];
-        unsigned int idx_d = h_rtag.data[dihedral.tag[3]];
-
-        // throw an error if this angle is incomplete
-        if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL || idx_d == NOT_LOCAL)
-            {
-            this->m_exec_conf->msg->error() << "dihedral.harmonic: dihedral " <<
-                dihedral.tag[0] << " " << dihedral.tag[1] << " " << dihedral.tag[2] << " " << dihedral.tag[3]
-                << " incomplete." << endl << endl;
-            throw std::runtime_error("Error in dihedral calculation");
-            }
+    resetThreadSpill();
+    m_exec_conf->getThreadPool().run(bind(&HarmonicDihedralForceCompute::computeForcesThread, this, _1, boost::cref(args)));
+    applyThreadSpill(h_force.data, h_virial.data, true);
+
+    if (m_prof) m_prof->pop();
+    }
 
-        assert(idx_a < m_pdata->getN() + m_pdata->getNGhosts());
-        assert(idx_b < m_pdata->getN() + m_pdata->getNGhosts());
-        assert(idx_c < m_pdata->getN() + m_pdata->getNGhosts());
-        assert(idx_d < m_pdata->getN() + m_pdata->getNGhosts());
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void HarmonicDihedralForceCompute::computeForcesThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    bonded_output out = getBondedOutput(thread_idx, args.force, args.virial, true);
+
+    // for each of the dihedrals whose lowest member is owned by this thread
+    for (unsigned int i = args.offset[out.first]; i < args.offset[out.last]; i++)
+        {
+        // the indices of the particles participating in the dihedral
+        const DihedralData::members_t& dihedral = args.dihedrals[i];
+        unsigned int idx_a = dihedral.idx[0];
+        unsigned int idx_b = dihedral.idx[1];
+        unsigned int idx_c = dihedral.idx[2];
+        unsigned int idx_d = dihedral.idx[3];
+
+        assert(idx_a < m_pdata->getN()+m_pdata->getNGhosts());
+        assert(idx_b < m_pdata->getN()+m_pdata->getNGhosts());
+        assert(idx_c < m_pdata->getN()+m_pdata->getNGhosts());
+        assert(idx_d < m_pdata->getN()+m_pdata->getNGhosts());
 
         // calculate d\vec{r}
         Scalar3 dab;
-        dab.x = h_pos.data[idx_a].x - h_pos.data[idx_b].x;
-        dab.y = h_pos.data[idx_a].y - h_pos.data[idx_b].y;
-        dab.z = h_pos.data[idx_a].z - h_pos.data[idx_b].z;
+        dab.x = args.pos[idx_a].x - args.pos[idx_b].x;
+        dab.y = args.pos[idx_a].y - args.pos[idx_b].y;
+        dab.z = args.pos[idx_a].z - args.pos[idx_b].z;
 
         Scalar3 dcb;
-        dcb.x = h_pos.data[idx_c].x - h_pos.data[idx_b].x;
-        dcb.y = h_pos.data[idx_c].y - h_pos.data[idx_b].y;
-        dcb.z = h_pos.data[idx_c].z - h_pos.data[idx_b].z;
+        dcb.x = args.pos[idx_c].x - args.pos[idx_b].x;
+        dcb.y = args.pos[idx_c].y - args.pos[idx_b].y;
+        dcb.z = args.pos[idx_c].z - args.pos[idx_b].z;
 
         Scalar3 ddc;
-        ddc.x = h_pos.data[idx_d].x - h_pos.data[idx_c].x;
-        ddc.y = h_pos.data[idx_d].y - h_pos.data[idx_c].y;
-        ddc.z = h_pos.data[idx_d].z - h_pos.data[idx_c].z;
+        ddc.x = args.pos[idx_d].x - args.pos[idx_c].x;
+        ddc.y = args.pos[idx_d].y - args.pos[idx_c].y;
+        ddc.z = args.pos[idx_d].z - args.pos[idx_c].z;
 
         // apply periodic boundary conditions
-        dab = box.minImage(dab);
-        dcb = box.minImage(dcb);
-        ddc = box.minImage(ddc);
+        dab = args.box.minImage(dab);
+        dcb = args.box.minImage(dcb);
+        ddc = args.box.minImage(ddc);
 
         Scalar3 dcbm;
         dcbm.x = -dcb.x;
         dcbm.y = -dcb.y;
         dcbm.z = -dcb.z;
 
-        dcbm = box.minImage(dcbm);
+        dcbm = args.box.minImage(dcbm);
 
         Scalar aax = dab.y*dcbm.z - dab.z*dcbm.y;
         Scalar aay = dab.z*dcbm.x - dab.x*dcbm.z;
@@ -280,7 +292,7 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
         if (c_abcd > 1.0) c_abcd = 1.0;
         if (c_abcd < -1.0) c_abcd = -1.0;
 
-        unsigned int dihedral_type = m_dihedral_data->getTypeByIndex(i);
+        unsigned int dihedral_type = args.type[i];
         int multi = (int)m_multi[dihedral_type];
         Scalar p = Scalar(1.0);
         Scalar dfab = Scalar(0.0);
@@ -367,36 +379,12 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
         dihedral_virial[4] = (1./4.)*(dab.z*ffay + dcb.z*ffcy + (ddc.z+dcb.z)*ffdy);
         dihedral_virial[5] = (1./4.)*(dab.z*ffaz + dcb.z*ffcz + (ddc.z+dcb.z)*ffdz);
 
-        h_force.data[idx_a].x += ffax;
-        h_force.data[idx_a].y += ffay;
-        h_force.data[idx_a].z += ffaz;
-        h_force.data[idx_a].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_a]  += dihedral_virial[k];
-
-        h_force.data[idx_b].x += ffbx;
-        h_force.data[idx_b].y += ffby;
-        h_force.data[idx_b].z += ffbz;
-        h_force.data[idx_b].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_b]  += dihedral_virial[k];
-
-        h_force.data[idx_c].x += ffcx;
-        h_force.data[idx_c].y += ffcy;
-        h_force.data[idx_c].z += ffcz;
-        h_force.data[idx_c].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_c]  += dihedral_virial[k];
-
-        h_force.data[idx_d].x += ffdx;
-        h_force.data[idx_d].y += ffdy;
-        h_force.data[idx_d].z += ffdz;
-        h_force.data[idx_d].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_d]  += dihedral_virial[k];
-       }
-
-    if (m_prof) m_prof->pop();
+        // ghost particles receive no forces
+        out.add(idx_a, make_scalar4(ffax, ffay, ffaz, dihedral_eng), dihedral_virial);
+        out.add(idx_b, make_scalar4(ffbx, ffby, ffbz, dihedral_eng), dihedral_virial);
+        out.add(idx_c, make_scalar4(ffcx, ffcy, ffcz, dihedral_eng), dihedral_virial);
+        out.add(idx_d, make_scalar4(ffdx, ffdy, ffdz, dihedral_eng), dihedral_virial);
+        }
     }
 
 void export_HarmonicDihedralForceCompute()
@@ -111,8 +111,23 @@ class HarmonicDihedralForceCompute : public ForceCompute
 
         boost::shared_ptr<DihedralData> m_dihedral_data;    //!< Dihedral data to use in computing dihedrals
 
+        //! Pointers to the input and output arrays of the CPU force computation, shared by all threads
+        struct cpu_args
+            {
+            const Scalar4 *pos;                     //!< Particle positions
+            const DihedralData::members_t *dihedrals;   //!< Dihedrals ordered by their lowest member index
+            const unsigned int *type;               //!< Types of the dihedrals
+            const unsigned int *offset;             //!< Offsets of the dihedrals by lowest member index
+            BoxDim box;                             //!< Simulation box
+            Scalar4 *force;                         //!< Forces (output)
+            Scalar *virial;                         //!< Virials (output)
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! Compute the forces of the dihedrals assigned to one thread
+        void computeForcesThread(unsigned int thread_idx, const cpu_args& args);
     };
 
 //! Exports the DihedralForceCompute class to python
@@ -68,6 +68,7 @@ using namespace boost::python;
 
 #include <iostream>
 #include <stdexcept>
+#include <climits>
 
 using namespace boost;
 using namespace std;
@@ -82,12 +83,12 @@ using namespace std;
 
     \post NeighborList is initialized and the list memory has been allocated,
         but the list will not be computed until compute is called.
-    \post The storage mode defaults to half
+    \post The storage mode defaults to half, with the dense (non compact) layout
 */
 NeighborList::NeighborList(boost::shared_ptr<SystemDefinition> sysdef, Scalar r_cut, Scalar r_buff)
     : Compute(sysdef), m_r_cut(r_cut), m_r_buff(r_buff), m_d_max(1.0), m_filter_body(false), m_filter_diameter(false),
-      m_storage_mode(half), m_updates(0), m_forced_updates(0), m_dangerous_updates(0),
-      m_force_update(true), m_dist_check(true), m_has_been_updated_once(false), m_want_exclusions(false)
+      m_storage_mode(half), m_compact_storage(false), m_incremental(false), m_nlist_stride(0), m_updates(0),
+      m_forced_updates(0), m_dangerous_updates(0), m_partial_updates(0), m_partial_pending(false), m_force_update(true), m_dist_check(true), m_has_been_updated_once(false), m_want_exclusions(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Neighborlist" << endl;
 
@@ -106,12 +107,25 @@ NeighborList::NeighborList(boost::shared_ptr<SystemDefinition> sysdef, Scalar r_
 
     // initialize values
     m_last_updated_tstep = 0;
+    m_last_partial_tstep = 0;
     m_last_checked_tstep = 0;
     m_last_check_result = false;
     m_every = 0;
     m_Nmax = 0;
     m_exclusions_set = false;
 
+    // buffer tuning is disabled by default
+    m_tune_window = 0;
+    m_tune_max_every = 1;
+    m_tune_window_open = false;
+    m_tune_sampling = false;
+    m_tune_probe = false;
+    m_tune_window_start = 0;
+    m_tune_min_period = UINT_MAX;
+    m_tune_dangerous = 0;
+    m_tune_ref_period = 0;
+    m_tune_ref_n_neigh = Scalar(0.0);
+
 
     // initialize box length at last update
     m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
@@ -125,6 +139,10 @@ NeighborList::NeighborList(boost::shared_ptr<SystemDefinition> sysdef, Scalar r_
     GPUArray<unsigned int> n_neigh(m_pdata->getMaxN(), exec_conf);
     m_n_neigh.swap(n_neigh);
 
+    // allocate the head list
+    GPUArray<unsigned int> head_list(m_pdata->getMaxN()+1, exec_conf);
+    m_head_list.swap(head_list);
+
     // allocate neighbor list
     allocateNlist();
 
@@ -170,10 +188,15 @@ void NeighborList::reallocate()
     m_ex_list_idx.resize(m_pdata->getMaxN(), ex_list_height );
     m_ex_list_indexer = Index2D(m_ex_list_idx.getPitch(), ex_list_height);
 
-    m_nlist.resize(m_pdata->getMaxN(), m_Nmax+1);
-    m_nlist_indexer = Index2D(m_nlist.getPitch(), m_Nmax);
-
     m_n_neigh.resize(m_pdata->getMaxN());
+    m_head_list.resize(m_pdata->getMaxN()+1);
+
+    if (!m_compact_storage)
+        {
+        m_nlist.resize(m_pdata->getMaxN(), m_Nmax+1);
+        m_nlist_indexer = Index2D(m_nlist.getPitch(), m_Nmax);
+        }
+    updateHeadList();
 
     if (m_n_ex_tag.getNumElements() != m_pdata->getNGlobal())
         {
@@ -212,6 +235,10 @@ void NeighborList::compute(unsigned int timestep)
     if (!shouldCompute(timestep) && !m_force_update)
         return;
 
+    // a new tuning window may change r_buff
+    if (m_buffer_tuner)
+        updateBufferTuning(timestep);
+
     if (m_prof) m_prof->push("Neighbor");
 
     // update the exclusion data if this is a forced update
@@ -222,26 +249,29 @@ void NeighborList::compute(unsigned int timestep)
         }
 
     // check if the list needs to be updated and update it
-    if (needsUpdating(timestep))
+    bool full_update = needsUpdating(timestep);
+
+    // in the incremental mode, only the lists around the displaced particles are rebuilt
+    if (!full_update && m_partial_pending)
         {
-        // rebuild the list until there is no overflow
-        bool overflowed = false;
-        do
+        m_partial_pending = false;
+        if (updatePartial(timestep))
             {
-            buildNlist(timestep);
-
-            overflowed = checkConditions();
-            // if we overflowed, need to reallocate memory and reset the conditions
-            if (overflowed)
-                {
-                allocateNlist();
-                resetConditions();
-                }
-            } while (overflowed);
-
-        if (m_exclusions_set)
-            filterNlist();
+            m_partial_updates += 1;
+            m_last_partial_tstep = timestep;
+            }
+        else
+            {
+            // count the fallback as a normal update
+            m_updates += 1;
+            m_last_updated_tstep = timestep;
+            full_update = true;
+            }
+        }
 
+    if (full_update)
+        {
+        rebuildNlist(timestep);
         setLastUpdatedPos();
         m_has_been_updated_once = true;
         }
@@ -249,6 +279,35 @@ void NeighborList::compute(unsigned int timestep)
     if (m_prof) m_prof->pop();
     }
 
+/*! \param timestep Current time step of the simulation
+
+    Calls buildNlist() until the list fits into its memory and filters the exclusions from the result.
+*/
+void NeighborList::rebuildNlist(unsigned int timestep)
+    {
+    // in the compact layout, fit the capacities to the neighbor counts of the previous build
+    if (m_compact_storage)
+        updateHeadList();
+
+    // rebuild the list until there is no overflow
+    bool overflowed = false;
+    do
+        {
+        buildNlist(timestep);
+
+        overflowed = checkConditions();
+        // if we overflowed, need to reallocate memory and reset the conditions
+        if (overflowed)
+            {
+            allocateNlist();
+            resetConditions();
+            }
+        } while (overflowed);
+
+    if (m_exclusions_set)
+        filterNlist();
+    }
+
 /*! \param num_iters Number of iterations to average for the benchmark
     \returns Milliseconds of execution time per calculation
 
@@ -891,6 +950,99 @@ void NeighborList::setLastUpdatedPos()
     if (m_prof) m_prof->pop();
     }
 
+/*! \param timestep Current time step
+    \returns true if the whole list needs to be rebuilt
+
+    Every particle is compared to its own last position. Those that have moved a quarter of the buffer distance or
+    more are collected in m_displaced and a partial update is requested, see the class documentation for why the
+    threshold is a quarter instead of half of the buffer. Any change of the box, or a number of displaced particles
+    for which a full build is cheaper, requests a full rebuild instead.
+*/
+bool NeighborList::incrementalCheck(unsigned int timestep)
+    {
+    m_displaced.clear();
+
+    // the rows are not built for a common reference box, so any box change invalidates the whole list
+    Scalar3 L_g = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    if (L_g.x != m_last_L.x || L_g.y != m_last_L.y || L_g.z != m_last_L.z)
+        return true;
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::read);
+
+    if (m_prof) m_prof->push("Dist check");
+
+    const BoxDim& box = m_pdata->getBox();
+
+    Scalar rmax = m_r_cut + m_r_buff;
+    if (!m_filter_diameter)
+        rmax += m_d_max - Scalar(1.0);
+
+    Scalar delta_max = (rmax - m_r_cut)/Scalar(4.0);
+    Scalar maxsq = delta_max*delta_max;
+
+    // beyond a tenth of the particles, the stencils cover most of the system and a full build is cheaper
+    unsigned int max_displaced = m_pdata->getN()/10;
+
+    bool result = false;
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        Scalar3 dx = make_scalar3(h_pos.data[i].x - h_last_pos.data[i].x,
+                                  h_pos.data[i].y - h_last_pos.data[i].y,
+                                  h_pos.data[i].z - h_last_pos.data[i].z);
+
+        dx = box.minImage(dx);
+
+        if (dot(dx, dx) >= maxsq)
+            {
+            if (m_displaced.size() == max_displaced)
+                {
+                result = true;
+                break;
+                }
+            m_displaced.push_back(i);
+            }
+        }
+
+    m_partial_pending = !result && !m_displaced.empty();
+
+    if (m_prof) m_prof->pop();
+
+    return result;
+    }
+
+/*! \param timestep Current time step
+    \returns false if the partial update could not be performed and the whole list needs to be rebuilt
+*/
+bool NeighborList::updatePartial(unsigned int timestep)
+    {
+    if (!buildNlistPartial(timestep))
+        return false;
+
+    // a rebuilt list may have outgrown its capacity, make room and let the caller rebuild everything
+    if (checkConditions())
+        {
+        allocateNlist();
+        resetConditions();
+        return false;
+        }
+
+    // filtering is idempotent, the lists that were not rebuilt are unchanged by it
+    if (m_exclusions_set)
+        filterNlist();
+
+    // only the displaced particles get a new reference position
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::readwrite);
+    for (unsigned int k = 0; k < m_displaced.size(); k++)
+        {
+        unsigned int i = m_displaced[k];
+        h_last_pos.data[i] = make_scalar4(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z, Scalar(0.0));
+        }
+
+    return true;
+    }
+
 bool NeighborList::shouldCheckDistance(unsigned int timestep)
     {
     return !m_force_update && !(timestep < (m_last_updated_tstep + m_every));
@@ -956,6 +1108,10 @@ bool NeighborList::needsUpdating(unsigned int timestep)
             {
             result = true;
             }
+        else if (m_incremental)
+            {
+            result = incrementalCheck(timestep);
+            }
         else
             {
             result = distanceCheck(timestep);
@@ -967,6 +1123,7 @@ bool NeighborList::needsUpdating(unsigned int timestep)
             if (timestep > m_last_updated_tstep)
                 {
                 unsigned int period = timestep - m_last_updated_tstep;
+                m_tune_min_period = min(m_tune_min_period, period);
                 if (period >= m_update_periods.size())
                     period = m_update_periods.size()-1;
                 m_update_periods[period]++;
@@ -1000,7 +1157,18 @@ void NeighborList::printStats()
 
     m_exec_conf->msg->notice(1) << "-- Neighborlist stats:" << endl;
     m_exec_conf->msg->notice(1) << m_updates << " normal updates / " << m_forced_updates << " forced updates / " << m_dangerous_updates << " dangerous updates" << endl;
+    if (m_incremental)
+        m_exec_conf->msg->notice(1) << m_partial_updates << " partial updates" << endl;
+
+    printNNeighStats();
 
+    m_exec_conf->msg->notice(1) << "shortest rebuild period: " << getSmallestRebuild() << endl;
+    }
+
+/*! Prints the minimum, maximum and average number of neighbors of the local particles.
+*/
+void NeighborList::printNNeighStats()
+    {
     // access the number of neighbors to generate stats
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
 
@@ -1023,13 +1191,11 @@ void NeighborList::printStats()
     // divide to get the average
     n_neigh_avg /= Scalar(m_pdata->getN());
     m_exec_conf->msg->notice(1) << "n_neigh_min: " << n_neigh_min << " / n_neigh_max: " << n_neigh_max << " / n_neigh_avg: " << n_neigh_avg << endl;
-
-    m_exec_conf->msg->notice(1) << "shortest rebuild period: " << getSmallestRebuild() << endl;
     }
 
 void NeighborList::resetStats()
     {
-    m_updates = m_forced_updates = m_dangerous_updates = 0;
+    m_updates = m_forced_updates = m_dangerous_updates = m_partial_updates = 0;
 
     for (unsigned int i = 0; i < m_update_periods.size(); i++)
         m_update_periods[i] = 0;
@@ -1089,6 +1255,7 @@ void NeighborList::buildNlist(unsigned int timestep)
 
     // access the nlist data
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
 
     unsigned int conditions = 0;
@@ -1130,35 +1297,25 @@ void NeighborList::buildNlist(unsigned int timestep)
             Scalar rsq = dot(dx, dx);
             if (rsq <= (rmaxsq + sqshift) && !excluded)
                 {
-                if (m_storage_mode == full)
-                    {
-                    unsigned int posi = h_n_neigh.data[i];
-                    if (posi < m_Nmax)
-                        h_nlist.data[m_nlist_indexer(i, posi)] = j;
-                    else
-                        conditions = max(conditions, h_n_neigh.data[i]+1);
+                unsigned int posi = h_n_neigh.data[i];
+                if (posi < getMaxNNeigh(h_head_list.data, i))
+                    h_nlist.data[h_head_list.data[i] + posi*m_nlist_stride] = j;
+                else
+                    conditions = max(conditions, posi+1);
 
-                    h_n_neigh.data[i]++;
+                h_n_neigh.data[i]++;
 
+                // only local particles get a neighbor list
+                if (m_storage_mode == full && j < m_pdata->getN())
+                    {
                     unsigned int posj = h_n_neigh.data[j];
-                    if (posj < m_Nmax)
-                        h_nlist.data[m_nlist_indexer(j, posj)] = i;
+                    if (posj < getMaxNNeigh(h_head_list.data, j))
+                        h_nlist.data[h_head_list.data[j] + posj*m_nlist_stride] = i;
                     else
-                        conditions = max(conditions, h_n_neigh.data[j]+1);
+                        conditions = max(conditions, posj+1);
 
                     h_n_neigh.data[j]++;
                     }
-                else
-                    {
-                    unsigned int pos = h_n_neigh.data[i];
-
-                    if (pos < m_Nmax)
-                        h_nlist.data[m_nlist_indexer(i, pos)] = j;
-                    else
-                        conditions = max(conditions, h_n_neigh.data[i]+1);
-
-                    h_n_neigh.data[i]++;
-                    }
                 }
             }
         }
@@ -1221,11 +1378,13 @@ void NeighborList::filterNlist()
     ArrayHandle<unsigned int> h_n_ex_idx(m_n_ex_idx, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_ex_list_idx(m_ex_list_idx, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
 
     // for each particle's neighbor list
     for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
         {
+        unsigned int *nlist_idx = h_nlist.data + h_head_list.data[idx];
         unsigned int n_neigh = h_n_neigh.data[idx];
         unsigned int n_ex = h_n_ex_idx.data[idx];
         unsigned int new_n_neigh = 0;
@@ -1233,7 +1392,7 @@ void NeighborList::filterNlist()
         // loop over the list, regenerating it as we go
         for (unsigned int cur_neigh_idx = 0; cur_neigh_idx < n_neigh; cur_neigh_idx++)
             {
-            unsigned int cur_neigh = h_nlist.data[m_nlist_indexer(idx, cur_neigh_idx)];
+            unsigned int cur_neigh = nlist_idx[cur_neigh_idx*m_nlist_stride];
 
             // test if excluded
             bool excluded = false;
@@ -1250,7 +1409,7 @@ void NeighborList::filterNlist()
             // add it back to the list if it is not excluded
             if (!excluded)
                 {
-                h_nlist.data[m_nlist_indexer(idx, new_n_neigh)] = cur_neigh;
+                nlist_idx[new_n_neigh*m_nlist_stride] = cur_neigh;
                 new_n_neigh++;
                 }
             }
@@ -1265,6 +1424,13 @@ void NeighborList::filterNlist()
 
 void NeighborList::allocateNlist()
     {
+    // the compact layout is sized from the neighbor counts
+    if (m_compact_storage)
+        {
+        updateHeadList();
+        return;
+        }
+
     // round up to the nearest multiple of 8
     m_Nmax = m_Nmax + 8 - (m_Nmax & 7);
 
@@ -1276,6 +1442,237 @@ void NeighborList::allocateNlist()
 
     // update the indexer
     m_nlist_indexer = Index2D(m_nlist.getPitch(), m_Nmax);
+    updateHeadList();
+    }
+
+/*! In the dense layout, the head list is simply <code>head_list[i] = i</code> and the stride is the pitch of the 2D
+    matrix.
+
+    In the compact layout, the capacity of each local particle is its neighbor count from the last build, plus room
+    for its exclusions (the counts are taken after filterNlist()) and some headroom, rounded up to a multiple of 4.
+    The head list is the exclusive prefix sum over these capacities. Entries past the local particles are set to the
+    total, so that <code>head_list[i+1] - head_list[i]</code> is the capacity of every local particle. The list
+    memory is reallocated only if it needs to grow or is more than twice as large as needed.
+*/
+void NeighborList::updateHeadList()
+    {
+    if (!m_compact_storage)
+        {
+        ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < m_head_list.getNumElements(); i++)
+            h_head_list.data[i] = i;
+
+        m_nlist_stride = m_nlist.getPitch();
+        return;
+        }
+
+    unsigned int n_total = 0;
+        {
+        ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_ex_idx(m_n_ex_idx, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::overwrite);
+
+        unsigned int N = m_pdata->getN();
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_head_list.data[i] = n_total;
+
+            unsigned int n = h_n_neigh.data[i];
+            if (m_exclusions_set)
+                n += h_n_ex_idx.data[i];
+
+            n_total += (n + n/8 + 4 + 3) & ~3;
+            }
+
+        for (unsigned int i = N; i < m_head_list.getNumElements(); i++)
+            h_head_list.data[i] = n_total;
+        }
+
+    unsigned int n_alloc = m_nlist.getNumElements();
+    if (n_total > n_alloc || n_total < n_alloc/2 || m_nlist.getHeight() > 1)
+        {
+        m_exec_conf->msg->notice(6) << "nlist: (Re-)Allocating compact list with " << n_total << " entries" << endl;
+
+        GPUArray<unsigned int> nlist(max(n_total, (unsigned int)1), exec_conf);
+        m_nlist.swap(nlist);
+        }
+
+    m_nlist_stride = 1;
+    }
+
+/*! \param incremental Set to true to rebuild only the lists around displaced particles
+
+    The base class does not implement partial builds, derived classes that do override this method.
+*/
+void NeighborList::setIncremental(bool incremental)
+    {
+    if (incremental)
+        {
+        m_exec_conf->msg->error() << "nlist: Incremental updates are not supported by this neighbor list" << endl;
+        throw runtime_error("Error setting neighbor list parameters");
+        }
+    }
+
+/*! \param r_buff_min Smallest buffer distance to try
+    \param r_buff_max Largest buffer distance to try
+    \param n_values Number of buffer distances to try, evenly spaced from \a r_buff_min to \a r_buff_max
+    \param window Number of time steps that are timed for each sample
+    \param max_every Upper bound for the tuned check period
+    \param period Number of windows after which a new sweep is made, even if the conditions have not changed
+
+    Tuning starts with the next call to compute(), see the class documentation for details.
+*/
+void NeighborList::enableBufferTuning(Scalar r_buff_min,
+                                      Scalar r_buff_max,
+                                      unsigned int n_values,
+                                      unsigned int window,
+                                      unsigned int max_every,
+                                      unsigned int period)
+    {
+    if (r_buff_min < 0.0 || r_buff_max < r_buff_min || n_values == 0 || window == 0 || max_every == 0)
+        {
+        m_exec_conf->msg->error() << "nlist: Invalid buffer tuning parameters" << endl;
+        throw runtime_error("Error enabling neighbor list buffer tuning");
+        }
+
+    m_tune_r_buff.resize(n_values);
+    for (unsigned int i = 0; i < n_values; i++)
+        {
+        m_tune_r_buff[i] = (n_values > 1) ? r_buff_min + (r_buff_max - r_buff_min) * Scalar(i) / Scalar(n_values - 1)
+                                          : r_buff_min;
+        }
+
+    // median of 3 samples, as in tune.r_buff()
+    m_buffer_tuner.reset(new Autotuner(0, n_values - 1, 1, 3, period, "nlist_r_buff", m_exec_conf));
+
+    #ifdef ENABLE_MPI
+    // all ranks must agree on r_buff, it sets the ghost layer width
+    if (m_pdata->getDomainDecomposition())
+        m_buffer_tuner->setSync(true);
+    #endif
+
+    m_tune_window = window;
+    m_tune_max_every = max_every;
+    m_tune_window_open = false;
+    m_tune_probe = false;
+    }
+
+void NeighborList::disableBufferTuning()
+    {
+    m_buffer_tuner.reset();
+    m_tune_window_open = false;
+    }
+
+/*! \param timestep Current time step
+
+    Called once per time step before the list is checked. Nothing happens until the current window of m_tune_window
+    steps has passed. Then the window is closed, which records its duration in the Autotuner, and evaluated: after a
+    sweep the check period is derived from the shortest rebuild period, and in production the rebuild period and the
+    neighbor count are compared to their values after the last sweep. Finally, the next window is opened with the
+    r_buff requested by the Autotuner.
+*/
+void NeighborList::updateBufferTuning(unsigned int timestep)
+    {
+    if (m_tune_window_open && timestep < m_tune_window_start + m_tune_window)
+        return;
+
+    if (m_tune_window_open)
+        {
+        m_buffer_tuner->end();
+
+        if (m_tune_sampling)
+            {
+            // when the sweep is complete, measure the rebuild period at the optimal r_buff in the next window
+            m_tune_probe = !m_buffer_tuner->isSampling();
+            }
+        else if (m_tune_probe)
+            {
+            m_tune_probe = false;
+
+            // without any rebuild, the period is at least the window
+            m_tune_ref_period = min(m_tune_min_period, m_tune_window);
+            m_tune_ref_n_neigh = getAverageNNeigh();
+
+            // leave a safety margin for fluctuations
+            m_every = max(1u, min(m_tune_ref_period / 2, m_tune_max_every));
+
+            m_exec_conf->msg->notice(2) << "nlist: Tuned r_buff = " << m_r_buff << ", check_period = " << m_every
+                                        << endl;
+            }
+        else
+            {
+            // production window: look for signs that the temperature or density have changed
+            unsigned int period = min(m_tune_min_period, m_tune_window);
+            Scalar n_neigh = getAverageNNeigh();
+
+            int drift = 0;
+            if (m_dangerous_updates > m_tune_dangerous || period > 2*m_tune_ref_period ||
+                fabs(n_neigh - m_tune_ref_n_neigh) > Scalar(0.1) * m_tune_ref_n_neigh)
+                drift = 1;
+
+            #ifdef ENABLE_MPI
+            // the neighbor counts are local, all ranks must take the same decision
+            if (m_pdata->getDomainDecomposition())
+                MPI_Allreduce(MPI_IN_PLACE, &drift, 1, MPI_INT, MPI_MAX, m_exec_conf->getMPICommunicator());
+            #endif
+
+            if (drift)
+                {
+                m_exec_conf->msg->notice(3) << "nlist: Conditions have changed, re-tuning r_buff" << endl;
+                m_buffer_tuner->startScan();
+                }
+            }
+        }
+
+    // open the next window
+    m_tune_sampling = m_buffer_tuner->isSampling();
+
+    // r_buff is compared at a check period of 1, so that the rebuilds happen exactly when they are needed
+    if (m_tune_sampling || m_tune_probe)
+        m_every = 1;
+
+    Scalar r_buff = m_tune_r_buff[m_buffer_tuner->getParam()];
+    if (r_buff != m_r_buff)
+        setRCut(m_r_cut, r_buff);
+
+    m_tune_window_start = timestep;
+    m_tune_min_period = UINT_MAX;
+    m_tune_dangerous = m_dangerous_updates;
+    m_tune_window_open = true;
+
+    m_buffer_tuner->begin();
+    }
+
+/*! \returns The average number of neighbors per local particle
+*/
+Scalar NeighborList::getAverageNNeigh()
+    {
+    unsigned int N = m_pdata->getN();
+    if (N == 0)
+        return Scalar(0.0);
+
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+
+    Scalar n_neigh_total = Scalar(0.0);
+    for (unsigned int i = 0; i < N; i++)
+        n_neigh_total += Scalar(h_n_neigh.data[i]);
+
+    return n_neigh_total / Scalar(N);
+    }
+
+/*! \param compact Set to true to store the neighbor list in compact (CSR) form
+
+    The list memory is reallocated in the new layout and a full update of the list is forced on the next call to
+    compute().
+*/
+void NeighborList::setCompactStorage(bool compact)
+    {
+    if (compact == m_compact_storage)
+        return;
+
+    m_compact_storage = compact;
+    allocateNlist();
+    forceUpdate();
     }
 
 unsigned int NeighborList::readConditions()
@@ -1291,9 +1688,10 @@ bool NeighborList::checkConditions()
     conditions = readConditions();
 
     // up m_Nmax to the overflow value, reallocate memory and set the overflow condition
-    if (conditions > m_Nmax)
+    // in the compact layout, any particle may overflow its capacity independently of m_Nmax
+    if (conditions > m_Nmax || (m_compact_storage && conditions > 0))
         {
-        m_Nmax = conditions;
+        m_Nmax = max(m_Nmax, conditions);
         result = true;
         }
 
@@ -1349,6 +1747,10 @@ void NeighborList::setCommunicator(boost::shared_ptr<Communicator> comm)
  */
 bool NeighborList::peekUpdate(unsigned int timestep)
     {
+    // change r_buff before the ghost layer is exchanged with the current width
+    if (m_buffer_tuner)
+        updateBufferTuning(timestep);
+
     if (m_prof) m_prof->push("Neighbor");
 
     bool result = needsUpdating(timestep);
@@ -1371,6 +1773,13 @@ void export_NeighborList()
                      .def("setRCut", &NeighborList::setRCut)
                      .def("setEvery", &NeighborList::setEvery)
                      .def("setStorageMode", &NeighborList::setStorageMode)
+                     .def("setCompactStorage", &NeighborList::setCompactStorage)
+                     .def("setIncremental", &NeighborList::setIncremental)
+                     .def("enableBufferTuning", &NeighborList::enableBufferTuning)
+                     .def("disableBufferTuning", &NeighborList::disableBufferTuning)
+                     .def("getRBuff", &NeighborList::getRBuff)
+                     .def("getEvery", &NeighborList::getEvery)
+                     .def("getIncremental", &NeighborList::getIncremental)
                      .def("addExclusion", &NeighborList::addExclusion)
                      .def("clearExclusions", &NeighborList::clearExclusions)
                      .def("countExclusions", &NeighborList::countExclusions)
@@ -1389,6 +1798,7 @@ void export_NeighborList()
                      .def("estimateNNeigh", &NeighborList::estimateNNeigh)
                      .def("getSmallestRebuild", &NeighborList::getSmallestRebuild)
                      .def("getNumUpdates", &NeighborList::getNumUpdates)
+                     .def("getNumPartialUpdates", &NeighborList::getNumPartialUpdates)
                      .def("getNumExclusions", &NeighborList::getNumExclusions)
                      .def("wantExclusions", &NeighborList::wantExclusions)
 #ifdef ENABLE_MPI
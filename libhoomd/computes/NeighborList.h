@@ -51,12 +51,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/shared_ptr.hpp>
 #include <boost/signals2.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <vector>
 
 #include "Compute.h"
 #include "GPUArray.h"
 #include "GPUFlags.h"
 #include "Index1D.h"
+#include "Autotuner.h"
 
 /*! \file NeighborList.h
     \brief Declares the NeighborList class
@@ -103,6 +105,24 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     \a jf includes flags in the highest bits. The format and use of these flags are yet to be determined.
 
+    <b>Compact storage:</b>
+
+    The 2D matrix reserves Nmax slots for every particle, so its size is set by the most crowded particle in the
+    system. When compact storage is enabled with setCompactStorage(), the list is instead stored in CSR form: the
+    neighbors of particle \a i are stored contiguously starting at offset <code>head_list[i]</code>. The offsets are a
+    prefix sum over per-particle capacities that are sized from the neighbor counts of the previous build (plus some
+    headroom for fluctuations and room for the exclusions that filterNlist() removes), so the memory used scales with
+    the actual number of pairs. A particle whose capacity is exceeded triggers the usual overflow handling, which
+    re-sizes the capacities from the true counts and rebuilds the list.
+
+    Code that is to work with both layouts accesses the list through the head list and the stride
+    (getHeadList(), getNListStride()):
+     - <code>jf = nlist[head_list[i] + n*stride]</code>
+
+    In the default (dense) layout <code>head_list[i] = i</code> and the stride is the pitch of the matrix, so this
+    addresses the same element as <code>nlist_indexer(i,n)</code>. The nlist indexer is only valid in the dense layout.
+    Compact storage is only supported on the CPU.
+
     \b Filtering:
 
     By default, a neighbor list includes all particles within a single cutoff distance r_cut. Various filters can be
@@ -130,6 +150,30 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     setEvery takes a dist_check parameter. When dist_check=True, the above described behavior is followed. When
     dist_check is false, the nlist is built exactly m_every steps. This is intended for use in profiling only.
 
+    <b>Buffer tuning:</b>
+
+    enableBufferTuning() tunes r_buff and the check period while the simulation runs. The time steps are divided into
+    windows of a fixed number of steps, and an Autotuner times each window with the wall clock, sweeping r_buff over
+    the given range with the check period set to 1. This measures the total cost of the pair forces and the neighbor
+    list builds for each r_buff. Once a sweep is complete, the fastest r_buff is set and one more window measures the
+    shortest rebuild period, half of which becomes the check period (within the given bound). During production, a
+    new sweep is started when a dangerous build occurs, when the shortest rebuild period doubles or when the average
+    number of neighbors changes by more than 10%, i.e. when the temperature or density have drifted. The Autotuner
+    also sweeps again periodically.
+
+    <b>Incremental updates:</b>
+
+    In systems where only a small fraction of the particles is mobile, a few fast particles would trigger full
+    rebuilds over and over. With setIncremental(), every particle is instead checked against its own last position.
+    The particles that have moved more than a quarter of the buffer distance are collected in \a m_displaced, and
+    buildNlistPartial() rebuilds only the lists of the particles in their cell stencils. Only the displaced particles
+    get a new last position. Rows of the list are then built at different times: a pair (i,j) missing from the list of
+    i was farther apart than r_cut + r_buff when that row was built, and since then either particle has moved less
+    than two quarters of the buffer relative to any earlier reference, so the pair is still beyond r_cut. A box
+    change, a forced update or more than a tenth of the particles displaced at once fall back to a full rebuild.
+    Incremental updates are not available with domain decomposition (ghost particles are re-exchanged on every
+    rebuild) and only supported by NeighborListBinned.
+
     \b Exclusions:
 
     Exclusions are stored in \a ex_list, a data structure similar in structure to \a nlist, except this time exclusions
@@ -199,6 +243,23 @@ class NeighborList : public Compute
             forceUpdate();
             }
 
+        //! Enable/disable compact (CSR) storage of the neighbor list
+        virtual void setCompactStorage(bool compact);
+
+        //! Enable/disable incremental updates of the neighbor list
+        virtual void setIncremental(bool incremental);
+
+        //! Enable online tuning of the buffer distance and the check period
+        void enableBufferTuning(Scalar r_buff_min,
+                                Scalar r_buff_max,
+                                unsigned int n_values,
+                                unsigned int window,
+                                unsigned int max_every,
+                                unsigned int period);
+
+        //! Disable online tuning, keeping the current buffer distance and check period
+        void disableBufferTuning();
+
         // @}
         //! \name Get properties
         // @{
@@ -209,6 +270,30 @@ class NeighborList : public Compute
             return m_storage_mode;
             }
 
+        //! Test if compact storage is enabled
+        bool getCompactStorage()
+            {
+            return m_compact_storage;
+            }
+
+        //! Test if incremental updates are enabled
+        bool getIncremental()
+            {
+            return m_incremental;
+            }
+
+        //! Get the buffer distance added to the cutoff
+        Scalar getRBuff() const
+            {
+            return m_r_buff;
+            }
+
+        //! Get the number of steps between distance checks
+        unsigned int getEvery() const
+            {
+            return m_every;
+            }
+
         // @}
         //! \name Statistics
         // @{
@@ -229,12 +314,14 @@ class NeighborList : public Compute
         //! Get the number of neighbors array
         const GPUArray<unsigned int>& getNNeighArray()
             {
+            requestParticleNlist();
             return m_n_neigh;
             }
 
         //! Get the neighbor list
         const GPUArray<unsigned int>& getNListArray()
             {
+            requestParticleNlist();
             return m_nlist;
             }
 
@@ -256,9 +343,26 @@ class NeighborList : public Compute
         */
         const Index2D& getNListIndexer()
             {
+            requestParticleNlist();
             return m_nlist_indexer;
             }
 
+        //! Get the head list (offset of the first neighbor of each particle in the neighbor list)
+        const GPUArray<unsigned int>& getHeadList()
+            {
+            requestParticleNlist();
+            return m_head_list;
+            }
+
+        //! Get the stride between consecutive neighbors of a particle in the neighbor list
+        /*! \note Like the indexer, the stride may change after every call to compute().
+        */
+        unsigned int getNListStride()
+            {
+            requestParticleNlist();
+            return m_nlist_stride;
+            }
+
         const Index2D& getExListIndexer()
             {
             return m_ex_list_indexer;
@@ -382,9 +486,17 @@ class NeighborList : public Compute
             }
 
         //! Get the number of updates
+        /*! Partial updates count as well, since they also change the list.
+        */
         virtual unsigned int getNumUpdates()
             {
-            return m_updates + m_forced_updates;
+            return m_updates + m_forced_updates + m_partial_updates;
+            }
+
+        //! Get the number of partial updates
+        unsigned int getNumPartialUpdates()
+            {
+            return m_partial_updates;
             }
 
 
@@ -407,7 +519,7 @@ class NeighborList : public Compute
          */
         bool hasBeenUpdated(unsigned int timestep)
             {
-            return m_last_updated_tstep == timestep && m_has_been_updated_once;
+            return (m_last_updated_tstep == timestep || m_last_partial_tstep == timestep) && m_has_been_updated_once;
             }
 
    protected:
@@ -417,15 +529,20 @@ class NeighborList : public Compute
         bool m_filter_body;         //!< Set to true if particles in the same body are to be filtered
         bool m_filter_diameter;     //!< Set to true if particles are to be filtered by diameter (slj style)
         storageMode m_storage_mode; //!< The storage mode
+        bool m_compact_storage;     //!< True if the list is stored in compact (CSR) form
+        bool m_incremental;         //!< True if only the lists around displaced particles are rebuilt
 
         Index2D m_nlist_indexer;             //!< Indexer for accessing the neighbor list
         GPUArray<unsigned int> m_nlist;      //!< Neighbor list data
         GPUArray<unsigned int> m_n_neigh;    //!< Number of neighbors for each particle
+        GPUArray<unsigned int> m_head_list;  //!< Offset of the first neighbor of each particle in m_nlist
+        unsigned int m_nlist_stride;         //!< Stride between consecutive neighbors of a particle in m_nlist
         GPUArray<Scalar4> m_last_pos;        //!< coordinates of last updated particle positions
         Scalar3 m_last_L;                    //!< Box lengths at last update
         Scalar3 m_last_L_local;              //!< Local Box lengths at last update
         unsigned int m_Nmax;                 //!< Maximum number of neighbors that can be held in m_nlist
         GPUFlags<unsigned int> m_conditions; //!< Condition flags set during the buildNlist() call
+        std::vector<unsigned int> m_displaced; //!< Particles that moved too far, for the pending partial update
 
         GPUArray<unsigned int> m_ex_list_tag;  //!< List of excluded particles referenced by tag
         GPUArray<unsigned int> m_ex_list_idx;  //!< List of excluded particles referenced by index
@@ -451,9 +568,30 @@ class NeighborList : public Compute
         //! Updates the previous position table for use in the next distance check
         virtual void setLastUpdatedPos();
 
+        //! Get the capacity of the neighbor list of particle \a i
+        /*! \param head_list Host pointer to the head list
+            \param i Index of the (local) particle
+        */
+        unsigned int getMaxNNeigh(const unsigned int *head_list, unsigned int i) const
+            {
+            return m_compact_storage ? head_list[i+1] - head_list[i] : m_Nmax;
+            }
+
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
 
+        //! Rebuilds the neighbor lists of the particles around the displaced ones
+        /*! \param timestep Current time step
+            \returns false if partial builds are not supported, in which case the whole list is rebuilt
+
+            Derived classes that support incremental updates rebuild (at least) the lists of all particles that are in
+            the cell stencil of a particle in m_displaced, and leave all other lists untouched.
+        */
+        virtual bool buildNlistPartial(unsigned int timestep)
+            {
+            return false;
+            }
+
         //! Updates the idx exlcusion list
         virtual void updateExListIdx();
 
@@ -470,15 +608,35 @@ class NeighborList : public Compute
             }
         #endif
 
+        //! Prepares the per particle list before it is handed out
+        /*! Called by the accessors of the per particle list. Derived classes that build the list on demand override
+            this method.
+        */
+        virtual void requestParticleNlist()
+            {
+            }
+
+        //! Builds the list until it does not overflow and applies the exclusions
+        void rebuildNlist(unsigned int timestep);
+
+        //! Average number of neighbors per particle
+        virtual Scalar getAverageNNeigh();
+
+        //! Print the statistics of the number of neighbors
+        virtual void printNNeighStats();
+
     private:
         int64_t m_updates;              //!< Number of times the neighbor list has been updated
         int64_t m_forced_updates;       //!< Number of times the neighbor list has been foribly updated
         int64_t m_dangerous_updates;    //!< Number of dangerous builds counted
+        int64_t m_partial_updates;      //!< Number of partial (incremental) updates
+        bool m_partial_pending;         //!< True if the last check requested a partial update
         bool m_force_update;            //!< Flag to handle the forcing of neighborlist updates
         bool m_dist_check;              //!< Set to false to disable distance checks (nlist always built m_every steps)
         bool m_has_been_updated_once;   //!< True if the neighbor list has been updated at least once
 
         unsigned int m_last_updated_tstep; //!< Track the last time step we were updated
+        unsigned int m_last_partial_tstep; //!< Track the last time step we were partially updated
         unsigned int m_last_checked_tstep; //!< Track the last time step we have checked
         bool m_last_check_result;          //!< Last result of rebuild check
         unsigned int m_every; //!< No update checks will be performed until m_every steps after the last one
@@ -486,15 +644,40 @@ class NeighborList : public Compute
 
         bool m_want_exclusions;       //!< True if we want updated exclusions
 
+        boost::scoped_ptr<Autotuner> m_buffer_tuner; //!< Autotuner for r_buff, timing windows of m_tune_window steps
+        std::vector<Scalar> m_tune_r_buff;  //!< Values of r_buff to choose from
+        unsigned int m_tune_window;         //!< Number of steps per timed window
+        unsigned int m_tune_max_every;      //!< Upper bound for the tuned check period
+        bool m_tune_window_open;            //!< True if a window has been started
+        bool m_tune_sampling;               //!< True if the current window is timed
+        bool m_tune_probe;                  //!< True if the current window measures the rebuild period
+        unsigned int m_tune_window_start;   //!< Time step at which the current window started
+        unsigned int m_tune_min_period;     //!< Shortest rebuild period in the current window
+        int64_t m_tune_dangerous;           //!< Dangerous updates at the start of the current window
+        unsigned int m_tune_ref_period;     //!< Shortest rebuild period measured after the last sweep
+        Scalar m_tune_ref_n_neigh;          //!< Average number of neighbors after the last sweep
+
+        //! Drive the buffer tuning at the start of a time step
+        void updateBufferTuning(unsigned int timestep);
+
         //! Test if the list needs updating
         bool needsUpdating(unsigned int timestep);
 
+        //! Performs the per-particle distance check of the incremental mode
+        bool incrementalCheck(unsigned int timestep);
+
+        //! Rebuilds the lists around the displaced particles
+        bool updatePartial(unsigned int timestep);
+
         //! Reallocate internal data structures
         void reallocate();
 
         //! Allocate the nlist array
         void allocateNlist();
 
+        //! Size the compact list capacities from the current neighbor counts
+        void updateHeadList();
+
         //! Check the status of the conditions
         bool checkConditions();
 
@@ -58,6 +58,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/python.hpp>
 using namespace boost::python;
 
+#include <boost/bind.hpp>
+using namespace boost;
+
+#include <algorithm>
+#include <vector>
+
 #ifdef ENABLE_MPI
 #include "Communicator.h"
 #endif
@@ -78,6 +84,7 @@ NeighborListBinned::NeighborListBinned(boost::shared_ptr<SystemDefinition> sysde
     m_cl->setRadius(1);
     m_cl->setComputeTDB(false);
     m_cl->setFlagIndex();
+    m_cl->setCompact(true);
     }
 
 NeighborListBinned::~NeighborListBinned()
@@ -101,19 +108,91 @@ void NeighborListBinned::setMaximumDiameter(Scalar d_max)
     m_cl->setNominalWidth(m_r_cut + m_r_buff + m_d_max - Scalar(1.0));
     }
 
+/*! \param incremental Set to true to rebuild only the lists around displaced particles
+*/
+void NeighborListBinned::setIncremental(bool incremental)
+    {
+#ifdef ENABLE_MPI
+    // every rebuild re-exchanges the ghost particles, which invalidates all lists
+    if (incremental && m_pdata->getDomainDecomposition())
+        {
+        m_exec_conf->msg->error() << "nlist: Incremental updates are not supported with domain decomposition" << endl;
+        throw runtime_error("Error setting neighbor list parameters");
+        }
+#endif
+
+    m_incremental = incremental;
+    forceUpdate();
+    }
+
+/*! \param timestep Current time step
+*/
 void NeighborListBinned::buildNlist(unsigned int timestep)
+    {
+    buildNlistCells(timestep, NULL);
+    }
+
+/*! \param timestep Current time step
+    \returns true
+
+    The cell list is recomputed for the current positions, and every cell that contains a displaced particle marks its
+    whole stencil for rebuilding. Since the cell width is at least the neighbor list cutoff, this covers every particle
+    within range of a displaced particle as well as the displaced particles themselves.
+*/
+bool NeighborListBinned::buildNlistPartial(unsigned int timestep)
     {
     m_cl->compute(timestep);
 
-    uint3 dim = m_cl->getDim();
-    Scalar3 ghost_width = m_cl->getGhostWidth();
+    unsigned int n_cells = m_cl->getCellIndexer().getNumElements();
+    std::vector<unsigned char> cell_mask(n_cells, 0);
+
+        {
+        ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_start(m_cl->getCellStartArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_adj(m_cl->getCellAdjArray(), access_location::host, access_mode::read);
+        Index2D cadji = m_cl->getCellAdjIndexer();
+
+        unsigned int N = m_pdata->getN();
+        std::vector<unsigned char> displaced(N, 0);
+        for (unsigned int k = 0; k < m_displaced.size(); k++)
+            displaced[m_displaced[k]] = 1;
+
+        for (unsigned int cell = 0; cell < n_cells; cell++)
+            {
+            for (unsigned int offset = 0; offset < h_cell_size.data[cell]; offset++)
+                {
+                unsigned int i = __scalar_as_int(h_cell_xyzf.data[h_cell_start.data[cell] + offset].w);
+                if (i < N && displaced[i])
+                    {
+                    for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); cur_adj++)
+                        cell_mask[h_cell_adj.data[cadji(cur_adj, cell)]] = 1;
+                    break;
+                    }
+                }
+            }
+        }
+
+    buildNlistCells(timestep, &cell_mask[0]);
+    return true;
+    }
+
+/*! \param timestep Current time step
+    \param cell_mask Nonzero for the cells whose particles get their list rebuilt, or NULL to build the whole list
+
+    The neighbor list is built cell by cell, so that all particles in a cell share the same stencil of neighboring
+    cells. The cells are divided evenly among the threads of the ThreadPool. Every local particle is in exactly one
+    cell, so each neighbor list row is written by a single thread. The body and diameter filters and the storage
+    mode are resolved at compile time to keep the innermost loop free of branches that do not apply.
+*/
+void NeighborListBinned::buildNlistCells(unsigned int timestep, const unsigned char *cell_mask)
+    {
+    m_cl->compute(timestep);
 
     if (m_prof)
         m_prof->push(exec_conf, "compute");
 
-
     // acquire the particle data and box dimension
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
 
@@ -137,92 +216,157 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
 
     // access the cell list data arrays
     ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start(m_cl->getCellStartArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cell_adj(m_cl->getCellAdjArray(), access_location::host, access_mode::read);
 
-    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
-    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+    // a partial build keeps the lists of the cells that are not selected
+    access_mode::Enum mode = cell_mask ? access_mode::readwrite : access_mode::overwrite;
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, mode);
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, mode);
+
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    std::vector<unsigned int> conditions(n_threads, 0);
+
+    build_args args;
+    args.body = h_body.data;
+    args.diameter = h_diameter.data;
+    args.cell_size = h_cell_size.data;
+    args.cell_start = h_cell_start.data;
+    args.cell_xyzf = h_cell_xyzf.data;
+    args.cell_adj = h_cell_adj.data;
+    args.cell_mask = cell_mask;
+    args.head_list = h_head_list.data;
+    args.nlist = h_nlist.data;
+    args.n_neigh = h_n_neigh.data;
+    args.conditions = &conditions[0];
+    args.cadji = m_cl->getCellAdjIndexer();
+    args.n_cells = m_cl->getCellIndexer().getNumElements();
+    args.N = m_pdata->getN();
+    args.box = box;
+    args.rmax = rmax;
+    args.rmaxsq = rmaxsq;
+
+    // pick the specialization for the current filter and storage mode settings
+    ThreadPool::task_type task;
+    bool full_list = (m_storage_mode == full);
+    if (m_filter_body)
+        {
+        if (m_filter_diameter)
+            task = full_list ? bind(&NeighborListBinned::buildNlistThread<true, true, true>, this, _1, boost::cref(args))
+                             : bind(&NeighborListBinned::buildNlistThread<true, true, false>, this, _1, boost::cref(args));
+        else
+            task = full_list ? bind(&NeighborListBinned::buildNlistThread<true, false, true>, this, _1, boost::cref(args))
+                             : bind(&NeighborListBinned::buildNlistThread<true, false, false>, this, _1, boost::cref(args));
+        }
+    else
+        {
+        if (m_filter_diameter)
+            task = full_list ? bind(&NeighborListBinned::buildNlistThread<false, true, true>, this, _1, boost::cref(args))
+                             : bind(&NeighborListBinned::buildNlistThread<false, true, false>, this, _1, boost::cref(args));
+        else
+            task = full_list ? bind(&NeighborListBinned::buildNlistThread<false, false, true>, this, _1, boost::cref(args))
+                             : bind(&NeighborListBinned::buildNlistThread<false, false, false>, this, _1, boost::cref(args));
+        }
 
-    unsigned int conditions = 0;
+    m_exec_conf->getThreadPool().run(task);
 
-    // access indexers
-    Index3D ci = m_cl->getCellIndexer();
-    Index2D cli = m_cl->getCellListIndexer();
-    Index2D cadji = m_cl->getCellAdjIndexer();
+    // write out conditions
+    m_conditions.resetFlags(*std::max_element(conditions.begin(), conditions.end()));
 
-    // get periodic flags
-    uchar3 periodic = box.getPeriodic();
+    if (m_prof)
+        m_prof->pop(exec_conf);
+    }
 
-    // for each local particle
-    unsigned int nparticles = m_pdata->getN();
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
 
-    for (int i = 0; i < (int)nparticles; i++)
+    \tparam filter_body True if particles in the same body are excluded
+    \tparam filter_diameter True if the cutoff is shifted by the particle diameters
+    \tparam full True if a full neighbor list is built, false for a half list
+*/
+template<bool filter_body, bool filter_diameter, bool full>
+void NeighborListBinned::buildNlistThread(unsigned int thread_idx, const build_args& args)
+    {
+    unsigned int first_cell, last_cell;
+    ThreadPool::getRange(args.n_cells, thread_idx, m_exec_conf->getNumThreads(), first_cell, last_cell);
+
+    const BoxDim& box = args.box;
+    const unsigned int n_adj = args.cadji.getW();
+    const unsigned int nlist_stride = m_nlist_stride;
+
+    unsigned int conditions = 0;
+
+    for (unsigned int my_cell = first_cell; my_cell < last_cell; my_cell++)
         {
-        unsigned int cur_n_neigh = 0;
-
-        Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int bodyi = h_body.data[i];
-        Scalar di = h_diameter.data[i];
-
-        // find the bin each particle belongs in
-        Scalar3 f = box.makeFraction(my_pos,ghost_width);
-        int ib = (unsigned int)(f.x * dim.x);
-        int jb = (unsigned int)(f.y * dim.y);
-        int kb = (unsigned int)(f.z * dim.z);
-
-        // need to handle the case where the particle is exactly at the box hi
-        if (ib == (int)dim.x && periodic.x)
-            ib = 0;
-        if (jb == (int)dim.y && periodic.y)
-            jb = 0;
-        if (kb == (int)dim.z && periodic.z)
-            kb = 0;
-
-        // identify the bin
-        unsigned int my_cell = ci(ib,jb,kb);
-
-        // loop through all neighboring bins
-        for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); cur_adj++)
+        unsigned int my_size = args.cell_size[my_cell];
+        if (my_size == 0 || (args.cell_mask && !args.cell_mask[my_cell]))
+            continue;
+
+        // the stencil of neighboring cells is shared by all particles in this cell
+        const unsigned int *my_adj = args.cell_adj + args.cadji(0, my_cell);
+
+        for (unsigned int my_offset = 0; my_offset < my_size; my_offset++)
             {
-            unsigned int neigh_cell = h_cell_adj.data[cadji(cur_adj, my_cell)];
+            const Scalar4& my_xyzf = args.cell_xyzf[args.cell_start[my_cell] + my_offset];
+            unsigned int i = __scalar_as_int(my_xyzf.w);
 
-            // check against all the particles in that neighboring bin to see if it is a neighbor
-            unsigned int size = h_cell_size.data[neigh_cell];
-            for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+            // only local particles get a neighbor list
+            if (i >= args.N)
+                continue;
+
+            unsigned int cur_n_neigh = 0;
+            const unsigned int head_i = args.head_list[i];
+            const unsigned int max_n_neigh = getMaxNNeigh(args.head_list, i);
+
+            Scalar3 my_pos = make_scalar3(my_xyzf.x, my_xyzf.y, my_xyzf.z);
+            unsigned int bodyi = filter_body ? args.body[i] : NO_BODY;
+            Scalar di = filter_diameter ? args.diameter[i] : Scalar(0.0);
+
+            // loop through all neighboring bins
+            for (unsigned int cur_adj = 0; cur_adj < n_adj; cur_adj++)
                 {
-                Scalar4& cur_xyzf = h_cell_xyzf.data[cli(cur_offset, neigh_cell)];
-                unsigned int cur_neigh = __scalar_as_int(cur_xyzf.w);
+                unsigned int neigh_cell = my_adj[cur_adj];
 
-                Scalar3 neigh_pos = make_scalar3(cur_xyzf.x, cur_xyzf.y, cur_xyzf.z);
+                // check against all the particles in that neighboring bin to see if it is a neighbor
+                unsigned int size = args.cell_size[neigh_cell];
+                for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                    {
+                    const Scalar4& cur_xyzf = args.cell_xyzf[args.cell_start[neigh_cell] + cur_offset];
+                    unsigned int cur_neigh = __scalar_as_int(cur_xyzf.w);
 
-                Scalar3 dx = my_pos - neigh_pos;
+                    // in a half list, only the particle with the lower index stores the pair
+                    if (!full && cur_neigh <= i)
+                        continue;
 
-                dx = box.minImage(dx);
+                    Scalar3 neigh_pos = make_scalar3(cur_xyzf.x, cur_xyzf.y, cur_xyzf.z);
 
-                bool excluded = (i == (int)cur_neigh);
+                    Scalar3 dx = my_pos - neigh_pos;
 
-                if (m_filter_body && bodyi != NO_BODY)
-                    excluded = excluded | (bodyi == h_body.data[cur_neigh]);
+                    dx = box.minImage(dx);
 
-                Scalar sqshift = Scalar(0.0);
-                if (m_filter_diameter)
-                    {
-                    // compute the shift in radius to accept neighbors based on their diameters
-                    Scalar delta = (di + h_diameter.data[cur_neigh]) * Scalar(0.5) - Scalar(1.0);
-                    // r^2 < (r_max + delta)^2
-                    // r^2 < r_maxsq + delta^2 + 2*r_max*delta
-                    sqshift = (delta + Scalar(2.0) * rmax) * delta;
-                    }
+                    bool excluded = (i == cur_neigh);
 
-                Scalar dr_sq = dot(dx,dx);
+                    if (filter_body && bodyi != NO_BODY)
+                        excluded = excluded | (bodyi == args.body[cur_neigh]);
 
-                if (dr_sq <= (rmaxsq + sqshift) && !excluded)
-                    {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    Scalar sqshift = Scalar(0.0);
+                    if (filter_diameter)
                         {
-                        // local neighbor
-                        if (cur_n_neigh < m_nlist_indexer.getH())
-                            h_nlist.data[m_nlist_indexer(i, cur_n_neigh)] = cur_neigh;
+                        // compute the shift in radius to accept neighbors based on their diameters
+                        Scalar delta = (di + args.diameter[cur_neigh]) * Scalar(0.5) - Scalar(1.0);
+                        // r^2 < (r_max + delta)^2
+                        // r^2 < r_maxsq + delta^2 + 2*r_max*delta
+                        sqshift = (delta + Scalar(2.0) * args.rmax) * delta;
+                        }
+
+                    Scalar dr_sq = dot(dx,dx);
+
+                    if (dr_sq <= (args.rmaxsq + sqshift) && !excluded)
+                        {
+                        if (cur_n_neigh < max_n_neigh)
+                            args.nlist[head_i + cur_n_neigh*nlist_stride] = cur_neigh;
                         else
                             conditions = max(conditions, cur_n_neigh+1);
 
@@ -230,16 +374,12 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                         }
                     }
                 }
-            }
 
-        h_n_neigh.data[i] = cur_n_neigh;
+            args.n_neigh[i] = cur_n_neigh;
+            }
         }
 
-    // write out conditions
-    m_conditions.resetFlags(conditions);
-
-    if (m_prof)
-        m_prof->pop(exec_conf);
+    args.conditions[thread_idx] = conditions;
     }
 
 void export_NeighborListBinned()
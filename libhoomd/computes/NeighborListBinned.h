@@ -86,11 +86,46 @@ class NeighborListBinned : public NeighborList
         //! Set the maximum diameter to use in computing neighbor lists
         virtual void setMaximumDiameter(Scalar d_max);
 
+        //! Enable/disable incremental updates of the neighbor list
+        virtual void setIncremental(bool incremental);
+
     protected:
         boost::shared_ptr<CellList> m_cl;   //!< The cell list
 
+        //! Pointers to the input and output arrays of the neighbor list build, shared by all threads
+        struct build_args
+            {
+            const unsigned int *body;       //!< Body index of each particle
+            const Scalar *diameter;         //!< Diameter of each particle
+            const unsigned int *cell_size;  //!< Number of particles in each cell
+            const unsigned int *cell_start; //!< Offset of the first particle of each cell in the cell list
+            const Scalar4 *cell_xyzf;       //!< Positions and indices of the particles in each cell
+            const unsigned int *cell_adj;   //!< Cell adjacency list
+            const unsigned char *cell_mask; //!< Nonzero for the cells whose particles are rebuilt (NULL for all)
+            const unsigned int *head_list;  //!< Offset of the first neighbor of each particle in the neighbor list
+            unsigned int *nlist;            //!< Neighbor list (output)
+            unsigned int *n_neigh;          //!< Number of neighbors (output)
+            unsigned int *conditions;       //!< Overflow condition of each thread (output)
+            Index2D cadji;                  //!< Indexer for the cell adjacency list
+            unsigned int n_cells;           //!< Total number of cells
+            unsigned int N;                 //!< Number of local particles
+            BoxDim box;                     //!< Local simulation box
+            Scalar rmax;                    //!< Maximum distance for neighbors
+            Scalar rmaxsq;                  //!< Square of rmax
+            };
+
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
+
+        //! Rebuilds the neighbor lists of the particles around the displaced ones
+        virtual bool buildNlistPartial(unsigned int timestep);
+
+        //! Builds the neighbor lists of the particles in the selected cells
+        void buildNlistCells(unsigned int timestep, const unsigned char *cell_mask);
+
+        //! Builds the neighbor lists of the particles in the cells assigned to one thread
+        template<bool filter_body, bool filter_diameter, bool full>
+        void buildNlistThread(unsigned int thread_idx, const build_args& args);
     };
 
 //! Exports NeighborListBinned to python
@@ -0,0 +1,600 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Maintainer: joaander
+
+/*! \file NeighborListCluster.cc
+    \brief Defines NeighborListCluster
+*/
+
+#include "NeighborListCluster.h"
+
+#include <boost/python.hpp>
+using namespace boost::python;
+
+#include <boost/bind.hpp>
+using namespace boost;
+
+#include <algorithm>
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#endif
+
+//! Orders particles along the z direction
+static bool compare_z(const Scalar4& a, const Scalar4& b)
+    {
+    return a.z < b.z;
+    }
+
+//! Orders particles along the y direction (used in 2D)
+static bool compare_y(const Scalar4& a, const Scalar4& b)
+    {
+    return a.y < b.y;
+    }
+
+//! Tests if the pair of clusters I and J is stored in the row of I
+/*! Of two different clusters, the lower index stores the pair if the sum of the indices is even, the higher index
+    otherwise. Clusters have neighbors with lower and higher indices, so every row holds about half of its pairs and
+    the width of the list (the largest row) is halved as well. Storing all J > I in row I would leave the first rows
+    of each region with almost all of their neighbors.
+*/
+static inline bool store_cluster_pair(unsigned int I, unsigned int J)
+    {
+    return J == I || (I < J) == ((I + J) % 2 == 0);
+    }
+
+//! Tests if the bounding boxes of two clusters are closer than the list cutoff
+static inline bool clusters_overlap(const BoxDim& box,
+                                    const Scalar4& center_I,
+                                    const Scalar4& extent_I,
+                                    const Scalar4& center_J,
+                                    const Scalar4& extent_J,
+                                    Scalar rlistsq)
+    {
+    Scalar3 dc = box.minImage(make_scalar3(center_I.x - center_J.x,
+                                           center_I.y - center_J.y,
+                                           center_I.z - center_J.z));
+
+    // distance between the bounding boxes along each direction
+    Scalar3 d = make_scalar3(max(fabs(dc.x) - extent_I.x - extent_J.x, Scalar(0.0)),
+                             max(fabs(dc.y) - extent_I.y - extent_J.y, Scalar(0.0)),
+                             max(fabs(dc.z) - extent_I.z - extent_J.z, Scalar(0.0)));
+
+    return dot(d, d) <= rlistsq;
+    }
+
+NeighborListCluster::NeighborListCluster(boost::shared_ptr<SystemDefinition> sysdef,
+                                         Scalar r_cut,
+                                         Scalar r_buff,
+                                         boost::shared_ptr<CellList> cl)
+    : NeighborListBinned(sysdef, r_cut, r_buff, cl), m_particle_nlist_requested(false), m_particle_nlist_built(false),
+      m_last_build_tstep(0), m_n_clusters(0), m_cluster_Nmax(32)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListCluster" << endl;
+    }
+
+NeighborListCluster::~NeighborListCluster()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListCluster" << endl;
+    }
+
+/*! \param timestep Current time step
+
+    The build proceeds in passes over the cells, all divided among the threads of the ThreadPool. The first pass
+    sorts the particles of each cell into clusters and computes their bounding boxes. The second pass finds the
+    neighbor clusters of every cluster with the cell stencil. If the cluster neighbor list overflows, it is grown and
+    the second pass is repeated. Once a consumer has requested the per particle neighbor list, a third pass derives
+    it from the clusters.
+*/
+void NeighborListCluster::buildNlist(unsigned int timestep)
+    {
+    m_cl->compute(timestep);
+    m_last_build_tstep = timestep;
+
+    if (m_prof)
+        m_prof->push(exec_conf, "compute");
+
+    // acquire the particle data and box dimension
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+    Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
+
+    // start by creating a temporary copy of r_cut sqaured
+    Scalar rmax = m_r_cut + m_r_buff;
+    // add d_max - 1.0, if diameter filtering is not already taking care of it
+    if (!m_filter_diameter)
+        rmax += m_d_max - Scalar(1.0);
+    Scalar rmaxsq = rmax*rmax;
+
+    // clusters are neighbors if any pair of their particles may be, including the largest diameter shift
+    Scalar rlist = m_r_cut + m_r_buff + m_d_max - Scalar(1.0);
+
+    if ((box.getPeriodic().x && nearest_plane_distance.x <= rmax * 2.0) ||
+        (box.getPeriodic().y && nearest_plane_distance.y <= rmax * 2.0) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && nearest_plane_distance.z <= rmax * 2.0))
+        {
+        m_exec_conf->msg->error() << "nlist: Simulation box is too small! Particles would be interacting with themselves." << endl;
+        throw runtime_error("Error updating neighborlist bins");
+        }
+
+    // access the cell list data arrays
+    ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start(m_cl->getCellStartArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_adj(m_cl->getCellAdjArray(), access_location::host, access_mode::read);
+
+    // count the clusters in each cell
+    unsigned int n_cells = m_cl->getCellIndexer().getNumElements();
+    m_cell_first_cluster.resize(n_cells+1);
+    unsigned int n_clusters = 0;
+    for (unsigned int cell = 0; cell < n_cells; cell++)
+        {
+        m_cell_first_cluster[cell] = n_clusters;
+        n_clusters += (h_cell_size.data[cell] + NLIST_CLUSTER_SIZE - 1) / NLIST_CLUSTER_SIZE;
+        }
+    m_cell_first_cluster[n_cells] = n_clusters;
+    m_n_clusters = n_clusters;
+
+    // grow the per cluster arrays if needed
+    if (m_cluster_center.getNumElements() < n_clusters)
+        {
+        GPUArray<unsigned int> cluster_idx(n_clusters*NLIST_CLUSTER_SIZE, exec_conf);
+        m_cluster_idx.swap(cluster_idx);
+        GPUArray<Scalar4> cluster_center(n_clusters, exec_conf);
+        m_cluster_center.swap(cluster_center);
+        GPUArray<Scalar4> cluster_extent(n_clusters, exec_conf);
+        m_cluster_extent.swap(cluster_extent);
+        GPUArray<unsigned int> cluster_n_neigh(n_clusters, exec_conf);
+        m_cluster_n_neigh.swap(cluster_n_neigh);
+        }
+
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    std::vector<unsigned int> conditions(n_threads, 0);
+    std::vector<unsigned int> cluster_conditions(n_threads, 0);
+
+    cluster_args args;
+    args.pos = h_pos.data;
+    args.body = h_body.data;
+    args.diameter = h_diameter.data;
+    args.cell_size = h_cell_size.data;
+    args.cell_start = h_cell_start.data;
+    args.cell_xyzf = h_cell_xyzf.data;
+    args.cell_adj = h_cell_adj.data;
+    args.cell_first_cluster = &m_cell_first_cluster[0];
+    args.conditions = &conditions[0];
+    args.cluster_conditions = &cluster_conditions[0];
+    args.cadji = m_cl->getCellAdjIndexer();
+    args.n_cells = n_cells;
+    args.N = m_pdata->getN();
+    args.box = box;
+    args.rmax = rmax;
+    args.rmaxsq = rmaxsq;
+    args.rlistsq = rlist*rlist;
+    args.filter_body = m_filter_body;
+    args.filter_diameter = m_filter_diameter;
+    args.full = (m_storage_mode == full);
+
+    ArrayHandle<unsigned int> h_cluster_idx(m_cluster_idx, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_cluster_center(m_cluster_center, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_cluster_extent(m_cluster_extent, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cluster_n_neigh(m_cluster_n_neigh, access_location::host, access_mode::overwrite);
+    args.cluster_idx = h_cluster_idx.data;
+    args.cluster_center = h_cluster_center.data;
+    args.cluster_extent = h_cluster_extent.data;
+    args.cluster_n_neigh = h_cluster_n_neigh.data;
+
+    m_exec_conf->getThreadPool().run(bind(&NeighborListCluster::formClustersThread, this, _1, boost::cref(args)));
+
+    // build the cluster list until there is no overflow
+    bool overflowed = false;
+    do
+        {
+        if (m_cluster_nlist.getNumElements() < n_clusters*m_cluster_Nmax)
+            {
+            GPUArray<unsigned int> cluster_nlist(n_clusters*m_cluster_Nmax, exec_conf);
+            m_cluster_nlist.swap(cluster_nlist);
+            }
+        m_cluster_nlist_indexer = Index2D(m_cluster_Nmax, n_clusters);
+
+        ArrayHandle<unsigned int> h_cluster_nlist(m_cluster_nlist, access_location::host, access_mode::overwrite);
+        args.cluster_nlist = h_cluster_nlist.data;
+
+        m_exec_conf->getThreadPool().run(bind(&NeighborListCluster::buildClusterNlistThread, this, _1, boost::cref(args)));
+
+        unsigned int cluster_Nmax = *std::max_element(cluster_conditions.begin(), cluster_conditions.end());
+        overflowed = cluster_Nmax > m_cluster_Nmax;
+        if (overflowed)
+            {
+            // round up to a multiple of 8 to avoid repeated small reallocations
+            m_cluster_Nmax = (cluster_Nmax + 7) & ~7;
+            m_exec_conf->msg->notice(6) << "nlist: (Re-)allocating cluster neighbor list, new size " << m_cluster_Nmax
+                                        << " clusters" << endl;
+            std::fill(cluster_conditions.begin(), cluster_conditions.end(), 0);
+            }
+        } while (overflowed);
+
+    if (m_particle_nlist_requested)
+        {
+        ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
+        args.head_list = h_head_list.data;
+        args.nlist = h_nlist.data;
+        args.n_neigh = h_n_neigh.data;
+
+        m_exec_conf->getThreadPool().run(bind(&NeighborListCluster::buildParticleNlistThread, this, _1, boost::cref(args)));
+        }
+    m_particle_nlist_built = m_particle_nlist_requested;
+
+    // write out conditions
+    m_conditions.resetFlags(*std::max_element(conditions.begin(), conditions.end()));
+
+    if (m_prof)
+        m_prof->pop(exec_conf);
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void NeighborListCluster::formClustersThread(unsigned int thread_idx, const cluster_args& args)
+    {
+    unsigned int first_cell, last_cell;
+    ThreadPool::getRange(args.n_cells, thread_idx, m_exec_conf->getNumThreads(), first_cell, last_cell);
+
+    bool (*compare)(const Scalar4&, const Scalar4&) = (m_sysdef->getNDimensions() == 2) ? compare_y : compare_z;
+    std::vector<Scalar4> sorted;
+
+    for (unsigned int cell = first_cell; cell < last_cell; cell++)
+        {
+        unsigned int size = args.cell_size[cell];
+        if (size == 0)
+            continue;
+
+        // sort the particles of this cell so that the clusters are compact
+        const Scalar4 *cell_xyzf = args.cell_xyzf + args.cell_start[cell];
+        sorted.assign(cell_xyzf, cell_xyzf + size);
+        std::sort(sorted.begin(), sorted.end(), compare);
+
+        unsigned int first_cluster = args.cell_first_cluster[cell];
+        unsigned int n_cell_clusters = args.cell_first_cluster[cell+1] - first_cluster;
+        for (unsigned int k = 0; k < n_cell_clusters; k++)
+            {
+            unsigned int cluster = first_cluster + k;
+            Scalar3 lo = make_scalar3(sorted[k*NLIST_CLUSTER_SIZE].x,
+                                      sorted[k*NLIST_CLUSTER_SIZE].y,
+                                      sorted[k*NLIST_CLUSTER_SIZE].z);
+            Scalar3 hi = lo;
+            bool has_local = false;
+
+            for (unsigned int a = 0; a < NLIST_CLUSTER_SIZE; a++)
+                {
+                unsigned int offset = k*NLIST_CLUSTER_SIZE + a;
+                if (offset >= size)
+                    {
+                    args.cluster_idx[cluster*NLIST_CLUSTER_SIZE + a] = NLIST_CLUSTER_EMPTY;
+                    continue;
+                    }
+
+                const Scalar4& xyzf = sorted[offset];
+                unsigned int idx = __scalar_as_int(xyzf.w);
+                args.cluster_idx[cluster*NLIST_CLUSTER_SIZE + a] = idx;
+                has_local = has_local || (idx < args.N);
+
+                lo.x = min(lo.x, xyzf.x); hi.x = max(hi.x, xyzf.x);
+                lo.y = min(lo.y, xyzf.y); hi.y = max(hi.y, xyzf.y);
+                lo.z = min(lo.z, xyzf.z); hi.z = max(hi.z, xyzf.z);
+                }
+
+            args.cluster_center[cluster] = make_scalar4((lo.x + hi.x) * Scalar(0.5),
+                                                        (lo.y + hi.y) * Scalar(0.5),
+                                                        (lo.z + hi.z) * Scalar(0.5),
+                                                        has_local ? Scalar(1.0) : Scalar(0.0));
+            args.cluster_extent[cluster] = make_scalar4((hi.x - lo.x) * Scalar(0.5),
+                                                        (hi.y - lo.y) * Scalar(0.5),
+                                                        (hi.z - lo.z) * Scalar(0.5),
+                                                        Scalar(0.0));
+            }
+        }
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+
+    Every pair of clusters is stored once, see store_cluster_pair(). Every cluster is in exactly one cell, so each
+    row is written by a single thread.
+*/
+void NeighborListCluster::buildClusterNlistThread(unsigned int thread_idx, const cluster_args& args)
+    {
+    unsigned int first_cell, last_cell;
+    ThreadPool::getRange(args.n_cells, thread_idx, m_exec_conf->getNumThreads(), first_cell, last_cell);
+
+    const unsigned int n_adj = args.cadji.getW();
+    const Index2D& cnli = m_cluster_nlist_indexer;
+    const unsigned int cluster_Nmax = cnli.getW();
+
+    unsigned int cluster_conditions = 0;
+
+    for (unsigned int my_cell = first_cell; my_cell < last_cell; my_cell++)
+        {
+        const unsigned int *my_adj = args.cell_adj + args.cadji(0, my_cell);
+
+        for (unsigned int I = args.cell_first_cluster[my_cell]; I < args.cell_first_cluster[my_cell+1]; I++)
+            {
+            Scalar4 center_I = args.cluster_center[I];
+            Scalar4 extent_I = args.cluster_extent[I];
+            bool local_I = center_I.w != Scalar(0.0);
+
+            // find all clusters with overlapping (bounding box + r_list) in the neighboring cells
+            unsigned int n_neigh_clusters = 0;
+            for (unsigned int cur_adj = 0; cur_adj < n_adj; cur_adj++)
+                {
+                unsigned int neigh_cell = my_adj[cur_adj];
+                for (unsigned int J = args.cell_first_cluster[neigh_cell]; J < args.cell_first_cluster[neigh_cell+1]; J++)
+                    {
+                    if (!store_cluster_pair(I, J))
+                        continue;
+
+                    Scalar4 center_J = args.cluster_center[J];
+
+                    // pairs between ghost particles are never needed
+                    if (!local_I && center_J.w == Scalar(0.0))
+                        continue;
+
+                    if (clusters_overlap(args.box, center_I, extent_I, center_J, args.cluster_extent[J], args.rlistsq))
+                        {
+                        if (n_neigh_clusters < cluster_Nmax)
+                            args.cluster_nlist[cnli(n_neigh_clusters, I)] = J;
+                        n_neigh_clusters++;
+                        }
+                    }
+                }
+
+            args.cluster_n_neigh[I] = n_neigh_clusters;
+
+            // the list will be rebuilt with more memory
+            if (n_neigh_clusters > cluster_Nmax)
+                cluster_conditions = max(cluster_conditions, n_neigh_clusters);
+            }
+        }
+
+    args.cluster_conditions[thread_idx] = cluster_conditions;
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+
+    The per particle neighbor list of a local particle only needs to look at the particles of the clusters that
+    overlap its own cluster. The cluster list only holds half of them, so the overlapping clusters are searched again
+    with the cell stencil. Every local particle is in exactly one cluster, so each row is written by a single thread.
+*/
+void NeighborListCluster::buildParticleNlistThread(unsigned int thread_idx, const cluster_args& args)
+    {
+    unsigned int first_cell, last_cell;
+    ThreadPool::getRange(args.n_cells, thread_idx, m_exec_conf->getNumThreads(), first_cell, last_cell);
+
+    const BoxDim& box = args.box;
+    const unsigned int n_adj = args.cadji.getW();
+    const unsigned int nlist_stride = m_nlist_stride;
+
+    unsigned int conditions = 0;
+    std::vector<unsigned int> neigh_clusters;
+
+    for (unsigned int my_cell = first_cell; my_cell < last_cell; my_cell++)
+        {
+        const unsigned int *my_adj = args.cell_adj + args.cadji(0, my_cell);
+
+        for (unsigned int I = args.cell_first_cluster[my_cell]; I < args.cell_first_cluster[my_cell+1]; I++)
+            {
+            Scalar4 center_I = args.cluster_center[I];
+            Scalar4 extent_I = args.cluster_extent[I];
+            if (center_I.w == Scalar(0.0))
+                continue;
+
+            neigh_clusters.clear();
+            for (unsigned int cur_adj = 0; cur_adj < n_adj; cur_adj++)
+                {
+                unsigned int neigh_cell = my_adj[cur_adj];
+                for (unsigned int J = args.cell_first_cluster[neigh_cell]; J < args.cell_first_cluster[neigh_cell+1]; J++)
+                    if (clusters_overlap(box, center_I, extent_I, args.cluster_center[J], args.cluster_extent[J], args.rlistsq))
+                        neigh_clusters.push_back(J);
+                }
+
+            // derive the per particle neighbor lists of the local particles in this cluster
+            for (unsigned int a = 0; a < NLIST_CLUSTER_SIZE; a++)
+                {
+                unsigned int i = args.cluster_idx[I*NLIST_CLUSTER_SIZE + a];
+                if (i == NLIST_CLUSTER_EMPTY || i >= args.N)
+                    continue;
+
+                Scalar3 my_pos = make_scalar3(args.pos[i].x, args.pos[i].y, args.pos[i].z);
+                unsigned int bodyi = args.filter_body ? args.body[i] : NO_BODY;
+                Scalar di = args.filter_diameter ? args.diameter[i] : Scalar(0.0);
+
+                unsigned int cur_n_neigh = 0;
+                const unsigned int head_i = args.head_list[i];
+                const unsigned int max_n_neigh = getMaxNNeigh(args.head_list, i);
+                for (unsigned int k = 0; k < neigh_clusters.size(); k++)
+                    {
+                    unsigned int J = neigh_clusters[k];
+                    for (unsigned int b = 0; b < NLIST_CLUSTER_SIZE; b++)
+                        {
+                        unsigned int cur_neigh = args.cluster_idx[J*NLIST_CLUSTER_SIZE + b];
+                        if (cur_neigh == NLIST_CLUSTER_EMPTY || cur_neigh == i)
+                            continue;
+
+                        // in a half list, only the particle with the lower index stores the pair
+                        if (!args.full && cur_neigh < i)
+                            continue;
+
+                        Scalar3 neigh_pos = make_scalar3(args.pos[cur_neigh].x, args.pos[cur_neigh].y, args.pos[cur_neigh].z);
+                        Scalar3 dx = box.minImage(my_pos - neigh_pos);
+
+                        bool excluded = false;
+                        if (args.filter_body && bodyi != NO_BODY)
+                            excluded = (bodyi == args.body[cur_neigh]);
+
+                        Scalar sqshift = Scalar(0.0);
+                        if (args.filter_diameter)
+                            {
+                            // compute the shift in radius to accept neighbors based on their diameters
+                            Scalar delta = (di + args.diameter[cur_neigh]) * Scalar(0.5) - Scalar(1.0);
+                            sqshift = (delta + Scalar(2.0) * args.rmax) * delta;
+                            }
+
+                        Scalar dr_sq = dot(dx,dx);
+
+                        if (dr_sq <= (args.rmaxsq + sqshift) && !excluded)
+                            {
+                            if (cur_n_neigh < max_n_neigh)
+                                args.nlist[head_i + cur_n_neigh*nlist_stride] = cur_neigh;
+                            else
+                                conditions = max(conditions, cur_n_neigh+1);
+
+                            cur_n_neigh++;
+                            }
+                        }
+                    }
+
+                args.n_neigh[i] = cur_n_neigh;
+                }
+            }
+        }
+
+    args.conditions[thread_idx] = conditions;
+    }
+
+void NeighborListCluster::filterNlist()
+    {
+    if (m_particle_nlist_built)
+        NeighborList::filterNlist();
+    }
+
+/*! The list of the last update has no per particle list. It is rebuilt right away, from the current positions, so
+    that the caller gets a list that is valid for this time step. All later updates include the per particle list.
+*/
+void NeighborListCluster::requestParticleNlist()
+    {
+    if (m_particle_nlist_requested)
+        return;
+
+    m_particle_nlist_requested = true;
+    if (!m_cell_first_cluster.empty())
+        {
+        m_exec_conf->msg->notice(6) << "nlist: Building the per particle list on request" << endl;
+
+        // the particles may have moved since the cell list was computed
+        m_cl->forceCompute(m_last_build_tstep);
+        rebuildNlist(m_last_build_tstep);
+        setLastUpdatedPos();
+        }
+    }
+
+/*! \returns The average number of neighbors per local particle
+
+    Without the per particle list, the number of particle pairs in the neighbor clusters is returned, which is the
+    work done by the cluster kernel.
+*/
+Scalar NeighborListCluster::getAverageNNeigh()
+    {
+    if (m_particle_nlist_built)
+        return NeighborList::getAverageNNeigh();
+
+    unsigned int N = m_pdata->getN();
+    if (N == 0)
+        return Scalar(0.0);
+
+    ArrayHandle<unsigned int> h_cluster_n_neigh(m_cluster_n_neigh, access_location::host, access_mode::read);
+
+    // every stored cluster pair holds NLIST_CLUSTER_SIZE^2 particle pairs, each counted for both particles
+    Scalar n_pairs = Scalar(0.0);
+    for (unsigned int I = 0; I < m_n_clusters; I++)
+        n_pairs += Scalar(h_cluster_n_neigh.data[I]);
+
+    return Scalar(2.0) * n_pairs * Scalar(NLIST_CLUSTER_SIZE*NLIST_CLUSTER_SIZE) / Scalar(N);
+    }
+
+/*! Without the per particle list, the statistics of the cluster list are printed instead.
+*/
+void NeighborListCluster::printNNeighStats()
+    {
+    if (m_particle_nlist_built)
+        {
+        NeighborList::printNNeighStats();
+        return;
+        }
+
+    ArrayHandle<unsigned int> h_cluster_n_neigh(m_cluster_n_neigh, access_location::host, access_mode::read);
+
+    unsigned int n_min = m_n_clusters > 0 ? 0xffffffff : 0;
+    unsigned int n_max = 0;
+    Scalar n_avg = 0.0;
+    for (unsigned int I = 0; I < m_n_clusters; I++)
+        {
+        unsigned int n = h_cluster_n_neigh.data[I];
+        n_min = min(n_min, n);
+        n_max = max(n_max, n);
+        n_avg += Scalar(n);
+        }
+    if (m_n_clusters > 0)
+        n_avg /= Scalar(m_n_clusters);
+
+    m_exec_conf->msg->notice(1) << m_n_clusters << " clusters / n_cluster_neigh_min: " << n_min
+                                << " / n_cluster_neigh_max: " << n_max << " / n_cluster_neigh_avg: " << n_avg << endl;
+    }
+
+void export_NeighborListCluster()
+    {
+    class_<NeighborListCluster, boost::shared_ptr<NeighborListCluster>, bases<NeighborListBinned>, boost::noncopyable >
+                     ("NeighborListCluster", init< boost::shared_ptr<SystemDefinition>, Scalar, Scalar, boost::shared_ptr<CellList> >())
+                     .def("getNClusters", &NeighborListCluster::getNClusters)
+                     ;
+    }
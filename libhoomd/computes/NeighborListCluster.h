@@ -0,0 +1,229 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Maintainer: joaander
+
+#include "NeighborListBinned.h"
+
+#include <vector>
+
+/*! \file NeighborListCluster.h
+    \brief Declares the NeighborListCluster class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __NEIGHBORLISTCLUSTER_H__
+#define __NEIGHBORLISTCLUSTER_H__
+
+//! Number of particles in a cluster of NeighborListCluster
+const unsigned int NLIST_CLUSTER_SIZE = 4;
+
+//! Marks an empty slot in a cluster
+const unsigned int NLIST_CLUSTER_EMPTY = 0xffffffff;
+
+//! Verlet cluster neighbor list on the CPU
+/*! The particles in each cell of the CellList are sorted along z and grouped into clusters of NLIST_CLUSTER_SIZE
+    consecutive particles. Every cluster gets an axis aligned bounding box. Two clusters are neighbors when the
+    distance between their bounding boxes is less than r_cut + r_buff (+ d_max - 1). Independent of the storage mode,
+    every pair of neighboring clusters is stored once, in the row of either cluster, and every cluster I stores
+    itself. The pairs are split evenly between the two clusters, so the rows of all clusters have about the same
+    length.
+
+    <b>Data access:</b>
+    - getNClusters() is the number of clusters.
+    - <code>cluster_idx[I*NLIST_CLUSTER_SIZE + a]</code> is the index of particle \a a of cluster \a I, or
+      NLIST_CLUSTER_EMPTY for the unused slots of the last cluster of a cell.
+    - <code>cluster_nlist[cluster_nli(k, I)]</code> is neighbor cluster \a k of cluster \a I, where \a k can vary
+      from 0 to <code>cluster_n_neigh[I] - 1</code>. The neighbors of a cluster are contiguous in memory.
+
+    Clusters may contain both local and ghost particles. Pairs of clusters that contain only ghost particles are not
+    stored. Exclusions and filters are not applied to the cluster list, consumers must mask those pairs themselves.
+
+    PotentialPair evaluates the NLIST_CLUSTER_SIZE x NLIST_CLUSTER_SIZE pairs of two clusters with a single call to
+    the batch interface of the evaluator, see PairEvaluatorBatch. The per particle neighbor list is only built for
+    other consumers: the first access through getNListArray() and the other accessors rebuilds the list with the per
+    particle list from the current positions, and every later update includes it. A simulation where the cluster
+    kernel is the only consumer never allocates the per particle list beyond its initial size.
+
+    \ingroup computes
+*/
+class NeighborListCluster : public NeighborListBinned
+    {
+    public:
+        //! Constructs the compute
+        NeighborListCluster(boost::shared_ptr<SystemDefinition> sysdef,
+                            Scalar r_cut,
+                            Scalar r_buff,
+                            boost::shared_ptr<CellList> cl = boost::shared_ptr<CellList>());
+
+        //! Destructor
+        virtual ~NeighborListCluster();
+
+        //! Incremental updates are not supported, a partial build would leave the cluster list stale
+        virtual void setIncremental(bool incremental)
+            {
+            NeighborList::setIncremental(incremental);
+            }
+
+        //! \name Get data
+        // @{
+
+        //! Get the number of clusters
+        unsigned int getNClusters()
+            {
+            return m_n_clusters;
+            }
+
+        //! Get the particle indices of the clusters
+        const GPUArray<unsigned int>& getClusterIdxArray()
+            {
+            return m_cluster_idx;
+            }
+
+        //! Get the number of neighboring clusters of each cluster
+        const GPUArray<unsigned int>& getClusterNNeighArray()
+            {
+            return m_cluster_n_neigh;
+            }
+
+        //! Get the cluster neighbor list
+        const GPUArray<unsigned int>& getClusterNListArray()
+            {
+            return m_cluster_nlist;
+            }
+
+        //! Get the cluster neighbor list indexer
+        /*! \note Do not save indexers across calls. Get a new indexer after every call to compute() - they will
+            change.
+        */
+        const Index2D& getClusterNListIndexer()
+            {
+            return m_cluster_nlist_indexer;
+            }
+
+        // @}
+
+    protected:
+        bool m_particle_nlist_requested;            //!< True if a consumer has accessed the per particle list
+        bool m_particle_nlist_built;                //!< True if the last update built the per particle list
+        unsigned int m_last_build_tstep;            //!< Time step of the last build
+        unsigned int m_n_clusters;                  //!< Number of clusters
+        unsigned int m_cluster_Nmax;                //!< Maximum number of neighbor clusters per cluster
+        Index2D m_cluster_nlist_indexer;            //!< Indexer for the cluster neighbor list
+        GPUArray<unsigned int> m_cluster_idx;       //!< Particle indices of the clusters
+        GPUArray<Scalar4> m_cluster_center;         //!< Bounding box centers (w is 1 if the cluster has a local particle)
+        GPUArray<Scalar4> m_cluster_extent;         //!< Bounding box half extents
+        GPUArray<unsigned int> m_cluster_nlist;     //!< Cluster neighbor list
+        GPUArray<unsigned int> m_cluster_n_neigh;   //!< Number of neighbor clusters of each cluster
+        std::vector<unsigned int> m_cell_first_cluster; //!< Index of the first cluster of each cell
+
+        //! Pointers to the input and output arrays of the cluster list build, shared by all threads
+        struct cluster_args
+            {
+            const Scalar4 *pos;                 //!< Particle positions
+            const unsigned int *body;           //!< Body index of each particle
+            const Scalar *diameter;             //!< Diameter of each particle
+            const unsigned int *cell_size;      //!< Number of particles in each cell
+            const unsigned int *cell_start;     //!< Offset of the first particle of each cell in the cell list
+            const Scalar4 *cell_xyzf;           //!< Positions and indices of the particles in each cell
+            const unsigned int *cell_adj;       //!< Cell adjacency list
+            const unsigned int *cell_first_cluster; //!< Index of the first cluster of each cell
+            unsigned int *cluster_idx;          //!< Particle indices of the clusters (output)
+            Scalar4 *cluster_center;            //!< Bounding box centers (output)
+            Scalar4 *cluster_extent;            //!< Bounding box half extents (output)
+            unsigned int *cluster_nlist;        //!< Cluster neighbor list (output)
+            unsigned int *cluster_n_neigh;      //!< Number of neighbor clusters (output)
+            const unsigned int *head_list;      //!< Offset of the first neighbor of each particle in the neighbor list
+            unsigned int *nlist;                //!< Neighbor list (output)
+            unsigned int *n_neigh;              //!< Number of neighbors (output)
+            unsigned int *conditions;           //!< Neighbor list overflow condition of each thread (output)
+            unsigned int *cluster_conditions;   //!< Cluster list overflow condition of each thread (output)
+            Index2D cadji;                      //!< Indexer for the cell adjacency list
+            unsigned int n_cells;               //!< Total number of cells
+            unsigned int N;                     //!< Number of local particles
+            BoxDim box;                         //!< Local simulation box
+            Scalar rmax;                        //!< Maximum distance for neighbors
+            Scalar rmaxsq;                      //!< Square of rmax
+            Scalar rlistsq;                     //!< Square of the maximum bounding box distance of neighbor clusters
+            bool filter_body;                   //!< True if particles in the same body are excluded
+            bool filter_diameter;               //!< True if the cutoff is shifted by the particle diameters
+            bool full;                          //!< True if a full per particle neighbor list is built
+            };
+
+        //! Builds the neighbor list
+        virtual void buildNlist(unsigned int timestep);
+
+        //! Filter the per particle list, if it has been built
+        virtual void filterNlist();
+
+        //! Starts building the per particle list
+        virtual void requestParticleNlist();
+
+        //! Average number of neighbors per particle
+        virtual Scalar getAverageNNeigh();
+
+        //! Print the statistics of the number of neighbors
+        virtual void printNNeighStats();
+
+        //! Sorts the particles in the cells assigned to one thread into clusters
+        void formClustersThread(unsigned int thread_idx, const cluster_args& args);
+
+        //! Builds the cluster neighbor list of the cells assigned to one thread
+        void buildClusterNlistThread(unsigned int thread_idx, const cluster_args& args);
+
+        //! Builds the per particle neighbor list of the cells assigned to one thread
+        void buildParticleNlistThread(unsigned int thread_idx, const cluster_args& args);
+    };
+
+//! Exports NeighborListCluster to python
+void export_NeighborListCluster();
+
+#endif
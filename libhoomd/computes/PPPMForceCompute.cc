@@ -59,10 +59,16 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "PPPMForceCompute.h"
 
+#ifdef ENABLE_MPI
+#include "DomainDecomposition.h"
+#include "HOOMDMPI.h"
+#endif
+
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
 #include <math.h>
+#include <algorithm>
 
 using namespace boost;
 using namespace boost::python;
@@ -87,13 +93,27 @@ PPPMForceCompute::PPPMForceCompute(boost::shared_ptr<SystemDefinition> sysdef,
                                    boost::shared_ptr<NeighborList> nlist,
                                    boost::shared_ptr<ParticleGroup> group)
     : ForceCompute(sysdef), m_params_set(false), m_nlist(nlist), m_group(group),
-      fft_in(NULL), fft_ex(NULL), fft_ey(NULL), fft_ez(NULL)
+      m_distributed(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing PPPMForceCompute" << endl;
 
     assert(m_pdata);
     assert(m_nlist);
 
+    m_local_dim = make_int3(0,0,0);
+    m_local_offset = make_int3(0,0,0);
+    m_n_ghost = make_int3(0,0,0);
+    m_mesh_dim = make_int3(0,0,0);
+
+#ifdef ENABLE_MPI
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        m_row_comm[dir] = MPI_COMM_NULL;
+        m_fft_1d_forward[dir] = NULL;
+        m_fft_1d_inverse[dir] = NULL;
+        }
+#endif
+
     m_box_changed = false;
     m_boxchange_connection = m_pdata->connectBoxChange(bind(&PPPMForceCompute::slotBoxChanged, this));
     }
@@ -102,14 +122,17 @@ PPPMForceCompute::~PPPMForceCompute()
     {
     m_exec_conf->msg->notice(5) << "Destroying PPPMForceCompute" << endl;
 
-    if (fft_in)
-        free(fft_in);
-    if (fft_ex)
-        free(fft_ex);
-    if (fft_ey)
-        free(fft_ey);
-    if (fft_ez)
-        free(fft_ez);
+#ifdef ENABLE_MPI
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        if (m_row_comm[dir] != MPI_COMM_NULL)
+            MPI_Comm_free(&m_row_comm[dir]);
+        if (m_fft_1d_forward[dir])
+            kiss_fft_free(m_fft_1d_forward[dir]);
+        if (m_fft_1d_inverse[dir])
+            kiss_fft_free(m_fft_1d_inverse[dir]);
+        }
+#endif
 
     m_boxchange_connection.disconnect();
     }
@@ -132,7 +155,9 @@ void PPPMForceCompute::setParams(int Nx, int Ny, int Nz, int order, Scalar kappa
     m_order = order;
     m_kappa = kappa;
     m_rcut = rcut;
-    first_run = 0;
+
+    // the transforms are planned for the new mesh on first use
+    m_fft.reset();
 
     if(!(m_Nx == 2)&& !(m_Nx == 4)&& !(m_Nx == 8)&& !(m_Nx == 16)&& !(m_Nx == 32)&& !(m_Nx == 64)&& !(m_Nx == 128)&& !(m_Nx == 256)&& !(m_Nx == 512)&& !(m_Nx == 1024))
         {
@@ -157,30 +182,53 @@ void PPPMForceCompute::setParams(int Nx, int Ny, int Nz, int order, Scalar kappa
         throw std::runtime_error("Error initializing PPPMForceCompute");
         }
 
-    GPUArray<CUFFTCOMPLEX> n_rho_real_space(Nx*Ny*Nz, exec_conf);
+    // by default, this rank owns the whole mesh
+    m_local_dim = make_int3(Nx, Ny, Nz);
+    m_local_offset = make_int3(0, 0, 0);
+    m_n_ghost = make_int3(0, 0, 0);
+    m_mesh_dim = m_local_dim;
+
+#ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        m_distributed = true;
+        initializeDomainMesh();
+        }
+#endif
+
+    // number of mesh points in the local block
+    unsigned int n_local = m_local_dim.x * m_local_dim.y * m_local_dim.z;
+
+    GPUArray<CUFFTCOMPLEX> n_rho_real_space(n_local, exec_conf);
     m_rho_real_space.swap(n_rho_real_space);
-    GPUArray<Scalar> n_green_hat(Nx*Ny*Nz, exec_conf);
+    GPUArray<Scalar> n_green_hat(n_local, exec_conf);
     m_green_hat.swap(n_green_hat);
 
-    GPUArray<Scalar> n_vg(6*Nx*Ny*Nz, exec_conf);
+    GPUArray<Scalar> n_vg(6*n_local, exec_conf);
     m_vg.swap(n_vg);
 
 
-    GPUArray<Scalar3> n_kvec(Nx*Ny*Nz, exec_conf);
+    GPUArray<Scalar3> n_kvec(n_local, exec_conf);
     m_kvec.swap(n_kvec);
-    GPUArray<CUFFTCOMPLEX> n_Ex(Nx*Ny*Nz, exec_conf);
+    GPUArray<CUFFTCOMPLEX> n_Ex(n_local, exec_conf);
     m_Ex.swap(n_Ex);
-    GPUArray<CUFFTCOMPLEX> n_Ey(Nx*Ny*Nz, exec_conf);
+    GPUArray<CUFFTCOMPLEX> n_Ey(n_local, exec_conf);
     m_Ey.swap(n_Ey);
-    GPUArray<CUFFTCOMPLEX> n_Ez(Nx*Ny*Nz, exec_conf);
+    GPUArray<CUFFTCOMPLEX> n_Ez(n_local, exec_conf);
     m_Ez.swap(n_Ez);
     GPUArray<Scalar> n_gf_b(order, exec_conf);
     m_gf_b.swap(n_gf_b);
     GPUArray<Scalar> n_rho_coeff(order*(2*order+1), exec_conf);
     m_rho_coeff.swap(n_rho_coeff);
-    GPUArray<Scalar3> n_field(Nx*Ny*Nz, exec_conf);
-    m_field.swap(n_field);
-    const BoxDim& box = m_pdata->getBox();
+
+    // the combined field is only used by the GPU on the full mesh, a distributed mesh never needs it
+    if (!m_distributed)
+        {
+        GPUArray<Scalar3> n_field(Nx*Ny*Nz, exec_conf);
+        m_field.swap(n_field);
+        }
+
+    const BoxDim& box = m_pdata->getGlobalBox();
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
     // get system charge
@@ -190,6 +238,13 @@ void PPPMForceCompute::setParams(int Nx, int Ny, int Nz, int order, Scalar kappa
         m_q += h_charge.data[i];
         m_q2 += h_charge.data[i]*h_charge.data[i];
         }
+#ifdef ENABLE_MPI
+    if (m_distributed)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &m_q, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &m_q2, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+#endif
     if(fabs(m_q) > 0.0)
         m_exec_conf->msg->warning() << "charge.pppm: system in not neutral, the net charge is " << m_q << endl;
 
@@ -198,18 +253,21 @@ void PPPMForceCompute::setParams(int Nx, int Ny, int Nz, int order, Scalar kappa
     Scalar hx =  L.x/(Scalar)Nx;
     Scalar hy =  L.y/(Scalar)Ny;
     Scalar hz =  L.z/(Scalar)Nz;
-    Scalar lprx = PPPMForceCompute::rms(hx, L.x, (int)m_pdata->getN());
-    Scalar lpry = PPPMForceCompute::rms(hy, L.y, (int)m_pdata->getN());
-    Scalar lprz = PPPMForceCompute::rms(hz, L.z, (int)m_pdata->getN());
+    Scalar lprx = PPPMForceCompute::rms(hx, L.x, (int)m_pdata->getNGlobal());
+    Scalar lpry = PPPMForceCompute::rms(hy, L.y, (int)m_pdata->getNGlobal());
+    Scalar lprz = PPPMForceCompute::rms(hz, L.z, (int)m_pdata->getNGlobal());
     Scalar lpr = sqrt(lprx*lprx + lpry*lpry + lprz*lprz) / sqrt(3.0);
-    Scalar spr = 2.0*m_q2*exp(-m_kappa*m_kappa*m_rcut*m_rcut) / sqrt((int)m_pdata->getN()*m_rcut*L.x*L.y*L.z);
+    Scalar spr = 2.0*m_q2*exp(-m_kappa*m_kappa*m_rcut*m_rcut) / sqrt((int)m_pdata->getNGlobal()*m_rcut*L.x*L.y*L.z);
 
     double RMS_error = MAX(lpr,spr);
-    if(RMS_error > 0.1) {
-        printf("!!!!!!!\n!!!!!!!\n!!!!!!!\nWARNING RMS error of %g is probably too high %f %f\n!!!!!!!\n!!!!!!!\n!!!!!!!\n", RMS_error, lpr, spr);
-        }
-    else{
-        printf("Notice: PPPM RMS error: %g\n", RMS_error);
+    if (m_exec_conf->getRank() == 0)
+        {
+        if(RMS_error > 0.1) {
+            printf("!!!!!!!\n!!!!!!!\n!!!!!!!\nWARNING RMS error of %g is probably too high %f %f\n!!!!!!!\n!!!!!!!\n!!!!!!!\n", RMS_error, lpr, spr);
+            }
+        else{
+            printf("Notice: PPPM RMS error: %g\n", RMS_error);
+            }
         }
 
     PPPMForceCompute::compute_rho_coeff();
@@ -263,26 +321,21 @@ void PPPMForceCompute::computeForces(unsigned int timestep)
 
     // start the profile for this compute
     if (m_prof) m_prof->push("PPPM force");
-    int dim[3];
-    dim[0] = m_Nx;
-    dim[1] = m_Ny;
-    dim[2] = m_Nz;
 
-    if(first_run == 0)
+    // the serial transforms act on the full mesh, they are not needed if it is distributed
+    if (!m_fft && !m_distributed)
         {
-        first_run = 1;
-        fft_in = (kiss_fft_cpx *)malloc(m_Nx*m_Ny*m_Nz*sizeof(kiss_fft_cpx));
-        fft_ex = (kiss_fft_cpx *)malloc(m_Nx*m_Ny*m_Nz*sizeof(kiss_fft_cpx));
-        fft_ey = (kiss_fft_cpx *)malloc(m_Nx*m_Ny*m_Nz*sizeof(kiss_fft_cpx));
-        fft_ez = (kiss_fft_cpx *)malloc(m_Nx*m_Ny*m_Nz*sizeof(kiss_fft_cpx));
-
-        fft_forward = kiss_fftnd_alloc(dim, 3, 0, NULL, NULL);
-        fft_inverse = kiss_fftnd_alloc(dim, 3, 1, NULL, NULL);
+#ifdef ENABLE_FFTW
+        m_fft.reset(new FFTBackendFFTW(m_exec_conf, m_Nx, m_Ny, m_Nz, 3));
+#else
+        m_fft.reset(new FFTBackendKiss(m_exec_conf, m_Nx, m_Ny, m_Nz, 3));
+#endif
+        m_exec_conf->msg->notice(5) << "charge.pppm: using " << m_fft->getName() << " for the mesh transforms" << endl;
         }
 
     if(m_box_changed)
         {
-        const BoxDim& box = m_pdata->getBox();
+        const BoxDim& box = m_pdata->getGlobalBox();
         Scalar3 L = box.getL();
         PPPMForceCompute::reset_kvec_green_hat_cpu();
         Scalar scale = Scalar(1.0)/((Scalar)(m_Nx * m_Ny * m_Nz));
@@ -290,64 +343,40 @@ void PPPMForceCompute::computeForces(unsigned int timestep)
         m_box_changed = false;
         }
 
-    PPPMForceCompute::assign_charges_to_grid();
-
-//FFTs go next
+#ifdef ENABLE_MPI
+    // the mesh blocks are only aligned with the domains if these have equal sizes
+    if (m_distributed && !m_pdata->getDomainDecomposition()->isUniform())
+        {
+        m_exec_conf->msg->error() << "charge.pppm: Domains of unequal size are not supported, do not combine with a load balancer" << endl;
+        throw std::runtime_error("Error computing forces in PPPMForceCompute");
+        }
 
-        { // scoping array handles
-        ArrayHandle<CUFFTCOMPLEX> h_rho_real_space(m_rho_real_space, access_location::host, access_mode::readwrite);
-        for(int i = 0; i < m_Nx * m_Ny * m_Nz ; i++) {
-            fft_in[i].r = (Scalar) h_rho_real_space.data[i].x;
-            fft_in[i].i = (Scalar)0.0;
-            }
+    // the ghost layer depends on the box and the neighbor list buffer
+    if (m_distributed)
+        updateGhostWidth();
+#endif
 
-        kiss_fftnd(fft_forward, &fft_in[0], &fft_in[0]);
+    PPPMForceCompute::assign_charges_to_grid();
 
-        for(int i = 0; i < m_Nx * m_Ny * m_Nz ; i++) {
-            h_rho_real_space.data[i].x = fft_in[i].r;
-            h_rho_real_space.data[i].y = fft_in[i].i;
+//FFTs go next
 
-            }
-        }
+#ifdef ENABLE_MPI
+    if (m_distributed)
+        distributed_forward_fft();
+    else
+#endif
+        serial_forward_fft();
 
     PPPMForceCompute::combined_green_e();
 
 //More FFTs
 
-        { // scoping array handles
-        ArrayHandle<CUFFTCOMPLEX> h_Ex(m_Ex, access_location::host, access_mode::readwrite);
-        ArrayHandle<CUFFTCOMPLEX> h_Ey(m_Ey, access_location::host, access_mode::readwrite);
-        ArrayHandle<CUFFTCOMPLEX> h_Ez(m_Ez, access_location::host, access_mode::readwrite);
-
-        for(int i = 0; i < m_Nx * m_Ny * m_Nz ; i++)
-            {
-            fft_ex[i].r = (Scalar) h_Ex.data[i].x;
-            fft_ex[i].i = (Scalar) h_Ex.data[i].y;
-
-            fft_ey[i].r = (Scalar) h_Ey.data[i].x;
-            fft_ey[i].i = (Scalar) h_Ey.data[i].y;
-
-            fft_ez[i].r = (Scalar) h_Ez.data[i].x;
-            fft_ez[i].i = (Scalar) h_Ez.data[i].y;
-            }
-
-
-        kiss_fftnd(fft_inverse, &fft_ex[0], &fft_ex[0]);
-        kiss_fftnd(fft_inverse, &fft_ey[0], &fft_ey[0]);
-        kiss_fftnd(fft_inverse, &fft_ez[0], &fft_ez[0]);
-
-        for(int i = 0; i < m_Nx * m_Ny * m_Nz ; i++)
-            {
-            h_Ex.data[i].x = fft_ex[i].r;
-            h_Ex.data[i].y = fft_ex[i].i;
-
-            h_Ey.data[i].x = fft_ey[i].r;
-            h_Ey.data[i].y = fft_ey[i].i;
-
-            h_Ez.data[i].x = fft_ez[i].r;
-            h_Ez.data[i].y = fft_ez[i].i;
-            }
-        }
+#ifdef ENABLE_MPI
+    if (m_distributed)
+        distributed_inverse_fft();
+    else
+#endif
+        serial_inverse_fft();
 
     PPPMForceCompute::calculate_forces();
 
@@ -514,7 +543,7 @@ inline Scalar sinc(Scalar x)
 void PPPMForceCompute::reset_kvec_green_hat_cpu()
     {
     ArrayHandle<Scalar3> h_kvec(m_kvec, access_location::host, access_mode::readwrite);
-    const BoxDim& box = m_pdata->getBox();
+    const BoxDim& box = m_pdata->getGlobalBox();
     Scalar3 L = box.getL();
 
     // compute reciprocal lattice vectors
@@ -527,34 +556,37 @@ void PPPMForceCompute::reset_kvec_green_hat_cpu()
     Scalar3 b2 = Scalar(2.0*M_PI)*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
     Scalar3 b3 = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
 
-    // Set up the k-vectors
+    // Set up the k-vectors of the local block of the mesh, the global index of local point i is i+m_local_offset
     int ix, iy, iz, kper, lper, mper, k, l, m;
-    for (ix = 0; ix < m_Nx; ix++) {
+    for (ix = 0; ix < m_local_dim.x; ix++) {
         Scalar3 j;
-        j.x = ix > m_Nx/2 ? ix - m_Nx : ix;
-        for (iy = 0; iy < m_Ny; iy++) {
-            j.y = iy > m_Ny/2 ? iy - m_Ny : iy;
-            for (iz = 0; iz < m_Nz; iz++) {
-                j.z = iz > m_Nz/2 ? iz - m_Nz : iz;
-                h_kvec.data[iz + m_Nz * (iy + m_Ny * ix)] =  j.x*b1+j.y*b2+j.z*b3;
+        int gx = ix + m_local_offset.x;
+        j.x = gx > m_Nx/2 ? gx - m_Nx : gx;
+        for (iy = 0; iy < m_local_dim.y; iy++) {
+            int gy = iy + m_local_offset.y;
+            j.y = gy > m_Ny/2 ? gy - m_Ny : gy;
+            for (iz = 0; iz < m_local_dim.z; iz++) {
+                int gz = iz + m_local_offset.z;
+                j.z = gz > m_Nz/2 ? gz - m_Nz : gz;
+                h_kvec.data[iz + m_local_dim.z * (iy + m_local_dim.y * ix)] =  j.x*b1+j.y*b2+j.z*b3;
                 }
             }
         }
 
     // Set up constants for virial calculation
     ArrayHandle<Scalar> h_vg(m_vg, access_location::host, access_mode::readwrite);;
-    for(int x = 0; x < m_Nx; x++)
+    for(int x = 0; x < m_local_dim.x; x++)
         {
-        for(int y = 0; y < m_Ny; y++)
+        for(int y = 0; y < m_local_dim.y; y++)
             {
-            for(int z = 0; z < m_Nz; z++)
+            for(int z = 0; z < m_local_dim.z; z++)
                 {
-                Scalar3 kvec = h_kvec.data[z + m_Nz * (y + m_Ny * x)];
+                int grid_point = z + m_local_dim.z * (y + m_local_dim.y * x);
+                Scalar3 kvec = h_kvec.data[grid_point];
                 Scalar sqk =  kvec.x*kvec.x;
                 sqk += kvec.y*kvec.y;
                 sqk += kvec.z*kvec.z;
 
-                int grid_point = z + m_Nz * (y + m_Ny * x);
                 if (sqk == 0.0)
                     {
                     h_vg.data[0 + 6*grid_point] = Scalar(0.0);
@@ -612,17 +644,20 @@ void PPPMForceCompute::reset_kvec_green_hat_cpu()
     Scalar3 kvec,kn, kn1, kn2, kn3;
     Scalar arg_gauss, gauss;
 
-    for (m = 0; m < m_Nz; m++) {
+    for (int lm = 0; lm < m_local_dim.z; lm++) {
+        m = lm + m_local_offset.z;
         mper = m - m_Nz*(2*m/m_Nz);
         snz = sin(0.5*kH.z*mper);
         snz2 = snz*snz;
 
-        for (l = 0; l < m_Ny; l++) {
+        for (int ll = 0; ll < m_local_dim.y; ll++) {
+            l = ll + m_local_offset.y;
             lper = l - m_Ny*(2*l/m_Ny);
             sny = sin(0.5*kH.y*lper);
             sny2 = sny*sny;
 
-            for (k = 0; k < m_Nx; k++) {
+            for (int lk = 0; lk < m_local_dim.x; lk++) {
+                k = lk + m_local_offset.x;
                 kper = k - m_Nx*(2*k/m_Nx);
                 snx = sin(0.5*kH.x*kper);
                 snx2 = snx*snx;
@@ -663,104 +698,341 @@ void PPPMForceCompute::reset_kvec_green_hat_cpu()
                                 }
                             }
                         }
-                    h_green_hat.data[m + m_Nz * (l + m_Ny * k)] = numerator*sum1/denominator;
-                    } else h_green_hat.data[m + m_Nz * (l + m_Ny * k)] = 0.0;
+                    h_green_hat.data[lm + m_local_dim.z * (ll + m_local_dim.y * lk)] = numerator*sum1/denominator;
+                    } else h_green_hat.data[lm + m_local_dim.z * (ll + m_local_dim.y * lk)] = 0.0;
                 }
             }
         }
     }
 
-void PPPMForceCompute::assign_charges_to_grid()
+/*! \param idx Global mesh index of the stencil origin along one direction, on output the index into the local mesh
+    \param N Number of mesh points along this direction
+    \param n_local Number of mesh points in the local block
+    \param offset Global index of the first point of the local block
+    \param n_ghost Number of ghost cells on either side of the local block
+    \param nlower Lower bound of the stencil relative to its origin
+    \param nupper Upper bound of the stencil relative to its origin
+    \returns true if the stencil fits into the local mesh including the ghost cells
+
+    A particle that has left the local box since the last migration may have been wrapped across the global
+    boundary, so the periodic image closest to the local block is used.
+*/
+inline bool map_to_local_mesh(int& idx, int N, int n_local, int offset, int n_ghost, int nlower, int nupper)
     {
+    idx -= offset;
+    if (idx - n_local/2 >= N/2)
+        idx -= N;
+    else if (idx - n_local/2 < -N/2)
+        idx += N;
+    idx += n_ghost;
+
+    return (idx + nlower >= 0 && idx + nupper < n_local + 2*n_ghost);
+    }
 
-    const BoxDim& box = m_pdata->getBox();
-
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
 
-    ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff, access_location::host, access_mode::read);
-    ArrayHandle<CUFFTCOMPLEX> h_rho_real_space(m_rho_real_space, access_location::host, access_mode::readwrite);
+    The stencil of a particle covers m_order mesh points along each direction, starting at m_stencil_origin. The
+    weights of the stencil points along one direction are evaluated with the Horner scheme for all points at once,
+    so that the inner loop can be vectorized by the compiler.
+*/
+void PPPMForceCompute::computeStencilsThread(unsigned int thread_idx, const assign_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.N, thread_idx, m_exec_conf->getNumThreads(), first, last);
 
-    memset(h_rho_real_space.data, 0, sizeof(CUFFTCOMPLEX)*m_Nx*m_Ny*m_Nz);
+    int nlower = -(m_order-1)/2;
+    int nupper = m_order/2;
+    Scalar shift = (m_order % 2) ? Scalar(0.5) : Scalar(0.0);
+    Scalar shiftone = (m_order % 2) ? Scalar(0.0) : Scalar(0.5);
+    int mult_fact = 2*m_order+1;
+    unsigned int n_out_of_bounds = 0;
 
-    Scalar V_cell = box.getVolume()/(Scalar)(m_Nx*m_Ny*m_Nz);
-
-    for(int i = 0; i < (int)m_pdata->getN(); i++)
+    for (unsigned int i = first; i < last; i++)
         {
-        Scalar qi = h_charge.data[i];
-        Scalar3 posi;
-        posi.x = h_pos.data[i].x;
-        posi.y = h_pos.data[i].y;
-        posi.z = h_pos.data[i].z;
+        Scalar3 posi = make_scalar3(args.pos[i].x, args.pos[i].y, args.pos[i].z);
 
         //normalize position to gridsize:
-        Scalar3 pos_frac = box.makeFraction(posi);
+        Scalar3 pos_frac = args.box.makeFraction(posi);
         pos_frac.x *= (Scalar)m_Nx;
         pos_frac.y *= (Scalar)m_Ny;
         pos_frac.z *= (Scalar)m_Nz;
 
-        Scalar shift, shiftone, x0, y0, z0, dx, dy, dz;
-        int nlower, nupper, mx, my, mz, nxi, nyi, nzi;
+        int nxi = (int)(pos_frac.x + shift);
+        int nyi = (int)(pos_frac.y + shift);
+        int nzi = (int)(pos_frac.z + shift);
 
-        nlower = -(m_order-1)/2;
-        nupper = m_order/2;
+        Scalar d[3];
+        d[0] = shiftone+(Scalar)nxi-pos_frac.x;
+        d[1] = shiftone+(Scalar)nyi-pos_frac.y;
+        d[2] = shiftone+(Scalar)nzi-pos_frac.z;
 
-        if (m_order % 2)
+        if (m_distributed &&
+            (!map_to_local_mesh(nxi, m_Nx, m_local_dim.x, m_local_offset.x, m_n_ghost.x, nlower, nupper) ||
+             !map_to_local_mesh(nyi, m_Ny, m_local_dim.y, m_local_offset.y, m_n_ghost.y, nlower, nupper) ||
+             !map_to_local_mesh(nzi, m_Nz, m_local_dim.z, m_local_offset.z, m_n_ghost.z, nlower, nupper)))
             {
-            shift =0.5;
-            shiftone = 0.0;
+            n_out_of_bounds++;
+            continue;
             }
-        else
+
+        m_stencil_origin[i] = make_int3(nxi + nlower, nyi + nlower, nzi + nlower);
+
+        Scalar *weight = &m_stencil_weight[3*m_order*i];
+        for (unsigned int dir = 0; dir < 3; dir++)
             {
-            shift = 0.0;
-            shiftone = 0.5;
-            }
+            Scalar w[MaxOrder];
+            for (int s = 0; s < m_order; s++)
+                w[s] = Scalar(0.0);
 
-        nxi = (int)(pos_frac.x + shift);
-        nyi = (int)(pos_frac.y + shift);
-        nzi = (int)(pos_frac.z + shift);
-
-        dx = shiftone+(Scalar)nxi-pos_frac.x;
-        dy = shiftone+(Scalar)nyi-pos_frac.y;
-        dz = shiftone+(Scalar)nzi-pos_frac.z;
-
-        int n,m,l,k;
-        Scalar result;
-        int mult_fact = 2*m_order+1;
-
-        x0 = qi / V_cell;
-        for (n = nlower; n <= nupper; n++) {
-            mx = n+nxi;
-            if(mx >= m_Nx) mx -= m_Nx;
-            if(mx < 0)  mx += m_Nx;
-            result = Scalar(0.0);
-            for (k = m_order-1; k >= 0; k--) {
-                result = h_rho_coeff.data[n-nlower + k*mult_fact] + result * dx;
+            for (int k = m_order-1; k >= 0; k--)
+                {
+                const Scalar *coeff = &args.rho_coeff[k*mult_fact];
+                for (int s = 0; s < m_order; s++)
+                    w[s] = coeff[s] + w[s] * d[dir];
                 }
-            y0 = x0*result;
-            for (m = nlower; m <= nupper; m++) {
-                my = m+nyi;
-                if(my >= m_Ny) my -= m_Ny;
-                if(my < 0)  my += m_Ny;
-                result = Scalar(0.0);
-                for (k = m_order-1; k >= 0; k--) {
-                    result = h_rho_coeff.data[m-nlower + k*mult_fact] + result * dy;
-                    }
-                z0 = y0*result;
-                for (l = nlower; l <= nupper; l++) {
-                    mz = l+nzi;
-                    if(mz >= m_Nz) mz -= m_Nz;
-                    if(mz < 0)  mz += m_Nz;
-                    result = Scalar(0.0);
-                    for (k = m_order-1; k >= 0; k--) {
-                        result = h_rho_coeff.data[l-nlower + k*mult_fact] + result * dz;
+
+            for (int s = 0; s < m_order; s++)
+                weight[dir*m_order + s] = w[s];
+            }
+        }
+
+    m_thread_out_of_bounds[thread_idx] = n_out_of_bounds;
+    }
+
+/*! The particles are sorted by the x plane of their stencil origin with a stable counting sort, so they keep their
+    relative order within a plane. The planes are then divided into contiguous ranges with about the same number of
+    particle contributions per thread. The division only balances the load, it does not change the result.
+*/
+void PPPMForceCompute::sortParticlesIntoPlanes()
+    {
+    unsigned int N = m_pdata->getN();
+    int n_planes = m_mesh_dim.x;
+
+    // counting sort
+    std::vector<unsigned int> plane(N);
+    m_plane_start.assign(n_planes+1, 0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        int x = m_stencil_origin[i].x % n_planes;
+        if (x < 0) x += n_planes;
+        plane[i] = x;
+        m_plane_start[x+1]++;
+        }
+
+    for (int x = 0; x < n_planes; x++)
+        m_plane_start[x+1] += m_plane_start[x];
+
+    m_plane_particles.resize(N);
+    std::vector<unsigned int> fill(m_plane_start.begin(), m_plane_start.end()-1);
+    for (unsigned int i = 0; i < N; i++)
+        m_plane_particles[fill[plane[i]]++] = i;
+
+    // every plane receives the contributions of the particles with a stencil origin in the m_order planes below it
+    std::vector<unsigned int> work(n_planes, 0);
+    unsigned int total_work = 0;
+    for (int x = 0; x < n_planes; x++)
+        {
+        for (int n = 0; n < m_order; n++)
+            {
+            int ox = (x - n) % n_planes;
+            if (ox < 0) ox += n_planes;
+            work[x] += m_plane_start[ox+1] - m_plane_start[ox];
+            }
+        total_work += work[x];
+        }
+
+    unsigned int n_threads = m_exec_conf->getNumThreads();
+    m_thread_first_plane.assign(n_threads+1, n_planes);
+    unsigned int cumulative_work = 0;
+    unsigned int t = 0;
+    for (int x = 0; x < n_planes; x++)
+        {
+        while (t < n_threads && (unsigned long long)cumulative_work * n_threads >= (unsigned long long)total_work * t)
+            m_thread_first_plane[t++] = x;
+        cumulative_work += work[x];
+        }
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+
+    Every mesh plane is written by one thread only. A mesh point adds the contributions of the particles in the order
+    of the offset of the point within their stencils, and of the particle index for the same offset. This order only
+    depends on the particle positions, so the sums are bitwise reproducible for any number of threads.
+*/
+void PPPMForceCompute::spreadChargesThread(unsigned int thread_idx, const assign_args& args)
+    {
+    int n_planes = m_mesh_dim.x;
+
+    for (unsigned int mx = m_thread_first_plane[thread_idx]; mx < m_thread_first_plane[thread_idx+1]; mx++)
+        {
+        CUFFTCOMPLEX *plane = &args.rho[m_mesh_dim.z * m_mesh_dim.y * mx];
+
+        for (int n = 0; n < m_order; n++)
+            {
+            int ox = ((int)mx - n) % n_planes;
+            if (ox < 0) ox += n_planes;
+
+            for (unsigned int p = m_plane_start[ox]; p < m_plane_start[ox+1]; p++)
+                {
+                unsigned int i = m_plane_particles[p];
+                int3 origin = m_stencil_origin[i];
+                const Scalar *weight = &m_stencil_weight[3*m_order*i];
+                Scalar wx = args.charge[i] * args.charge_scale * weight[n];
+
+                for (int m = 0; m < m_order; m++)
+                    {
+                    int my = origin.y + m;
+                    if (my >= m_mesh_dim.y) my -= m_mesh_dim.y;
+                    if (my < 0) my += m_mesh_dim.y;
+                    Scalar wxy = wx * weight[m_order + m];
+                    CUFFTCOMPLEX *row = &plane[m_mesh_dim.z * my];
+
+                    for (int l = 0; l < m_order; l++)
+                        {
+                        int mz = origin.z + l;
+                        if (mz >= m_mesh_dim.z) mz -= m_mesh_dim.z;
+                        if (mz < 0) mz += m_mesh_dim.z;
+                        row[mz].x += wxy * weight[2*m_order + l];
                         }
-                    h_rho_real_space.data[mz + m_Nz * (my + m_Ny * mx)].x += z0*result;
                     }
                 }
             }
         }
+    }
+
+/*! The stencils of the particles are computed in parallel, then every thread spreads the charges onto its own range
+    of mesh planes.
+*/
+void PPPMForceCompute::assign_charges_to_grid()
+    {
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+    ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff, access_location::host, access_mode::read);
+
+    // with a distributed mesh, charges are spread onto the local mesh including ghost cells
+    GPUArray<CUFFTCOMPLEX>& rho_mesh = m_distributed ? m_mesh_rho : m_rho_real_space;
+    ArrayHandle<CUFFTCOMPLEX> h_rho_real_space(rho_mesh, access_location::host, access_mode::readwrite);
 
+    memset(h_rho_real_space.data, 0, sizeof(CUFFTCOMPLEX)*m_mesh_dim.x*m_mesh_dim.y*m_mesh_dim.z);
+
+    Scalar V_cell = box.getVolume()/(Scalar)(m_Nx*m_Ny*m_Nz);
+
+    unsigned int N = m_pdata->getN();
+    m_stencil_origin.resize(N);
+    m_stencil_weight.resize(3*m_order*N);
+    m_thread_out_of_bounds.assign(m_exec_conf->getNumThreads(), 0);
+
+    assign_args args;
+    args.pos = h_pos.data;
+    args.charge = h_charge.data;
+    args.rho_coeff = h_rho_coeff.data;
+    args.rho = h_rho_real_space.data;
+    args.Ex = args.Ey = args.Ez = NULL;
+    args.force = NULL;
+    args.box = box;
+    args.charge_scale = Scalar(1.0) / V_cell;
+    args.N = N;
+
+    m_exec_conf->getThreadPool().run(bind(&PPPMForceCompute::computeStencilsThread, this, _1, boost::cref(args)));
+
+    unsigned int n_out_of_bounds = 0;
+    for (unsigned int t = 0; t < m_thread_out_of_bounds.size(); t++)
+        n_out_of_bounds += m_thread_out_of_bounds[t];
+
+    if (n_out_of_bounds)
+        {
+        m_exec_conf->msg->error() << "charge.pppm: " << n_out_of_bounds << " particles are too far outside of the local domain"
+                                  << endl << endl;
+        throw std::runtime_error("Error assigning charges to the PPPM mesh");
+        }
+
+    sortParticlesIntoPlanes();
+    m_exec_conf->getThreadPool().run(bind(&PPPMForceCompute::spreadChargesThread, this, _1, boost::cref(args)));
+    }
+
+/*! The real part of the charge mesh is transformed with a real to complex transform. The coefficients with
+    kz > Nz/2 are filled in from rho(-k) = conj(rho(k)) to leave the full spectrum in m_rho_real_space.
+*/
+void PPPMForceCompute::serial_forward_fft()
+    {
+    ArrayHandle<CUFFTCOMPLEX> h_rho_real_space(m_rho_real_space, access_location::host, access_mode::readwrite);
+
+    Scalar *in = m_fft->getRealData(0);
+    unsigned int NNN = m_Nx*m_Ny*m_Nz;
+    for (unsigned int i = 0; i < NNN; i++)
+        in[i] = h_rho_real_space.data[i].x;
+
+    m_fft->forward(1);
+
+    const kiss_fft_cpx *out = m_fft->getComplexData(0);
+    int Nz_half = m_Nz/2 + 1;
+    for (int x = 0; x < m_Nx; x++)
+        for (int y = 0; y < m_Ny; y++)
+            for (int z = 0; z < m_Nz; z++)
+                {
+                CUFFTCOMPLEX& rho = h_rho_real_space.data[z + m_Nz * (y + m_Ny * x)];
+                if (z < Nz_half)
+                    {
+                    const kiss_fft_cpx& v = out[z + Nz_half * (y + m_Ny * x)];
+                    rho.x = v.r;
+                    rho.y = v.i;
+                    }
+                else
+                    {
+                    const kiss_fft_cpx& v = out[(m_Nz - z)
+                                                + Nz_half * ((m_Ny - y) % m_Ny + m_Ny * ((m_Nx - x) % m_Nx))];
+                    rho.x = v.r;
+                    rho.y = -v.i;
+                    }
+                }
+    }
+
+/*! The forces only use the real part of the inverse transform of the field, which is the inverse transform of the
+    hermitian part (E(k) + conj(E(-k)))/2 of its spectrum. The hermitian parts of the three components are
+    transformed back to real meshes in a single batch, the imaginary parts of m_Ex, m_Ey and m_Ez are set to zero.
+*/
+void PPPMForceCompute::serial_inverse_fft()
+    {
+    ArrayHandle<CUFFTCOMPLEX> h_Ex(m_Ex, access_location::host, access_mode::readwrite);
+    ArrayHandle<CUFFTCOMPLEX> h_Ey(m_Ey, access_location::host, access_mode::readwrite);
+    ArrayHandle<CUFFTCOMPLEX> h_Ez(m_Ez, access_location::host, access_mode::readwrite);
+    CUFFTCOMPLEX *field[3] = {h_Ex.data, h_Ey.data, h_Ez.data};
+
+    int Nz_half = m_Nz/2 + 1;
+    for (unsigned int c = 0; c < 3; c++)
+        {
+        kiss_fft_cpx *half = m_fft->getComplexData(c);
+        for (int x = 0; x < m_Nx; x++)
+            for (int y = 0; y < m_Ny; y++)
+                for (int z = 0; z < Nz_half; z++)
+                    {
+                    const CUFFTCOMPLEX& e = field[c][z + m_Nz * (y + m_Ny * x)];
+                    const CUFFTCOMPLEX& e_mirror = field[c][(m_Nz - z) % m_Nz
+                                                            + m_Nz * ((m_Ny - y) % m_Ny + m_Ny * ((m_Nx - x) % m_Nx))];
+                    kiss_fft_cpx& h = half[z + Nz_half * (y + m_Ny * x)];
+                    h.r = Scalar(0.5) * (e.x + e_mirror.x);
+                    h.i = Scalar(0.5) * (e.y - e_mirror.y);
+                    }
+        }
+
+    m_fft->inverse(3);
+
+    unsigned int NNN = m_Nx*m_Ny*m_Nz;
+    for (unsigned int c = 0; c < 3; c++)
+        {
+        const Scalar *out = m_fft->getRealData(c);
+        for (unsigned int i = 0; i < NNN; i++)
+            {
+            field[c][i].x = out[i];
+            field[c][i].y = Scalar(0.0);
+            }
+        }
     }
 
 void PPPMForceCompute::combined_green_e()
@@ -774,7 +1046,8 @@ void PPPMForceCompute::combined_green_e()
     ArrayHandle<CUFFTCOMPLEX> h_rho_real_space(m_rho_real_space, access_location::host, access_mode::readwrite);
 
     unsigned int NNN = m_Nx*m_Ny*m_Nz;
-    for(unsigned int i = 0; i < NNN; i++)
+    unsigned int n_local = m_local_dim.x*m_local_dim.y*m_local_dim.z;
+    for(unsigned int i = 0; i < n_local; i++)
         {
 
         CUFFTCOMPLEX rho_local = h_rho_real_space.data[i];
@@ -793,11 +1066,58 @@ void PPPMForceCompute::combined_green_e()
         }
     }
 
-void PPPMForceCompute::calculate_forces()
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void PPPMForceCompute::interpolateForcesThread(unsigned int thread_idx, const assign_args& args)
     {
-    const BoxDim& box = m_pdata->getBox();
+    unsigned int first, last;
+    ThreadPool::getRange(args.N, thread_idx, m_exec_conf->getNumThreads(), first, last);
 
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    for (unsigned int i = first; i < last; i++)
+        {
+        int3 origin = m_stencil_origin[i];
+        const Scalar *weight = &m_stencil_weight[3*m_order*i];
+        Scalar3 field = make_scalar3(0.0, 0.0, 0.0);
+
+        for (int n = 0; n < m_order; n++)
+            {
+            int mx = origin.x + n;
+            if (mx >= m_mesh_dim.x) mx -= m_mesh_dim.x;
+            if (mx < 0) mx += m_mesh_dim.x;
+
+            for (int m = 0; m < m_order; m++)
+                {
+                int my = origin.y + m;
+                if (my >= m_mesh_dim.y) my -= m_mesh_dim.y;
+                if (my < 0) my += m_mesh_dim.y;
+                Scalar wxy = weight[n] * weight[m_order + m];
+                unsigned int row = m_mesh_dim.z * (my + m_mesh_dim.y * mx);
+
+                for (int l = 0; l < m_order; l++)
+                    {
+                    int mz = origin.z + l;
+                    if (mz >= m_mesh_dim.z) mz -= m_mesh_dim.z;
+                    if (mz < 0) mz += m_mesh_dim.z;
+                    Scalar z0 = wxy * weight[2*m_order + l];
+                    field.x += z0 * args.Ex[row + mz].x;
+                    field.y += z0 * args.Ey[row + mz].x;
+                    field.z += z0 * args.Ez[row + mz].x;
+                    }
+                }
+            }
+
+        Scalar qi = args.charge[i];
+        args.force[i].x = qi * field.x;
+        args.force[i].y = qi * field.y;
+        args.force[i].z = qi * field.z;
+        }
+    }
+
+/*! The field is interpolated with the stencils computed by assign_charges_to_grid() in the same time step.
+*/
+void PPPMForceCompute::calculate_forces()
+    {
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
@@ -811,91 +1131,27 @@ void PPPMForceCompute::calculate_forces()
     memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
     memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
 
-    ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff, access_location::host, access_mode::read);
-    ArrayHandle<CUFFTCOMPLEX> h_Ex(m_Ex, access_location::host, access_mode::readwrite);
-    ArrayHandle<CUFFTCOMPLEX> h_Ey(m_Ey, access_location::host, access_mode::readwrite);
-    ArrayHandle<CUFFTCOMPLEX> h_Ez(m_Ez, access_location::host, access_mode::readwrite);
-
-    for(int i = 0; i < (int)m_pdata->getN(); i++)
-        {
-        Scalar qi = h_charge.data[i];
-        Scalar3 posi;
-        posi.x = h_pos.data[i].x;
-        posi.y = h_pos.data[i].y;
-        posi.z = h_pos.data[i].z;
-
-        //normalize position to gridsize:
-        Scalar3 pos_frac = box.makeFraction(posi);
-        pos_frac.x *= (Scalar)m_Nx;
-        pos_frac.y *= (Scalar)m_Ny;
-        pos_frac.z *= (Scalar)m_Nz;
-
-        Scalar shift, shiftone, x0, y0, z0, dx, dy, dz;
-        int nlower, nupper, mx, my, mz, nxi, nyi, nzi;
-
-        nlower = -(m_order-1)/2;
-        nupper = m_order/2;
-
-        if (m_order % 2)
-            {
-            shift =0.5;
-            shiftone = 0.0;
-            }
-        else
-            {
-            shift = 0.0;
-            shiftone = 0.5;
-            }
-
-        nxi = (int)(pos_frac.x + shift);
-        nyi = (int)(pos_frac.y + shift);
-        nzi = (int)(pos_frac.z + shift);
-
-        dx = shiftone+(Scalar)nxi-pos_frac.x;
-        dy = shiftone+(Scalar)nyi-pos_frac.y;
-        dz = shiftone+(Scalar)nzi-pos_frac.z;
-
-        int n,m,l,k;
-        Scalar result;
-        int mult_fact = 2*m_order+1;
-        for (n = nlower; n <= nupper; n++) {
-            mx = n+nxi;
-            if(mx >= m_Nx) mx -= m_Nx;
-            if(mx < 0)  mx += m_Nx;
-            result = Scalar(0.0);
-            for (k = m_order-1; k >= 0; k--) {
-                result = h_rho_coeff.data[n-nlower + k*mult_fact] + result * dx;
-                }
-            x0 = result;
-            for (m = nlower; m <= nupper; m++) {
-                my = m+nyi;
-                if(my >= m_Ny) my -= m_Ny;
-                if(my < 0)  my += m_Ny;
-                result = Scalar(0.0);
-                for (k = m_order-1; k >= 0; k--) {
-                    result = h_rho_coeff.data[m-nlower + k*mult_fact] + result * dy;
-                    }
-                y0 = x0*result;
-                for (l = nlower; l <= nupper; l++) {
-                    mz = l+nzi;
-                    if(mz >= m_Nz) mz -= m_Nz;
-                    if(mz < 0)  mz += m_Nz;
-                    result = Scalar(0.0);
-                    for (k = m_order-1; k >= 0; k--) {
-                        result = h_rho_coeff.data[l-nlower + k*mult_fact] + result * dz;
-                        }
-                    z0 = y0*result;
-                    Scalar local_field_x = h_Ex.data[mz + m_Nz * (my + m_Ny * mx)].x;
-                    Scalar local_field_y = h_Ey.data[mz + m_Nz * (my + m_Ny * mx)].x;
-                    Scalar local_field_z = h_Ez.data[mz + m_Nz * (my + m_Ny * mx)].x;
-                    h_force.data[i].x += qi*z0*local_field_x;
-                    h_force.data[i].y += qi*z0*local_field_y;
-                    h_force.data[i].z += qi*z0*local_field_z;
-                    }
-                }
-            }
-        }
-
+    // with a distributed mesh, the field is interpolated from the local mesh including ghost cells
+    ArrayHandle<CUFFTCOMPLEX> h_Ex(m_distributed ? m_mesh_Ex : m_Ex, access_location::host, access_mode::read);
+    ArrayHandle<CUFFTCOMPLEX> h_Ey(m_distributed ? m_mesh_Ey : m_Ey, access_location::host, access_mode::read);
+    ArrayHandle<CUFFTCOMPLEX> h_Ez(m_distributed ? m_mesh_Ez : m_Ez, access_location::host, access_mode::read);
+
+    assert(m_stencil_origin.size() >= m_pdata->getN());
+
+    assign_args args;
+    args.pos = NULL;
+    args.charge = h_charge.data;
+    args.rho_coeff = NULL;
+    args.rho = NULL;
+    args.Ex = h_Ex.data;
+    args.Ey = h_Ey.data;
+    args.Ez = h_Ez.data;
+    args.force = h_force.data;
+    args.box = m_pdata->getGlobalBox();
+    args.charge_scale = Scalar(1.0);
+    args.N = m_pdata->getN();
+
+    m_exec_conf->getThreadPool().run(bind(&PPPMForceCompute::interpolateForcesThread, this, _1, boost::cref(args)));
     }
 
 void PPPMForceCompute::fix_exclusions_cpu()
@@ -987,7 +1243,7 @@ void PPPMForceCompute::fix_exclusions_cpu()
 void PPPMForceCompute::fix_thermo_quantities()
     {
     // access data arrays
-    BoxDim box = m_pdata->getBox();
+    BoxDim box = m_pdata->getGlobalBox();
     Scalar3 L = box.getL();
 
     ArrayHandle<CUFFTCOMPLEX> d_rho_real_space(m_rho_real_space, access_location::host, access_mode::readwrite);
@@ -1000,7 +1256,7 @@ void PPPMForceCompute::fix_thermo_quantities()
 
 
     // compute the correction
-    for (int i = 0; i < m_Nx*m_Ny*m_Nz; i++)
+    for (int i = 0; i < m_local_dim.x*m_local_dim.y*m_local_dim.z; i++)
         {
         Scalar energy = d_green_hat.data[i]*(d_rho_real_space.data[i].x*d_rho_real_space.data[i].x +
                                              d_rho_real_space.data[i].y*d_rho_real_space.data[i].y);
@@ -1015,6 +1271,26 @@ void PPPMForceCompute::fix_thermo_quantities()
         pppm_virial_energy.y += energy;
         }
 
+#ifdef ENABLE_MPI
+    // every rank only sums over its block of the mesh
+    unsigned int correction_rank = 0;
+    if (m_distributed)
+        {
+        Scalar sums[8] = {pppm_virial_energy.x, pppm_virial_energy.y, v_xx, v_xy, v_xz, v_yy, v_yz, v_zz};
+        MPI_Allreduce(MPI_IN_PLACE, sums, 8, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+        pppm_virial_energy = make_scalar2(sums[0], sums[1]);
+        v_xx = sums[2]; v_xy = sums[3]; v_xz = sums[4];
+        v_yy = sums[5]; v_yz = sums[6]; v_zz = sums[7];
+
+        // the correction goes to the first local particle on the lowest rank that has any
+        unsigned int rank = m_pdata->getN() ? m_exec_conf->getRank() : m_exec_conf->getNRanks();
+        MPI_Allreduce(&rank, &correction_rank, 1, MPI_UNSIGNED, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+
+    if (m_exec_conf->getRank() != correction_rank)
+        return;
+#endif
+
     pppm_virial_energy.x *= m_energy_virial_factor/ (Scalar(3.0) * L.x * L.y * L.z);
     pppm_virial_energy.y *= m_energy_virial_factor;
     pppm_virial_energy.y -= m_q2 * m_kappa / Scalar(1.772453850905516027298168);
@@ -1036,6 +1312,381 @@ void PPPMForceCompute::fix_thermo_quantities()
     h_virial.data[5*virial_pitch+0] += v_zz*m_energy_virial_factor;
     }
 
+#ifdef ENABLE_MPI
+/*! Divides the mesh into blocks along the processor grid of the DomainDecomposition and creates the communicators
+    that connect the ranks sharing a row of domains along each direction. The ghost layer is sized later by
+    updateGhostWidth(), since it depends on the neighbor list buffer.
+*/
+void PPPMForceCompute::initializeDomainMesh()
+    {
+    boost::shared_ptr<DomainDecomposition> decomposition = m_pdata->getDomainDecomposition();
+    assert(decomposition);
+
+    const Index3D& di = decomposition->getDomainIndexer();
+    uint3 grid_pos = decomposition->getGridPos();
+
+    int N[3] = {m_Nx, m_Ny, m_Nz};
+    int n_domains[3] = {(int)di.getW(), (int)di.getH(), (int)di.getD()};
+    unsigned int pos[3] = {grid_pos.x, grid_pos.y, grid_pos.z};
+
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        if (N[dir] % n_domains[dir])
+            {
+            m_exec_conf->msg->error() << "charge.pppm: The number of mesh points along " << (char)('x'+dir)
+                                      << " (" << N[dir] << ") is not a multiple of the number of domains ("
+                                      << n_domains[dir] << ")" << endl << endl;
+            throw std::runtime_error("Error initializing PPPMForceCompute");
+            }
+        }
+
+    m_local_dim = make_int3(m_Nx/n_domains[0], m_Ny/n_domains[1], m_Nz/n_domains[2]);
+    m_local_offset = make_int3(grid_pos.x*m_local_dim.x, grid_pos.y*m_local_dim.y, grid_pos.z*m_local_dim.z);
+    m_n_ghost = make_int3(0, 0, 0);
+    m_mesh_dim = m_local_dim;
+
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        if (m_row_comm[dir] != MPI_COMM_NULL)
+            MPI_Comm_free(&m_row_comm[dir]);
+
+        // the ranks in a row share the grid position along the other two directions, and are ordered along dir
+        unsigned int row;
+        if (dir == 0)
+            row = di(0, grid_pos.y, grid_pos.z);
+        else if (dir == 1)
+            row = di(grid_pos.x, 0, grid_pos.z);
+        else
+            row = di(grid_pos.x, grid_pos.y, 0);
+
+        MPI_Comm_split(m_exec_conf->getMPICommunicator(), row, pos[dir], &m_row_comm[dir]);
+
+        if (m_fft_1d_forward[dir])
+            kiss_fft_free(m_fft_1d_forward[dir]);
+        if (m_fft_1d_inverse[dir])
+            kiss_fft_free(m_fft_1d_inverse[dir]);
+        m_fft_1d_forward[dir] = kiss_fft_alloc(N[dir], 0, NULL, NULL);
+        m_fft_1d_inverse[dir] = kiss_fft_alloc(N[dir], 1, NULL, NULL);
+        }
+    }
+
+/*! The ghost layer must hold the full interpolation stencil of every local particle. Particles are only migrated
+    when the neighbor list is rebuilt, so they can be up to r_buff/2 outside of the local box.
+    The local meshes are reallocated when the required width changes.
+*/
+void PPPMForceCompute::updateGhostWidth()
+    {
+    Scalar3 npd = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    Scalar max_dist = Scalar(0.5)*m_nlist->getRBuff();
+
+    int3 n_ghost;
+    n_ghost.x = m_order/2 + 1 + (int)ceil(max_dist*(Scalar)m_Nx/npd.x);
+    n_ghost.y = m_order/2 + 1 + (int)ceil(max_dist*(Scalar)m_Ny/npd.y);
+    n_ghost.z = m_order/2 + 1 + (int)ceil(max_dist*(Scalar)m_Nz/npd.z);
+
+    if (n_ghost.x == m_n_ghost.x && n_ghost.y == m_n_ghost.y && n_ghost.z == m_n_ghost.z)
+        return;
+
+    // ghost cells are only exchanged with the nearest neighbors
+    if (n_ghost.x > m_local_dim.x || n_ghost.y > m_local_dim.y || n_ghost.z > m_local_dim.z)
+        {
+        m_exec_conf->msg->error() << "charge.pppm: The ghost layer (" << n_ghost.x << "x" << n_ghost.y << "x" << n_ghost.z
+                                  << ") is wider than the local mesh (" << m_local_dim.x << "x" << m_local_dim.y << "x"
+                                  << m_local_dim.z << ")." << endl;
+        m_exec_conf->msg->error() << "Use a finer mesh or fewer domains." << endl << endl;
+        throw std::runtime_error("Error computing PPPM forces");
+        }
+
+    m_n_ghost = n_ghost;
+    m_mesh_dim = make_int3(m_local_dim.x + 2*n_ghost.x, m_local_dim.y + 2*n_ghost.y, m_local_dim.z + 2*n_ghost.z);
+
+    unsigned int n_mesh = m_mesh_dim.x*m_mesh_dim.y*m_mesh_dim.z;
+    GPUArray<CUFFTCOMPLEX> mesh_rho(n_mesh, exec_conf);
+    m_mesh_rho.swap(mesh_rho);
+    GPUArray<CUFFTCOMPLEX> mesh_Ex(n_mesh, exec_conf);
+    m_mesh_Ex.swap(mesh_Ex);
+    GPUArray<CUFFTCOMPLEX> mesh_Ey(n_mesh, exec_conf);
+    m_mesh_Ey.swap(mesh_Ey);
+    GPUArray<CUFFTCOMPLEX> mesh_Ez(n_mesh, exec_conf);
+    m_mesh_Ez.swap(mesh_Ez);
+    }
+
+//! Ways of moving a box of mesh points between a mesh and a contiguous buffer
+enum mesh_copy_mode
+    {
+    mesh_to_buffer,
+    buffer_to_mesh,
+    add_buffer_to_mesh
+    };
+
+/*! \param mesh Local mesh
+    \param dim Dimensions of the local mesh
+    \param lo Lower corner of the box (inclusive)
+    \param hi Upper corner of the box (exclusive)
+    \param buf Buffer, the box is stored contiguously with z running fastest
+    \param mode Direction of the copy
+    \returns The number of mesh points copied
+*/
+static unsigned int copy_mesh_box(CUFFTCOMPLEX *mesh, const int3 dim, const int *lo, const int *hi,
+                                  CUFFTCOMPLEX *buf, mesh_copy_mode mode)
+    {
+    unsigned int k = 0;
+    for (int x = lo[0]; x < hi[0]; ++x)
+        for (int y = lo[1]; y < hi[1]; ++y)
+            for (int z = lo[2]; z < hi[2]; ++z)
+                {
+                CUFFTCOMPLEX& m = mesh[z + dim.z * (y + dim.y * x)];
+                if (mode == mesh_to_buffer)
+                    buf[k] = m;
+                else if (mode == buffer_to_mesh)
+                    m = buf[k];
+                else
+                    {
+                    m.x += buf[k].x;
+                    m.y += buf[k].y;
+                    }
+                k++;
+                }
+    return k;
+    }
+
+/*! \param meshes Local meshes including ghost cells
+    \param n_mesh Number of meshes
+    \param reduce If true, the ghost cells are summed into the neighboring domains. Otherwise the ghost cells
+           are filled with the values of the neighboring domains.
+
+    The ghost layers are exchanged one direction at a time. When reducing, the ghost cells along directions that
+    have already been handled are left out, because their values have been passed on. When filling, they are
+    included so that the corners are filled in by the later directions.
+*/
+void PPPMForceCompute::communicateGhostCells(CUFFTCOMPLEX **meshes, unsigned int n_mesh, bool reduce)
+    {
+    boost::shared_ptr<DomainDecomposition> decomposition = m_pdata->getDomainDecomposition();
+    MPI_Comm comm = m_exec_conf->getMPICommunicator();
+
+    int n[3] = {m_local_dim.x, m_local_dim.y, m_local_dim.z};
+    int g[3] = {m_n_ghost.x, m_n_ghost.y, m_n_ghost.z};
+    int M[3] = {m_mesh_dim.x, m_mesh_dim.y, m_mesh_dim.z};
+
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        int send_lo[3], send_hi[3], recv_lo[3], recv_hi[3];
+        for (unsigned int e = 0; e < 3; ++e)
+            {
+            bool with_ghosts = reduce ? (e > dir) : (e < dir);
+            send_lo[e] = recv_lo[e] = with_ghosts ? 0 : g[e];
+            send_hi[e] = recv_hi[e] = with_ghosts ? M[e] : g[e] + n[e];
+            }
+
+        unsigned int n_box = 1;
+        for (unsigned int e = 0; e < 3; ++e)
+            n_box *= (e == dir) ? g[e] : send_hi[e] - send_lo[e];
+        m_ghost_send_buf.resize(n_mesh*n_box);
+        m_ghost_recv_buf.resize(n_mesh*n_box);
+
+        // side 0 sends to the neighbor in +dir and receives from -dir, side 1 the other way around
+        for (unsigned int side = 0; side < 2; ++side)
+            {
+            unsigned int send_rank = decomposition->getNeighborRank(2*dir + side);
+            unsigned int recv_rank = decomposition->getNeighborRank(2*dir + 1 - side);
+
+            if (reduce)
+                {
+                // ghost cells are added to the first cells of the neighbor's block
+                send_lo[dir] = side == 0 ? n[dir] + g[dir] : 0;
+                recv_lo[dir] = side == 0 ? g[dir] : n[dir];
+                }
+            else
+                {
+                // the first and last cells of the block fill the ghost cells of the neighbor
+                send_lo[dir] = side == 0 ? n[dir] : g[dir];
+                recv_lo[dir] = side == 0 ? 0 : n[dir] + g[dir];
+                }
+            send_hi[dir] = send_lo[dir] + g[dir];
+            recv_hi[dir] = recv_lo[dir] + g[dir];
+
+            for (unsigned int i = 0; i < n_mesh; ++i)
+                copy_mesh_box(meshes[i], m_mesh_dim, send_lo, send_hi, &m_ghost_send_buf[i*n_box], mesh_to_buffer);
+
+            MPI_Sendrecv(&m_ghost_send_buf.front(), n_mesh*n_box*sizeof(CUFFTCOMPLEX), MPI_BYTE, send_rank, 0,
+                         &m_ghost_recv_buf.front(), n_mesh*n_box*sizeof(CUFFTCOMPLEX), MPI_BYTE, recv_rank, 0,
+                         comm, MPI_STATUS_IGNORE);
+
+            for (unsigned int i = 0; i < n_mesh; ++i)
+                copy_mesh_box(meshes[i], m_mesh_dim, recv_lo, recv_hi, &m_ghost_recv_buf[i*n_box],
+                              reduce ? add_buffer_to_mesh : buffer_to_mesh);
+            }
+        }
+    }
+
+/*! \param data Local blocks of the mesh (m_local_dim points each), transformed in place
+    \param n_data Number of blocks
+    \param inverse True for the inverse transform
+
+    The result is identical to the serial kiss_fftnd transform of the full mesh, restricted to the local block.
+*/
+void PPPMForceCompute::distributedFFT(CUFFTCOMPLEX **data, unsigned int n_data, bool inverse)
+    {
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        distributedFFT1D(dir, data, n_data, inverse);
+    }
+
+/*! \param dir Direction of the transform
+    \param data Local blocks of the mesh (m_local_dim points each), transformed in place
+    \param n_data Number of blocks
+    \param inverse True for the inverse transform
+
+    The local block holds a segment of every mesh line along \a dir. The lines are split evenly among the ranks of
+    the row communicator, which gather the segments of their lines with an MPI_Alltoallv, transform the complete
+    lines and return the segments with a second MPI_Alltoallv.
+*/
+void PPPMForceCompute::distributedFFT1D(unsigned int dir, CUFFTCOMPLEX **data, unsigned int n_data, bool inverse)
+    {
+    int n[3] = {m_local_dim.x, m_local_dim.y, m_local_dim.z};
+    int N[3] = {m_Nx, m_Ny, m_Nz};
+    int n_dir = n[dir];
+    int N_dir = N[dir];
+
+    // points along a line are inner apart, line l starts at (l % inner) + (l / inner)*inner*n_dir
+    unsigned int inner = 1;
+    for (unsigned int e = dir+1; e < 3; ++e)
+        inner *= n[e];
+    unsigned int n_lines = n[0]*n[1]*n[2]/n_dir;
+
+    MPI_Comm comm = m_row_comm[dir];
+    int n_ranks, rank;
+    MPI_Comm_size(comm, &n_ranks);
+    MPI_Comm_rank(comm, &rank);
+
+    // rank r transforms the lines [line_begin[r], line_begin[r+1])
+    std::vector<unsigned int> line_begin(n_ranks+1);
+    for (int r = 0; r <= n_ranks; ++r)
+        line_begin[r] = n_lines*r/n_ranks;
+    unsigned int my_lines = line_begin[rank+1] - line_begin[rank];
+
+    // all counts are in bytes
+    std::vector<int> send_counts(n_ranks), send_displs(n_ranks), recv_counts(n_ranks), recv_displs(n_ranks);
+    for (int r = 0; r < n_ranks; ++r)
+        {
+        send_counts[r] = (line_begin[r+1] - line_begin[r])*n_data*n_dir*sizeof(kiss_fft_cpx);
+        recv_counts[r] = my_lines*n_data*n_dir*sizeof(kiss_fft_cpx);
+        send_displs[r] = r ? send_displs[r-1] + send_counts[r-1] : 0;
+        recv_displs[r] = r ? recv_displs[r-1] + recv_counts[r-1] : 0;
+        }
+
+    unsigned int n_line_buf = my_lines*n_data*N_dir;
+    m_fft_send_buf.resize(n_lines*n_data*n_dir);
+    m_fft_recv_buf.resize(n_line_buf);
+    m_fft_line_buf.resize(n_line_buf);
+
+    // pack the segments, ordered by the rank that transforms the line
+    unsigned int k = 0;
+    for (unsigned int l = 0; l < n_lines; ++l)
+        {
+        unsigned int base = (l % inner) + (l / inner)*inner*n_dir;
+        for (unsigned int j = 0; j < n_data; ++j)
+            for (int a = 0; a < n_dir; ++a)
+                {
+                const CUFFTCOMPLEX& v = data[j][base + a*inner];
+                m_fft_send_buf[k].r = v.x;
+                m_fft_send_buf[k].i = v.y;
+                k++;
+                }
+        }
+
+    MPI_Alltoallv(&m_fft_send_buf.front(), &send_counts.front(), &send_displs.front(), MPI_BYTE,
+                  &m_fft_recv_buf.front(), &recv_counts.front(), &recv_displs.front(), MPI_BYTE, comm);
+
+    // assemble the lines, the segment received from rank s of the row starts at s*n_dir
+    k = 0;
+    for (int s = 0; s < n_ranks; ++s)
+        for (unsigned int l = 0; l < my_lines*n_data; ++l)
+            for (int a = 0; a < n_dir; ++a)
+                m_fft_line_buf[l*N_dir + s*n_dir + a] = m_fft_recv_buf[k++];
+
+    kiss_fft_cfg cfg = inverse ? m_fft_1d_inverse[dir] : m_fft_1d_forward[dir];
+    for (unsigned int l = 0; l < my_lines*n_data; ++l)
+        kiss_fft(cfg, &m_fft_line_buf[l*N_dir], &m_fft_recv_buf[l*N_dir]);
+
+    // split the transformed lines back into segments
+    k = 0;
+    for (int s = 0; s < n_ranks; ++s)
+        for (unsigned int l = 0; l < my_lines*n_data; ++l)
+            for (int a = 0; a < n_dir; ++a)
+                m_fft_line_buf[k++] = m_fft_recv_buf[l*N_dir + s*n_dir + a];
+
+    MPI_Alltoallv(&m_fft_line_buf.front(), &recv_counts.front(), &recv_displs.front(), MPI_BYTE,
+                  &m_fft_send_buf.front(), &send_counts.front(), &send_displs.front(), MPI_BYTE, comm);
+
+    k = 0;
+    for (unsigned int l = 0; l < n_lines; ++l)
+        {
+        unsigned int base = (l % inner) + (l / inner)*inner*n_dir;
+        for (unsigned int j = 0; j < n_data; ++j)
+            for (int a = 0; a < n_dir; ++a)
+                {
+                CUFFTCOMPLEX& v = data[j][base + a*inner];
+                v.x = m_fft_send_buf[k].r;
+                v.y = m_fft_send_buf[k].i;
+                k++;
+                }
+        }
+    }
+
+/*! The ghost cells of the charge mesh are summed into the neighboring domains, after which the local block is
+    copied into m_rho_real_space and transformed.
+*/
+void PPPMForceCompute::distributed_forward_fft()
+    {
+    ArrayHandle<CUFFTCOMPLEX> h_mesh_rho(m_mesh_rho, access_location::host, access_mode::readwrite);
+    CUFFTCOMPLEX *mesh[1] = {h_mesh_rho.data};
+    communicateGhostCells(mesh, 1, true);
+
+    ArrayHandle<CUFFTCOMPLEX> h_rho_real_space(m_rho_real_space, access_location::host, access_mode::overwrite);
+    for (int x = 0; x < m_local_dim.x; ++x)
+        for (int y = 0; y < m_local_dim.y; ++y)
+            for (int z = 0; z < m_local_dim.z; ++z)
+                {
+                unsigned int mesh_idx = (z + m_n_ghost.z) + m_mesh_dim.z * ((y + m_n_ghost.y) + m_mesh_dim.y * (x + m_n_ghost.x));
+                unsigned int block_idx = z + m_local_dim.z * (y + m_local_dim.y * x);
+                h_rho_real_space.data[block_idx].x = h_mesh_rho.data[mesh_idx].x;
+                h_rho_real_space.data[block_idx].y = Scalar(0.0);
+                }
+
+    CUFFTCOMPLEX *block[1] = {h_rho_real_space.data};
+    distributedFFT(block, 1, false);
+    }
+
+/*! The three field components are transformed together, copied into the local meshes, and the ghost cells are
+    filled from the neighboring domains.
+*/
+void PPPMForceCompute::distributed_inverse_fft()
+    {
+    ArrayHandle<CUFFTCOMPLEX> h_Ex(m_Ex, access_location::host, access_mode::readwrite);
+    ArrayHandle<CUFFTCOMPLEX> h_Ey(m_Ey, access_location::host, access_mode::readwrite);
+    ArrayHandle<CUFFTCOMPLEX> h_Ez(m_Ez, access_location::host, access_mode::readwrite);
+    CUFFTCOMPLEX *block[3] = {h_Ex.data, h_Ey.data, h_Ez.data};
+    distributedFFT(block, 3, true);
+
+    ArrayHandle<CUFFTCOMPLEX> h_mesh_Ex(m_mesh_Ex, access_location::host, access_mode::overwrite);
+    ArrayHandle<CUFFTCOMPLEX> h_mesh_Ey(m_mesh_Ey, access_location::host, access_mode::overwrite);
+    ArrayHandle<CUFFTCOMPLEX> h_mesh_Ez(m_mesh_Ez, access_location::host, access_mode::overwrite);
+    CUFFTCOMPLEX *mesh[3] = {h_mesh_Ex.data, h_mesh_Ey.data, h_mesh_Ez.data};
+
+    for (int x = 0; x < m_local_dim.x; ++x)
+        for (int y = 0; y < m_local_dim.y; ++y)
+            for (int z = 0; z < m_local_dim.z; ++z)
+                {
+                unsigned int mesh_idx = (z + m_n_ghost.z) + m_mesh_dim.z * ((y + m_n_ghost.y) + m_mesh_dim.y * (x + m_n_ghost.x));
+                unsigned int block_idx = z + m_local_dim.z * (y + m_local_dim.y * x);
+                for (unsigned int j = 0; j < 3; ++j)
+                    mesh[j][mesh_idx] = block[j][block_idx];
+                }
+
+    communicateGhostCells(mesh, 3, false);
+    }
+#endif
+
 void export_PPPMForceCompute()
     {
     class_<PPPMForceCompute, boost::shared_ptr<PPPMForceCompute>, bases<ForceCompute>, boost::noncopyable >
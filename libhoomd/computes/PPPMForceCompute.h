@@ -50,6 +50,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Maintainer: sbarr
 
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/signals2.hpp>
 
 #include "ForceCompute.h"
@@ -86,6 +87,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 #include "HOOMDMath.h"
 #include "kiss_fftnd.h"
+#include "FFTBackend.h"
 
 
 // MAX gives the larger of two values
@@ -103,6 +105,42 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //! Computes the long ranged part of the electrostatic forces on each particle
 /*! PPPM forces are computed on every particle in the simulation.
 
+    <b>Fourier transforms on the CPU</b>
+
+    On a single rank, the meshes are transformed by an FFTBackend (FFTW if hoomd is built with ENABLE_FFTW,
+    kiss_fft otherwise). The charge density is real, so only half of its spectrum is computed and the rest is filled
+    in from the hermitian symmetry. Only the real part of the inverse transform of the field is used for the
+    forces, which is the inverse transform of the hermitian part of the field spectrum. The three field components
+    are therefore symmetrized and transformed back in one real valued batch.
+
+    <b>Domain decomposition</b>
+
+    In MPI simulations with a DomainDecomposition, the mesh is divided into blocks along the same processor grid
+    as the particles. Every rank owns the m_local_dim block of mesh points starting at global mesh index
+    m_local_offset, and spreads the charges of its local particles onto a local mesh (m_mesh_rho) that extends the
+    block by m_n_ghost cells on every side. The ghost layer is wide enough to hold the stencil of particles that
+    have moved up to r_buff/2 outside of the local box since the last migration. Ghost cell contributions are then
+    summed into the owning neighbor (communicateGhostCells()), and the block is Fourier transformed by
+    distributedFFT().
+
+    The parallel FFT works on pencils: for each of the three directions in turn, the ranks that share a row of
+    domains along that direction exchange their blocks with an MPI_Alltoallv so that every rank holds a subset of
+    complete mesh lines, transform those lines with a 1D FFT, and send them back. The result is left in the block
+    layout, so that the Green's function, k vectors and virial coefficients only need to be stored for the local
+    block. After the inverse transform of the field components, the ghost layer of the field meshes is filled from
+    the neighbors and the forces are interpolated locally.
+
+    The mesh dimensions must be divisible by the number of domains along the corresponding direction.
+
+    <b>Multithreading</b>
+
+    The charge assignment and the force interpolation run on the ThreadPool of the execution configuration. The
+    stencil origin and the order weights along each direction are computed once per particle and time step, and
+    are shared by both stages. The forces are interpolated independently for every particle. To spread the charges
+    without write conflicts, every thread owns a contiguous range of mesh planes along x and adds the contributions
+    of all particles whose stencils cover its planes. The particles are sorted by the x plane of their stencil
+    origin, and every mesh point sums its contributions in the same fixed order, so the charge mesh and the forces
+    do not depend on the number of threads or on how the planes are divided between them.
 */
 class PPPMForceCompute : public ForceCompute
     {
@@ -150,6 +188,17 @@ class PPPMForceCompute : public ForceCompute
         void fix_exclusions_cpu();
         //! fix the energy and virial thermodynamic quantities
         virtual void fix_thermo_quantities();
+        //! Transform the charge mesh of a single rank
+        void serial_forward_fft();
+        //! Transform the field components of a single rank
+        void serial_inverse_fft();
+
+#ifdef ENABLE_MPI
+        //! Fold ghost cells of the charge mesh and transform the local block
+        void distributed_forward_fft();
+        //! Transform the local blocks of the field and fill the ghost cells of the field meshes
+        void distributed_inverse_fft();
+#endif
 
     protected:
         GPUArray<Scalar>m_vg;                    //!< Virial coefficient
@@ -185,13 +234,74 @@ class PPPMForceCompute : public ForceCompute
         boost::signals2::connection m_boxchange_connection;   //!< Connection to the ParticleData box size change signal
         boost::shared_ptr<NeighborList> m_nlist; //!< The neighborlist to use for the computation
         boost::shared_ptr<ParticleGroup> m_group;//!< Group to compute properties for
-        kiss_fft_cpx *fft_in;                    //!< For FFTs on CPU rho_real_space
-        kiss_fft_cpx *fft_ex;                    //!< For FFTs on CPU E-field x component
-        kiss_fft_cpx *fft_ey;                    //!< For FFTs on CPU E-field y component
-        kiss_fft_cpx *fft_ez;                    //!< For FFTs on CPU E-field z component
-        kiss_fftnd_cfg fft_forward;              //!< Forward FFT on CPU
-        kiss_fftnd_cfg fft_inverse;              //!< Inverse FFT on CPU
-        int first_run;                           //!< flag for allocating arrays
+        boost::scoped_ptr<FFTBackend> m_fft;     //!< Transforms of the full mesh on the CPU (created on first use)
+
+        bool m_distributed;                      //!< True if the mesh is divided among the MPI ranks
+        int3 m_local_dim;                        //!< Number of mesh points in the block owned by this rank
+        int3 m_local_offset;                     //!< Global mesh index of the first point of the local block
+        int3 m_n_ghost;                          //!< Number of ghost cells on either side of the local block
+        int3 m_mesh_dim;                         //!< Dimensions of the local mesh including ghost cells
+        GPUArray<CUFFTCOMPLEX> m_mesh_rho;       //!< Local charge density mesh including ghost cells (MPI only)
+        GPUArray<CUFFTCOMPLEX> m_mesh_Ex;        //!< Local x component of the field including ghost cells (MPI only)
+        GPUArray<CUFFTCOMPLEX> m_mesh_Ey;        //!< Local y component of the field including ghost cells (MPI only)
+        GPUArray<CUFFTCOMPLEX> m_mesh_Ez;        //!< Local z component of the field including ghost cells (MPI only)
+
+        std::vector<int3> m_stencil_origin;      //!< Mesh index of the first stencil point of each local particle
+        std::vector<Scalar> m_stencil_weight;    //!< Assignment weights along x, y and z of each local particle
+        std::vector<unsigned int> m_plane_start; //!< Offset of the first particle of each x plane in m_plane_particles
+        std::vector<unsigned int> m_plane_particles; //!< Local particles sorted by the x plane of their stencil origin
+        std::vector<unsigned int> m_thread_first_plane; //!< First x plane of the mesh spread by each thread
+        std::vector<unsigned int> m_thread_out_of_bounds; //!< Number of particles outside of the mesh per thread
+
+        //! Pointers to the input and output arrays of the threaded mesh assignment, shared by all threads
+        struct assign_args
+            {
+            const Scalar4 *pos;                  //!< Particle positions
+            const Scalar *charge;                //!< Particle charges
+            const Scalar *rho_coeff;             //!< Coefficients of the assignment function
+            CUFFTCOMPLEX *rho;                   //!< Charge mesh (output)
+            const CUFFTCOMPLEX *Ex;              //!< x component of the field
+            const CUFFTCOMPLEX *Ey;              //!< y component of the field
+            const CUFFTCOMPLEX *Ez;              //!< z component of the field
+            Scalar4 *force;                      //!< Particle forces (output)
+            BoxDim box;                          //!< Global simulation box
+            Scalar charge_scale;                 //!< Factor converting a charge to a charge density
+            unsigned int N;                      //!< Number of local particles
+            };
+
+        //! Compute the stencil origins and weights of the particles assigned to one thread
+        void computeStencilsThread(unsigned int thread_idx, const assign_args& args);
+
+        //! Spread the charges onto the mesh planes assigned to one thread
+        void spreadChargesThread(unsigned int thread_idx, const assign_args& args);
+
+        //! Interpolate the forces on the particles assigned to one thread
+        void interpolateForcesThread(unsigned int thread_idx, const assign_args& args);
+
+        //! Sort the particles by the x plane of their stencil origin and divide the planes between the threads
+        void sortParticlesIntoPlanes();
+
+#ifdef ENABLE_MPI
+        MPI_Comm m_row_comm[3];                  //!< Communicators of the ranks sharing a row of domains along x,y,z
+        kiss_fft_cfg m_fft_1d_forward[3];        //!< Forward 1D FFTs along x,y,z
+        kiss_fft_cfg m_fft_1d_inverse[3];        //!< Inverse 1D FFTs along x,y,z
+        std::vector<kiss_fft_cpx> m_fft_send_buf;    //!< Send buffer for the FFT transposes
+        std::vector<kiss_fft_cpx> m_fft_recv_buf;    //!< Receive buffer for the FFT transposes
+        std::vector<kiss_fft_cpx> m_fft_line_buf;    //!< Complete mesh lines being transformed
+        std::vector<CUFFTCOMPLEX> m_ghost_send_buf;  //!< Send buffer for ghost cell communication
+        std::vector<CUFFTCOMPLEX> m_ghost_recv_buf;  //!< Receive buffer for ghost cell communication
+
+        //! Set up the block decomposition of the mesh and the row communicators
+        void initializeDomainMesh();
+        //! Resize the ghost layer to account for the current neighbor list buffer
+        void updateGhostWidth();
+        //! Exchange the ghost layers of several meshes with the neighboring domains
+        void communicateGhostCells(CUFFTCOMPLEX **meshes, unsigned int n_mesh, bool reduce);
+        //! Fourier transform a set of local blocks of the distributed mesh
+        void distributedFFT(CUFFTCOMPLEX **data, unsigned int n_data, bool inverse);
+        //! Fourier transform a set of local blocks of the distributed mesh along one direction
+        void distributedFFT1D(unsigned int dir, CUFFTCOMPLEX **data, unsigned int n_data, bool inverse);
+#endif
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -50,6 +50,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Maintainer: phillicl
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include "TableDihedralForceCompute.h"
@@ -168,66 +169,77 @@ Scalar TableDihedralForceCompute::getLogValue(const std::string& quantity, unsig
         }
     }
 
-/*! \post The table based forces are computed for the given timestep.
-\param timestep specifies the current time step of the simulation
-*/
+/*! Actually perform the force computation
+    \param timestep Current time step
+
+    The dihedrals are divided among the threads as described for ForceCompute::bonded_output.
+ */
 void TableDihedralForceCompute::computeForces(unsigned int timestep)
     {
-
-    // start the profile for this compute
     if (m_prof) m_prof->push("Dihedral Table pair");
 
+    assert(m_pdata);
+
+    // the table is rebuilt here if the particles have been sorted since the last call
+    const GPUVector<DihedralData::members_t>& dihedral_table = m_dihedral_data->getCPUTable();
+    const GPUVector<unsigned int>& dihedral_type = m_dihedral_data->getCPUTableTypes();
+    const GPUVector<unsigned int>& dihedral_offset = m_dihedral_data->getCPUTableOffsets();
 
-    // access the particle data
+    // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
+    ArrayHandle<DihedralData::members_t> h_dihedrals(dihedral_table, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_type(dihedral_type, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_offset(dihedral_offset, access_location::host, access_mode::read);
+
+    // access the table data
+    ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::read);
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
     assert(h_pos.data);
 
-    unsigned int virial_pitch = m_virial.getPitch();
-
     // Zero data for force calculation.
     memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
     memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
 
-    // get a local copy of the simulation box too
-    const BoxDim& box = m_pdata->getBox();
+    cpu_args args;
+    args.pos = h_pos.data;
+    args.dihedrals = h_dihedrals.data;
+    args.type = h_type.data;
+    args.offset = h_offset.data;
+    args.tables = h_tables.data;
+    args.box = m_pdata->getBox();
+    args.force = h_force.data;
+    args.virial = h_virial.data;
 
-    // access the table data
-    ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::read);
+    resetThreadSpill();
+    m_exec_conf->getThreadPool().run(bind(&TableDihedralForceCompute::computeForcesThread, this, _1, boost::cref(args)));
+    applyThreadSpill(h_force.data, h_virial.data, true);
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+void TableDihedralForceCompute::computeForcesThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    bonded_output out = getBondedOutput(thread_idx, args.force, args.virial, true);
 
-    // for each of the dihedrals
-    const unsigned int size = (unsigned int)m_dihedral_data->getN();
-    for (unsigned int i = 0; i < size; i++)
+    // for each of the dihedrals whose lowest member is owned by this thread
+    for (unsigned int i = args.offset[out.first]; i < args.offset[out.last]; i++)
         {
-        // lookup the tag of each of the particles participating in the dihedral
-        const DihedralData::members_t& dihedral = m_dihedral_data->getMembersByIndex(i);
-        assert(dihedral.tag[0] < m_pdata->getNGlobal());
-        assert(dihedral.tag[1] < m_pdata->getNGlobal());
-        assert(dihedral.tag[2] < m_pdata->getNGlobal());
-        assert(dihedral.tag[3] < m_pdata->getNGlobal());
-
-        // transform a and b into indicies into the particle data arrays
-        // (MEM TRANSFER: 4 integers)
-        unsigned int idx_a = h_rtag.data[dihedral.tag[0]];
-        unsigned int idx_b = h_rtag.data[dihedral.tag[1]];
-        unsigned int idx_c = h_rtag.data[dihedral.tag[2]];
-        unsigned int idx_d = h_rtag.data[dihedral.tag[3]];
-
-        // throw an error if this angle is incomplete
-        if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL || idx_d == NOT_LOCAL)
-            {
-            this->m_exec_conf->msg->error() << "dihedral.harmonic: dihedral " <<
-                dihedral.tag[0] << " " << dihedral.tag[1] << " " << dihedral.tag[2] << " " << dihedral.tag[3]
-                << " incomplete." << endl << endl;
-            throw std::runtime_error("Error in dihedral calculation");
-            }
+        // the indices of the particles participating in the dihedral
+        const DihedralData::members_t& dihedral = args.dihedrals[i];
+        unsigned int idx_a = dihedral.idx[0];
+        unsigned int idx_b = dihedral.idx[1];
+        unsigned int idx_c = dihedral.idx[2];
+        unsigned int idx_d = dihedral.idx[3];
 
         assert(idx_a < m_pdata->getN()+m_pdata->getNGhosts());
         assert(idx_b < m_pdata->getN()+m_pdata->getNGhosts());
@@ -236,14 +248,14 @@ void TableDihedralForceCompute::computeForces(unsigned int timestep)
 
         // calculate d\vec{r}
         Scalar3 dab;
-        dab.x = h_pos.data[idx_a].x - h_pos.data[idx_b].x; //vb1x
-        dab.y = h_pos.data[idx_a].y - h_pos.data[idx_b].y; //vb1y
-        dab.z = h_pos.data[idx_a].z - h_pos.data[idx_b].z; //vb1z
+        dab.x = args.pos[idx_a].x - args.pos[idx_b].x; //vb1x
+        dab.y = args.pos[idx_a].y - args.pos[idx_b].y; //vb1y
+        dab.z = args.pos[idx_a].z - args.pos[idx_b].z; //vb1z
 
         Scalar3 dcb;
-        dcb.x = h_pos.data[idx_c].x - h_pos.data[idx_b].x; //vb2x
-        dcb.y = h_pos.data[idx_c].y - h_pos.data[idx_b].y; //vb2y
-        dcb.z = h_pos.data[idx_c].z - h_pos.data[idx_b].z; //vb2z
+        dcb.x = args.pos[idx_c].x - args.pos[idx_b].x; //vb2x
+        dcb.y = args.pos[idx_c].y - args.pos[idx_b].y; //vb2y
+        dcb.z = args.pos[idx_c].z - args.pos[idx_b].z; //vb2z
 
         Scalar3 dcbm;
         dcbm.x = -dcb.x;
@@ -251,15 +263,15 @@ void TableDihedralForceCompute::computeForces(unsigned int timestep)
         dcbm.z = -dcb.z;
 
         Scalar3 ddc;
-        ddc.x = h_pos.data[idx_d].x - h_pos.data[idx_c].x; //vb3x
-        ddc.y = h_pos.data[idx_d].y - h_pos.data[idx_c].y; //vb3y
-        ddc.z = h_pos.data[idx_d].z - h_pos.data[idx_c].z; //vb3z
+        ddc.x = args.pos[idx_d].x - args.pos[idx_c].x; //vb3x
+        ddc.y = args.pos[idx_d].y - args.pos[idx_c].y; //vb3y
+        ddc.z = args.pos[idx_d].z - args.pos[idx_c].z; //vb3z
 
         // apply periodic boundary conditions
-        dab = box.minImage(dab);
-        dcb = box.minImage(dcb);
-        ddc = box.minImage(ddc);
-        dcbm = box.minImage(dcbm);
+        dab = args.box.minImage(dab);
+        dcb = args.box.minImage(dcb);
+        ddc = args.box.minImage(ddc);
+        dcbm = args.box.minImage(dcbm);
 
         // c0 calculation
         Scalar sb1 = 1.0 / (dab.x*dab.x + dab.y*dab.y + dab.z*dab.z);
@@ -322,10 +334,10 @@ void TableDihedralForceCompute::computeForces(unsigned int timestep)
         // compute index into the table and read in values
 
         /// Here we use the table!!
-        unsigned int dihedral_type = m_dihedral_data->getTypeByIndex(i);
+        unsigned int dihedral_type = args.type[i];
         unsigned int value_i = value_f;
-        Scalar2 VT0 = h_tables.data[m_table_value(value_i, dihedral_type)];
-        Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, dihedral_type)];
+        Scalar2 VT0 = args.tables[m_table_value(value_i, dihedral_type)];
+        Scalar2 VT1 = args.tables[m_table_value(value_i+1, dihedral_type)];
         // unpack the data
         Scalar V0 = VT0.x;
         Scalar V1 = VT1.x;
@@ -366,36 +378,12 @@ void TableDihedralForceCompute::computeForces(unsigned int timestep)
         dihedral_virial[4] = (1./4.)*(dab.z*f_a.y + dcb.z*f_c.y + (ddc.z+dcb.z)*f_d.y);
         dihedral_virial[5] = (1./4.)*(dab.z*f_a.z + dcb.z*f_c.z + (ddc.z+dcb.z)*f_d.z);
 
-        h_force.data[idx_a].x += f_a.x;
-        h_force.data[idx_a].y += f_a.y;
-        h_force.data[idx_a].z += f_a.z;
-        h_force.data[idx_a].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_a]  += dihedral_virial[k];
-
-        h_force.data[idx_b].x += f_b.x;
-        h_force.data[idx_b].y += f_b.y;
-        h_force.data[idx_b].z += f_b.z;
-        h_force.data[idx_b].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_b]  += dihedral_virial[k];
-
-        h_force.data[idx_c].x += f_c.x;
-        h_force.data[idx_c].y += f_c.y;
-        h_force.data[idx_c].z += f_c.z;
-        h_force.data[idx_c].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_c]  += dihedral_virial[k];
-
-        h_force.data[idx_d].x += f_d.x;
-        h_force.data[idx_d].y += f_d.y;
-        h_force.data[idx_d].z += f_d.z;
-        h_force.data[idx_d].w += dihedral_eng;
-        for (int k = 0; k < 6; k++)
-           h_virial.data[virial_pitch*k+idx_d]  += dihedral_virial[k];
-       }
-
-    if (m_prof) m_prof->pop();
+        // ghost particles receive no forces
+        out.add(idx_a, make_scalar4(f_a.x, f_a.y, f_a.z, dihedral_eng), dihedral_virial);
+        out.add(idx_b, make_scalar4(f_b.x, f_b.y, f_b.z, dihedral_eng), dihedral_virial);
+        out.add(idx_c, make_scalar4(f_c.x, f_c.y, f_c.z, dihedral_eng), dihedral_virial);
+        out.add(idx_d, make_scalar4(f_d.x, f_d.y, f_d.z, dihedral_eng), dihedral_virial);
+        }
     }
 
 //! Exports the TableDihedralForceCompute class to python
@@ -136,8 +136,24 @@ class TableDihedralForceCompute : public ForceCompute
         Index2D m_table_value;                      //!< Index table helper
         std::string m_log_name;                     //!< Cached log name
 
+        //! Pointers to the input and output arrays of the CPU force computation, shared by all threads
+        struct cpu_args
+            {
+            const Scalar4 *pos;                     //!< Particle positions
+            const DihedralData::members_t *dihedrals;   //!< Dihedrals ordered by their lowest member index
+            const unsigned int *type;               //!< Types of the dihedrals
+            const unsigned int *offset;             //!< Offsets of the dihedrals by lowest member index
+            const Scalar2 *tables;                  //!< Potential and torque tables
+            BoxDim box;                             //!< Simulation box
+            Scalar4 *force;                         //!< Forces (output)
+            Scalar *virial;                         //!< Virials (output)
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! Compute the forces of the dihedrals assigned to one thread
+        void computeForcesThread(unsigned int thread_idx, const cpu_args& args);
     };
 
 //! Exports the TablePotential class to python
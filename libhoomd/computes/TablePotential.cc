@@ -232,7 +232,8 @@ void TablePotential::computeForces(unsigned int timestep)
     // access the neighbor list
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-    Index2D nli = m_nlist->getNListIndexer();
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+    const unsigned int nlist_stride = m_nlist->getNListStride();
 
     // access the particle data
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
@@ -284,7 +285,7 @@ void TablePotential::computeForces(unsigned int timestep)
         for (unsigned int j = 0; j < size; j++)
             {
             // access the index of this neighbor
-            unsigned int k = h_nlist.data[nli(i, j)];
+            unsigned int k = h_nlist.data[h_head_list.data[i] + j*nlist_stride];
             // sanity check
             assert(k < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -87,6 +87,16 @@ class CellListGPU : public CellList
             m_tuner->setEnabled(enable);
             }
 
+        //! The compact layout is not implemented on the GPU
+        virtual void setCompact(bool compact)
+            {
+            if (compact)
+                {
+                m_exec_conf->msg->error() << "cell list: The compact layout is not supported on the GPU" << std::endl;
+                throw std::runtime_error("Error setting cell list parameters");
+                }
+            }
+
     protected:
         //! Compute the cell list
         virtual void computeCellList();
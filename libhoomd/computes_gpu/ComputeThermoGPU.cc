@@ -199,6 +199,9 @@ void ComputeThermoGPU::reduceProperties()
     cudaEventSynchronize(m_event);
 
     // reduce properties
+    if (postProperties(h_properties.data))
+        return;
+
     MPI_Allreduce(MPI_IN_PLACE, h_properties.data, thermo_index::num_quantities, MPI_HOOMD_SCALAR,
             MPI_SUM, m_exec_conf->getMPICommunicator());
 
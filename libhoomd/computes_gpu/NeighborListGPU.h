@@ -118,6 +118,16 @@ class NeighborListGPU : public NeighborList
             m_tuner_filter->setEnabled(enable);
             }
 
+        //! Compact storage is not implemented on the GPU
+        virtual void setCompactStorage(bool compact)
+            {
+            if (compact)
+                {
+                m_exec_conf->msg->error() << "nlist: Compact storage is not supported on the GPU" << std::endl;
+                throw std::runtime_error("Error setting neighbor list storage");
+                }
+            }
+
         //! Benchmark the filter kernel
         double benchmarkFilter(unsigned int num_iters);
 
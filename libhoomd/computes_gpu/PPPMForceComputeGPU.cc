@@ -109,6 +109,15 @@ PPPMForceComputeGPU::~PPPMForceComputeGPU()
 */
 void PPPMForceComputeGPU::setParams(int Nx, int Ny, int Nz, int order, Scalar kappa, Scalar rcut)
     {
+#ifdef ENABLE_MPI
+    // the GPU implementation transforms the full mesh
+    if (m_pdata->getDomainDecomposition())
+        {
+        m_exec_conf->msg->error() << "charge.pppm: Domain decomposition is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error initializing PPPMForceComputeGPU");
+        }
+#endif
+
     PPPMForceCompute::setParams(Nx, Ny, Nz, order, kappa, rcut);
     cufftPlan3d(&plan, Nx, Ny, Nz, CUFFT_TRANSFORM_TYPE);
 
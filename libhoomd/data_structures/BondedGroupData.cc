@@ -58,6 +58,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ParticleData.h"
 #include "Index1D.h"
 
+#include <vector>
+#include <algorithm>
+
 #ifdef ENABLE_CUDA
 #include "BondedGroupData.cuh"
 #include "CachedAllocator.h"
@@ -81,7 +84,8 @@ template<unsigned int group_size, typename Group, const char *name>
 BondedGroupData<group_size, Group, name>::BondedGroupData(
     boost::shared_ptr<ParticleData> pdata,
     unsigned int n_group_types)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_nglobal(0), m_groups_dirty(true),
+      m_cpu_table_dirty(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name<< "s, n=" << group_size << ") "
         << endl;
@@ -127,7 +131,8 @@ template<unsigned int group_size, typename Group, const char *name>
 BondedGroupData<group_size, Group, name>::BondedGroupData(
     boost::shared_ptr<ParticleData> pdata,
     const Snapshot& snapshot)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_nglobal(0), m_groups_dirty(true),
+      m_cpu_table_dirty(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name << ") " << endl;
 
@@ -201,6 +206,16 @@ void BondedGroupData<group_size, Group, name>::initialize()
     GPUVector<unsigned int> n_groups(m_exec_conf);
     m_n_groups.swap(n_groups);
 
+    // Lookup by lowest member index table
+    GPUVector<members_t> cpu_table(m_exec_conf);
+    m_cpu_table.swap(cpu_table);
+
+    GPUVector<unsigned int> cpu_table_type(m_exec_conf);
+    m_cpu_table_type.swap(cpu_table_type);
+
+    GPUVector<unsigned int> cpu_table_offset(m_exec_conf);
+    m_cpu_table_offset.swap(cpu_table_offset);
+
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
@@ -398,8 +413,8 @@ unsigned int BondedGroupData<group_size, Group, name>::addBondedGroup(Group g)
     // increment number of bonded groups
     m_nglobal++;
 
-    // set flag to rebuild GPU table
-    m_groups_dirty = true;
+    // set flag to rebuild the lookup tables
+    setDirty();
 
     // notifiy observers
     m_group_num_change_signal();
@@ -590,8 +605,8 @@ void BondedGroupData<group_size, Group, name>::removeBondedGroup(unsigned int ta
     m_recycled_tags.push(tag);
     m_nglobal--;
 
-    // set flag to trigger rebuild of GPU table
-    m_groups_dirty = true;
+    // set flag to trigger rebuild of the lookup tables
+    setDirty();
 
     // notifiy observers
     m_group_num_change_signal();
@@ -752,6 +767,79 @@ void BondedGroupData<group_size, Group, name>::rebuildGPUTable()
         }
     }
 
+/*! The groups are sorted by the lowest local index of their members with a stable counting sort. After a particle
+    sort, the groups of a molecule are then stored next to each other and next to the particles they act on, so
+    bonded force computations stream through the particle data instead of accessing it through the reverse-lookup
+    table in tag order.
+ */
+template<unsigned int group_size, typename Group, const char *name>
+void BondedGroupData<group_size, Group, name>::rebuildCPUTable()
+    {
+    if (m_prof) m_prof->push("update " + std::string(name) + " CPU table");
+
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_group_type(m_group_type, access_location::host, access_mode::read);
+
+    unsigned int N = m_pdata->getN();
+    unsigned int n_groups = getN();
+
+    m_cpu_table.resize(n_groups);
+    m_cpu_table_type.resize(n_groups);
+    m_cpu_table_offset.resize(N+1);
+
+    ArrayHandle<members_t> h_cpu_table(m_cpu_table, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cpu_table_type(m_cpu_table_type, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cpu_table_offset(m_cpu_table_offset, access_location::host, access_mode::overwrite);
+
+    // lowest member index of every group, groups of ghost particles only are counted at N
+    std::vector<unsigned int> key(n_groups);
+    memset(h_cpu_table_offset.data, 0, sizeof(unsigned int)*(N+1));
+    for (unsigned int cur_group = 0; cur_group < n_groups; cur_group++)
+        {
+        const members_t& g = h_groups.data[cur_group];
+        unsigned int min_idx = N;
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            unsigned int idx = h_rtag.data[g.tag[i]];
+
+            if (idx == NOT_LOCAL)
+                {
+                // incomplete group
+                std::ostringstream oss;
+                oss << name << ".*: " << name << " ";
+                for (unsigned int k = 0; k < group_size; ++k)
+                    oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
+                oss << "incomplete!" << std::endl;
+                m_exec_conf->msg->error() << oss.str();
+                throw std::runtime_error("Error building CPU group table.");
+                }
+
+            min_idx = std::min(min_idx, idx);
+            }
+
+        key[cur_group] = min_idx;
+        if (min_idx < N)
+            h_cpu_table_offset.data[min_idx+1]++;
+        }
+
+    // exclusive scan of the counts, the all-ghost groups follow the last local particle
+    for (unsigned int i = 0; i < N; i++)
+        h_cpu_table_offset.data[i+1] += h_cpu_table_offset.data[i];
+
+    std::vector<unsigned int> fill(h_cpu_table_offset.data, h_cpu_table_offset.data + N + 1);
+    for (unsigned int cur_group = 0; cur_group < n_groups; cur_group++)
+        {
+        unsigned int k = fill[key[cur_group]]++;
+        const members_t& g = h_groups.data[cur_group];
+        for (unsigned int i = 0; i < group_size; ++i)
+            h_cpu_table.data[k].idx[i] = h_rtag.data[g.tag[i]];
+        h_cpu_table_type.data[k] = h_group_type.data[cur_group];
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
 #ifdef ENABLE_CUDA
 template<unsigned int group_size, typename Group, const char *name>
 void BondedGroupData<group_size, Group, name>::rebuildGPUTableGPU()
@@ -1063,7 +1151,7 @@ void BondedGroupData<group_size, Group, name>::moveParticleGroups(unsigned int t
 
     // notify observers
     m_group_num_change_signal();
-    m_groups_dirty = true;
+    setDirty();
     }
 #endif
 
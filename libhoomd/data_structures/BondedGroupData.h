@@ -468,6 +468,37 @@ class BondedGroupData : boost::noncopyable
             return m_n_groups;
             }
 
+        /*
+         * CPU group table
+         */
+
+        //! Return the local groups with member indices, ordered by the lowest local index of their members
+        /*! The members are in the same order as in the group, but stored as particle indices (idx) instead of tags.
+            Groups with the same lowest member index keep their relative order.
+         */
+        const GPUVector<members_t>& getCPUTable()
+            {
+            checkCPUTable();
+            return m_cpu_table;
+            }
+
+        //! Return the types of the groups in the CPU table
+        const GPUVector<unsigned int>& getCPUTableTypes()
+            {
+            checkCPUTable();
+            return m_cpu_table_type;
+            }
+
+        //! Return the offsets of the groups in the CPU table by their lowest member index
+        /*! The groups whose lowest member index is i < N are stored in [offsets[i], offsets[i+1]). Groups that
+            consist only of ghost particles are stored in [offsets[N], getN()).
+         */
+        const GPUVector<unsigned int>& getCPUTableOffsets()
+            {
+            checkCPUTable();
+            return m_cpu_table_offset;
+            }
+
         /*
          * add/remove groups globally
          */
@@ -503,6 +534,7 @@ class BondedGroupData : boost::noncopyable
         void setDirty()
             {
             m_groups_dirty = true;
+            m_cpu_table_dirty = true;
             }
 
     protected:
@@ -526,6 +558,9 @@ class BondedGroupData : boost::noncopyable
         GPUVector<unsigned int> m_gpu_pos_table;     //!< Position of particle idx in group table
         Index2D m_gpu_table_indexer;                 //!< Indexer for GPU table
         GPUVector<unsigned int> m_n_groups;          //!< Number of entries in lookup table per particle
+        GPUVector<members_t> m_cpu_table;            //!< Groups by lowest member index for access on the CPU
+        GPUVector<unsigned int> m_cpu_table_type;    //!< Types of the groups in the CPU table
+        GPUVector<unsigned int> m_cpu_table_offset;  //!< Offsets of the groups in the CPU table per particle index
         std::vector<std::string> m_type_mapping;     //!< Mapping of types of bonded groups
 
         #ifdef ENABLE_MPI
@@ -547,6 +582,7 @@ class BondedGroupData : boost::noncopyable
 
     private:
         bool m_groups_dirty;                         //!< Is it necessary to rebuild the lookup-by-index table?
+        bool m_cpu_table_dirty;                      //!< Is it necessary to rebuild the CPU table?
         boost::signals2::connection m_sort_connection;   //!< Connection to the resort signal from ParticleData
 
         #ifdef ENABLE_MPI
@@ -561,6 +597,19 @@ class BondedGroupData : boost::noncopyable
         //! Helper function to rebuild lookup by index table
         void rebuildGPUTable();
 
+        //! Rebuild the CPU table if necessary
+        void checkCPUTable()
+            {
+            if (m_cpu_table_dirty)
+                {
+                rebuildCPUTable();
+                m_cpu_table_dirty = false;
+                }
+            }
+
+        //! Helper function to rebuild the CPU table
+        void rebuildCPUTable();
+
         #ifdef ENABLE_CUDA
         //! Helper function to rebuild lookup by index table on the GPU
         void rebuildGPUTableGPU();
@@ -111,6 +111,10 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
     exec_mode = mode;
 
     m_rank = 0;
+    m_thread_pool = boost::shared_ptr<ThreadPool>(new ThreadPool(1));
+    m_pin_threads = false;
+    m_host_alloc_flags = host_alloc::none;
+    m_host_pool = boost::shared_ptr<HostMemoryPool>(new HostMemoryPool());
 
 #ifdef ENABLE_CUDA
     // scan the available GPUs
@@ -158,6 +162,11 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
 
     setupStats();
 
+    // size the thread pool from the environment, it can be changed later with setNumThreads()
+    unsigned int n_threads = getDefaultNumThreads();
+    if (n_threads > 1)
+        setNumThreads(n_threads);
+
     #ifdef ENABLE_CUDA
     if (exec_mode == GPU)
         {
@@ -228,6 +237,64 @@ void ExecutionConfiguration::initializeMPI()
     }
 #endif
 
+/*! \param n_threads Number of CPU threads to use (including the main thread)
+
+    The thread pool is recreated with the requested number of threads. It must not be called while any compute
+    is executing.
+*/
+void ExecutionConfiguration::setNumThreads(unsigned int n_threads)
+    {
+    if (n_threads == 0)
+        {
+        msg->error() << "The number of CPU threads must be at least 1" << endl;
+        throw runtime_error("Error setting the number of threads");
+        }
+
+    if (n_threads == getNumThreads())
+        return;
+
+    // shut down the old pool before starting the new threads
+    m_thread_pool.reset();
+    m_thread_pool = boost::shared_ptr<ThreadPool>(new ThreadPool(n_threads, m_pin_threads));
+    n_cpu = n_threads;
+
+    if (exec_mode == GPU && n_threads > 1)
+        msg->notice(2) << "Multiple CPU threads requested, but only CPU code paths are multithreaded" << endl;
+
+    // warn if the threads of all ranks on this node exceed the number of hardware threads
+    unsigned int n_hw_threads = boost::thread::hardware_concurrency();
+    int n_local_ranks = guessLocalSize();
+    if (n_local_ranks < 1)
+        n_local_ranks = 1;
+    if (getRank() == 0 && n_hw_threads > 0 && n_threads*n_local_ranks > n_hw_threads)
+        msg->warning() << n_local_ranks << " rank(s) with " << n_threads << " CPU thread(s) each oversubscribe the "
+                       << n_hw_threads << " hardware threads of this node" << endl;
+
+    ostringstream s;
+    s << "HOOMD-blue is using " << n_threads << " CPU thread(s) per rank" << endl;
+    msg->collectiveNoticeStr(2, s.str());
+    }
+
+/*! \param pin_threads If true, pin every CPU thread to one of the cores this rank may run on
+
+    The thread pool is recreated with the same number of threads. The cores are taken in order from the affinity
+    mask of the calling thread, so every rank should be bound to its own set of cores by the MPI launcher (or with
+    \c taskset). It must not be called while any compute is executing.
+*/
+void ExecutionConfiguration::setPinThreads(bool pin_threads)
+    {
+    m_pin_threads = pin_threads;
+    if (pin_threads == getPinThreads())
+        return;
+
+    unsigned int n_threads = getNumThreads();
+    m_thread_pool.reset();
+    m_thread_pool = boost::shared_ptr<ThreadPool>(new ThreadPool(n_threads, m_pin_threads));
+
+    if (pin_threads && !getPinThreads())
+        msg->warning() << "Unable to pin the CPU threads to cores on this system" << endl;
+    }
+
 std::string ExecutionConfiguration::getGPUName() const
     {
     #ifdef ENABLE_CUDA
@@ -634,6 +701,54 @@ int ExecutionConfiguration::guessLocalRank()
     return -1;
     }
 
+int ExecutionConfiguration::guessLocalSize()
+    {
+    std::vector<std::string> env_vars;
+
+    // setup common environment variables containing the number of local ranks
+    env_vars.push_back("MV2_COMM_WORLD_LOCAL_SIZE");
+    env_vars.push_back("OMPI_COMM_WORLD_LOCAL_SIZE");
+
+    std::vector<std::string>::iterator it;
+
+    for (it = env_vars.begin(); it != env_vars.end(); it++)
+        {
+        char *env;
+        if ((env = getenv(it->c_str())) != NULL)
+            return atoi(env);
+        }
+
+    return -1;
+    }
+
+/*! \returns The value of HOOMD_NUM_THREADS, or of OMP_NUM_THREADS if the former is not set. 1 if neither is set
+    to a positive number.
+
+    Running one rank per socket or NUMA domain and setting the number of threads to the number of cores in it
+    reduces the ghost particle overhead compared to one rank per core.
+*/
+unsigned int ExecutionConfiguration::getDefaultNumThreads()
+    {
+    std::vector<std::string> env_vars;
+    env_vars.push_back("HOOMD_NUM_THREADS");
+    env_vars.push_back("OMP_NUM_THREADS");
+
+    std::vector<std::string>::iterator it;
+
+    for (it = env_vars.begin(); it != env_vars.end(); it++)
+        {
+        char *env;
+        if ((env = getenv(it->c_str())) != NULL)
+            {
+            int n_threads = atoi(env);
+            if (n_threads > 0)
+                return n_threads;
+            }
+        }
+
+    return 1;
+    }
+
 /*! Print out GPU stats if running on the GPU, otherwise determine and print out the CPU stats
 */
 void ExecutionConfiguration::setupStats()
@@ -678,6 +793,13 @@ void export_ExecutionConfiguration()
                          .def("isCUDAEnabled", &ExecutionConfiguration::isCUDAEnabled)
                          .def("setCUDAErrorChecking", &ExecutionConfiguration::setCUDAErrorChecking)
                          .def("getGPUName", &ExecutionConfiguration::getGPUName)
+                         .def("setNumThreads", &ExecutionConfiguration::setNumThreads)
+                         .def("getNumThreads", &ExecutionConfiguration::getNumThreads)
+                         .def("setPinThreads", &ExecutionConfiguration::setPinThreads)
+                         .def("getPinThreads", &ExecutionConfiguration::getPinThreads)
+                         .def("setHostAllocFlags", &ExecutionConfiguration::setHostAllocFlags)
+                         .def("getHostAllocFlags", &ExecutionConfiguration::getHostAllocFlags)
+                         .def("getHostMemoryPool", &ExecutionConfiguration::getHostMemoryPool, return_internal_reference<>())
                          .def_readonly("n_cpu", &ExecutionConfiguration::n_cpu)
                          .def_readonly("msg", &ExecutionConfiguration::msg)
 #ifdef ENABLE_CUDA
@@ -702,6 +824,23 @@ void export_ExecutionConfiguration()
     .value("AUTO", ExecutionConfiguration::AUTO)
     ;
 
+    enum_<host_alloc::Enum>("host_alloc")
+    .value("none", host_alloc::none)
+    .value("huge_pages", host_alloc::huge_pages)
+    .value("first_touch", host_alloc::first_touch)
+    ;
+
+    class_<HostMemoryPool, boost::noncopyable>("HostMemoryPool", no_init)
+    .def("setMaxCachedBytes", &HostMemoryPool::setMaxCachedBytes)
+    .def("getMaxCachedBytes", &HostMemoryPool::getMaxCachedBytes)
+    .def("releaseCache", &HostMemoryPool::releaseCache)
+    .def("getBytesInUse", &HostMemoryPool::getBytesInUse)
+    .def("getBytesCached", &HostMemoryPool::getBytesCached)
+    .def("getPeakBytes", &HostMemoryPool::getPeakBytes)
+    .def("getNumAllocations", &HostMemoryPool::getNumAllocations)
+    .def("getNumHits", &HostMemoryPool::getNumHits)
+    ;
+
     // allow classes to take shared_ptr<const ExecutionConfiguration> arguments
     implicitly_convertible<boost::shared_ptr<ExecutionConfiguration>, boost::shared_ptr<const ExecutionConfiguration> >();
     }
@@ -66,6 +66,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "Messenger.h"
+#include "ThreadPool.h"
+#include "HostMemoryPool.h"
 
 /*! \file ExecutionConfiguration.h
     \brief Declares ExecutionConfiguration and related classes
@@ -80,6 +82,23 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class CachedAllocator;
 #endif
 
+//! Flags selecting how GPUArray allocates host memory
+/*! The flags can be or'ed together. They are set for all arrays with ExecutionConfiguration::setHostAllocFlags()
+    and can be overridden for a single array with GPUArray::setHostAllocFlags().
+*/
+struct host_alloc
+    {
+    //! The enum
+    enum Enum
+        {
+        none = 0,           //!< Allocate with cache line alignment and clear the memory on the calling thread
+        huge_pages = 1,     //!< Advise the kernel to back arrays of at least one huge page with transparent huge pages
+        first_touch = 2,    //!< Clear new arrays with the thread pool, so that every page is placed on the NUMA node
+                            //!< of the thread that processes the corresponding particles
+        use_default = 4     //!< Use the flags of the ExecutionConfiguration (only valid for a single GPUArray)
+        };
+    };
+
 //! Defines the execution configuration for the simulation
 /*! \ingroup data_structs
     ExecutionConfiguration is a data structure needed to support the hybrid CPU/GPU code. It initializes the CUDA GPU
@@ -130,8 +149,17 @@ struct ExecutionConfiguration : boost::noncopyable
      */
     static int guessLocalRank();
 
+    //! Guess the number of ranks on this node
+    /*! \returns Number of local ranks guessed from common environment variables
+     *           or -1 if no information is available
+     */
+    static int guessLocalSize();
+
+    //! Get the default number of CPU threads per rank
+    static unsigned int getDefaultNumThreads();
+
     executionMode exec_mode;    //!< Execution mode specified in the constructor
-    unsigned int n_cpu;         //!< Number of CPUS hoomd is executing on
+    unsigned int n_cpu;         //!< Number of CPU threads hoomd is executing on
     bool m_cuda_error_checking;                //!< Set to true if GPU error checking is enabled
     boost::shared_ptr<Messenger> msg;          //!< Messenger for use in printing messages to the screen / log file
 
@@ -157,6 +185,56 @@ struct ExecutionConfiguration : boost::noncopyable
         m_cuda_error_checking = cuda_error_checking;
         }
 
+    //! Set the number of CPU threads used by the computes on this rank
+    void setNumThreads(unsigned int n_threads);
+
+    //! Get the number of CPU threads used by the computes on this rank
+    unsigned int getNumThreads() const
+        {
+        return m_thread_pool->getNumThreads();
+        }
+
+    //! Set whether the CPU threads are pinned to cores
+    void setPinThreads(bool pin_threads);
+
+    //! Returns true if the CPU threads are pinned to cores
+    bool getPinThreads() const
+        {
+        return m_thread_pool->isPinned();
+        }
+
+    //! Set the flags for allocating host memory in GPUArrays
+    /*! \param flags Combination of host_alloc flags
+        The flags apply to all arrays allocated or resized afterwards.
+    */
+    void setHostAllocFlags(unsigned int flags)
+        {
+        m_host_alloc_flags = flags & (host_alloc::huge_pages | host_alloc::first_touch);
+        }
+
+    //! Get the flags for allocating host memory in GPUArrays
+    unsigned int getHostAllocFlags() const
+        {
+        return m_host_alloc_flags;
+        }
+
+    //! Get the thread pool shared by all CPU computes
+    /*! The pool is not part of the logical state of the execution configuration, computes that only hold a
+        const reference may still submit work to it.
+    */
+    ThreadPool& getThreadPool() const
+        {
+        return *m_thread_pool;
+        }
+
+    //! Get the pool serving the host memory of all GPUArrays
+    /*! Like the thread pool, the memory pool is not part of the logical state of the execution configuration.
+    */
+    HostMemoryPool& getHostMemoryPool() const
+        {
+        return *m_host_pool;
+        }
+
     //! Get the name of the executing GPU (or the empty string)
     std::string getGPUName() const;
 #ifdef ENABLE_CUDA
@@ -272,6 +350,11 @@ private:
 
     unsigned int m_rank;                   //!< Rank of this processor (0 if running in single-processor mode)
 
+    boost::shared_ptr<ThreadPool> m_thread_pool; //!< Thread pool for multithreaded execution on the CPU
+    bool m_pin_threads;                    //!< True if the threads of the pool should be pinned to cores
+    unsigned int m_host_alloc_flags;       //!< Flags for allocating host memory in GPUArrays (see host_alloc)
+    boost::shared_ptr<HostMemoryPool> m_host_pool;  //!< Pool for the host memory of GPUArrays
+
     #ifdef ENABLE_CUDA
     CachedAllocator *m_cached_alloc;       //!< Cached allocator for temporary allocations
     #endif
@@ -63,6 +63,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // 4 GB limit for a single GPU buffer
 #define MAXALLOCBYTES 0xffffffff
 
+// size of a transparent huge page
+#define HUGEPAGEBYTES (2*1024*1024)
+
 // for vector types
 #ifdef ENABLE_CUDA
 #include <cuda_runtime.h>
@@ -75,6 +78,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <algorithm>
 #include <boost/bind.hpp>
 #include <stdlib.h>
+#include <sys/mman.h>
 
 //! Specifies where to acquire the data
 struct access_location
@@ -238,6 +242,18 @@ ArrayHandle<int> h_handle(gpu_array, access_location::host, access_mode::readwri
 h_handle.data[i*pitch + j] = 5;
 \endcode
 
+Host memory is aligned to 64 bytes. How it is allocated can further be tuned with the host_alloc flags, set for all
+arrays in the ExecutionConfiguration or for a single array with setHostAllocFlags(). With host_alloc::huge_pages,
+arrays of at least one huge page are aligned to the huge page size and the kernel is advised to back them with
+transparent huge pages. With host_alloc::first_touch, new memory is cleared by the threads of the ThreadPool. Each
+thread clears the same range of every row that ThreadPool::getRange() assigns it when the particles are distributed
+over the threads, so that on NUMA systems the pages end up on the node of the thread that processes them.
+
+The host memory is served by the HostMemoryPool of the ExecutionConfiguration, which keeps freed blocks for reuse. An
+array that is resized back and forth, such as the particle data under MPI, then rarely allocates new pages. Arrays
+with host_alloc::first_touch or host_alloc::huge_pages always get fresh pages from the system, because the placement
+and page size of a reused block are fixed by its first use.
+
 A future modification of GPUArray will allow mirroring or splitting the data across multiple GPUs.
 
 \ingroup data_structs
@@ -319,6 +335,17 @@ template<class T> class GPUArray
         //! Resize a 2D GPUArray
         virtual void resize(unsigned int width, unsigned int height);
 
+        //! Set the flags for allocating the host memory of this array
+        void setHostAllocFlags(unsigned int flags);
+
+        //! Get the flags used for allocating the host memory of this array
+        unsigned int getHostAllocFlags() const
+            {
+            if (m_host_alloc_flags & host_alloc::use_default)
+                return m_exec_conf ? m_exec_conf->getHostAllocFlags() : (unsigned int)host_alloc::none;
+            return m_host_alloc_flags;
+            }
+
     protected:
         //! Clear memory starting from a given element
         /*! \param first The first element to clear
@@ -345,6 +372,7 @@ template<class T> class GPUArray
 
         mutable bool m_acquired;                //!< Tracks whether the data has been aquired
         mutable data_location::Enum m_data_location;    //!< Tracks the current location of the data
+        mutable unsigned int m_host_alloc_flags;        //!< Flags for allocating host memory (see host_alloc)
 #ifdef ENABLE_CUDA
         mutable bool m_mapped;                          //!< True if we are using mapped memory
 #endif
@@ -371,6 +399,16 @@ template<class T> class GPUArray
         inline void memcpyHostToDevice(bool async) const;
 #endif
 
+        //! Helper function to allocate and clear a host array
+        inline T* allocateHostArray(unsigned int pitch, unsigned int height) const;
+
+        //! Helper function to free a host array
+        inline void freeHostArray(T *data) const;
+
+        //! Helper function to clear the part of a host array assigned to one thread
+        static void clearHostArrayRange(T *data, unsigned int pitch, unsigned int height, unsigned int n_threads,
+                                        unsigned int thread_idx);
+
         //! Helper function to resize host array
         inline T* resizeHostArray(unsigned int num_elements);
 
@@ -429,6 +467,7 @@ template<class T> ArrayHandleAsync<T>::~ArrayHandleAsync()
 
 template<class T> GPUArray<T>::GPUArray() :
         m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_data_location(data_location::host),
+        m_host_alloc_flags(host_alloc::use_default),
 #ifdef ENABLE_CUDA
         m_mapped(false),
         d_data(NULL),
@@ -442,6 +481,7 @@ template<class T> GPUArray<T>::GPUArray() :
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, boost::shared_ptr<const ExecutionConfiguration> exec_conf) :
         m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_data_location(data_location::host),
+        m_host_alloc_flags(host_alloc::use_default),
 #ifdef ENABLE_CUDA
         m_mapped(false),
         d_data(NULL),
@@ -451,7 +491,6 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, boost::shared
     {
     // allocate and clear memory
     allocate();
-    memclear();
     }
 
 /*! \param width Width of the 2-D array to allocate (in elements)
@@ -460,6 +499,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, boost::shared
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height, boost::shared_ptr<const ExecutionConfiguration> exec_conf) :
         m_height(height), m_acquired(false), m_data_location(data_location::host),
+        m_host_alloc_flags(host_alloc::use_default),
 #ifdef ENABLE_CUDA
         m_mapped(false),
         d_data(NULL),
@@ -475,7 +515,6 @@ template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height,
 
     // allocate and clear memory
     allocate();
-    memclear();
     }
 
 #ifdef ENABLE_CUDA
@@ -485,6 +524,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height,
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, boost::shared_ptr<const ExecutionConfiguration> exec_conf, bool mapped) :
         m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_data_location(data_location::host),
+        m_host_alloc_flags(host_alloc::use_default),
         m_mapped(mapped),
         d_data(NULL),
         h_data(NULL),
@@ -492,7 +532,6 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, boost::shared
     {
     // allocate and clear memory
     allocate();
-    memclear();
     }
 
 /*! \param width Width of the 2-D array to allocate (in elements)
@@ -502,6 +541,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, boost::shared
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height, boost::shared_ptr<const ExecutionConfiguration> exec_conf, bool mapped) :
         m_height(height), m_acquired(false), m_data_location(data_location::host),
+        m_host_alloc_flags(host_alloc::use_default),
         m_mapped(mapped),
         d_data(NULL),
         h_data(NULL),
@@ -515,7 +555,6 @@ template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height,
 
     // allocate and clear memory
     allocate();
-    memclear();
     }
 #endif
 
@@ -526,6 +565,7 @@ template<class T> GPUArray<T>::~GPUArray()
 
 template<class T> GPUArray<T>::GPUArray(const GPUArray& from) : m_num_elements(from.m_num_elements), m_pitch(from.m_pitch),
         m_height(from.m_height), m_acquired(false), m_data_location(data_location::host),
+        m_host_alloc_flags(from.m_host_alloc_flags),
 #ifdef ENABLE_CUDA
         m_mapped(from.m_mapped),
         d_data(NULL),
@@ -535,7 +575,6 @@ template<class T> GPUArray<T>::GPUArray(const GPUArray& from) : m_num_elements(f
     {
     // allocate and clear new memory the same size as the data in from
     allocate();
-    memclear();
 
     // copy over the data to the new GPUArray
     if (m_num_elements > 0)
@@ -560,6 +599,7 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(const GPUArray& rhs)
         m_pitch = rhs.m_pitch;
         m_height = rhs.m_height;
         m_exec_conf = rhs.m_exec_conf;
+        m_host_alloc_flags = rhs.m_host_alloc_flags;
 #ifdef ENABLE_CUDA
         m_mapped = rhs.m_mapped;
 #endif
@@ -568,7 +608,6 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(const GPUArray& rhs)
 
         // allocate and clear new memory the same size as the data in rhs
         allocate();
-        memclear();
 
         // copy over the data to the new GPUArray
         if (m_num_elements > 0)
@@ -604,6 +643,7 @@ template<class T> void GPUArray<T>::swap(GPUArray& from)
     std::swap(m_height, from.m_height);
     std::swap(m_acquired, from.m_acquired);
     std::swap(m_data_location, from.m_data_location);
+    std::swap(m_host_alloc_flags, from.m_host_alloc_flags);
     std::swap(m_exec_conf, from.m_exec_conf);
 #ifdef ENABLE_CUDA
     std::swap(d_data, from.d_data);
@@ -624,6 +664,7 @@ template<class T> void GPUArray<T>::swap(GPUArray& from) const
     std::swap(m_exec_conf, from.m_exec_conf);
     std::swap(m_acquired, from.m_acquired);
     std::swap(m_data_location, from.m_data_location);
+    std::swap(m_host_alloc_flags, from.m_host_alloc_flags);
 #ifdef ENABLE_CUDA
     std::swap(d_data, from.d_data);
     std::swap(m_mapped, from.m_mapped);
@@ -633,7 +674,7 @@ template<class T> void GPUArray<T>::swap(GPUArray& from) const
 
 /*! \pre m_num_elements is set
     \pre pointers are not allocated
-    \post All memory pointers needed for GPUArray are allocated
+    \post All memory pointers needed for GPUArray are allocated and cleared
 */
 template<class T> void GPUArray<T>::allocate()
     {
@@ -666,14 +707,7 @@ template<class T> void GPUArray<T>::allocate()
     assert(h_data == NULL);
 
     // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign((void**)&h_data, 32, m_num_elements*sizeof(T));
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    h_data = allocateHostArray(m_pitch, m_height);
 
 #ifdef ENABLE_CUDA
     assert(d_data == NULL);
@@ -692,11 +726,87 @@ template<class T> void GPUArray<T>::allocate()
             {
             cudaMalloc(&d_data, m_num_elements*sizeof(T));
             CHECK_CUDA_ERROR();
+            cudaMemset(d_data, 0, m_num_elements*sizeof(T));
             }
         }
 #endif
     }
 
+/*! \param pitch Number of elements per row
+    \param height Number of rows
+    \returns A pointer to the newly allocated host memory, which is cleared
+
+    The memory is aligned to 64 bytes, the size of a cache line, and taken from the HostMemoryPool. See the class
+    documentation for the effect of the host_alloc flags.
+*/
+template<class T> T* GPUArray<T>::allocateHostArray(unsigned int pitch, unsigned int height) const
+    {
+    unsigned int flags = getHostAllocFlags();
+    size_t size = size_t(pitch)*size_t(height)*sizeof(T);
+
+    size_t alignment = 64;
+#ifdef MADV_HUGEPAGE
+    if ((flags & host_alloc::huge_pages) && size >= HUGEPAGEBYTES)
+        alignment = HUGEPAGEBYTES;
+#endif
+
+    // a cached block has been touched already, so its placement and page size can no longer be changed
+    bool fresh = (flags & (host_alloc::first_touch | host_alloc::huge_pages)) != 0;
+
+    T *h_tmp = NULL;
+    if (m_exec_conf)
+        h_tmp = (T*)m_exec_conf->getHostMemoryPool().allocate(size, alignment, fresh);
+    else if (posix_memalign((void**)&h_tmp, alignment, size) != 0)
+        h_tmp = NULL;
+
+    if (h_tmp == NULL)
+        {
+        if (m_exec_conf)
+            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
+        throw std::runtime_error("Error allocating GPUArray.");
+        }
+
+#ifdef MADV_HUGEPAGE
+    // huge pages can only be used for pages that have not been touched yet
+    if (alignment == HUGEPAGEBYTES)
+        madvise(h_tmp, size, MADV_HUGEPAGE);
+#endif
+
+    // the pages are placed on the NUMA node of the thread that first writes to them
+    unsigned int n_threads = m_exec_conf ? m_exec_conf->getNumThreads() : 1;
+    if ((flags & host_alloc::first_touch) && n_threads > 1)
+        m_exec_conf->getThreadPool().run(boost::bind(&GPUArray<T>::clearHostArrayRange, h_tmp, pitch, height, n_threads, _1));
+    else
+        memset(h_tmp, 0, size);
+
+    return h_tmp;
+    }
+
+/*! \param data Host array returned by allocateHostArray()
+*/
+template<class T> void GPUArray<T>::freeHostArray(T *data) const
+    {
+    if (m_exec_conf)
+        m_exec_conf->getHostMemoryPool().deallocate(data);
+    else
+        free(data);
+    }
+
+/*! \param data Host array to clear
+    \param pitch Number of elements per row
+    \param height Number of rows
+    \param n_threads Number of threads clearing the array
+    \param thread_idx Index of this thread
+*/
+template<class T> void GPUArray<T>::clearHostArrayRange(T *data, unsigned int pitch, unsigned int height,
+                                                        unsigned int n_threads, unsigned int thread_idx)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(pitch, thread_idx, n_threads, first, last);
+    for (unsigned int i = 0; i < height; i++)
+        memset(data + size_t(i)*pitch + first, 0, sizeof(T)*(last - first));
+    }
+
 /*! \pre allocate() has been called
     \post All allocated memory is freed
 */
@@ -727,7 +837,7 @@ template<class T> void GPUArray<T>::deallocate()
         }
 #endif
 
-    free(h_data);
+    freeHostArray(h_data);
 
     // set pointers to NULL
     h_data = NULL;
@@ -1002,18 +1112,8 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
     // if not allocated, do nothing
     if (isNull()) return NULL;
 
-    // allocate resized array
-    T *h_tmp = NULL;
-
-    // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign((void**)&h_tmp, 32, num_elements*sizeof(T));
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    // allocate and clear resized array
+    T *h_tmp = allocateHostArray(num_elements, 1);
 
 #ifdef ENABLE_CUDA
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
@@ -1021,8 +1121,6 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
         cudaHostRegister(h_tmp, num_elements*sizeof(T), m_mapped ? cudaHostRegisterMapped : cudaHostRegisterDefault);
         }
 #endif
-    // clear memory
-    memset(h_tmp, 0, sizeof(T)*num_elements);
 
     // copy over data
     unsigned int num_copy_elements = m_num_elements > num_elements ? num_elements : m_num_elements;
@@ -1037,7 +1135,7 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
         }
 #endif
 
-    free(h_data);
+    freeHostArray(h_data);
     h_data = h_tmp;
 
 #ifdef ENABLE_CUDA
@@ -1055,30 +1153,17 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
 */
 template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned int new_pitch, unsigned int height, unsigned int new_height )
     {
-    // allocate resized array
-    T *h_tmp = NULL;
-
-    // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    unsigned int size = new_pitch*new_height*sizeof(T);
-    int retval = posix_memalign((void**)&h_tmp, 32, size);
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    // allocate and clear resized array
+    T *h_tmp = allocateHostArray(new_pitch, new_height);
 
 #ifdef ENABLE_CUDA
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
         {
+        unsigned int size = new_pitch*new_height*sizeof(T);
         cudaHostRegister(h_tmp, size, cudaHostRegisterDefault);
         }
 #endif
 
-    // clear memory
-    memset(h_tmp, 0, sizeof(T)*new_pitch*new_height);
-
     // copy over data
     // every column is copied separately such as to align with the new pitch
     unsigned int num_copy_rows = height > new_height ? new_height : height;
@@ -1095,7 +1180,7 @@ template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned
         }
 #endif
 
-    free(h_data);
+    freeHostArray(h_data);
     h_data = h_tmp;
 
 #ifdef ENABLE_CUDA
@@ -1200,6 +1285,8 @@ template<class T> void GPUArray<T>::resize(unsigned int num_elements)
     if (isNull())
         {
         m_num_elements = num_elements;
+        m_pitch = num_elements;
+        m_height = 1;
         allocate();
         return;
         };
@@ -1245,9 +1332,9 @@ template<class T> void GPUArray<T>::resize(unsigned int width, unsigned int heig
     if (isNull())
         {
         m_num_elements = num_elements;
-        allocate();
         m_pitch = new_pitch;
         m_height = height;
+        allocate();
         return;
         };
 
@@ -1270,4 +1357,38 @@ template<class T> void GPUArray<T>::resize(unsigned int width, unsigned int heig
     m_pitch  = new_pitch;
     m_num_elements = m_pitch * m_height;
     }
+
+/*! \param flags Combination of host_alloc flags, or host_alloc::use_default to follow the ExecutionConfiguration
+
+    If the array is already allocated, its host memory is reallocated with the new flags and the contents are
+    copied over.
+*/
+template<class T> void GPUArray<T>::setHostAllocFlags(unsigned int flags)
+    {
+    assert(! m_acquired);
+
+    if (flags == m_host_alloc_flags)
+        return;
+    m_host_alloc_flags = flags;
+
+    if (isNull())
+        return;
+
+    T *h_tmp = allocateHostArray(m_pitch, m_height);
+    memcpy(h_tmp, h_data, sizeof(T)*m_num_elements);
+
+#ifdef ENABLE_CUDA
+    if (m_exec_conf && m_exec_conf->isCUDAEnabled())
+        {
+        cudaHostUnregister(h_data);
+        CHECK_CUDA_ERROR();
+        cudaHostRegister(h_tmp, m_num_elements*sizeof(T), m_mapped ? cudaHostRegisterMapped : cudaHostRegisterDefault);
+        if (m_mapped)
+            cudaHostGetDevicePointer(&d_data, h_tmp, 0);
+        }
+#endif
+
+    freeHostArray(h_data);
+    h_data = h_tmp;
+    }
 #endif
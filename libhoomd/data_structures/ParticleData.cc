@@ -775,9 +775,10 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData& snapshot)
                 // determine domain the particle is placed into
                 Scalar3 pos = *it;
                 Scalar3 f = m_global_box.makeFraction(pos);
-                int i= f.x * ((Scalar)di.getW());
-                int j= f.y * ((Scalar)di.getH());
-                int k= f.z * ((Scalar)di.getD());
+                uint3 grid_pos = m_decomposition->findGridPos(f);
+                int i = grid_pos.x;
+                int j = grid_pos.y;
+                int k = grid_pos.z;
 
                 // wrap particles that are exactly on a boundary
                 // we only need to wrap in the negative direction, since
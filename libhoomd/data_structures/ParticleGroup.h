@@ -301,6 +301,15 @@ class ParticleGroup
             return m_member_idx;
             }
 
+        //! Direct access to the sorted list of member tags
+        /*! \returns A GPUArray with the tags of all getNumMembersGlobal() members in increasing order
+            \note The caller \b must \b not write to or change the array.
+        */
+        const GPUArray<unsigned int>& getMemberTagArray() const
+            {
+            return m_member_tags;
+            }
+
         // @}
         //! \name Analysis methods
         // @{
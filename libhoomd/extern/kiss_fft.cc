@@ -251,8 +251,9 @@ void kf_work(
 
 #ifdef _OPENMP
     // use openmp extensions at the 
-    // top-level (not recursive)
-    if (fstride==1 && p<=5)
+    // top-level (not recursive), single stage transforms
+    // (m==1) have no sub-transforms to distribute
+    if (fstride==1 && p<=5 && m>1)
     {
         int k;
 
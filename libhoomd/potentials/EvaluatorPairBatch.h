@@ -0,0 +1,143 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Maintainer: joaander
+
+#ifndef __EVALUATOR_PAIR_BATCH_H__
+#define __EVALUATOR_PAIR_BATCH_H__
+
+#include "HOOMDMath.h"
+
+/*! \file EvaluatorPairBatch.h
+    \brief Declares the opt-in batch interface of pair evaluators used by PotentialPair on the CPU
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Number of pairs evaluated at once by the batch interface
+/*! 16 lanes fill one AVX-512 register in single precision, and two AVX2 or four SSE registers. The compiler splits
+    the fixed length lane loops into vectors of the width available on the target.
+*/
+const unsigned int PAIR_BATCH_SIZE = 16;
+
+//! Batch interface of a pair evaluator
+/*! PotentialPair evaluates pairs one at a time by constructing an evaluator for every pair. Evaluators that opt in
+    to the batch interface are instead handed the squared distances, cutoffs and parameters of PAIR_BATCH_SIZE pairs
+    at a time in separate lane arrays. Such evaluators provide a static method
+
+    \code
+    static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                        const Scalar *rcutsq,
+                                        const param_type *params,
+                                        Scalar *force_divr,
+                                        Scalar *pair_eng,
+                                        bool energy_shift);
+    \endcode
+
+    that fills all PAIR_BATCH_SIZE lanes of \a force_divr and \a pair_eng. Lanes beyond the cutoff (including the
+    padding lanes of a partially filled batch, which are given rsq == rcutsq) must produce a force and energy of 0.
+    The method should be written as a loop over the lanes without branches that depend on the lane, so that the
+    compiler can vectorize it.
+
+    An evaluator opts in by specializing PairEvaluatorBatch as a subclass of PairEvaluatorBatchEnabled:
+    \code
+    template<> struct PairEvaluatorBatch<EvaluatorPairLJ> : public PairEvaluatorBatchEnabled<EvaluatorPairLJ> { };
+    \endcode
+
+    The batch interface is only used for the no_shift and shift energy shift modes. Only evaluators that need neither
+    diameter nor charge may opt in.
+*/
+template<class evaluator>
+struct PairEvaluatorBatch
+    {
+    //! True if the evaluator provides evalForceAndEnergyBatch()
+    static const bool enabled = false;
+
+    //! Placeholder for evaluators without a batch interface, never called
+    static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                        const Scalar *rcutsq,
+                                        const typename evaluator::param_type *params,
+                                        Scalar *force_divr,
+                                        Scalar *pair_eng,
+                                        bool energy_shift)
+        {
+        }
+    };
+
+//! Base class for the specializations of PairEvaluatorBatch of evaluators that provide a batch interface
+template<class evaluator>
+struct PairEvaluatorBatchEnabled
+    {
+    //! True if the evaluator provides evalForceAndEnergyBatch()
+    static const bool enabled = true;
+
+    //! Evaluate the forces and energies of a batch of pairs
+    /*! \param rsq Squared distances of the pairs
+        \param rcutsq Squared cutoff radii of the pairs
+        \param params Per type pair parameters of the pairs
+        \param force_divr Output array for the forces divided by r
+        \param pair_eng Output array for the pair energies
+        \param energy_shift If true, the potential is shifted so that V(r) is continuous at the cutoff
+
+        All arrays have PAIR_BATCH_SIZE elements.
+    */
+    static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                        const Scalar *rcutsq,
+                                        const typename evaluator::param_type *params,
+                                        Scalar *force_divr,
+                                        Scalar *pair_eng,
+                                        bool energy_shift)
+        {
+        evaluator::evalForceAndEnergyBatch(rsq, rcutsq, params, force_divr, pair_eng, energy_shift);
+        }
+    };
+
+#endif // __EVALUATOR_PAIR_BATCH_H__
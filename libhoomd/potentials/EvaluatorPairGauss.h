@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef NVCC
 #include <string>
+#include "EvaluatorPairBatch.h"
 #endif
 
 #include "HOOMDMath.h"
@@ -152,6 +153,45 @@ class EvaluatorPairGauss
             }
 
         #ifndef NVCC
+        //! Evaluate the force and energy of a batch of pairs
+        /*! \param rsq Squared distances of the pairs
+            \param rcutsq Squared cutoff radii of the pairs
+            \param params Per type pair parameters of the pairs
+            \param force_divr Output array for the forces divided by r
+            \param pair_eng Output array for the pair energies
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+
+            All arrays have PAIR_BATCH_SIZE elements. The exponentials vectorize when the toolchain provides vector math
+            functions.
+        */
+        static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+                {
+                Scalar epsilon = params[l].x;
+                Scalar sigma = params[l].y;
+
+                Scalar sigma_sq = sigma*sigma;
+                Scalar r_over_sigma_sq = rsq[l] / sigma_sq;
+                Scalar exp_val = fast::exp(-Scalar(1.0)/Scalar(2.0) * r_over_sigma_sq);
+
+                Scalar f = epsilon / sigma_sq * exp_val;
+                Scalar e = epsilon * exp_val;
+
+                if (energy_shift)
+                    e -= epsilon * fast::exp(-Scalar(1.0)/Scalar(2.0) * rcutsq[l] / sigma_sq);
+
+                bool inside = rsq[l] < rcutsq[l];
+                force_divr[l] = inside ? f : Scalar(0.0);
+                pair_eng[l] = inside ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -170,4 +210,9 @@ class EvaluatorPairGauss
     };
 
 
+#ifndef NVCC
+//! EvaluatorPairGauss provides a batch interface
+template<> struct PairEvaluatorBatch<EvaluatorPairGauss> : public PairEvaluatorBatchEnabled<EvaluatorPairGauss> { };
+#endif
+
 #endif // __PAIR_EVALUATOR_GAUSS_H__
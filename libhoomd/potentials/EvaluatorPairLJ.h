@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef NVCC
 #include <string>
+#include "EvaluatorPairBatch.h"
 #endif
 
 #include "HOOMDMath.h"
@@ -203,6 +204,47 @@ class EvaluatorPairLJ
             }
 
         #ifndef NVCC
+        //! Evaluate the force and energy of a batch of pairs
+        /*! \param rsq Squared distances of the pairs
+            \param rcutsq Squared cutoff radii of the pairs
+            \param params Per type pair parameters of the pairs
+            \param force_divr Output array for the forces divided by r
+            \param pair_eng Output array for the pair energies
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+
+            All arrays have PAIR_BATCH_SIZE elements. Both branches of the cutoff test are computed and the result
+            is selected per lane, so that the loop vectorizes.
+        */
+        static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+                {
+                Scalar lj1 = params[l].x;
+                Scalar lj2 = params[l].y;
+
+                Scalar r2inv = Scalar(1.0)/rsq[l];
+                Scalar r6inv = r2inv * r2inv * r2inv;
+                Scalar f = r2inv * r6inv * (Scalar(12.0)*lj1*r6inv - Scalar(6.0)*lj2);
+                Scalar e = r6inv * (lj1*r6inv - lj2);
+
+                if (energy_shift)
+                    {
+                    Scalar rcut2inv = Scalar(1.0)/rcutsq[l];
+                    Scalar rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+                    e -= rcut6inv * (lj1*rcut6inv - lj2);
+                    }
+
+                bool inside = rsq[l] < rcutsq[l] && lj1 != 0;
+                force_divr[l] = inside ? f : Scalar(0.0);
+                pair_eng[l] = inside ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -221,4 +263,9 @@ class EvaluatorPairLJ
     };
 
 
+#ifndef NVCC
+//! EvaluatorPairLJ provides a batch interface
+template<> struct PairEvaluatorBatch<EvaluatorPairLJ> : public PairEvaluatorBatchEnabled<EvaluatorPairLJ> { };
+#endif
+
 #endif // __PAIR_EVALUATOR_LJ_H__
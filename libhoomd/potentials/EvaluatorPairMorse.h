@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef NVCC
 #include <string>
+#include "EvaluatorPairBatch.h"
 #endif
 
 #include "HOOMDMath.h"
@@ -151,6 +152,49 @@ class EvaluatorPairMorse
             }
 
         #ifndef NVCC
+        //! Evaluate the force and energy of a batch of pairs
+        /*! \param rsq Squared distances of the pairs
+            \param rcutsq Squared cutoff radii of the pairs
+            \param params Per type pair parameters of the pairs
+            \param force_divr Output array for the forces divided by r
+            \param pair_eng Output array for the pair energies
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+
+            All arrays have PAIR_BATCH_SIZE elements. The exponentials vectorize when the toolchain provides vector math
+            functions.
+        */
+        static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+                {
+                Scalar D0 = params[l].x;
+                Scalar alpha = params[l].y;
+                Scalar r0 = params[l].z;
+
+                Scalar r = fast::sqrt(rsq[l]);
+                Scalar Exp_factor = fast::exp(-alpha*(r-r0));
+
+                Scalar e = D0 * Exp_factor * (Exp_factor - Scalar(2.0));
+                Scalar f = Scalar(2.0) * D0 * alpha * Exp_factor * (Exp_factor - Scalar(1.0)) / r;
+
+                if (energy_shift)
+                    {
+                    Scalar rcut = fast::sqrt(rcutsq[l]);
+                    Scalar Exp_factor_cut = fast::exp(-alpha*(rcut-r0));
+                    e -= D0 * Exp_factor_cut * (Exp_factor_cut - Scalar(2.0));
+                    }
+
+                bool inside = rsq[l] < rcutsq[l];
+                force_divr[l] = inside ? f : Scalar(0.0);
+                pair_eng[l] = inside ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -170,4 +214,9 @@ class EvaluatorPairMorse
     };
 
 
+#ifndef NVCC
+//! EvaluatorPairMorse provides a batch interface
+template<> struct PairEvaluatorBatch<EvaluatorPairMorse> : public PairEvaluatorBatchEnabled<EvaluatorPairMorse> { };
+#endif
+
 #endif // __PAIR_EVALUATOR_MORSE_H__
@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef NVCC
 #include <string>
+#include "EvaluatorPairBatch.h"
 #endif
 
 #include "HOOMDMath.h"
@@ -156,6 +157,51 @@ class EvaluatorPairYukawa
             }
 
         #ifndef NVCC
+        //! Evaluate the force and energy of a batch of pairs
+        /*! \param rsq Squared distances of the pairs
+            \param rcutsq Squared cutoff radii of the pairs
+            \param params Per type pair parameters of the pairs
+            \param force_divr Output array for the forces divided by r
+            \param pair_eng Output array for the pair energies
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+
+            All arrays have PAIR_BATCH_SIZE elements. The exponentials vectorize when the toolchain provides vector math
+            functions.
+        */
+        static void evalForceAndEnergyBatch(const Scalar *rsq,
+                                            const Scalar *rcutsq,
+                                            const param_type *params,
+                                            Scalar *force_divr,
+                                            Scalar *pair_eng,
+                                            bool energy_shift)
+            {
+            for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+                {
+                Scalar epsilon = params[l].x;
+                Scalar kappa = params[l].y;
+
+                Scalar rinv = fast::rsqrt(rsq[l]);
+                Scalar r = Scalar(1.0) / rinv;
+                Scalar r2inv = Scalar(1.0) / rsq[l];
+
+                Scalar exp_val = fast::exp(-kappa * r);
+
+                Scalar f = epsilon * exp_val * r2inv * (rinv + kappa);
+                Scalar e = epsilon * exp_val * rinv;
+
+                if (energy_shift)
+                    {
+                    Scalar rcutinv = fast::rsqrt(rcutsq[l]);
+                    Scalar rcut = Scalar(1.0) / rcutinv;
+                    e -= epsilon * fast::exp(-kappa * rcut) * rcutinv;
+                    }
+
+                bool inside = rsq[l] < rcutsq[l] && epsilon != 0;
+                force_divr[l] = inside ? f : Scalar(0.0);
+                pair_eng[l] = inside ? e : Scalar(0.0);
+                }
+            }
+
         //! Get the name of this potential
         /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
             via analyze.log.
@@ -174,4 +220,9 @@ class EvaluatorPairYukawa
     };
 
 
+#ifndef NVCC
+//! EvaluatorPairYukawa provides a batch interface
+template<> struct PairEvaluatorBatch<EvaluatorPairYukawa> : public PairEvaluatorBatchEnabled<EvaluatorPairYukawa> { };
+#endif
+
 #endif // __PAIR_EVALUATOR_YUKAWA_H__
@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/shared_ptr.hpp>
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include "ForceCompute.h"
@@ -110,8 +111,27 @@ class PotentialBond : public ForceCompute
         std::string m_log_name;                     //!< Cached log name
         std::string m_prof_name;                    //!< Cached profiler name
 
+        //! Pointers to the input and output arrays of the CPU force computation, shared by all threads
+        struct cpu_args
+            {
+            const Scalar4 *pos;                     //!< Particle positions
+            const Scalar *diameter;                 //!< Particle diameters
+            const Scalar *charge;                   //!< Particle charges
+            const typename BondData::members_t *bonds;  //!< Bonds ordered by their lowest member index
+            const unsigned int *type;               //!< Types of the bonds
+            const unsigned int *offset;             //!< Offsets of the bonds by lowest member index
+            const param_type *params;               //!< Bond parameters per type
+            BoxDim box;                             //!< Global simulation box
+            Scalar4 *force;                         //!< Forces (output)
+            Scalar *virial;                         //!< Virials (output)
+            bool compute_virial;                    //!< True if the virial is needed
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! Compute the forces of the bonds assigned to one thread
+        void computeForcesThread(unsigned int thread_idx, const cpu_args& args);
     };
 
 /*! \param sysdef System to compute forces on
@@ -191,6 +211,8 @@ Scalar PotentialBond< evaluator >::getLogValue(const std::string& quantity, unsi
 
 /*! Actually perform the force computation
     \param timestep Current time step
+
+    The bonds are divided among the threads as described for ForceCompute::bonded_output.
  */
 template< class evaluator >
 void PotentialBond< evaluator >::computeForces(unsigned int timestep)
@@ -199,9 +221,13 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
 
     assert(m_pdata);
 
+    // the table is rebuilt here if the particles have been sorted since the last call
+    const GPUVector<typename BondData::members_t>& bond_table = m_bond_data->getCPUTable();
+    const GPUVector<unsigned int>& bond_type = m_bond_data->getCPUTableTypes();
+    const GPUVector<unsigned int>& bond_offset = m_bond_data->getCPUTableOffsets();
+
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
@@ -211,6 +237,9 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     // access the parameters
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
 
+    ArrayHandle<typename BondData::members_t> h_bonds(bond_table, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_type(bond_type, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_offset(bond_offset, access_location::host, access_mode::read);
 
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
@@ -223,47 +252,57 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
     memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
 
-    // get a local copy of the simulation box too
-    const BoxDim& box = m_pdata->getGlobalBox();
-
     PDataFlags flags = this->m_pdata->getFlags();
-    bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
+
+    cpu_args args;
+    args.pos = h_pos.data;
+    args.diameter = h_diameter.data;
+    args.charge = h_charge.data;
+    args.bonds = h_bonds.data;
+    args.type = h_type.data;
+    args.offset = h_offset.data;
+    args.params = h_params.data;
+    args.box = m_pdata->getGlobalBox();
+    args.force = h_force.data;
+    args.virial = h_virial.data;
+    args.compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
+
+    resetThreadSpill();
+    m_exec_conf->getThreadPool().run(boost::bind(&PotentialBond<evaluator>::computeForcesThread,
+                                                 this,
+                                                 _1,
+                                                 boost::cref(args)));
+    applyThreadSpill(h_force.data, h_virial.data, args.compute_virial);
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Input and output arrays
+*/
+template< class evaluator >
+void PotentialBond< evaluator >::computeForcesThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    bonded_output out = getBondedOutput(thread_idx, args.force, args.virial, args.compute_virial);
 
     Scalar bond_virial[6];
     for (unsigned int i = 0; i< 6; i++)
         bond_virial[i]=Scalar(0.0);
 
-    ArrayHandle<typename BondData::members_t> h_bonds(m_bond_data->getMembersArray(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_type(m_bond_data->getTypesArray(), access_location::host, access_mode::read);
-
-    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
-
-    // for each of the bonds
-    const unsigned int size = (unsigned int)m_bond_data->getN();
-    for (unsigned int i = 0; i < size; i++)
+    // for each of the bonds whose lowest member is owned by this thread
+    for (unsigned int i = args.offset[out.first]; i < args.offset[out.last]; i++)
         {
-        // lookup the tag of each of the particles participating in the bond
-        const typename BondData::members_t& bond = h_bonds.data[i];
-        assert(bond.tag[0] < m_pdata->getNGlobal());
-        assert(bond.tag[1] < m_pdata->getNGlobal());
-
-        // transform a and b into indicies into the particle data arrays
-        // (MEM TRANSFER: 4 integers)
-        unsigned int idx_a = h_rtag.data[bond.tag[0]];
-        unsigned int idx_b = h_rtag.data[bond.tag[1]];
-
-        // throw an error if this bond is incomplete
-        if (idx_a >= max_local || idx_b >= max_local)
-            {
-            this->m_exec_conf->msg->error() << "bond." << evaluator::getName() << ": bond " <<
-                bond.tag[0] << " " << bond.tag[1] << " incomplete." << endl << endl;
-            throw std::runtime_error("Error in bond calculation");
-            }
+        // the indices of the particles participating in the bond
+        const typename BondData::members_t& bond = args.bonds[i];
+        unsigned int idx_a = bond.idx[0];
+        unsigned int idx_b = bond.idx[1];
+        assert(idx_a < m_pdata->getN() + m_pdata->getNGhosts());
+        assert(idx_b < m_pdata->getN() + m_pdata->getNGhosts());
 
         // calculate d\vec{r}
         // (MEM TRANSFER: 6 Scalars / FLOPS: 3)
-        Scalar3 posa = make_scalar3(h_pos.data[idx_a].x, h_pos.data[idx_a].y, h_pos.data[idx_a].z);
-        Scalar3 posb = make_scalar3(h_pos.data[idx_b].x, h_pos.data[idx_b].y, h_pos.data[idx_b].z);
+        Scalar3 posa = make_scalar3(args.pos[idx_a].x, args.pos[idx_a].y, args.pos[idx_a].z);
+        Scalar3 posb = make_scalar3(args.pos[idx_b].x, args.pos[idx_b].y, args.pos[idx_b].z);
 
         Scalar3 dx = posb - posa;
 
@@ -272,8 +311,8 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
         Scalar diameter_b = Scalar(0.0);
         if (evaluator::needsDiameter())
             {
-            diameter_a = h_diameter.data[idx_a];
-            diameter_b = h_diameter.data[idx_b];
+            diameter_a = args.diameter[idx_a];
+            diameter_b = args.diameter[idx_b];
             }
 
         // acesss charge (if needed)
@@ -281,18 +320,18 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
         Scalar charge_b = Scalar(0.0);
         if (evaluator::needsCharge())
             {
-            charge_a = h_charge.data[idx_a];
-            charge_b = h_charge.data[idx_b];
+            charge_a = args.charge[idx_a];
+            charge_b = args.charge[idx_b];
             }
 
         // if the vector crosses the box, pull it back
-        dx = box.minImage(dx);
+        dx = args.box.minImage(dx);
 
         // calculate r_ab squared
         Scalar rsq = dot(dx,dx);
 
         // get parameters for this bond type
-        param_type param = h_params.data[h_type.data[i]];
+        param_type param = args.params[args.type[i]];
 
         // compute the force and potential energy
         Scalar force_divr = Scalar(0.0);
@@ -311,7 +350,7 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
         if (evaluated)
             {
             // calculate virial
-            if (compute_virial)
+            if (args.compute_virial)
                 {
                 Scalar force_div2r = Scalar(1.0/2.0)*force_divr;
                 bond_virial[0] = dx.x * dx.x * force_div2r; // xx
@@ -323,27 +362,10 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
                 }
 
             // add the force to the particles (only for non-ghost particles)
-            if (idx_b < m_pdata->getN())
-                {
-                h_force.data[idx_b].x += force_divr * dx.x;
-                h_force.data[idx_b].y += force_divr * dx.y;
-                h_force.data[idx_b].z += force_divr * dx.z;
-                h_force.data[idx_b].w += bond_eng;
-                if (compute_virial)
-                    for (unsigned int i = 0; i < 6; i++)
-                        h_virial.data[i*m_virial_pitch+idx_b]  += bond_virial[i];
-                }
-
-            if (idx_a < m_pdata->getN())
-                {
-                h_force.data[idx_a].x -= force_divr * dx.x;
-                h_force.data[idx_a].y -= force_divr * dx.y;
-                h_force.data[idx_a].z -= force_divr * dx.z;
-                h_force.data[idx_a].w += bond_eng;
-                if (compute_virial)
-                    for (unsigned int i = 0; i < 6; i++)
-                        h_virial.data[i*m_virial_pitch+idx_a]  += bond_virial[i];
-                }
+            out.add(idx_b, make_scalar4(force_divr * dx.x, force_divr * dx.y, force_divr * dx.z, bond_eng),
+                    bond_virial);
+            out.add(idx_a, make_scalar4(-force_divr * dx.x, -force_divr * dx.y, -force_divr * dx.z, bond_eng),
+                    bond_virial);
             }
         else
             {
@@ -351,8 +373,6 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
             throw std::runtime_error("Error in bond calculation");
             }
         }
-
-    if (m_prof) m_prof->pop();
     }
 
 #ifdef ENABLE_MPI
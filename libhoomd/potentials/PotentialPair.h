@@ -57,12 +57,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/shared_ptr.hpp>
 #include <boost/python.hpp>
 #include <boost/bind.hpp>
+#include <boost/static_assert.hpp>
 
 #include "HOOMDMath.h"
 #include "Index1D.h"
 #include "GPUArray.h"
 #include "ForceCompute.h"
 #include "NeighborList.h"
+#include "NeighborListCluster.h"
+#include "EvaluatorPairBatch.h"
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
@@ -115,6 +118,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     <b>Implementation details</b>
 
+    Evaluators that provide a batch interface (see PairEvaluatorBatch) are evaluated PAIR_BATCH_SIZE neighbors at a
+    time when the shift mode is no_shift or shift. The distances, cutoffs and parameters of the neighbors are gathered
+    into lane arrays, and the evaluator computes all lanes in a loop that the compiler vectorizes. The per pair
+    evaluator is used in xplor mode and for all other evaluators.
+
+    When the neighbor list is a NeighborListCluster, batch evaluators instead loop over the cluster neighbor list and
+    evaluate all NLIST_CLUSTER_SIZE x NLIST_CLUSTER_SIZE pairs of two clusters as one batch. Exclusions are masked
+    per lane. The per particle list is used when body or diameter filtering is enabled.
+
     rcutsq, ronsq, and the params are stored per particle type pair. It wastes a little bit of space, but benchmarks
     show that storing the symmetric type pairs and indexing with Index2D is faster than not storing redudant pairs
     and indexing with Index2DUpperTriangular. All of these values are stored in GPUArray
@@ -171,6 +183,9 @@ class PotentialPair : public ForceCompute
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! Compute the forces between local particles while the ghost update is in flight
+        virtual void preComputeLocal(unsigned int timestep);
         #endif
 
     protected:
@@ -183,9 +198,74 @@ class PotentialPair : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        //! Pointers to the input arrays of the CPU force computation, shared by all threads
+        struct cpu_args
+            {
+            const unsigned int *n_neigh;    //!< Number of neighbors of each particle
+            const unsigned int *nlist;      //!< Neighbor list
+            const unsigned int *head_list;  //!< Offset of the first neighbor of each particle in the neighbor list
+            unsigned int nlist_stride;      //!< Stride between consecutive neighbors of a particle
+            const Scalar4 *pos;             //!< Particle positions and types
+            const Scalar *diameter;         //!< Particle diameters
+            const Scalar *charge;           //!< Particle charges
+            const Scalar *ronsq;            //!< ron squared per type pair
+            const Scalar *rcutsq;           //!< rcut squared per type pair
+            const param_type *params;       //!< Pair parameters per type pair
+            BoxDim box;                     //!< Simulation box
+            bool third_law;                 //!< True if the neighbor list is a half list
+            bool compute_virial;            //!< True if the virial needs to be computed
+            Scalar4 *thread_force;          //!< Per-thread partial forces (threads 1..n-1)
+            Scalar *thread_virial;          //!< Per-thread partial virials (threads 1..n-1)
+            unsigned int thread_force_pitch;  //!< Pitch of \a thread_force
+            unsigned int thread_virial_pitch; //!< Pitch of \a thread_virial
+            const unsigned int *cluster_idx;      //!< Particle indices of the clusters (NULL if clusters are not used)
+            const unsigned int *cluster_n_neigh;  //!< Number of neighbor clusters of each cluster
+            const unsigned int *cluster_nlist;    //!< Cluster neighbor list
+            Index2D cluster_nli;                  //!< Indexer for the cluster neighbor list
+            unsigned int n_clusters;              //!< Number of clusters
+            const unsigned int *n_ex;             //!< Number of exclusions of each particle (NULL if none are set)
+            const unsigned int *ex_list;          //!< Exclusion list
+            Index2D exli;                         //!< Indexer for the exclusion list
+            unsigned int j_first;                 //!< Pairs with neighbors before this index are skipped
+            unsigned int j_last;                  //!< Pairs with neighbors at or after this index are skipped
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        //! Evaluate the pairs with neighbors in a given index range
+        void computePairs(unsigned int j_first, unsigned int j_last, bool accumulate);
+
+        //! Returns true if the cluster kernel is used
+        bool useClusters() const;
+
+        //! Compute the forces on the particles assigned to one thread
+        void computeForcesThread(unsigned int thread_idx, const cpu_args& args, Scalar4 *h_force, Scalar *h_virial);
+
+        //! Evaluate all pair interactions of a range of particles
+        void evaluatePairs(const cpu_args& args,
+                           unsigned int first,
+                           unsigned int last,
+                           Scalar4 *h_force,
+                           Scalar *h_virial,
+                           unsigned int virial_pitch);
+
+        //! Evaluate all pair interactions of a range of particles with the batch interface of the evaluator
+        void evaluatePairsBatch(const cpu_args& args,
+                                unsigned int first,
+                                unsigned int last,
+                                Scalar4 *h_force,
+                                Scalar *h_virial,
+                                unsigned int virial_pitch);
+
+        //! Evaluate all pair interactions of a range of clusters of a NeighborListCluster
+        void evaluateClusterPairs(const cpu_args& args,
+                                  unsigned int first,
+                                  unsigned int last,
+                                  Scalar4 *h_force,
+                                  Scalar *h_virial,
+                                  unsigned int virial_pitch);
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -204,6 +284,20 @@ class PotentialPair : public ForceCompute
         //! Connection to the signal notifying when number of particle types changes
         boost::signals2::connection m_num_type_change_connection;
 
+        #ifdef ENABLE_MPI
+        bool m_local_valid;                     //!< True if m_force holds the pre-computed local forces
+        unsigned int m_local_step;              //!< Time step of the pre-computed local forces
+        unsigned int m_local_nlist_updates;     //!< Number of neighbor list builds at the time of the pre-computation
+
+        //! Connection to the signal notifying when the ghost particles are rebuilt
+        boost::signals2::connection m_ghost_change_connection;
+
+        //! Invalidate the pre-computed local forces
+        void slotGhostParticleNumberChange()
+            {
+            m_local_valid = false;
+            }
+        #endif
     };
 
 /*! \param sysdef System to compute forces on
@@ -234,6 +328,16 @@ PotentialPair< evaluator >::PotentialPair(boost::shared_ptr<SystemDefinition> sy
 
     // connect to the ParticleData to receive notifications when the maximum number of particles changes
     m_num_type_change_connection = m_pdata->connectNumTypesChange(boost::bind(&PotentialPair<evaluator>::slotNumTypesChange, this));
+
+    #ifdef ENABLE_MPI
+    m_local_valid = false;
+    m_local_step = 0;
+    m_local_nlist_updates = 0;
+
+    // the pre-computed local forces are invalidated by a rebuild of the ghost particles
+    m_ghost_change_connection = m_pdata->connectGhostParticleNumberChange(
+        boost::bind(&PotentialPair<evaluator>::slotGhostParticleNumberChange, this));
+    #endif
     }
 
 template< class evaluator >
@@ -242,6 +346,9 @@ PotentialPair< evaluator >::~PotentialPair()
     m_exec_conf->msg->notice(5) << "Destroying PotentialPair<" << evaluator::getName() << ">" << endl;
 
     m_num_type_change_connection.disconnect();
+    #ifdef ENABLE_MPI
+    m_ghost_change_connection.disconnect();
+    #endif
     }
 
 /*! \param typ1 First type index in the pair
@@ -342,6 +449,9 @@ Scalar PotentialPair< evaluator >::getLogValue(const std::string& quantity, unsi
     that it is up to date before proceeding.
 
     \param timestep specifies the current time step of the simulation
+
+    In MPI simulations on the CPU, the pairs of local particles may already have been evaluated by preComputeLocal()
+    while the ghost particles were communicated. In that case, only the pairs with ghost particles are added.
 */
 template< class evaluator >
 void PotentialPair< evaluator >::computeForces(unsigned int timestep)
@@ -352,26 +462,106 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     // start the profile for this compute
     if (m_prof) m_prof->push(m_prof_name);
 
+    #ifdef ENABLE_MPI
+    // the forces between local particles are still valid if they have been pre-computed in this time step
+    // with the same neighbor list
+    bool local_valid = m_local_valid && m_local_step == timestep && m_local_nlist_updates == m_nlist->getNumUpdates();
+    m_local_valid = false;
+
+    if (local_valid)
+        {
+        // only add the pairs with ghost particles
+        computePairs(m_pdata->getN(), m_pdata->getN() + m_pdata->getNGhosts(), true);
+        if (m_prof) m_prof->pop();
+        return;
+        }
+    #endif
+
+    computePairs(0, m_pdata->getN() + m_pdata->getNGhosts(), false);
+
+    if (m_prof) m_prof->pop();
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step
+
+    Evaluates all pairs of local particles with the current neighbor list. Since particles do not migrate in
+    this time step, the list is only rebuilt if it is forced to, which computeForces() detects.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::preComputeLocal(unsigned int timestep)
+    {
+    m_local_valid = false;
+
+    // the cluster kernel evaluates whole clusters that mix local and ghost particles
+    if (useClusters())
+        return;
+
+    if (m_prof) m_prof->push(m_prof_name);
+
+    computePairs(0, m_pdata->getN(), false);
+
+    m_local_valid = true;
+    m_local_step = timestep;
+    m_local_nlist_updates = m_nlist->getNumUpdates();
+
+    if (m_prof) m_prof->pop();
+    }
+#endif
+
+/*! \returns true if the neighbor list provides clusters and the evaluator a batch interface
+*/
+template< class evaluator >
+bool PotentialPair< evaluator >::useClusters() const
+    {
+    boost::shared_ptr<NeighborListCluster> cluster_nlist = boost::dynamic_pointer_cast<NeighborListCluster>(m_nlist);
+    return cluster_nlist && PairEvaluatorBatch<evaluator>::enabled && m_shift_mode != xplor
+           && !m_nlist->getFilterBody() && !m_nlist->getFilterDiameter();
+    }
+
+/*! \param j_first First neighbor index to evaluate the pairs with
+    \param j_last One past the last neighbor index to evaluate the pairs with
+    \param accumulate If true, add to the current forces instead of overwriting them
+
+    With \a accumulate, \a j_first must be at least getN(), so that no force is scattered to other local particles.
+
+    The particles are divided evenly among the threads of the ExecutionConfiguration's ThreadPool. With a full
+    neighbor list every thread only writes to the particles it owns. With a half neighbor list, the third law
+    contributions to other particles are accumulated in per-thread partial arrays (thread 0 writes directly into
+    the force arrays) which are summed at the end.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computePairs(unsigned int j_first, unsigned int j_last, bool accumulate)
+    {
+    assert(!accumulate || j_first >= m_pdata->getN());
+
+    // the cluster kernel is used when the neighbor list provides clusters and the evaluator a batch interface
+    boost::shared_ptr<NeighborListCluster> cluster_nlist = boost::dynamic_pointer_cast<NeighborListCluster>(m_nlist);
+    bool use_clusters = useClusters();
+    assert(!use_clusters || (j_first == 0 && !accumulate));
+
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
-    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+    // (the cluster list is always a half list)
+    bool third_law = m_nlist->getStorageMode() == NeighborList::half || use_clusters;
 
     // access the neighbor list, particle data, and system box
-    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-    Index2D nli = m_nlist->getNListIndexer();
+    // (the cluster kernel does not use the per particle list, NeighborListCluster then never builds it)
+    const GPUArray<unsigned int> no_n_neigh, no_nlist, no_head_list;
+    ArrayHandle<unsigned int> h_n_neigh(use_clusters ? no_n_neigh : m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(use_clusters ? no_nlist : m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(use_clusters ? no_head_list : m_nlist->getHeadList(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
-
     //force arrays
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
-
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host,
+        accumulate ? access_mode::readwrite : access_mode::overwrite);
+    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host,
+        accumulate ? access_mode::readwrite : access_mode::overwrite);
 
-    const BoxDim& box = m_pdata->getGlobalBox();
     ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
     ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
@@ -380,15 +570,152 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
 
     // need to start from a zero force, energy and virial
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (!accumulate)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
+
+    cpu_args args;
+    args.n_neigh = h_n_neigh.data;
+    args.nlist = h_nlist.data;
+    args.head_list = h_head_list.data;
+    args.nlist_stride = use_clusters ? 0 : m_nlist->getNListStride();
+    args.pos = h_pos.data;
+    args.diameter = h_diameter.data;
+    args.charge = h_charge.data;
+    args.ronsq = h_ronsq.data;
+    args.rcutsq = h_rcutsq.data;
+    args.params = h_params.data;
+    args.box = m_pdata->getGlobalBox();
+    args.third_law = third_law;
+    args.compute_virial = compute_virial;
+    args.j_first = j_first;
+    args.j_last = j_last;
+
+    args.cluster_idx = NULL;
+    args.n_ex = NULL;
+
+    // forces are only scattered to local neighbors
+    bool use_partial = third_law && j_first < m_pdata->getN() && m_exec_conf->getNumThreads() > 1;
+    if (use_partial)
+        allocateThreadPartial();
+
+        {
+        // per-thread partial arrays, only needed when forces are scattered to other particles
+        ArrayHandle<Scalar4> h_thread_force(m_thread_force, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_thread_virial(m_thread_virial, access_location::host, access_mode::overwrite);
+        args.thread_force = h_thread_force.data;
+        args.thread_virial = h_thread_virial.data;
+        args.thread_force_pitch = m_thread_force.getPitch();
+        args.thread_virial_pitch = m_thread_virial.getPitch();
+
+        ThreadPool::task_type task = boost::bind(&PotentialPair<evaluator>::computeForcesThread,
+                                                 this,
+                                                 _1,
+                                                 boost::cref(args),
+                                                 h_force.data,
+                                                 h_virial.data);
+
+        if (use_clusters)
+            {
+            ArrayHandle<unsigned int> h_cluster_idx(cluster_nlist->getClusterIdxArray(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_cluster_n_neigh(cluster_nlist->getClusterNNeighArray(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_cluster_nlist(cluster_nlist->getClusterNListArray(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_n_ex(m_nlist->getNExArray(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_ex_list(m_nlist->getExListArray(), access_location::host, access_mode::read);
+
+            args.cluster_idx = h_cluster_idx.data;
+            args.cluster_n_neigh = h_cluster_n_neigh.data;
+            args.cluster_nlist = h_cluster_nlist.data;
+            args.cluster_nli = cluster_nlist->getClusterNListIndexer();
+            args.n_clusters = cluster_nlist->getNClusters();
+            if (m_nlist->getExclusionsSet())
+                {
+                args.n_ex = h_n_ex.data;
+                args.ex_list = h_ex_list.data;
+                args.exli = m_nlist->getExListIndexer();
+                }
+
+            m_exec_conf->getThreadPool().run(task);
+            }
+        else
+            {
+            m_exec_conf->getThreadPool().run(task);
+            }
+        }
+
+    if (use_partial)
+        reduceThreadPartial(h_force.data, h_virial.data, compute_virial);
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Pointers to the input arrays
+    \param h_force Force array (written to by thread 0 and in the absence of third law scattering)
+    \param h_virial Virial array (written to by thread 0 and in the absence of third law scattering)
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeForcesThread(unsigned int thread_idx,
+                                                     const cpu_args& args,
+                                                     Scalar4 *h_force,
+                                                     Scalar *h_virial)
+    {
+    unsigned int N = m_pdata->getN();
+
+    // the cluster kernel divides the clusters among the threads, the others divide the particles
+    unsigned int first, last;
+    if (args.cluster_idx)
+        ThreadPool::getRange(args.n_clusters, thread_idx, m_exec_conf->getNumThreads(), first, last);
+    else
+        ThreadPool::getRange(N, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    unsigned int virial_pitch = m_virial_pitch;
+    if (args.third_law && args.j_first < N && thread_idx != 0)
+        {
+        // accumulate into this thread's partial arrays, which need to be zeroed first
+        h_force = args.thread_force + (thread_idx-1)*args.thread_force_pitch;
+        h_virial = args.thread_virial + 6*(thread_idx-1)*args.thread_virial_pitch;
+        virial_pitch = args.thread_virial_pitch;
+        memset((void*)h_force, 0, sizeof(Scalar4)*N);
+        if (args.compute_virial)
+            for (unsigned int l = 0; l < 6; l++)
+                memset((void*)(h_virial + l*virial_pitch), 0, sizeof(Scalar)*N);
+        }
+
+    if (args.cluster_idx)
+        evaluateClusterPairs(args, first, last, h_force, h_virial, virial_pitch);
+    else if (PairEvaluatorBatch<evaluator>::enabled && m_shift_mode != xplor)
+        evaluatePairsBatch(args, first, last, h_force, h_virial, virial_pitch);
+    else
+        evaluatePairs(args, first, last, h_force, h_virial, virial_pitch);
+    }
+
+/*! \param args Pointers to the input arrays
+    \param first First particle to compute the forces for
+    \param last One past the last particle to compute the forces for
+    \param h_force Force array to accumulate the forces in
+    \param h_virial Virial array to accumulate the virials in
+    \param virial_pitch Pitch of \a h_virial
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::evaluatePairs(const cpu_args& args,
+                                               unsigned int first,
+                                               unsigned int last,
+                                               Scalar4 *h_force,
+                                               Scalar *h_virial,
+                                               unsigned int virial_pitch)
+    {
+    const unsigned int nlist_stride = args.nlist_stride;
+    const BoxDim& box = args.box;
+    const bool third_law = args.third_law;
+    const bool compute_virial = args.compute_virial;
 
     // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    for (int i = (int)first; i < (int)last; i++)
         {
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        Scalar3 pi = make_scalar3(args.pos[i].x, args.pos[i].y, args.pos[i].z);
+        unsigned int typei = __scalar_as_int(args.pos[i].w);
 
         // sanity check
         assert(typei < m_pdata->getNTypes());
@@ -397,9 +724,9 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
         Scalar di = Scalar(0.0);
         Scalar qi = Scalar(0.0);
         if (evaluator::needsDiameter())
-            di = h_diameter.data[i];
+            di = args.diameter[i];
         if (evaluator::needsCharge())
-            qi = h_charge.data[i];
+            qi = args.charge[i];
 
         // initialize current particle force, potential energy, and virial to 0
         Scalar3 fi = make_scalar3(0, 0, 0);
@@ -412,28 +739,33 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
         Scalar virialzzi = 0.0;
 
         // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        const unsigned int head_i = args.head_list[i];
+        const unsigned int size = (unsigned int)args.n_neigh[i];
         for (unsigned int k = 0; k < size; k++)
             {
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[nli(i, k)];
+            unsigned int j = args.nlist[head_i + k*nlist_stride];
             assert(j < m_pdata->getN() + m_pdata->getNGhosts());
 
+            // skip neighbors outside of the requested range
+            if (j < args.j_first || j >= args.j_last)
+                continue;
+
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            Scalar3 pj = make_scalar3(args.pos[j].x, args.pos[j].y, args.pos[j].z);
             Scalar3 dx = pi - pj;
 
             // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+            unsigned int typej = __scalar_as_int(args.pos[j].w);
             assert(typej < m_pdata->getNTypes());
 
             // access diameter and charge (if needed)
             Scalar dj = Scalar(0.0);
             Scalar qj = Scalar(0.0);
             if (evaluator::needsDiameter())
-                dj = h_diameter.data[j];
+                dj = args.diameter[j];
             if (evaluator::needsCharge())
-                qj = h_charge.data[j];
+                qj = args.charge[j];
 
             // apply periodic boundary conditions
             dx = box.minImage(dx);
@@ -443,11 +775,11 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
             // get parameters for this type pair
             unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
+            param_type param = args.params[typpair_idx];
+            Scalar rcutsq = args.rcutsq[typpair_idx];
             Scalar ronsq = Scalar(0.0);
             if (m_shift_mode == xplor)
-                ronsq = h_ronsq.data[typpair_idx];
+                ronsq = args.ronsq[typpair_idx];
 
             // design specifies that energies are shifted if
             // 1) shift mode is set to shift
@@ -520,18 +852,18 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
                 if (third_law && j < m_pdata->getN())
                     {
                     unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x*force_divr;
-                    h_force.data[mem_idx].y -= dx.y*force_divr;
-                    h_force.data[mem_idx].z -= dx.z*force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                    h_force[mem_idx].x -= dx.x*force_divr;
+                    h_force[mem_idx].y -= dx.y*force_divr;
+                    h_force[mem_idx].z -= dx.z*force_divr;
+                    h_force[mem_idx].w += pair_eng * Scalar(0.5);
                     if (compute_virial)
                         {
-                        h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
-                        h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
-                        h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
-                        h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
-                        h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
-                        h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
+                        h_virial[0*virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
+                        h_virial[1*virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
+                        h_virial[2*virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
+                        h_virial[3*virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
+                        h_virial[4*virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
+                        h_virial[5*virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
                         }
                     }
                 }
@@ -539,22 +871,411 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
         // finally, increment the force, potential energy and virial for particle i
         unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
+        h_force[mem_idx].x += fi.x;
+        h_force[mem_idx].y += fi.y;
+        h_force[mem_idx].z += fi.z;
+        h_force[mem_idx].w += pei;
         if (compute_virial)
             {
-            h_virial.data[0*m_virial_pitch+mem_idx] += virialxxi;
-            h_virial.data[1*m_virial_pitch+mem_idx] += virialxyi;
-            h_virial.data[2*m_virial_pitch+mem_idx] += virialxzi;
-            h_virial.data[3*m_virial_pitch+mem_idx] += virialyyi;
-            h_virial.data[4*m_virial_pitch+mem_idx] += virialyzi;
-            h_virial.data[5*m_virial_pitch+mem_idx] += virialzzi;
+            h_virial[0*virial_pitch+mem_idx] += virialxxi;
+            h_virial[1*virial_pitch+mem_idx] += virialxyi;
+            h_virial[2*virial_pitch+mem_idx] += virialxzi;
+            h_virial[3*virial_pitch+mem_idx] += virialyyi;
+            h_virial[4*virial_pitch+mem_idx] += virialyzi;
+            h_virial[5*virial_pitch+mem_idx] += virialzzi;
             }
         }
+    }
 
-    if (m_prof) m_prof->pop();
+/*! \param args Pointers to the input arrays
+    \param first First particle to compute the forces for
+    \param last One past the last particle to compute the forces for
+    \param h_force Force array to accumulate the forces in
+    \param h_virial Virial array to accumulate the virials in
+    \param virial_pitch Pitch of \a h_virial
+
+    Computes the same forces as evaluatePairs() for the no_shift and shift modes. The neighbors of each particle are
+    processed in batches of PAIR_BATCH_SIZE. A partially filled batch is padded with lanes that lie beyond the cutoff,
+    which evaluate to zero force and energy.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::evaluatePairsBatch(const cpu_args& args,
+                                                    unsigned int first,
+                                                    unsigned int last,
+                                                    Scalar4 *h_force,
+                                                    Scalar *h_virial,
+                                                    unsigned int virial_pitch)
+    {
+    assert(!evaluator::needsDiameter() && !evaluator::needsCharge());
+    assert(m_shift_mode != xplor);
+
+    const unsigned int nlist_stride = args.nlist_stride;
+    const BoxDim& box = args.box;
+    const bool third_law = args.third_law;
+    const bool compute_virial = args.compute_virial;
+    const bool energy_shift = (m_shift_mode == shift);
+    const unsigned int N = m_pdata->getN();
+
+    // lane arrays of the current batch
+    Scalar dx_x[PAIR_BATCH_SIZE];
+    Scalar dx_y[PAIR_BATCH_SIZE];
+    Scalar dx_z[PAIR_BATCH_SIZE];
+    Scalar rsq[PAIR_BATCH_SIZE];
+    Scalar rcutsq[PAIR_BATCH_SIZE];
+    param_type params[PAIR_BATCH_SIZE];
+    Scalar force_divr[PAIR_BATCH_SIZE];
+    Scalar pair_eng[PAIR_BATCH_SIZE];
+    unsigned int jidx[PAIR_BATCH_SIZE];
+
+    // for each particle
+    for (int i = (int)first; i < (int)last; i++)
+        {
+        Scalar3 pi = make_scalar3(args.pos[i].x, args.pos[i].y, args.pos[i].z);
+        unsigned int typei = __scalar_as_int(args.pos[i].w);
+        assert(typei < m_pdata->getNTypes());
+
+        Scalar3 fi = make_scalar3(0, 0, 0);
+        Scalar pei = 0.0;
+        Scalar virialxxi = 0.0;
+        Scalar virialxyi = 0.0;
+        Scalar virialxzi = 0.0;
+        Scalar virialyyi = 0.0;
+        Scalar virialyzi = 0.0;
+        Scalar virialzzi = 0.0;
+
+        const unsigned int head_i = args.head_list[i];
+        const unsigned int size = (unsigned int)args.n_neigh[i];
+        for (unsigned int k0 = 0; k0 < size; k0 += PAIR_BATCH_SIZE)
+            {
+            unsigned int n_lanes = size - k0;
+            if (n_lanes > PAIR_BATCH_SIZE)
+                n_lanes = PAIR_BATCH_SIZE;
+
+            // gather the separations and type pair parameters into the lanes
+            for (unsigned int l = 0; l < n_lanes; l++)
+                {
+                unsigned int j = args.nlist[head_i + (k0 + l)*nlist_stride];
+                assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+                // mask neighbors outside of the requested range by placing them at the cutoff
+                if (j < args.j_first || j >= args.j_last)
+                    {
+                    jidx[l] = N;
+                    dx_x[l] = dx_y[l] = dx_z[l] = Scalar(0.0);
+                    rsq[l] = Scalar(1.0);
+                    rcutsq[l] = Scalar(1.0);
+                    params[l] = args.params[m_typpair_idx(typei, typei)];
+                    continue;
+                    }
+
+                jidx[l] = j;
+
+                Scalar3 pj = make_scalar3(args.pos[j].x, args.pos[j].y, args.pos[j].z);
+                Scalar3 dx = box.minImage(pi - pj);
+                dx_x[l] = dx.x;
+                dx_y[l] = dx.y;
+                dx_z[l] = dx.z;
+                rsq[l] = dot(dx, dx);
+
+                unsigned int typej = __scalar_as_int(args.pos[j].w);
+                assert(typej < m_pdata->getNTypes());
+                unsigned int typpair_idx = m_typpair_idx(typei, typej);
+                params[l] = args.params[typpair_idx];
+                rcutsq[l] = args.rcutsq[typpair_idx];
+                }
+
+            // pad the remaining lanes with pairs at the cutoff
+            for (unsigned int l = n_lanes; l < PAIR_BATCH_SIZE; l++)
+                {
+                dx_x[l] = dx_y[l] = dx_z[l] = Scalar(0.0);
+                rsq[l] = Scalar(1.0);
+                rcutsq[l] = Scalar(1.0);
+                params[l] = params[0];
+                }
+
+            PairEvaluatorBatch<evaluator>::evalForceAndEnergyBatch(rsq, rcutsq, params, force_divr, pair_eng, energy_shift);
+
+            // add the force, potential energy and virial of all lanes to particle i
+            for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+                {
+                fi.x += dx_x[l]*force_divr[l];
+                fi.y += dx_y[l]*force_divr[l];
+                fi.z += dx_z[l]*force_divr[l];
+                pei += pair_eng[l] * Scalar(0.5);
+                }
+
+            if (compute_virial)
+                {
+                for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+                    {
+                    Scalar force_div2r = force_divr[l] * Scalar(0.5);
+                    virialxxi += force_div2r*dx_x[l]*dx_x[l];
+                    virialxyi += force_div2r*dx_x[l]*dx_y[l];
+                    virialxzi += force_div2r*dx_x[l]*dx_z[l];
+                    virialyyi += force_div2r*dx_y[l]*dx_y[l];
+                    virialyzi += force_div2r*dx_y[l]*dx_z[l];
+                    virialzzi += force_div2r*dx_z[l]*dx_z[l];
+                    }
+                }
+
+            // scatter the third law contributions to the local neighbors
+            if (third_law)
+                {
+                for (unsigned int l = 0; l < n_lanes; l++)
+                    {
+                    unsigned int mem_idx = jidx[l];
+                    if (mem_idx >= N)
+                        continue;
+
+                    h_force[mem_idx].x -= dx_x[l]*force_divr[l];
+                    h_force[mem_idx].y -= dx_y[l]*force_divr[l];
+                    h_force[mem_idx].z -= dx_z[l]*force_divr[l];
+                    h_force[mem_idx].w += pair_eng[l] * Scalar(0.5);
+                    if (compute_virial)
+                        {
+                        Scalar force_div2r = force_divr[l] * Scalar(0.5);
+                        h_virial[0*virial_pitch+mem_idx] += force_div2r*dx_x[l]*dx_x[l];
+                        h_virial[1*virial_pitch+mem_idx] += force_div2r*dx_x[l]*dx_y[l];
+                        h_virial[2*virial_pitch+mem_idx] += force_div2r*dx_x[l]*dx_z[l];
+                        h_virial[3*virial_pitch+mem_idx] += force_div2r*dx_y[l]*dx_y[l];
+                        h_virial[4*virial_pitch+mem_idx] += force_div2r*dx_y[l]*dx_z[l];
+                        h_virial[5*virial_pitch+mem_idx] += force_div2r*dx_z[l]*dx_z[l];
+                        }
+                    }
+                }
+            }
+
+        // finally, increment the force, potential energy and virial for particle i
+        unsigned int mem_idx = i;
+        h_force[mem_idx].x += fi.x;
+        h_force[mem_idx].y += fi.y;
+        h_force[mem_idx].z += fi.z;
+        h_force[mem_idx].w += pei;
+        if (compute_virial)
+            {
+            h_virial[0*virial_pitch+mem_idx] += virialxxi;
+            h_virial[1*virial_pitch+mem_idx] += virialxyi;
+            h_virial[2*virial_pitch+mem_idx] += virialxzi;
+            h_virial[3*virial_pitch+mem_idx] += virialyyi;
+            h_virial[4*virial_pitch+mem_idx] += virialyzi;
+            h_virial[5*virial_pitch+mem_idx] += virialzzi;
+            }
+        }
+    }
+
+/*! \param args Pointers to the input arrays
+    \param first First cluster to compute the forces for
+    \param last One past the last cluster to compute the forces for
+    \param h_force Force array to accumulate the forces in
+    \param h_virial Virial array to accumulate the virials in
+    \param virial_pitch Pitch of \a h_virial
+
+    Computes the same forces as evaluatePairsBatch() from the cluster neighbor list of a NeighborListCluster. Lane
+    \a a * NLIST_CLUSTER_SIZE + \a b of a batch holds the pair of particle \a a of cluster I and particle \a b of
+    cluster J. Lanes of empty cluster slots, of pairs that are counted elsewhere or that are excluded are masked by
+    placing them at the cutoff. The cluster list holds every pair of clusters only once, so the forces are always applied
+    to both clusters with the third law and the forces on ghost particles are discarded.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::evaluateClusterPairs(const cpu_args& args,
+                                                      unsigned int first,
+                                                      unsigned int last,
+                                                      Scalar4 *h_force,
+                                                      Scalar *h_virial,
+                                                      unsigned int virial_pitch)
+    {
+    BOOST_STATIC_ASSERT(NLIST_CLUSTER_SIZE*NLIST_CLUSTER_SIZE == PAIR_BATCH_SIZE);
+    assert(m_shift_mode != xplor);
+    assert(args.third_law);
+
+    const BoxDim& box = args.box;
+    const bool compute_virial = args.compute_virial;
+    const bool energy_shift = (m_shift_mode == shift);
+    const unsigned int N = m_pdata->getN();
+    const unsigned int CS = NLIST_CLUSTER_SIZE;
+
+    // lane arrays of the current batch
+    Scalar dx_x[PAIR_BATCH_SIZE];
+    Scalar dx_y[PAIR_BATCH_SIZE];
+    Scalar dx_z[PAIR_BATCH_SIZE];
+    Scalar rsq[PAIR_BATCH_SIZE];
+    Scalar rcutsq[PAIR_BATCH_SIZE];
+    param_type params[PAIR_BATCH_SIZE];
+    Scalar force_divr[PAIR_BATCH_SIZE];
+    Scalar pair_eng[PAIR_BATCH_SIZE];
+
+    for (unsigned int I = first; I < last; I++)
+        {
+        // load the particles of cluster I
+        unsigned int idx_i[CS];
+        Scalar3 pos_i[CS];
+        unsigned int type_i[CS];
+        for (unsigned int a = 0; a < CS; a++)
+            {
+            unsigned int i = args.cluster_idx[I*CS + a];
+            idx_i[a] = i;
+            if (i == NLIST_CLUSTER_EMPTY)
+                continue;
+            pos_i[a] = make_scalar3(args.pos[i].x, args.pos[i].y, args.pos[i].z);
+            type_i[a] = __scalar_as_int(args.pos[i].w);
+            }
+
+        Scalar3 fi[CS];
+        Scalar pei[CS];
+        Scalar virial_i[6][CS];
+        for (unsigned int a = 0; a < CS; a++)
+            {
+            fi[a] = make_scalar3(0, 0, 0);
+            pei[a] = Scalar(0.0);
+            for (unsigned int l = 0; l < 6; l++)
+                virial_i[l][a] = Scalar(0.0);
+            }
+
+        const unsigned int n_neigh_clusters = args.cluster_n_neigh[I];
+        for (unsigned int k = 0; k < n_neigh_clusters; k++)
+            {
+            unsigned int J = args.cluster_nlist[args.cluster_nli(k, I)];
+
+            unsigned int idx_j[CS];
+            for (unsigned int b = 0; b < CS; b++)
+                idx_j[b] = args.cluster_idx[J*CS + b];
+
+            // gather the pairs into the lanes
+            for (unsigned int a = 0; a < CS; a++)
+                {
+                unsigned int i = idx_i[a];
+                for (unsigned int b = 0; b < CS; b++)
+                    {
+                    unsigned int l = a*CS + b;
+                    unsigned int j = idx_j[b];
+
+                    bool active = (i != NLIST_CLUSTER_EMPTY && j != NLIST_CLUSTER_EMPTY);
+                    if (J == I)
+                        active = active && b > a;
+                    active = active && (i < N || j < N);
+
+                    if (active && args.n_ex)
+                        {
+                        // exclusions are stored for local particles and are symmetric
+                        unsigned int p = (i < N) ? i : j;
+                        unsigned int q = (i < N) ? j : i;
+                        unsigned int n_ex = args.n_ex[p];
+                        for (unsigned int cur_ex = 0; cur_ex < n_ex; cur_ex++)
+                            if (args.ex_list[args.exli(p, cur_ex)] == q)
+                                active = false;
+                        }
+
+                    if (active)
+                        {
+                        Scalar3 dx = box.minImage(pos_i[a] - make_scalar3(args.pos[j].x, args.pos[j].y, args.pos[j].z));
+                        dx_x[l] = dx.x;
+                        dx_y[l] = dx.y;
+                        dx_z[l] = dx.z;
+                        rsq[l] = dot(dx, dx);
+
+                        unsigned int typej = __scalar_as_int(args.pos[j].w);
+                        unsigned int typpair_idx = m_typpair_idx(type_i[a], typej);
+                        params[l] = args.params[typpair_idx];
+                        rcutsq[l] = args.rcutsq[typpair_idx];
+                        }
+                    else
+                        {
+                        dx_x[l] = dx_y[l] = dx_z[l] = Scalar(0.0);
+                        rsq[l] = Scalar(1.0);
+                        rcutsq[l] = Scalar(1.0);
+                        params[l] = args.params[0];
+                        }
+                    }
+                }
+
+            PairEvaluatorBatch<evaluator>::evalForceAndEnergyBatch(rsq, rcutsq, params, force_divr, pair_eng, energy_shift);
+
+            // add the force, potential energy and virial to the particles of cluster I
+            for (unsigned int a = 0; a < CS; a++)
+                {
+                for (unsigned int b = 0; b < CS; b++)
+                    {
+                    unsigned int l = a*CS + b;
+                    fi[a].x += dx_x[l]*force_divr[l];
+                    fi[a].y += dx_y[l]*force_divr[l];
+                    fi[a].z += dx_z[l]*force_divr[l];
+                    pei[a] += pair_eng[l] * Scalar(0.5);
+                    }
+                }
+
+            if (compute_virial)
+                {
+                for (unsigned int a = 0; a < CS; a++)
+                    {
+                    for (unsigned int b = 0; b < CS; b++)
+                        {
+                        unsigned int l = a*CS + b;
+                        Scalar force_div2r = force_divr[l] * Scalar(0.5);
+                        virial_i[0][a] += force_div2r*dx_x[l]*dx_x[l];
+                        virial_i[1][a] += force_div2r*dx_x[l]*dx_y[l];
+                        virial_i[2][a] += force_div2r*dx_x[l]*dx_z[l];
+                        virial_i[3][a] += force_div2r*dx_y[l]*dx_y[l];
+                        virial_i[4][a] += force_div2r*dx_y[l]*dx_z[l];
+                        virial_i[5][a] += force_div2r*dx_z[l]*dx_z[l];
+                        }
+                    }
+                }
+
+            // scatter the third law contributions to the local particles of cluster J
+            for (unsigned int b = 0; b < CS; b++)
+                {
+                unsigned int mem_idx = idx_j[b];
+                if (mem_idx >= N)
+                    continue;
+
+                Scalar3 fj = make_scalar3(0, 0, 0);
+                Scalar pej = Scalar(0.0);
+                Scalar virial_j[6] = {0, 0, 0, 0, 0, 0};
+                for (unsigned int a = 0; a < CS; a++)
+                    {
+                    unsigned int l = a*CS + b;
+                    fj.x += dx_x[l]*force_divr[l];
+                    fj.y += dx_y[l]*force_divr[l];
+                    fj.z += dx_z[l]*force_divr[l];
+                    pej += pair_eng[l] * Scalar(0.5);
+                    if (compute_virial)
+                        {
+                        Scalar force_div2r = force_divr[l] * Scalar(0.5);
+                        virial_j[0] += force_div2r*dx_x[l]*dx_x[l];
+                        virial_j[1] += force_div2r*dx_x[l]*dx_y[l];
+                        virial_j[2] += force_div2r*dx_x[l]*dx_z[l];
+                        virial_j[3] += force_div2r*dx_y[l]*dx_y[l];
+                        virial_j[4] += force_div2r*dx_y[l]*dx_z[l];
+                        virial_j[5] += force_div2r*dx_z[l]*dx_z[l];
+                        }
+                    }
+
+                h_force[mem_idx].x -= fj.x;
+                h_force[mem_idx].y -= fj.y;
+                h_force[mem_idx].z -= fj.z;
+                h_force[mem_idx].w += pej;
+                if (compute_virial)
+                    for (unsigned int l = 0; l < 6; l++)
+                        h_virial[l*virial_pitch+mem_idx] += virial_j[l];
+                }
+            }
+
+        // finally, increment the force, potential energy and virial for the local particles of cluster I
+        for (unsigned int a = 0; a < CS; a++)
+            {
+            unsigned int mem_idx = idx_i[a];
+            if (mem_idx >= N)
+                continue;
+
+            h_force[mem_idx].x += fi[a].x;
+            h_force[mem_idx].y += fi[a].y;
+            h_force[mem_idx].z += fi[a].z;
+            h_force[mem_idx].w += pei[a];
+            if (compute_virial)
+                for (unsigned int l = 0; l < 6; l++)
+                    h_virial[l*virial_pitch+mem_idx] += virial_i[l][a];
+            }
+        }
     }
 
 #ifdef ENABLE_MPI
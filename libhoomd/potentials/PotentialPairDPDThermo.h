@@ -112,6 +112,9 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! The thermostat forces are computed in a single pass (overrides PotentialPair::preComputeLocal())
+        virtual void preComputeLocal(unsigned int timestep) { }
         #endif
 
     protected:
@@ -119,8 +122,44 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         unsigned int m_seed;  //!< seed for PRNG for DPD thermostat
         boost::shared_ptr<Variant> m_T;     //!< Temperature for the DPD thermostat
 
+        //! Pointers to the input arrays of the CPU force computation, shared by all threads
+        struct dpd_cpu_args
+            {
+            const unsigned int *n_neigh;    //!< Number of neighbors of each particle
+            const unsigned int *nlist;      //!< Neighbor list
+            const unsigned int *head_list;  //!< Offset of the first neighbor of each particle in the neighbor list
+            unsigned int nlist_stride;      //!< Stride between consecutive neighbors of a particle
+            const Scalar4 *pos;             //!< Particle positions and types
+            const Scalar4 *vel;             //!< Particle velocities
+            const unsigned int *tag;        //!< Particle tags
+            const Scalar *rcutsq;           //!< rcut squared per type pair
+            const param_type *params;       //!< Pair parameters per type pair
+            BoxDim box;                     //!< Simulation box
+            bool third_law;                 //!< True if the neighbor list is a half list
+            unsigned int timestep;          //!< Current time step (seeds the random forces)
+            Scalar T;                       //!< Current temperature of the thermostat
+            Scalar4 *thread_force;          //!< Per-thread partial forces (threads 1..n-1)
+            Scalar *thread_virial;          //!< Per-thread partial virials (threads 1..n-1)
+            unsigned int thread_force_pitch;  //!< Pitch of \a thread_force
+            unsigned int thread_virial_pitch; //!< Pitch of \a thread_virial
+            };
+
         //! Actually compute the forces (overwrites PotentialPair::computeForces())
         virtual void computeForces(unsigned int timestep);
+
+        //! Compute the forces on the particles assigned to one thread
+        void computeDPDForcesThread(unsigned int thread_idx,
+                                    const dpd_cpu_args& args,
+                                    Scalar4 *h_force,
+                                    Scalar *h_virial);
+
+        //! Evaluate all pair interactions of a range of particles
+        void evaluateDPDPairs(const dpd_cpu_args& args,
+                              unsigned int first,
+                              unsigned int last,
+                              Scalar4 *h_force,
+                              Scalar *h_virial,
+                              unsigned int virial_pitch);
     };
 
 /*! \param sysdef System to compute forces on
@@ -159,6 +198,10 @@ void PotentialPairDPDThermo< evaluator >::setT(boost::shared_ptr<Variant> T)
     that it is up to date before proceeding.
 
     \param timestep specifies the current time step of the simulation
+
+    The work is divided among the threads of the ThreadPool in the same way as in PotentialPair::computePairs().
+    The random forces are seeded by the particle tags and the timestep, so the result does not depend on the
+    number of threads.
 */
 template< class evaluator >
 void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
@@ -176,7 +219,7 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(this->m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(this->m_nlist->getNListArray(), access_location::host, access_mode::read);
-    Index2D nli = this->m_nlist->getNListIndexer();
+    ArrayHandle<unsigned int> h_head_list(this->m_nlist->getHeadList(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_pos(this->m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(this->m_pdata->getVelocities(), access_location::host, access_mode::read);
@@ -186,8 +229,6 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> h_force(this->m_force,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar>  h_virial(this->m_virial,access_location::host, access_mode::overwrite);
 
-    const BoxDim& box = this->m_pdata->getBox();
-    ArrayHandle<Scalar> h_ronsq(this->m_ronsq, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcutsq(this->m_rcutsq, access_location::host, access_mode::read);
     ArrayHandle<param_type> h_params(this->m_params, access_location::host, access_mode::read);
 
@@ -195,14 +236,105 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
     memset((void*)h_force.data,0,sizeof(Scalar4)*this->m_force.getNumElements());
     memset((void*)h_virial.data,0,sizeof(Scalar)*this->m_virial.getNumElements());
 
+    dpd_cpu_args args;
+    args.n_neigh = h_n_neigh.data;
+    args.nlist = h_nlist.data;
+    args.head_list = h_head_list.data;
+    args.nlist_stride = this->m_nlist->getNListStride();
+    args.pos = h_pos.data;
+    args.vel = h_vel.data;
+    args.tag = h_tag.data;
+    args.rcutsq = h_rcutsq.data;
+    args.params = h_params.data;
+    args.box = this->m_pdata->getBox();
+    args.third_law = third_law;
+    args.timestep = timestep;
+    args.T = m_T->getValue(timestep);
+
+    bool use_partial = third_law && this->m_exec_conf->getNumThreads() > 1;
+    if (use_partial)
+        this->allocateThreadPartial();
+
+        {
+        ArrayHandle<Scalar4> h_thread_force(this->m_thread_force, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_thread_virial(this->m_thread_virial, access_location::host, access_mode::overwrite);
+        args.thread_force = h_thread_force.data;
+        args.thread_virial = h_thread_virial.data;
+        args.thread_force_pitch = this->m_thread_force.getPitch();
+        args.thread_virial_pitch = this->m_thread_virial.getPitch();
+
+        this->m_exec_conf->getThreadPool().run(boost::bind(&PotentialPairDPDThermo<evaluator>::computeDPDForcesThread,
+                                                           this,
+                                                           _1,
+                                                           boost::cref(args),
+                                                           h_force.data,
+                                                           h_virial.data));
+        }
+
+    if (use_partial)
+        this->reduceThreadPartial(h_force.data, h_virial.data, true);
+
+    if (this->m_prof) this->m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Pointers to the input arrays
+    \param h_force Force array (written to by thread 0 and in the absence of third law scattering)
+    \param h_virial Virial array (written to by thread 0 and in the absence of third law scattering)
+*/
+template< class evaluator >
+void PotentialPairDPDThermo< evaluator >::computeDPDForcesThread(unsigned int thread_idx,
+                                                                 const dpd_cpu_args& args,
+                                                                 Scalar4 *h_force,
+                                                                 Scalar *h_virial)
+    {
+    unsigned int N = this->m_pdata->getN();
+    unsigned int first, last;
+    ThreadPool::getRange(N, thread_idx, this->m_exec_conf->getNumThreads(), first, last);
+
+    if (!args.third_law || thread_idx == 0)
+        {
+        evaluateDPDPairs(args, first, last, h_force, h_virial, this->m_virial_pitch);
+        }
+    else
+        {
+        // accumulate into this thread's partial arrays, which need to be zeroed first
+        Scalar4 *thread_force = args.thread_force + (thread_idx-1)*args.thread_force_pitch;
+        Scalar *thread_virial = args.thread_virial + 6*(thread_idx-1)*args.thread_virial_pitch;
+        memset((void*)thread_force, 0, sizeof(Scalar4)*N);
+        for (unsigned int l = 0; l < 6; l++)
+            memset((void*)(thread_virial + l*args.thread_virial_pitch), 0, sizeof(Scalar)*N);
+
+        evaluateDPDPairs(args, first, last, thread_force, thread_virial, args.thread_virial_pitch);
+        }
+    }
+
+/*! \param args Pointers to the input arrays
+    \param first First particle to compute the forces for
+    \param last One past the last particle to compute the forces for
+    \param h_force Force array to accumulate the forces in
+    \param h_virial Virial array to accumulate the virials in
+    \param virial_pitch Pitch of \a h_virial
+*/
+template< class evaluator >
+void PotentialPairDPDThermo< evaluator >::evaluateDPDPairs(const dpd_cpu_args& args,
+                                                           unsigned int first,
+                                                           unsigned int last,
+                                                           Scalar4 *h_force,
+                                                           Scalar *h_virial,
+                                                           unsigned int virial_pitch)
+    {
+    const unsigned int nlist_stride = args.nlist_stride;
+    const BoxDim& box = args.box;
+
     // for each particle
-    for (int i = 0; i < (int)this->m_pdata->getN(); i++)
+    for (int i = (int)first; i < (int)last; i++)
         {
         // access the particle's position, velocity, and type (MEM TRANSFER: 7 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        Scalar3 vi = make_scalar3(h_vel.data[i].x, h_vel.data[i].y, h_vel.data[i].z);
+        Scalar3 pi = make_scalar3(args.pos[i].x, args.pos[i].y, args.pos[i].z);
+        Scalar3 vi = make_scalar3(args.vel[i].x, args.vel[i].y, args.vel[i].z);
 
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        unsigned int typei = __scalar_as_int(args.pos[i].w);
 
         // sanity check
         assert(typei < this->m_pdata->getNTypes());
@@ -215,23 +347,24 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
             viriali[l] = 0.0;
 
         // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        const unsigned int head_i = args.head_list[i];
+        const unsigned int size = (unsigned int)args.n_neigh[i];
         for (unsigned int k = 0; k < size; k++)
             {
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[nli(i, k)];
+            unsigned int j = args.nlist[head_i + k*nlist_stride];
             assert(j < this->m_pdata->getN() + this->m_pdata->getNGhosts() );
 
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            Scalar3 pj = make_scalar3(args.pos[j].x, args.pos[j].y, args.pos[j].z);
             Scalar3 dx = pi - pj;
 
             // calculate dv_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 vj = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
+            Scalar3 vj = make_scalar3(args.vel[j].x, args.vel[j].y, args.vel[j].z);
             Scalar3 dv = vi - vj;
 
             // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+            unsigned int typej = __scalar_as_int(args.pos[j].w);
             assert(typej < this->m_pdata->getNTypes());
 
             // apply periodic boundary conditions
@@ -245,8 +378,8 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
 
             // get parameters for this type pair
             unsigned int typpair_idx = this->m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
+            param_type param = args.params[typpair_idx];
+            Scalar rcutsq = args.rcutsq[typpair_idx];
 
             // design specifies that energies are shifted if
             // 1) shift mode is set to shift
@@ -260,16 +393,13 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
             Scalar pair_eng = Scalar(0.0);
             evaluator eval(rsq, rcutsq, param);
 
-            // Special Potential Pair DPD Requirements
-            const Scalar currentTemp = m_T->getValue(timestep);
-
             // set seed using global tags
-            unsigned int tagi = h_tag.data[i];
-            unsigned int tagj = h_tag.data[j];
-            eval.set_seed_ij_timestep(m_seed,tagi,tagj,timestep);
+            unsigned int tagi = args.tag[i];
+            unsigned int tagj = args.tag[j];
+            eval.set_seed_ij_timestep(m_seed,tagi,tagj,args.timestep);
             eval.setDeltaT(this->m_deltaT);
             eval.setRDotV(rdotv);
-            eval.setT(currentTemp);
+            eval.setT(args.T);
 
             bool evaluated = eval.evalForceEnergyThermo(force_divr, force_divr_cons, pair_eng, energy_shift);
 
@@ -293,30 +423,29 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
                     viriali[l] += pair_virial[l];
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                if (third_law)
+                // only add force to local particles
+                if (args.third_law && j < this->m_pdata->getN())
                     {
                     unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x*force_divr;
-                    h_force.data[mem_idx].y -= dx.y*force_divr;
-                    h_force.data[mem_idx].z -= dx.z*force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                    h_force[mem_idx].x -= dx.x*force_divr;
+                    h_force[mem_idx].y -= dx.y*force_divr;
+                    h_force[mem_idx].z -= dx.z*force_divr;
+                    h_force[mem_idx].w += pair_eng * Scalar(0.5);
                     for (unsigned int l = 0; l < 6; l++)
-                        h_virial.data[l * this->m_virial_pitch + mem_idx] += pair_virial[l];
+                        h_virial[l * virial_pitch + mem_idx] += pair_virial[l];
                     }
                 }
             }
 
         // finally, increment the force, potential energy and virial for particle i
         unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
+        h_force[mem_idx].x += fi.x;
+        h_force[mem_idx].y += fi.y;
+        h_force[mem_idx].z += fi.z;
+        h_force[mem_idx].w += pei;
         for (unsigned int l = 0; l < 6; l++)
-            h_virial.data[l * this->m_virial_pitch + mem_idx] += viriali[l];
+            h_virial[l * virial_pitch + mem_idx] += viriali[l];
         }
-
-    if (this->m_prof) this->m_prof->pop();
     }
 
 #ifdef ENABLE_MPI
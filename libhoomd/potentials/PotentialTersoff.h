@@ -332,7 +332,8 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-    Index2D nli = m_nlist->getNListIndexer();
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+    const unsigned int nlist_stride = m_nlist->getNListStride();
 
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
@@ -367,7 +368,7 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
         for (unsigned int j = 0; j < size; j++)
             {
             // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-            unsigned int jj = h_nlist.data[nli(i, j)];
+            unsigned int jj = h_nlist.data[h_head_list.data[i] + j*nlist_stride];
             assert(jj < m_pdata->getN());
 
             // access the position and type of particle j
@@ -406,7 +407,7 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                 for (unsigned int k = 0; k < size; k++)
                     {
                     // access the index of neighbor k
-                    unsigned int kk = h_nlist.data[nli(i,k)];
+                    unsigned int kk = h_nlist.data[h_head_list.data[i] + k*nlist_stride];
                     assert(kk < m_pdata->getN());
 
                     // access the position and type of neighbor k
@@ -464,7 +465,7 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                 for (unsigned int k = 0; k < size; k++)
                     {
                     // access the index of neighbor k
-                    unsigned int kk = h_nlist.data[nli(i, k)];
+                    unsigned int kk = h_nlist.data[h_head_list.data[i] + k*nlist_stride];
                     assert(kk < m_pdata->getN());
 
                     // access the position and type of neighbor k
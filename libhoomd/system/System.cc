@@ -82,7 +82,7 @@ using namespace std;
 System::System(boost::shared_ptr<SystemDefinition> sysdef, unsigned int initial_tstep)
         : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep),
         m_last_status_time(0), m_last_status_tstep(initial_tstep), m_quiet_run(false),
-        m_profile(false), m_stats_period(10)
+        m_profile(false), m_trace_capacity(0), m_stats_period(10)
     {
     // sanity check
     assert(m_sysdef);
@@ -524,6 +524,9 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
                 #endif
                 }
 
+            if (m_profiler)
+                m_profiler->traceStep(m_cur_tstep);
+
             // execute analyzers
             vector<analyzer_item>::iterator analyzer;
             for (analyzer =  m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
@@ -611,9 +614,16 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_exec_conf->msg->notice(1) << "Average TPS: " << m_last_TPS << endl;
 
     // write out the profile data
-    if (m_profiler)
+    if (m_profiler && m_profile)
         m_exec_conf->msg->notice(1) << *m_profiler;
 
+    if (m_profiler && !m_trace_fname.empty())
+        {
+        m_exec_conf->msg->notice(2) << "Writing trace of " << m_profiler->getNumTraceEvents() << " events to "
+                                    << m_trace_fname << endl;
+        m_profiler->writeTrace(m_trace_fname, m_trace_format);
+        }
+
     if (!m_quiet_run)
         printStats();
 
@@ -626,6 +636,31 @@ void System::enableProfiler(bool enable)
     m_profile = enable;
     }
 
+/*! \param fname File to write the trace of each run to, an empty string disables tracing
+    \param format Format of the file, "json" or "binary" (see Profiler)
+    \param capacity Maximum number of events kept per rank, older events are discarded
+
+    Tracing attaches a Profiler to all computes, updaters and analyzers even if profiling is disabled, but only prints
+    the profile when enableProfiler() is set. The file is overwritten at the end of every run.
+*/
+void System::enableTrace(const std::string& fname, const std::string& format, unsigned int capacity)
+    {
+    if (!fname.empty() && format != "json" && format != "binary")
+        {
+        m_exec_conf->msg->error() << "Unknown trace format " << format << endl;
+        throw runtime_error("Error enabling trace");
+        }
+    if (!fname.empty() && capacity == 0)
+        {
+        m_exec_conf->msg->error() << "The trace must hold at least one event" << endl;
+        throw runtime_error("Error enabling trace");
+        }
+
+    m_trace_fname = fname;
+    m_trace_format = format;
+    m_trace_capacity = capacity;
+    }
+
 /*! \param logger Logger to register computes and updaters with
     All computes and updaters registered with the system are also registerd with the logger.
 */
@@ -687,8 +722,12 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 void System::setupProfiling()
     {
-    if (m_profile)
-        m_profiler = boost::shared_ptr<Profiler>(new Profiler("Simulation"));
+    if (m_profile || !m_trace_fname.empty())
+        {
+        m_profiler = boost::shared_ptr<Profiler>(new Profiler("Simulation", m_exec_conf));
+        if (!m_trace_fname.empty())
+            m_profiler->enableTrace(m_trace_capacity);
+        }
     else
         m_profiler = boost::shared_ptr<Profiler>();
 
@@ -842,6 +881,7 @@ void export_System()
     .def("setStatsPeriod", &System::setStatsPeriod)
     .def("setAutotunerParams", &System::setAutotunerParams)
     .def("enableProfiler", &System::enableProfiler)
+    .def("enableTrace", &System::enableTrace)
     .def("enableQuietRun", &System::enableQuietRun)
     .def("run", &System::run)
 
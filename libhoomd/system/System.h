@@ -192,6 +192,9 @@ class System
         //! Configures profiling of runs
         void enableProfiler(bool enable);
 
+        //! Configures the per step trace of runs
+        void enableTrace(const std::string& fname, const std::string& format, unsigned int capacity);
+
         //! Toggle whether or not to print the status line and TPS for each run
         void enableQuietRun(bool enable)
             {
@@ -458,6 +461,9 @@ class System
 
         bool m_quiet_run;       //!< True to suppress the status line and TPS from being printed to stdout for each run
         bool m_profile;         //!< True if runs should be profiled
+        std::string m_trace_fname;      //!< File to write the trace of each run to (empty to disable tracing)
+        std::string m_trace_format;     //!< Format of the trace file
+        unsigned int m_trace_capacity;  //!< Number of events kept in the trace
         unsigned int m_stats_period; //!< Number of seconds between statistics output lines
 
         // --------- Steps in the simulation run implemented in helper functions
@@ -82,6 +82,12 @@ Integrator::Integrator(boost::shared_ptr<SystemDefinition> sysdef, Scalar deltaT
     {
     if (m_deltaT <= 0.0)
         m_exec_conf->msg->warning() << "integrate.*: A timestep of less than 0.0 was specified" << endl;
+
+    // block sizes for the CPU net force summation, from well inside the L1 cache to about its size
+    std::vector<unsigned int> block_sizes;
+    for (unsigned int block_size = 32; block_size <= 1024; block_size *= 2)
+        block_sizes.push_back(block_size);
+    m_net_force_tuner.reset(new Autotuner(block_sizes, 5, 100000, "net_force", m_exec_conf));
     }
 
 Integrator::~Integrator()
@@ -92,6 +98,8 @@ Integrator::~Integrator()
         m_request_flags_connection.disconnect();
     if (m_callback_connection.connected())
         m_callback_connection.disconnect();
+    if (m_local_callback_connection.connected())
+        m_local_callback_connection.disconnect();
     #endif
     }
 
@@ -339,6 +347,10 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
     \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
     \note The summation step is performed <b>on the CPU</b> and will result in a lot of data traffic back and forth
           if the forces and/or integrater are on the GPU. Call computeNetForcesGPU() to sum the forces on the GPU
+
+    The contributions of all force computes are summed in one pass over the particles (see sumNetForceRange()), the
+    first force compute overwrites the net arrays so they need not be cleared beforehand. Constraint forces are
+    added in a second pass after they have been computed from the unconstrained net force.
 */
 void Integrator::computeNetForce(unsigned int timestep)
     {
@@ -362,55 +374,60 @@ void Integrator::computeNetForce(unsigned int timestep)
         ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
         ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
 
-        // start by zeroing the net force and virial arrays
-        memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
-        memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
-        memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
-
         for (unsigned int i = 0; i < 6; ++i)
            external_virial[i] = Scalar(0.0);
 
-        // now, add up the net forces
         unsigned int nparticles = m_pdata->getN();
         unsigned int net_virial_pitch = net_virial.getPitch();
         assert(nparticles <= net_force.getNumElements());
         assert(6*nparticles <= net_virial.getNumElements());
         assert(nparticles <= net_torque.getNumElements());
 
+        // the summation below only writes the local particles, zero the remainder of the arrays
+        memset((void *)(h_net_force.data + nparticles), 0, sizeof(Scalar4)*(net_force.getNumElements()-nparticles));
+        memset((void *)(h_net_torque.data + nparticles), 0, sizeof(Scalar4)*(net_torque.getNumElements()-nparticles));
+        for (unsigned int k = 0; k < 6; k++)
+            memset((void *)(h_net_virial.data + k*net_virial_pitch + nparticles),
+                   0,
+                   sizeof(Scalar)*(net_virial_pitch-nparticles));
+
+        // acquire the arrays of all force computes for the duration of the summation
+        net_force_args args;
+        args.net_force = h_net_force.data;
+        args.net_torque = h_net_torque.data;
+        args.net_virial = h_net_virial.data;
+        args.net_virial_pitch = net_virial_pitch;
+        args.N = nparticles;
+        args.accumulate = false;
+        args.block_size = m_net_force_tuner->getParam();
+
+        std::vector< boost::shared_ptr< ArrayHandle<Scalar4> > > force_handles;
+        std::vector< boost::shared_ptr< ArrayHandle<Scalar> > > virial_handles;
         for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
             {
-            //phasing out ForceDataArrays
-            //ForceDataArrays force_arrays = (*force_compute)->acquire();
             GPUArray<Scalar4>& h_force_array = (*force_compute)->getForceArray();
             GPUArray<Scalar>& h_virial_array = (*force_compute)->getVirialArray();
             GPUArray<Scalar4>& h_torque_array = (*force_compute)->getTorqueArray();
 
-            ArrayHandle<Scalar4> h_force(h_force_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar> h_virial(h_virial_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar4> h_torque(h_torque_array,access_location::host,access_mode::read);
-
-            unsigned int virial_pitch = h_virial_array.getPitch();
-            for (unsigned int j = 0; j < nparticles; j++)
-                {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
-
-                for (unsigned int k = 0; k < 6; k++)
-                    {
-                    h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
-                    }
-                }
+            force_handles.push_back(boost::shared_ptr< ArrayHandle<Scalar4> >(
+                new ArrayHandle<Scalar4>(h_force_array, access_location::host, access_mode::read)));
+            args.force.push_back(force_handles.back()->data);
+            force_handles.push_back(boost::shared_ptr< ArrayHandle<Scalar4> >(
+                new ArrayHandle<Scalar4>(h_torque_array, access_location::host, access_mode::read)));
+            args.torque.push_back(force_handles.back()->data);
+            virial_handles.push_back(boost::shared_ptr< ArrayHandle<Scalar> >(
+                new ArrayHandle<Scalar>(h_virial_array, access_location::host, access_mode::read)));
+            args.virial.push_back(virial_handles.back()->data);
+            args.virial_pitch.push_back(h_virial_array.getPitch());
 
             for (unsigned int k = 0; k < 6; k++)
                 external_virial[k] += (*force_compute)->getExternalVirial(k);
             }
+
+        // only the main pass is timed, the constraint pass sums fewer arrays
+        m_net_force_tuner->begin();
+        m_exec_conf->getThreadPool().run(bind(&Integrator::sumNetForceRange, this, _1, boost::cref(args)));
+        m_net_force_tuner->end();
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -442,37 +459,43 @@ void Integrator::computeNetForce(unsigned int timestep)
         // access the net force and virial arrays
         const GPUArray< Scalar4 >& net_force = m_pdata->getNetForce();
         const GPUArray< Scalar >& net_virial = m_pdata->getNetVirial();
-        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
-        unsigned int net_virial_pitch = net_virial.getPitch();
+        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::readwrite);
 
-        // now, add up the net forces
         unsigned int nparticles = m_pdata->getN();
-        assert(nparticles == net_force.getNumElements());
+        assert(nparticles <= net_force.getNumElements());
         assert(6*nparticles <= net_virial.getNumElements());
+
+        // add all constraint forces to the net force in one pass
+        net_force_args args;
+        args.net_force = h_net_force.data;
+        args.net_torque = NULL;
+        args.net_virial = h_net_virial.data;
+        args.net_virial_pitch = net_virial.getPitch();
+        args.N = nparticles;
+        args.accumulate = true;
+        args.block_size = m_net_force_tuner->getParam();
+
+        std::vector< boost::shared_ptr< ArrayHandle<Scalar4> > > force_handles;
+        std::vector< boost::shared_ptr< ArrayHandle<Scalar> > > virial_handles;
         for (force_constraint = m_constraint_forces.begin(); force_constraint != m_constraint_forces.end(); ++force_constraint)
             {
-            //phasing out ForceDataArrays
-            //ForceDataArrays force_arrays = (*force_compute)->acquire();
             GPUArray<Scalar4>& h_force_array =(*force_constraint)->getForceArray();
             GPUArray<Scalar>& h_virial_array =(*force_constraint)->getVirialArray();
-            ArrayHandle<Scalar4> h_force(h_force_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar> h_virial(h_virial_array,access_location::host,access_mode::read);
-            unsigned int virial_pitch = h_virial_array.getPitch();
 
+            force_handles.push_back(boost::shared_ptr< ArrayHandle<Scalar4> >(
+                new ArrayHandle<Scalar4>(h_force_array, access_location::host, access_mode::read)));
+            args.force.push_back(force_handles.back()->data);
+            virial_handles.push_back(boost::shared_ptr< ArrayHandle<Scalar> >(
+                new ArrayHandle<Scalar>(h_virial_array, access_location::host, access_mode::read)));
+            args.virial.push_back(virial_handles.back()->data);
+            args.virial_pitch.push_back(h_virial_array.getPitch());
 
-            for (unsigned int j = 0; j < nparticles; j++)
-                {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-                for (unsigned int k = 0; k < 6; k++)
-                    h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
-                }
             for (unsigned int k = 0; k < 6; k++)
                 external_virial[k] += (*force_constraint)->getExternalVirial(k);
             }
+
+        m_exec_conf->getThreadPool().run(bind(&Integrator::sumNetForceRange, this, _1, boost::cref(args)));
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -485,6 +508,101 @@ void Integrator::computeNetForce(unsigned int timestep)
         }
     }
 
+/*! \param thread_idx Index of the executing thread
+    \param args Arrays to sum
+
+    Each thread owns a contiguous range of particles, so there are no write conflicts. The range is processed in
+    blocks (of the size chosen by the Autotuner) so that the block of the net arrays stays in the L1 cache while the
+    arrays of all computes are streamed through it. Every net array element is thus written to memory once per call,
+    independent of the number of force computes. If \a args.accumulate is false, the first force compute overwrites the net arrays (or zeros
+    are written if there are no computes at all).
+*/
+void Integrator::sumNetForceRange(unsigned int thread_idx, const net_force_args& args)
+    {
+    // particles per block: 32 bytes of force and torque and 48 bytes of virial each
+    const unsigned int block_size = args.block_size;
+
+    unsigned int first, last;
+    ThreadPool::getRange(args.N, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    unsigned int n_computes = (unsigned int)args.force.size();
+    bool has_torque = args.net_torque != NULL;
+    Scalar4 *net_force = args.net_force;
+    Scalar4 *net_torque = args.net_torque;
+    Scalar *net_virial = args.net_virial;
+    unsigned int net_pitch = args.net_virial_pitch;
+
+    for (unsigned int block_start = first; block_start < last; block_start += block_size)
+        {
+        unsigned int block_end = std::min(block_start + block_size, last);
+
+        unsigned int c_first = 0;
+        if (!args.accumulate)
+            {
+            // initialize the block with the first compute, or with zeros
+            if (n_computes == 0)
+                {
+                for (unsigned int j = block_start; j < block_end; j++)
+                    {
+                    net_force[j] = make_scalar4(0.0, 0.0, 0.0, 0.0);
+                    if (has_torque)
+                        net_torque[j] = make_scalar4(0.0, 0.0, 0.0, 0.0);
+                    }
+                for (unsigned int k = 0; k < 6; k++)
+                    for (unsigned int j = block_start; j < block_end; j++)
+                        net_virial[k*net_pitch+j] = Scalar(0.0);
+                }
+            else
+                {
+                const Scalar4 *force = args.force[0];
+                const Scalar *virial = args.virial[0];
+                unsigned int pitch = args.virial_pitch[0];
+                for (unsigned int j = block_start; j < block_end; j++)
+                    {
+                    net_force[j] = force[j];
+                    if (has_torque)
+                        net_torque[j] = args.torque[0][j];
+                    }
+                for (unsigned int k = 0; k < 6; k++)
+                    for (unsigned int j = block_start; j < block_end; j++)
+                        net_virial[k*net_pitch+j] = virial[k*pitch+j];
+                c_first = 1;
+                }
+            }
+
+        // add the remaining computes to the block
+        for (unsigned int c = c_first; c < n_computes; c++)
+            {
+            const Scalar4 *force = args.force[c];
+            const Scalar *virial = args.virial[c];
+            unsigned int pitch = args.virial_pitch[c];
+            for (unsigned int j = block_start; j < block_end; j++)
+                {
+                net_force[j].x += force[j].x;
+                net_force[j].y += force[j].y;
+                net_force[j].z += force[j].z;
+                net_force[j].w += force[j].w;
+                }
+
+            if (has_torque)
+                {
+                const Scalar4 *torque = args.torque[c];
+                for (unsigned int j = block_start; j < block_end; j++)
+                    {
+                    net_torque[j].x += torque[j].x;
+                    net_torque[j].y += torque[j].y;
+                    net_torque[j].z += torque[j].z;
+                    net_torque[j].w += torque[j].w;
+                    }
+                }
+
+            for (unsigned int k = 0; k < 6; k++)
+                for (unsigned int j = block_start; j < block_end; j++)
+                    net_virial[k*net_pitch+j] += virial[k*pitch+j];
+            }
+        }
+    }
+
 #ifdef ENABLE_CUDA
 /*! \param timestep Current time step of the simulation
     \post All added frce computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
@@ -868,6 +986,10 @@ void Integrator::setCommunicator(boost::shared_ptr<Communicator> comm)
 
     if (! m_callback_connection.connected() && m_comm)
         m_callback_connection = comm->addComputeCallback(bind(&Integrator::computeCallback, this, _1));
+
+    // on the CPU, the forces between local particles are computed while the ghost update is in flight
+    if (! m_local_callback_connection.connected() && m_comm && ! m_exec_conf->isCUDAEnabled())
+        m_local_callback_connection = comm->addLocalComputeCallback(bind(&Integrator::localComputeCallback, this, _1));
     }
 
 void Integrator::computeCallback(unsigned int timestep)
@@ -883,6 +1005,15 @@ void Integrator::computeCallback(unsigned int timestep)
     for (force_constraint = m_constraint_forces.begin(); force_constraint != m_constraint_forces.end(); ++force_constraint)
         (*force_constraint)->preCompute(timestep);
     }
+
+void Integrator::localComputeCallback(unsigned int timestep)
+    {
+    // pre-compute the local part of all active forces
+    std::vector< boost::shared_ptr<ForceCompute> >::iterator force_compute;
+
+    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        (*force_compute)->preComputeLocal(timestep);
+    }
 #endif
 
 void export_Integrator()
@@ -64,13 +64,32 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ForceCompute.h"
 #include "ForceConstraint.h"
 #include "ParticleGroup.h"
+#include "Autotuner.h"
 #include <string>
 #include <vector>
 
+#include <boost/scoped_ptr.hpp>
+
 #ifdef ENABLE_CUDA
 #include <cuda_runtime.h>
 #endif
 
+//! Arguments passed to Integrator::sumNetForceRange()
+struct net_force_args
+    {
+    Scalar4 *net_force;                         //!< Net force array to write
+    Scalar4 *net_torque;                        //!< Net torque array to write (NULL to leave it untouched)
+    Scalar *net_virial;                         //!< Net virial array to write
+    unsigned int net_virial_pitch;              //!< Pitch of the net virial array
+    unsigned int N;                             //!< Number of local particles
+    bool accumulate;                            //!< True to add to the net arrays, false to overwrite them
+    unsigned int block_size;                    //!< Number of particles summed per block
+    std::vector<const Scalar4 *> force;         //!< Force arrays of the individual computes
+    std::vector<const Scalar4 *> torque;        //!< Torque arrays of the individual computes
+    std::vector<const Scalar *> virial;         //!< Virial arrays of the individual computes
+    std::vector<unsigned int> virial_pitch;     //!< Pitches of the individual virial arrays
+    };
+
 //! Base class that defines an integrator
 /*! An Integrator steps the entire simulation forward one time step in time.
     Prior to calling update(timestep), the system is at time step \a timestep.
@@ -93,6 +112,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     via the constraint forces can be totaled up with a call to getNDOFRemoved for convenience in derived classes
     implementing correct counting in getNDOF().
 
+    On the CPU, the net force, torque and virial are summed in a single pass over the particles that reads the arrays
+    of all force computes at once, instead of one pass per force compute. The particles are split into contiguous
+    ranges among the threads of the ThreadPool and processed in small blocks, so that the net force of a block stays
+    in cache while the contributions of every force compute are added to it. The block size is chosen at run time
+    by an Autotuner.
+
     Integrators take "ownership" of the particle's accellerations. Any other updater
     that modifies the particles accelerations will produce undefined results. If
     accelerations are to be modified, they must be done through forces, and added to
@@ -157,6 +182,17 @@ class Integrator : public Updater
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep);
 
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            Updater::setAutotunerParams(enable, period);
+            m_net_force_tuner->setPeriod(period);
+            m_net_force_tuner->setEnabled(enable);
+            }
+
         #ifdef ENABLE_MPI
         //! Set the communicator to use
         /*! \param comm The Communicator
@@ -165,6 +201,9 @@ class Integrator : public Updater
 
         //! Callback for pre-computing the forces
         void computeCallback(unsigned int timestep);
+
+        //! Callback for pre-computing the forces between local particles
+        void localComputeCallback(unsigned int timestep);
         #endif
 
     protected:
@@ -173,12 +212,17 @@ class Integrator : public Updater
 
         std::vector< boost::shared_ptr<ForceConstraint> > m_constraint_forces;    //!< List of all the constraints
 
+        boost::scoped_ptr<Autotuner> m_net_force_tuner;             //!< Autotuner for the block size of the net force sum
+
         //! helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
 
         //! helper function to compute net force/virial
         void computeNetForce(unsigned int timestep);
 
+        //! Sums the force, torque and virial arrays of all computes for a range of particles
+        void sumNetForceRange(unsigned int thread_idx, const net_force_args& args);
+
 #ifdef ENABLE_CUDA
         //! helper function to compute net force/virial on the GPU
         void computeNetForceGPU(unsigned int timestep);
@@ -186,13 +230,14 @@ class Integrator : public Updater
 
 #ifdef ENABLE_MPI
         //! helper function to determine the ghost communciation flags
-        CommFlags determineFlags(unsigned int timestep);
+        virtual CommFlags determineFlags(unsigned int timestep);
 #endif
 
     private:
         #ifdef ENABLE_MPI
         boost::signals2::connection m_request_flags_connection;     //!< Connection to Communicator to request communication flags
         boost::signals2::connection m_callback_connection;          //!< Connection to Commmunicator for compute callback
+        boost::signals2::connection m_local_callback_connection;    //!< Connection to Commmunicator for local compute callback
         #endif
     };
 
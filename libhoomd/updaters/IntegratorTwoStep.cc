@@ -64,12 +64,16 @@ using namespace boost::python;
 #include "IntegratorTwoStep.h"
 
 #include <boost/bind.hpp>
+#include <algorithm>
 using namespace boost;
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
 #endif
 
+//! Marks a slow force whose intervals begin at the next run
+const unsigned int SLOW_START_PENDING = 0xffffffff;
+
 IntegratorTwoStep::IntegratorTwoStep(boost::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
     : Integrator(sysdef, deltaT), m_first_step(true), m_prepared(false), m_gave_warning(false)
     {
@@ -135,6 +139,9 @@ Scalar IntegratorTwoStep::getLogValue(const std::string& quantity, unsigned int
     \post All integration methods previously added with addIntegrationMethod() are applied in order to move the system
           state variables forward to \a timestep+1.
     \post Internally, all forces added via Integrator::addForceCompute are evaluated at \a timestep+1
+
+    The impulses of slow forces are applied before the first step if one of their intervals begins at \a timestep,
+    and after the second step if one ends at \a timestep+1.
 */
 void IntegratorTwoStep::update(unsigned int timestep)
     {
@@ -148,6 +155,10 @@ void IntegratorTwoStep::update(unsigned int timestep)
     // ensure that prepRun() has been called
     assert(m_prepared);
 
+    // apply the impulses of the slow forces whose intervals begin now
+    if (m_slow_forces.size() > 0)
+        kickSlowForces(timestep, true);
+
     if (m_prof)
         m_prof->push("Integrate");
 
@@ -203,6 +214,10 @@ void IntegratorTwoStep::update(unsigned int timestep)
 
     if (m_prof)
         m_prof->pop();
+
+    // apply the impulses of the slow forces whose intervals end at the next step
+    if (m_slow_forces.size() > 0)
+        kickSlowForces(timestep+1, false);
     }
 
 /*! \param deltaT new deltaT to set
@@ -216,6 +231,10 @@ void IntegratorTwoStep::setDeltaT(Scalar deltaT)
     std::vector< boost::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
     for (method = m_methods.begin(); method != m_methods.end(); ++method)
         (*method)->setDeltaT(deltaT);
+
+    // slow forces act over their whole interval
+    for (unsigned int i = 0; i < m_slow_forces.size(); i++)
+        m_slow_forces[i]->setDeltaT(Scalar(m_slow_multiples[i])*deltaT);
     }
 
 /*! \param new_method New integration method to add to the integrator
@@ -259,6 +278,172 @@ void IntegratorTwoStep::removeAllIntegrationMethods()
     m_gave_warning = false;
     }
 
+/*! \param fc ForceCompute to add
+    \param multiple Number of time steps between evaluations of \a fc
+
+    A force with a multiple of 1 is added as a normal force compute. Non-conservative forces are given the length of
+    the interval as their time step, since their impulse acts over the whole interval.
+*/
+void IntegratorTwoStep::addSlowForceCompute(boost::shared_ptr<ForceCompute> fc, unsigned int multiple)
+    {
+    assert(fc);
+
+    if (multiple == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.mode_standard: The multiple of a force must be at least 1" << endl;
+        throw std::runtime_error("Error adding force compute");
+        }
+
+    if (multiple == 1)
+        {
+        addForceCompute(fc);
+        return;
+        }
+
+    // a force that was a slow force with the same multiple before continues its intervals
+    unsigned int start = SLOW_START_PENDING;
+    for (unsigned int i = 0; i < m_prev_slow_forces.size(); i++)
+        if (m_prev_slow_forces[i].lock() == fc && m_prev_slow_multiples[i] == multiple)
+            start = m_prev_slow_start[i];
+
+    m_slow_forces.push_back(fc);
+    m_slow_multiples.push_back(multiple);
+    m_slow_start.push_back(start);
+    fc->setDeltaT(Scalar(multiple)*m_deltaT);
+    }
+
+/*! \post All fast and slow force computes and all constraint forces are removed
+*/
+void IntegratorTwoStep::removeForceComputes()
+    {
+    Integrator::removeForceComputes();
+
+    // remember the intervals of the slow forces in case they are added again
+    m_prev_slow_forces.assign(m_slow_forces.begin(), m_slow_forces.end());
+    m_prev_slow_multiples = m_slow_multiples;
+    m_prev_slow_start = m_slow_start;
+
+    m_slow_forces.clear();
+    m_slow_multiples.clear();
+    m_slow_start.clear();
+    }
+
+/*! \param i Index of the slow force
+    \param timestep Time step
+    \param start True to query the interval beginning at \a timestep, false for the one ending at \a timestep
+    \returns The number of time steps in the interval, or 0 if no interval of slow force \a i starts or ends at
+             \a timestep
+
+    The intervals are aligned to multiples of the slow force's multiple. If the slow force starts in the middle of an
+    interval, that interval is shortened to begin at its start step.
+*/
+unsigned int IntegratorTwoStep::getSlowInterval(unsigned int i, unsigned int timestep, bool start)
+    {
+    unsigned int multiple = m_slow_multiples[i];
+    unsigned int slow_start = m_slow_start[i];
+    unsigned int offset = timestep % multiple;
+
+    if (timestep < slow_start)
+        return 0;
+
+    if (start)
+        {
+        if (offset == 0)
+            return multiple;
+        if (timestep == slow_start)
+            return multiple - offset;
+        return 0;
+        }
+
+    if (offset != 0 || timestep == slow_start)
+        return 0;
+    return std::min(multiple, timestep - slow_start);
+    }
+
+/*! \param timestep Time step at which the slow forces are evaluated
+    \param start True to apply the impulses of the intervals beginning at \a timestep, false for those ending there
+
+    Every slow force changes the velocities of the particles integrated by the methods by half of its impulse over
+    the interval. At the end of an interval, the slow force is also added to the net force, so that it is included
+    in quantities logged at this step. A slow force is evaluated once at a boundary between two intervals, the
+    second call to compute() for the same time step returns immediately.
+*/
+void IntegratorTwoStep::kickSlowForces(unsigned int timestep, bool start)
+    {
+    for (unsigned int i = 0; i < m_slow_forces.size(); i++)
+        {
+        unsigned int interval = getSlowInterval(i, timestep, start);
+        if (interval == 0)
+            continue;
+
+        m_slow_forces[i]->compute(timestep);
+
+        if (m_prof)
+            {
+            m_prof->push("Integrate");
+            m_prof->push("Slow kick");
+            }
+
+            {
+            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_force(m_slow_forces[i]->getForceArray(), access_location::host, access_mode::read);
+
+            Scalar half_dt = Scalar(0.5)*Scalar(interval)*m_deltaT;
+
+            std::vector< boost::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
+            for (method = m_methods.begin(); method != m_methods.end(); ++method)
+                {
+                boost::shared_ptr<ParticleGroup> group = (*method)->getGroup();
+                unsigned int group_size = group->getNumMembers();
+                for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+                    {
+                    unsigned int j = group->getMemberIndex(group_idx);
+                    Scalar minv = Scalar(1.0)/h_vel.data[j].w;
+                    h_vel.data[j].x += half_dt*h_force.data[j].x*minv;
+                    h_vel.data[j].y += half_dt*h_force.data[j].y*minv;
+                    h_vel.data[j].z += half_dt*h_force.data[j].z*minv;
+                    }
+                }
+            }
+
+        if (!start)
+            addSlowNetForce(i);
+
+        if (m_prof)
+            {
+            m_prof->pop();
+            m_prof->pop();
+            }
+        }
+    }
+
+/*! \param i Index of the slow force
+*/
+void IntegratorTwoStep::addSlowNetForce(unsigned int i)
+    {
+    const GPUArray<Scalar>& net_virial = m_pdata->getNetVirial();
+    const GPUArray<Scalar>& virial = m_slow_forces[i]->getVirialArray();
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_force(m_slow_forces[i]->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(virial, access_location::host, access_mode::read);
+
+    unsigned int net_virial_pitch = net_virial.getPitch();
+    unsigned int virial_pitch = virial.getPitch();
+    for (unsigned int j = 0; j < m_pdata->getN(); j++)
+        {
+        h_net_force.data[j].x += h_force.data[j].x;
+        h_net_force.data[j].y += h_force.data[j].y;
+        h_net_force.data[j].z += h_force.data[j].z;
+        h_net_force.data[j].w += h_force.data[j].w;
+        for (unsigned int k = 0; k < 6; k++)
+            h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+        }
+
+    for (unsigned int k = 0; k < 6; k++)
+        m_pdata->setExternalVirial(k, m_pdata->getExternalVirial(k) + m_slow_forces[i]->getExternalVirial(k));
+    }
+
 /*! \returns true If all added integration methods have valid restart information
 */
 bool IntegratorTwoStep::isValidRestart()
@@ -301,6 +486,18 @@ unsigned int IntegratorTwoStep::getNDOF(boost::shared_ptr<ParticleGroup> group)
 */
 void IntegratorTwoStep::prepRun(unsigned int timestep)
     {
+    // the impulses of slow forces are only applied to the particles integrated by the methods
+    if (m_slow_forces.size() > 0 && (m_sysdef->getRigidData()->getNumBodies() > 0 || m_constraint_forces.size() > 0))
+        {
+        m_exec_conf->msg->error() << "integrate.mode_standard: Forces with a multiple cannot be used with rigid bodies or constraint forces" << endl;
+        throw std::runtime_error("Error preparing integrator");
+        }
+
+    // the intervals of slow forces that were added or changed since the last run begin now
+    for (unsigned int i = 0; i < m_slow_forces.size(); i++)
+        if (m_slow_start[i] == SLOW_START_PENDING)
+            m_slow_start[i] = timestep;
+
     // if we haven't been called before, then the net force and accelerations have not been set and we need to calculate them
     if (m_first_step)
         {
@@ -325,6 +522,13 @@ void IntegratorTwoStep::prepRun(unsigned int timestep)
         if (!isValidRestart())
             computeAccelerations(timestep);
 
+        // the accelerations only include the fast forces, but the logged net force includes all forces
+        for (unsigned int i = 0; i < m_slow_forces.size(); i++)
+            {
+            m_slow_forces[i]->compute(timestep);
+            addSlowNetForce(i);
+            }
+
         // for the moment, isotropic_virial is invalid on the first step if there are any rigid bodies
         // a future update to the restart data format (that saves net_force and net_virial) will make it
         // valid when there is a valid restart
@@ -351,6 +555,21 @@ PDataFlags IntegratorTwoStep::getRequestedPDataFlags()
     }
 
 #ifdef ENABLE_MPI
+/*! \param timestep Time step for which to determine the flags
+
+    The slow forces only request ghost data at the time steps where they are evaluated.
+*/
+CommFlags IntegratorTwoStep::determineFlags(unsigned int timestep)
+    {
+    CommFlags flags = Integrator::determineFlags(timestep);
+
+    for (unsigned int i = 0; i < m_slow_forces.size(); i++)
+        if (getSlowInterval(i, timestep, true) > 0 || getSlowInterval(i, timestep, false) > 0)
+            flags |= m_slow_forces[i]->getRequestedCommFlags(timestep);
+
+    return flags;
+    }
+
 //! Set the communicator to use
 void IntegratorTwoStep::setCommunicator(boost::shared_ptr<Communicator> comm)
     {
@@ -381,5 +600,6 @@ void export_IntegratorTwoStep()
         ("IntegratorTwoStep", init< boost::shared_ptr<SystemDefinition>, Scalar >())
         .def("addIntegrationMethod", &IntegratorTwoStep::addIntegrationMethod)
         .def("removeAllIntegrationMethods", &IntegratorTwoStep::removeAllIntegrationMethods)
+        .def("addSlowForceCompute", &IntegratorTwoStep::addSlowForceCompute)
         ;
     }
@@ -52,6 +52,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Integrator.h"
 #include "IntegrationMethodTwoStep.h"
 
+#include <boost/weak_ptr.hpp>
+
 #ifndef __INTEGRATOR_TWO_STEP_H__
 #define __INTEGRATOR_TWO_STEP_H__
 
@@ -76,6 +78,22 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     To ensure that the user does not make a mistake and specify more than one method operating on a single particle,
     the particle groups are checked for intersections whenever a new method is added in addIntegrationMethod()
 
+    <b>Multiple time steps</b>
+
+    Slowly varying forces can be added with addSlowForceCompute() together with a \a multiple. They are integrated
+    with the impulse form of r-RESPA: the time steps are grouped into intervals of \a multiple steps, aligned to
+    multiples of \a multiple in the absolute time step, and the slow force kicks the velocities of all integrated
+    particles by half the interval length times deltaT at the beginning and at the end of each interval. The
+    integration methods only see the net force of the fast forces added with addForceCompute() and integrate
+    them with the inner time step deltaT as usual. Every slow force has its own multiple, so any number of levels
+    can be nested. The intervals of a slow force begin at the first run after it was added or its multiple was
+    changed. If that run begins in the middle of an interval, the first interval is shortened. A slow force that is
+    removed and added again with the same multiple, as hoomd_script does before every run, continues its intervals.
+
+    Slow forces are evaluated only at the ends of their intervals. At those steps they are also added to the net
+    force and virial, so logged energies and pressures include all forces only on steps that are multiples of all
+    slow force multiples. Slow forces cannot be combined with rigid bodies or constraint forces.
+
     \ingroup updaters
 */
 class IntegratorTwoStep : public Integrator
@@ -108,6 +126,12 @@ class IntegratorTwoStep : public Integrator
         //! Remove all integration methods
         virtual void removeAllIntegrationMethods();
 
+        //! Add a ForceCompute that is evaluated only every \a multiple time steps
+        virtual void addSlowForceCompute(boost::shared_ptr<ForceCompute> fc, unsigned int multiple);
+
+        //! Removes all ForceComputes from the list
+        virtual void removeForceComputes();
+
         //! Get the number of degrees of freedom granted to a given group
         virtual unsigned int getNDOF(boost::shared_ptr<ParticleGroup> group);
 
@@ -136,6 +160,28 @@ class IntegratorTwoStep : public Integrator
         bool m_prepared;        //!< True if preprun has been called
         bool m_gave_warning;    //!< True if a warning has been given about no methods added
 
+        std::vector< boost::shared_ptr<ForceCompute> > m_slow_forces;  //!< Force computes evaluated in outer steps
+        std::vector<unsigned int> m_slow_multiples;    //!< Number of time steps between evaluations of each slow force
+        std::vector<unsigned int> m_slow_start;        //!< Time step at which the first interval of each slow force begins
+
+        std::vector< boost::weak_ptr<ForceCompute> > m_prev_slow_forces;   //!< Slow forces before the last removeForceComputes()
+        std::vector<unsigned int> m_prev_slow_multiples;   //!< Multiples of the previous slow forces
+        std::vector<unsigned int> m_prev_slow_start;       //!< Start steps of the previous slow forces
+
+        //! Get the length of the interval of a slow force that starts or ends at a time step
+        unsigned int getSlowInterval(unsigned int i, unsigned int timestep, bool start);
+
+        //! Apply the impulses of the slow forces whose intervals start or end at a time step
+        void kickSlowForces(unsigned int timestep, bool start);
+
+        //! Add the current forces and virials of a slow force to the net force and virial
+        void addSlowNetForce(unsigned int i);
+
+#ifdef ENABLE_MPI
+        //! Determine the ghost communication flags, including those of the slow forces evaluated at \a timestep
+        virtual CommFlags determineFlags(unsigned int timestep);
+#endif
+
     };
 
 //! Exports the IntegratorTwoStep class to python
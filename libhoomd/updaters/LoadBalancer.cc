@@ -0,0 +1,240 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: jglaser
+
+/*! \file LoadBalancer.cc
+    \brief Defines the LoadBalancer class
+*/
+
+#ifdef ENABLE_MPI
+#include "LoadBalancer.h"
+#include "Communicator.h"
+
+#include <boost/python.hpp>
+using namespace boost::python;
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/*! \param sysdef System to balance
+    \param decomposition Domain decomposition of the system
+*/
+LoadBalancer::LoadBalancer(boost::shared_ptr<SystemDefinition> sysdef,
+                           boost::shared_ptr<DomainDecomposition> decomposition)
+        : Updater(sysdef), m_decomposition(decomposition), m_tolerance(Scalar(1.05)), m_max_scale(Scalar(0.05)),
+          m_max_imbalance(Scalar(1.0)), m_n_shifts(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing LoadBalancer" << endl;
+    assert(m_decomposition);
+
+    m_enable[0] = m_enable[1] = m_enable[2] = true;
+    }
+
+LoadBalancer::~LoadBalancer()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying LoadBalancer" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The particle counts of all slabs along the three directions are summed up in a single reduction. Every rank
+    computes the same new split planes from them.
+*/
+void LoadBalancer::update(unsigned int timestep)
+    {
+    if (!m_comm)
+        {
+        m_exec_conf->msg->error() << "update.balance: No communicator set" << endl;
+        throw runtime_error("Error balancing domains");
+        }
+
+    if (m_prof) m_prof->push("Balance");
+
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    uint3 grid_pos = m_decomposition->getGridPos();
+    unsigned int n_domains[3] = {di.getW(), di.getH(), di.getD()};
+    unsigned int pos[3] = {grid_pos.x, grid_pos.y, grid_pos.z};
+
+    // count the particles in every slab along x, y and z
+    std::vector<unsigned int> counts(n_domains[0] + n_domains[1] + n_domains[2], 0);
+    unsigned int offset = 0;
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        counts[offset + pos[dir]] = m_pdata->getN();
+        offset += n_domains[dir];
+        }
+    MPI_Allreduce(MPI_IN_PLACE, &counts.front(), counts.size(), MPI_UNSIGNED, MPI_SUM,
+                  m_exec_conf->getMPICommunicator());
+
+    // a domain must be wider than twice the ghost layer
+    Scalar3 L = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    Scalar L_dir[3] = {L.x, L.y, L.z};
+    Scalar r_ghost = m_comm->getGhostLayerWidth();
+
+    bool changed = false;
+    offset = 0;
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        std::vector<unsigned int> slab_counts(counts.begin() + offset, counts.begin() + offset + n_domains[dir]);
+        offset += n_domains[dir];
+
+        if (n_domains[dir] == 1 || !m_enable[dir])
+            continue;
+
+        std::vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(dir);
+        Scalar min_width = Scalar(2.0)*r_ghost/L_dir[dir]*Scalar(1.001);
+        if (adjustFractions(dir, slab_counts, min_width, cum_frac))
+            {
+            m_decomposition->setCumulativeFractions(dir, cum_frac);
+            changed = true;
+            }
+        }
+
+    if (changed)
+        {
+        // recompute the local box and move the particles to their new domains
+        m_pdata->setGlobalBox(m_pdata->getGlobalBox());
+        m_comm->forceMigrate();
+        m_n_shifts++;
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param dir Direction of the split planes
+    \param counts Number of particles in every slab along \a dir
+    \param min_width Minimum fractional width of a domain
+    \param cum_frac Current split planes on input, new split planes on output
+    \returns true if the split planes were changed
+*/
+bool LoadBalancer::adjustFractions(unsigned int dir, const std::vector<unsigned int>& counts, Scalar min_width,
+    std::vector<Scalar>& cum_frac)
+    {
+    unsigned int n = counts.size();
+    unsigned int n_total = 0;
+    unsigned int n_max = 0;
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        n_total += counts[i];
+        n_max = std::max(n_max, counts[i]);
+        }
+
+    if (n_total == 0)
+        return false;
+
+    Scalar target = Scalar(n_total)/Scalar(n);
+    Scalar imbalance = Scalar(n_max)/target;
+    m_max_imbalance = std::max(m_max_imbalance, imbalance);
+
+    if (imbalance <= m_tolerance)
+        return false;
+
+    // scale every slab towards the average particle count
+    std::vector<Scalar> width(n);
+    Scalar sum = Scalar(0.0);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        Scalar scale = counts[i] ? target/Scalar(counts[i]) : Scalar(1.0) + m_max_scale;
+        scale = std::max(Scalar(1.0) - m_max_scale, std::min(Scalar(1.0) + m_max_scale, scale));
+        width[i] = (cum_frac[i+1] - cum_frac[i])*scale;
+        sum += width[i];
+        }
+
+    // particles may only move into an adjacent domain, so limit the shift of every plane to half the width
+    // of its neighbors
+    std::vector<Scalar> new_frac(cum_frac);
+    Scalar frac = Scalar(0.0);
+    for (unsigned int i = 1; i < n; ++i)
+        {
+        frac += width[i-1]/sum;
+        Scalar lo = cum_frac[i] - Scalar(0.5)*(cum_frac[i] - cum_frac[i-1]);
+        Scalar hi = cum_frac[i] + Scalar(0.5)*(cum_frac[i+1] - cum_frac[i]);
+        new_frac[i] = std::max(lo, std::min(hi, frac));
+        }
+
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        if (new_frac[i+1] - new_frac[i] < min_width)
+            {
+            m_exec_conf->msg->notice(6) << "update.balance: Not moving the split planes along " << (char)('x'+dir)
+                                        << ", a domain would become narrower than the ghost layer" << endl;
+            return false;
+            }
+        }
+
+    cum_frac = new_frac;
+    return true;
+    }
+
+void LoadBalancer::printStats()
+    {
+    m_exec_conf->msg->notice(1) << "-- Load balancer stats:" << endl;
+    m_exec_conf->msg->notice(1) << "Split planes moved " << m_n_shifts << " times" << endl;
+    m_exec_conf->msg->notice(1) << "Maximum imbalance: " << m_max_imbalance << endl;
+    }
+
+void LoadBalancer::resetStats()
+    {
+    m_max_imbalance = Scalar(1.0);
+    m_n_shifts = 0;
+    }
+
+void export_LoadBalancer()
+    {
+    class_<LoadBalancer, boost::shared_ptr<LoadBalancer>, bases<Updater>, boost::noncopyable>
+    ("LoadBalancer", init< boost::shared_ptr<SystemDefinition>, boost::shared_ptr<DomainDecomposition> >())
+    .def("setTolerance", &LoadBalancer::setTolerance)
+    .def("setMaxScale", &LoadBalancer::setMaxScale)
+    .def("enableDimension", &LoadBalancer::enableDimension)
+    ;
+    }
+#endif // ENABLE_MPI
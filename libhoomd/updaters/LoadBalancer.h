@@ -0,0 +1,140 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: jglaser
+
+/*! \file LoadBalancer.h
+    \brief Declares an updater that balances the number of particles between the domains
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifdef ENABLE_MPI
+
+#include "Updater.h"
+#include "DomainDecomposition.h"
+
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+#ifndef __LOADBALANCER_H__
+#define __LOADBALANCER_H__
+
+//! Adjusts the domain boundaries to balance the number of particles per rank
+/*! The DomainDecomposition divides the global box with split planes along every direction. Every time update()
+    is called, the number of particles in every slab of domains is reduced over all ranks. Along every direction
+    where the most loaded slab exceeds the average by more than the tolerance, the width of every slab is scaled
+    by the ratio of the average and its particle count. The scale factor is limited to 1 +/- the maximum scale,
+    so that the boundaries relax over several calls.
+
+    To keep the one-hop particle migration of the Communicator valid, a split plane moves at most half the width
+    of its adjacent domains. An adjustment is rejected if a domain would become narrower than twice the ghost
+    layer width. After the split planes have been changed, the local box is recomputed and particle migration
+    is forced on the next communication step.
+
+    \ingroup updaters
+*/
+class LoadBalancer : public Updater
+    {
+    public:
+        //! Constructor
+        LoadBalancer(boost::shared_ptr<SystemDefinition> sysdef,
+                     boost::shared_ptr<DomainDecomposition> decomposition);
+        virtual ~LoadBalancer();
+
+        //! Balance the domains
+        virtual void update(unsigned int timestep);
+
+        //! Set the maximum tolerated ratio of the largest slab particle count to the average
+        void setTolerance(Scalar tolerance)
+            {
+            m_tolerance = tolerance;
+            }
+
+        //! Set the maximum relative change of a domain width per update
+        void setMaxScale(Scalar max_scale)
+            {
+            m_max_scale = max_scale;
+            }
+
+        //! Enable or disable balancing along a direction
+        void enableDimension(unsigned int dir, bool enable)
+            {
+            assert(dir < 3);
+            m_enable[dir] = enable;
+            }
+
+        //! Print statistics on the load balancing
+        virtual void printStats();
+
+        //! Reset the statistics counters
+        virtual void resetStats();
+
+    private:
+        boost::shared_ptr<DomainDecomposition> m_decomposition; //!< The domain decomposition to balance
+
+        Scalar m_tolerance;             //!< Maximum tolerated imbalance
+        Scalar m_max_scale;             //!< Maximum relative change of a domain width per update
+        bool m_enable[3];               //!< Whether balancing is enabled along each direction
+
+        Scalar m_max_imbalance;         //!< Largest imbalance measured since the last reset
+        unsigned int m_n_shifts;        //!< Number of times the split planes were moved since the last reset
+
+        //! Compute new split planes along a direction
+        bool adjustFractions(unsigned int dir, const std::vector<unsigned int>& counts, Scalar min_width,
+                             std::vector<Scalar>& cum_frac);
+    };
+
+//! Export the LoadBalancer to python
+void export_LoadBalancer();
+
+#endif // __LOADBALANCER_H__
+#endif // ENABLE_MPI
@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include "TwoStepNVE.h"
@@ -129,22 +130,53 @@ void TwoStepNVE::integrateStepOne(unsigned int timestep)
     if (m_prof)
         m_prof->push("NVE step 1");
 
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+    cpu_args args;
+    args.index = h_index.data;
+    args.group_size = group_size;
+    args.pos = h_pos.data;
+    args.vel = h_vel.data;
+    args.accel = h_accel.data;
+    args.image = h_image.data;
+    args.net_force = NULL;
+    args.box = m_pdata->getBox();
+
+    m_exec_conf->getThreadPool().run(bind(&TwoStepNVE::integrateStepOneThread, this, _1, boost::cref(args)));
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Particle data arrays and group members
+*/
+void TwoStepNVE::integrateStepOneThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.group_size, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    Scalar4 *pos = args.pos;
+    Scalar4 *vel = args.vel;
+    Scalar3 *accel = args.accel;
 
     // perform the first half step of velocity verlet
     // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
     // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    for (unsigned int group_idx = first; group_idx < last; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = args.index[group_idx];
         if (m_zero_force)
-            h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
+            accel[j].x = accel[j].y = accel[j].z = 0.0;
 
-        Scalar dx = h_vel.data[j].x*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT*m_deltaT;
-        Scalar dy = h_vel.data[j].y*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT*m_deltaT;
-        Scalar dz = h_vel.data[j].z*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT*m_deltaT;
+        Scalar dx = vel[j].x*m_deltaT + Scalar(1.0/2.0)*accel[j].x*m_deltaT*m_deltaT;
+        Scalar dy = vel[j].y*m_deltaT + Scalar(1.0/2.0)*accel[j].y*m_deltaT*m_deltaT;
+        Scalar dz = vel[j].z*m_deltaT + Scalar(1.0/2.0)*accel[j].z*m_deltaT*m_deltaT;
 
         // limit the movement of the particles
         if (m_limit)
@@ -158,29 +190,17 @@ void TwoStepNVE::integrateStepOne(unsigned int timestep)
                 }
             }
 
-        h_pos.data[j].x += dx;
-        h_pos.data[j].y += dy;
-        h_pos.data[j].z += dz;
-
-        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
-        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
-        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
-        }
+        pos[j].x += dx;
+        pos[j].y += dy;
+        pos[j].z += dz;
 
-    // particles may have been moved slightly outside the box by the above steps, wrap them back into place
-    const BoxDim& box = m_pdata->getBox();
+        vel[j].x += Scalar(1.0/2.0)*accel[j].x*m_deltaT;
+        vel[j].y += Scalar(1.0/2.0)*accel[j].y*m_deltaT;
+        vel[j].z += Scalar(1.0/2.0)*accel[j].z*m_deltaT;
 
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
-
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        box.wrap(h_pos.data[j], h_image.data[j]);
+        // particles may have been moved slightly outside the box by the above steps, wrap them back into place
+        args.box.wrap(pos[j], args.image[j]);
         }
-
-    // done profiling
-    if (m_prof)
-        m_prof->pop();
     }
 
 /*! \param timestep Current time step
@@ -198,50 +218,75 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
     if (m_prof)
         m_prof->push("NVE step 2");
 
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
+    cpu_args args;
+    args.index = h_index.data;
+    args.group_size = group_size;
+    args.pos = NULL;
+    args.vel = h_vel.data;
+    args.accel = h_accel.data;
+    args.image = NULL;
+    args.net_force = h_net_force.data;
+    args.box = m_pdata->getBox();
+
+    m_exec_conf->getThreadPool().run(bind(&TwoStepNVE::integrateStepTwoThread, this, _1, boost::cref(args)));
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Particle data arrays and group members
+*/
+void TwoStepNVE::integrateStepTwoThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.group_size, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    Scalar4 *vel = args.vel;
+    Scalar3 *accel = args.accel;
+
     // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    for (unsigned int group_idx = first; group_idx < last; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = args.index[group_idx];
 
         if (m_zero_force)
             {
-            h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
+            accel[j].x = accel[j].y = accel[j].z = 0.0;
             }
         else
             {
             // first, calculate acceleration from the net force
-            Scalar minv = Scalar(1.0) / h_vel.data[j].w;
-            h_accel.data[j].x = h_net_force.data[j].x*minv;
-            h_accel.data[j].y = h_net_force.data[j].y*minv;
-            h_accel.data[j].z = h_net_force.data[j].z*minv;
+            Scalar minv = Scalar(1.0) / vel[j].w;
+            accel[j].x = args.net_force[j].x*minv;
+            accel[j].y = args.net_force[j].y*minv;
+            accel[j].z = args.net_force[j].z*minv;
             }
 
         // then, update the velocity
-        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
-        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
-        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+        vel[j].x += Scalar(1.0/2.0)*accel[j].x*m_deltaT;
+        vel[j].y += Scalar(1.0/2.0)*accel[j].y*m_deltaT;
+        vel[j].z += Scalar(1.0/2.0)*accel[j].z*m_deltaT;
 
         // limit the movement of the particles
         if (m_limit)
             {
-            Scalar vel = sqrt(h_vel.data[j].x*h_vel.data[j].x+h_vel.data[j].y*h_vel.data[j].y+h_vel.data[j].z*h_vel.data[j].z);
-            if ( (vel*m_deltaT) > m_limit_val)
+            Scalar v = sqrt(vel[j].x*vel[j].x+vel[j].y*vel[j].y+vel[j].z*vel[j].z);
+            if ( (v*m_deltaT) > m_limit_val)
                 {
-                h_vel.data[j].x = h_vel.data[j].x / vel * m_limit_val / m_deltaT;
-                h_vel.data[j].y = h_vel.data[j].y / vel * m_limit_val / m_deltaT;
-                h_vel.data[j].z = h_vel.data[j].z / vel * m_limit_val / m_deltaT;
+                vel[j].x = vel[j].x / v * m_limit_val / m_deltaT;
+                vel[j].y = vel[j].y / v * m_limit_val / m_deltaT;
+                vel[j].z = vel[j].z / v * m_limit_val / m_deltaT;
                 }
             }
         }
-
-    // done profiling
-    if (m_prof)
-        m_prof->pop();
     }
 
 void export_TwoStepNVE()
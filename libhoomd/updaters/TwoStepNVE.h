@@ -65,6 +65,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //! Integrates part of the system forward in two steps in the NVE ensemble
 /*! Implements velocity-verlet NVE integration through the IntegrationMethodTwoStep interface
 
+    Both steps divide the members of the group evenly among the threads of the ExecutionConfiguration's ThreadPool.
+    Every particle is updated independently, so the result does not depend on the number of threads.
+
     \ingroup updaters
 */
 class TwoStepNVE : public IntegrationMethodTwoStep
@@ -101,6 +104,25 @@ class TwoStepNVE : public IntegrationMethodTwoStep
         bool m_limit;       //!< True if we should limit the distance a particle moves in one step
         Scalar m_limit_val; //!< The maximum distance a particle is to move in one step
         bool m_zero_force;  //!< True if the integration step should ignore computed forces
+
+        //! Arguments passed to the threads of the integration steps
+        struct cpu_args
+            {
+            const unsigned int *index;      //!< Particle indices of the group members
+            unsigned int group_size;        //!< Number of group members
+            Scalar4 *pos;                   //!< Particle positions
+            Scalar4 *vel;                   //!< Particle velocities and masses
+            Scalar3 *accel;                 //!< Particle accelerations
+            int3 *image;                    //!< Particle images
+            const Scalar4 *net_force;       //!< Net force on the particles
+            BoxDim box;                     //!< Local simulation box
+            };
+
+        //! Performs the first step on the range of group members of one thread
+        void integrateStepOneThread(unsigned int thread_idx, const cpu_args& args);
+
+        //! Performs the second step on the range of group members of one thread
+        void integrateStepTwoThread(unsigned int thread_idx, const cpu_args& args);
     };
 
 //! Exports the TwoStepNVE class to python
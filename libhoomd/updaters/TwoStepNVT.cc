@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include "TwoStepNVT.h"
@@ -163,43 +164,62 @@ void TwoStepNVT::integrateStepOne(unsigned int timestep)
     IntegratorVariables v = getIntegratorVariables();
     Scalar& xi = v.variable[0];
 
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
 
-    // precompute loop invariant quantities
-    Scalar denominv = Scalar(1.0) / (Scalar(1.0) + m_deltaT/Scalar(2.0) * xi);
+    cpu_args args;
+    args.index = h_index.data;
+    args.group_size = group_size;
+    args.pos = h_pos.data;
+    args.vel = h_vel.data;
+    args.accel = h_accel.data;
+    args.image = h_image.data;
+    args.net_force = NULL;
+    args.box = m_pdata->getBox();
+    args.xi = xi;
+
+    m_exec_conf->getThreadPool().run(bind(&TwoStepNVT::integrateStepOneThread, this, _1, boost::cref(args)));
+    }
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
 
-        h_vel.data[j].x = (h_vel.data[j].x + Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT) * denominv;
-        h_pos.data[j].x += m_deltaT * h_vel.data[j].x;
+/*! \param thread_idx Index of the executing thread
+    \param args Particle data arrays, group members and thermostat state
+*/
+void TwoStepNVT::integrateStepOneThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.group_size, thread_idx, m_exec_conf->getNumThreads(), first, last);
 
-        h_vel.data[j].y = (h_vel.data[j].y + Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT) * denominv;
-        h_pos.data[j].y += m_deltaT * h_vel.data[j].y;
+    Scalar4 *pos = args.pos;
+    Scalar4 *vel = args.vel;
+    const Scalar3 *accel = args.accel;
 
-        h_vel.data[j].z = (h_vel.data[j].z + Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT) * denominv;
-        h_pos.data[j].z += m_deltaT * h_vel.data[j].z;
-        }
+    // precompute loop invariant quantities
+    Scalar denominv = Scalar(1.0) / (Scalar(1.0) + m_deltaT/Scalar(2.0) * args.xi);
 
-    // particles may have been moved slightly outside the box by the above steps, wrap them back into place
-    const BoxDim& box = m_pdata->getBox();
+    for (unsigned int group_idx = first; group_idx < last; group_idx++)
+        {
+        unsigned int j = args.index[group_idx];
 
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        vel[j].x = (vel[j].x + Scalar(1.0/2.0)*accel[j].x*m_deltaT) * denominv;
+        pos[j].x += m_deltaT * vel[j].x;
 
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
-        {
-        unsigned int j = m_group->getMemberIndex(group_idx);
-        // wrap the particles around the box
-        box.wrap(h_pos.data[j], h_image.data[j]);
-        }
-    }
+        vel[j].y = (vel[j].y + Scalar(1.0/2.0)*accel[j].y*m_deltaT) * denominv;
+        pos[j].y += m_deltaT * vel[j].y;
 
-    // done profiling
-    if (m_prof)
-        m_prof->pop();
+        vel[j].z = (vel[j].z + Scalar(1.0/2.0)*accel[j].z*m_deltaT) * denominv;
+        pos[j].z += m_deltaT * vel[j].z;
+
+        // particles may have been moved slightly outside the box by the above steps, wrap them back into place
+        args.box.wrap(pos[j], args.image[j]);
+        }
     }
 
 /*! \param timestep Current time step
@@ -224,31 +244,58 @@ void TwoStepNVT::integrateStepTwo(unsigned int timestep)
     IntegratorVariables v = getIntegratorVariables();
     Scalar& xi = v.variable[0];
 
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
+    cpu_args args;
+    args.index = h_index.data;
+    args.group_size = group_size;
+    args.pos = NULL;
+    args.vel = h_vel.data;
+    args.accel = h_accel.data;
+    args.image = NULL;
+    args.net_force = h_net_force.data;
+    args.box = m_pdata->getBox();
+    args.xi = xi;
+
+    m_exec_conf->getThreadPool().run(bind(&TwoStepNVT::integrateStepTwoThread, this, _1, boost::cref(args)));
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param thread_idx Index of the executing thread
+    \param args Particle data arrays, group members and thermostat state
+*/
+void TwoStepNVT::integrateStepTwoThread(unsigned int thread_idx, const cpu_args& args)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange(args.group_size, thread_idx, m_exec_conf->getNumThreads(), first, last);
+
+    Scalar4 *vel = args.vel;
+    Scalar3 *accel = args.accel;
+    Scalar xi = args.xi;
+
     // perform second half step of Nose-Hoover integration
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    for (unsigned int group_idx = first; group_idx < last; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = args.index[group_idx];
 
         // first, calculate acceleration from the net force
-        Scalar minv = Scalar(1.0) / h_vel.data[j].w;
-        h_accel.data[j].x = h_net_force.data[j].x*minv;
-        h_accel.data[j].y = h_net_force.data[j].y*minv;
-        h_accel.data[j].z = h_net_force.data[j].z*minv;
+        Scalar minv = Scalar(1.0) / vel[j].w;
+        accel[j].x = args.net_force[j].x*minv;
+        accel[j].y = args.net_force[j].y*minv;
+        accel[j].z = args.net_force[j].z*minv;
 
         // then, update the velocity
-        h_vel.data[j].x += Scalar(1.0/2.0) * m_deltaT * (h_accel.data[j].x - xi * h_vel.data[j].x);
-        h_vel.data[j].y += Scalar(1.0/2.0) * m_deltaT * (h_accel.data[j].y - xi * h_vel.data[j].y);
-        h_vel.data[j].z += Scalar(1.0/2.0) * m_deltaT * (h_accel.data[j].z - xi * h_vel.data[j].z);
+        vel[j].x += Scalar(1.0/2.0) * m_deltaT * (accel[j].x - xi * vel[j].x);
+        vel[j].y += Scalar(1.0/2.0) * m_deltaT * (accel[j].y - xi * vel[j].y);
+        vel[j].z += Scalar(1.0/2.0) * m_deltaT * (accel[j].z - xi * vel[j].z);
         }
-
-    // done profiling
-    if (m_prof)
-        m_prof->pop();
     }
 
 void TwoStepNVT::advanceThermostat(unsigned int timestep)
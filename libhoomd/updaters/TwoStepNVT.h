@@ -75,6 +75,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     that the thermo computes the temperature of the assigned group and with D*N-D degrees of freedom. TwoStepNVT does
     not check for these conditions.
 
+    Both steps divide the members of the group evenly among the threads of the ExecutionConfiguration's ThreadPool,
+    the thermostat itself is advanced serially.
+
     \ingroup updaters
 */
 class TwoStepNVT : public IntegrationMethodTwoStep
@@ -142,6 +145,26 @@ class TwoStepNVT : public IntegrationMethodTwoStep
         /*!\ param timestep The time step
          */
         void advanceThermostat(unsigned int timestep);
+
+        //! Arguments passed to the threads of the integration steps
+        struct cpu_args
+            {
+            const unsigned int *index;      //!< Particle indices of the group members
+            unsigned int group_size;        //!< Number of group members
+            Scalar4 *pos;                   //!< Particle positions
+            Scalar4 *vel;                   //!< Particle velocities and masses
+            Scalar3 *accel;                 //!< Particle accelerations
+            int3 *image;                    //!< Particle images
+            const Scalar4 *net_force;       //!< Net force on the particles
+            BoxDim box;                     //!< Local simulation box
+            Scalar xi;                      //!< Current value of the thermostat variable xi
+            };
+
+        //! Performs the first step on the range of group members of one thread
+        void integrateStepOneThread(unsigned int thread_idx, const cpu_args& args);
+
+        //! Performs the second step on the range of group members of one thread
+        void integrateStepTwoThread(unsigned int thread_idx, const cpu_args& args);
     };
 
 //! Exports the TwoStepNVT class to python
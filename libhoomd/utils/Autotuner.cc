@@ -79,7 +79,7 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
                      boost::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name), m_parameters(parameters),
       m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0),
-      m_exec_conf(exec_conf), m_avg(false)
+      m_exec_conf(exec_conf), m_start_time(0), m_avg(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << nsamples << " " << period << " " << name << endl;
 
@@ -105,9 +105,12 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
 
     // create CUDA events
     #ifdef ENABLE_CUDA
-    cudaEventCreate(&m_start);
-    cudaEventCreate(&m_stop);
-    CHECK_CUDA_ERROR();
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        cudaEventCreate(&m_start);
+        cudaEventCreate(&m_stop);
+        CHECK_CUDA_ERROR();
+        }
     #endif
 
     m_sync = false;
@@ -133,7 +136,7 @@ Autotuner::Autotuner(unsigned int start,
                      boost::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name),
       m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_current_param(0),
-      m_exec_conf(exec_conf), m_avg(false)
+      m_exec_conf(exec_conf), m_start_time(0), m_avg(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << " " << start << " " << end << " " << step << " "
                                 << nsamples << " " << period << " " << name << endl;
@@ -169,9 +172,12 @@ Autotuner::Autotuner(unsigned int start,
 
     // create CUDA events
     #ifdef ENABLE_CUDA
-    cudaEventCreate(&m_start);
-    cudaEventCreate(&m_stop);
-    CHECK_CUDA_ERROR();
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        cudaEventCreate(&m_start);
+        cudaEventCreate(&m_stop);
+        CHECK_CUDA_ERROR();
+        }
     #endif
 
     m_sync = false;
@@ -181,9 +187,12 @@ Autotuner::~Autotuner()
     {
     m_exec_conf->msg->notice(5) << "Destroying Autotuner " << m_name << endl;
     #ifdef ENABLE_CUDA
-    cudaEventDestroy(m_start);
-    cudaEventDestroy(m_stop);
-    CHECK_CUDA_ERROR();
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        cudaEventDestroy(m_start);
+        cudaEventDestroy(m_stop);
+        CHECK_CUDA_ERROR();
+        }
     #endif
     }
 
@@ -193,15 +202,21 @@ void Autotuner::begin()
     if (!m_enabled)
         return;
 
-    #ifdef ENABLE_CUDA
-    // if we are scanning, record a cuda event - otherwise do nothing
+    // if we are scanning, record the start time - otherwise do nothing
     if (m_state == STARTUP || m_state == SCANNING)
         {
-        cudaEventRecord(m_start, 0);
-        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
+        #ifdef ENABLE_CUDA
+        if (m_exec_conf->isCUDAEnabled())
+            {
+            cudaEventRecord(m_start, 0);
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            return;
+            }
+        #endif
+
+        m_start_time = m_clock.getTime();
         }
-    #endif
     }
 
 void Autotuner::end()
@@ -210,20 +225,29 @@ void Autotuner::end()
     if (!m_enabled)
         return;
 
-    #ifdef ENABLE_CUDA
     // handle timing updates if scanning
     if (m_state == STARTUP || m_state == SCANNING)
         {
-        cudaEventRecord(m_stop, 0);
-        cudaEventSynchronize(m_stop);
-        cudaEventElapsedTime(&m_samples[m_current_element][m_current_sample], m_start, m_stop);
+        #ifdef ENABLE_CUDA
+        if (m_exec_conf->isCUDAEnabled())
+            {
+            cudaEventRecord(m_stop, 0);
+            cudaEventSynchronize(m_stop);
+            cudaEventElapsedTime(&m_samples[m_current_element][m_current_sample], m_start, m_stop);
+
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+        else
+        #endif
+            {
+            // elapsed wall clock time in milliseconds, like cudaEventElapsedTime
+            m_samples[m_current_element][m_current_sample] = float(m_clock.getTime() - m_start_time) / 1e6f;
+            }
+
         m_exec_conf->msg->notice(9) << "Autotuner " << m_name << ": t(" << m_current_param << "," << m_current_sample
                                      << ") = " << m_samples[m_current_element][m_current_sample] << endl;
-
-        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
         }
-    #endif
 
     // handle state data updates and transitions
     if (m_state == STARTUP)
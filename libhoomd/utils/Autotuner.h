@@ -56,6 +56,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "ExecutionConfiguration.h"
+#include "ClockSource.h"
 
 #include <vector>
 #include <string>
@@ -83,8 +84,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     Each Autotuner instance has a string name to help identify it's output on the notice stream.
 
-    Autotuner is not useful in non-GPU builds. Timing is performed with CUDA events and requires ENABLE_CUDA=on.
-    Behavior of Autotuner is undefined when ENABLE_CUDA=off.
+    When the execution configuration runs on the GPU, timing is performed with CUDA events. Otherwise, the wall-clock
+    time between begin() and end() is measured with a ClockSource. The timed region need not be a single kernel: it
+    may span any amount of CPU work, even several time steps.
 
     ** Implementation ** <br>
     Internally, m_nsamples is the number of samples to take (odd for median computation). m_current_sample is the
@@ -162,6 +164,30 @@ class Autotuner
                 }
             }
 
+        //! Test if the current call is timed
+        /*! \returns true if the next begin()/end() pair takes a sample
+        */
+        bool isSampling()
+            {
+            return m_enabled && (m_state == STARTUP || m_state == SCANNING);
+            }
+
+        //! Start a new scan immediately
+        /*! Use this when the conditions have changed enough that the optimal parameter may be different, instead of
+            waiting for the next periodic scan. Has no effect before the initial scan is complete.
+        */
+        void startScan()
+            {
+            if (m_state != IDLE)
+                return;
+
+            m_calls = 0;
+            m_current_element = 0;
+            m_current_param = m_parameters[m_current_element];
+            m_state = SCANNING;
+            m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " - beginning scan" << std::endl;
+            }
+
         //! Test if initial sampling is complete
         /*! \returns true if the initial sampling run is complete
         */
@@ -233,6 +259,9 @@ class Autotuner
         cudaEvent_t m_stop;       //!< CUDA event for recording end times
         #endif
 
+        ClockSource m_clock;      //!< Wall clock for timing on the CPU
+        int64_t m_start_time;     //!< Wall clock time recorded by begin()
+
         bool m_sync;              //!< If true, synchronize results via MPI
         bool m_avg;               //!< If true, use sample average instead of median
     };
@@ -0,0 +1,216 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HostMemoryPool.cc
+    \brief Defines the HostMemoryPool class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "HostMemoryPool.h"
+
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+
+/*! \param max_cached_bytes Maximum number of bytes kept in free blocks
+*/
+HostMemoryPool::HostMemoryPool(size_t max_cached_bytes)
+    : m_max_cached_bytes(max_cached_bytes), m_bytes_in_use(0), m_bytes_cached(0), m_peak_bytes(0), m_n_alloc(0),
+      m_n_hits(0)
+    {
+    }
+
+/*! All blocks are returned to the system, including those that have not been deallocated.
+*/
+HostMemoryPool::~HostMemoryPool()
+    {
+    for (free_blocks_type::iterator i = m_free_blocks.begin(); i != m_free_blocks.end(); ++i)
+        free(i->second);
+
+    for (allocated_blocks_type::iterator i = m_allocated_blocks.begin(); i != m_allocated_blocks.end(); ++i)
+        free(i->first);
+    }
+
+/*! \param num_bytes Size of the request
+    \returns The size of the blocks that serve the request
+
+    Sizes up to 64 bytes share one class. Above, the classes between two powers of two b and 2b are spaced by b/4.
+*/
+size_t HostMemoryPool::getSizeClass(size_t num_bytes)
+    {
+    if (num_bytes <= 64)
+        return 64;
+
+    size_t b = 64;
+    while (b <= num_bytes/2)
+        b *= 2;
+
+    size_t step = b/4;
+    return (num_bytes + step - 1)/step*step;
+    }
+
+/*! \param num_bytes Number of bytes requested
+    \param alignment Alignment of the block, a power of two and a multiple of sizeof(void *)
+    \param fresh If true, the block is newly allocated and its pages have not been touched yet
+    \returns A pointer to the block, or NULL if the system is out of memory
+
+    The contents of the block are undefined.
+*/
+void *HostMemoryPool::allocate(size_t num_bytes, size_t alignment, bool fresh)
+    {
+    block_key key(getSizeClass(num_bytes), alignment);
+
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_n_alloc++;
+
+    void *ptr = NULL;
+    free_blocks_type::iterator free_block = fresh ? m_free_blocks.end() : m_free_blocks.find(key);
+    if (free_block != m_free_blocks.end())
+        {
+        ptr = free_block->second;
+        m_free_blocks.erase(free_block);
+        m_bytes_cached -= key.first;
+        m_n_hits++;
+        }
+    else
+        {
+        if (posix_memalign(&ptr, alignment, key.first) != 0)
+            {
+            // the cached blocks may be what is missing
+            trimCache(0);
+            if (posix_memalign(&ptr, alignment, key.first) != 0)
+                return NULL;
+            }
+        }
+
+    allocated_block block;
+    block.key = key;
+    block.fresh = fresh;
+    m_allocated_blocks.insert(make_pair(ptr, block));
+    m_bytes_in_use += key.first;
+    m_peak_bytes = max(m_peak_bytes, m_bytes_in_use + m_bytes_cached);
+    return ptr;
+    }
+
+/*! \param ptr Block returned by allocate() (may be NULL)
+
+    The block is kept for reuse unless it was allocated fresh or would exceed the maximum cache size.
+*/
+void HostMemoryPool::deallocate(void *ptr)
+    {
+    if (ptr == NULL)
+        return;
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    allocated_blocks_type::iterator iter = m_allocated_blocks.find(ptr);
+    assert(iter != m_allocated_blocks.end());
+    block_key key = iter->second.key;
+    bool fresh = iter->second.fresh;
+    m_allocated_blocks.erase(iter);
+    m_bytes_in_use -= key.first;
+
+    if (fresh || key.first > m_max_cached_bytes)
+        {
+        free(ptr);
+        return;
+        }
+
+    m_free_blocks.insert(make_pair(key, ptr));
+    m_bytes_cached += key.first;
+    trimCache(m_max_cached_bytes);
+    }
+
+/*! \param max_cached_bytes Maximum number of bytes kept in free blocks
+*/
+void HostMemoryPool::setMaxCachedBytes(size_t max_cached_bytes)
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_max_cached_bytes = max_cached_bytes;
+    trimCache(m_max_cached_bytes);
+    }
+
+void HostMemoryPool::releaseCache()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    trimCache(0);
+    }
+
+void HostMemoryPool::resetStats()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_n_alloc = 0;
+    m_n_hits = 0;
+    m_peak_bytes = m_bytes_in_use + m_bytes_cached;
+    }
+
+/*! \param max_cached_bytes Number of bytes that may remain in free blocks
+    \pre The caller holds m_mutex
+*/
+void HostMemoryPool::trimCache(size_t max_cached_bytes)
+    {
+    while (m_bytes_cached > max_cached_bytes && !m_free_blocks.empty())
+        {
+        free_blocks_type::iterator largest = --m_free_blocks.end();
+        free(largest->second);
+        m_bytes_cached -= largest->first.first;
+        m_free_blocks.erase(largest);
+        }
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,182 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HostMemoryPool.h
+    \brief Declares the HostMemoryPool class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __HOST_MEMORY_POOL_H__
+#define __HOST_MEMORY_POOL_H__
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <stdlib.h>
+
+#include <boost/utility.hpp>
+#include <boost/thread/mutex.hpp>
+
+//! A caching pool for the host memory of GPUArrays
+/*! Arrays are resized frequently in some code paths: the particle data and the communication buffers follow the
+    number of particles on a rank, which changes every time particles migrate, and the neighbor list grows as
+    particles come closer. Every resize allocates a new block, copies the data and frees the old block.
+    HostMemoryPool keeps the freed blocks and hands them out again, so that an array that oscillates between a few
+    sizes no longer goes through the system allocator and the page fault handler on every resize.
+
+    Requests are rounded up to a size class. The classes are spaced four per power of two, so at most a quarter of
+    a block is wasted, and a block is reused for any request of the same class and alignment. The bytes held in free
+    blocks are limited by setMaxCachedBytes(); when a freed block would exceed the limit, the largest cached blocks
+    are returned to the system. A limit of 0 disables caching.
+
+    Blocks are handed out uncleared and keep the NUMA placement and huge page backing of their first use. Callers that
+    need untouched pages, to place them by first touch or back them with huge pages, request a fresh block. Fresh
+    blocks are always newly allocated and are returned to the system instead of the cache when they are freed.
+
+    The pool is owned by the ExecutionConfiguration and shared by all GPUArrays on this rank. It may be called from
+    several threads concurrently. The usage statistics are included in the output of the Profiler.
+    \ingroup utils
+*/
+class HostMemoryPool : boost::noncopyable
+    {
+    public:
+        //! Construct an empty pool
+        HostMemoryPool(size_t max_cached_bytes = 256u*1024u*1024u);
+
+        //! Destructor
+        ~HostMemoryPool();
+
+        //! Allocate a block
+        void *allocate(size_t num_bytes, size_t alignment, bool fresh=false);
+
+        //! Return a block to the pool
+        void deallocate(void *ptr);
+
+        //! Set the maximum number of bytes kept in free blocks
+        void setMaxCachedBytes(size_t max_cached_bytes);
+
+        //! Get the maximum number of bytes kept in free blocks
+        size_t getMaxCachedBytes() const
+            {
+            return m_max_cached_bytes;
+            }
+
+        //! Return all free blocks to the system
+        void releaseCache();
+
+        //! Get the number of bytes in blocks that are currently allocated
+        size_t getBytesInUse() const
+            {
+            return m_bytes_in_use;
+            }
+
+        //! Get the number of bytes in free blocks
+        size_t getBytesCached() const
+            {
+            return m_bytes_cached;
+            }
+
+        //! Get the largest number of bytes held by the pool since the last call to resetStats()
+        size_t getPeakBytes() const
+            {
+            return m_peak_bytes;
+            }
+
+        //! Get the number of calls to allocate() since the last call to resetStats()
+        unsigned int getNumAllocations() const
+            {
+            return m_n_alloc;
+            }
+
+        //! Get the number of allocations served from free blocks since the last call to resetStats()
+        unsigned int getNumHits() const
+            {
+            return m_n_hits;
+            }
+
+        //! Reset the usage statistics
+        void resetStats();
+
+        //! Get the size class of a request
+        static size_t getSizeClass(size_t num_bytes);
+
+    private:
+        //! Identifies interchangeable blocks by size class and alignment
+        typedef std::pair<size_t, size_t> block_key;
+
+        //! Bookkeeping of a block handed out by allocate()
+        struct allocated_block
+            {
+            block_key key;  //!< Size class and alignment
+            bool fresh;     //!< True if the block must not be cached
+            };
+
+        typedef std::multimap<block_key, void *> free_blocks_type;
+        typedef std::map<void *, allocated_block> allocated_blocks_type;
+
+        boost::mutex m_mutex;                   //!< Mutex protecting the pool state
+        free_blocks_type m_free_blocks;         //!< Cached blocks
+        allocated_blocks_type m_allocated_blocks;   //!< Blocks handed out by allocate()
+        size_t m_max_cached_bytes;              //!< Maximum number of bytes in free blocks
+        size_t m_bytes_in_use;                  //!< Number of bytes in allocated blocks
+        size_t m_bytes_cached;                  //!< Number of bytes in free blocks
+        size_t m_peak_bytes;                    //!< Largest value of m_bytes_in_use + m_bytes_cached
+        unsigned int m_n_alloc;                 //!< Number of calls to allocate()
+        unsigned int m_n_hits;                  //!< Number of allocations served from free blocks
+
+        //! Free cached blocks, largest first, until at most max_cached_bytes remain
+        void trimCache(size_t max_cached_bytes);
+    };
+
+#endif
@@ -55,6 +55,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <iomanip>
 #include <sstream>
+#include <fstream>
+#include <stdexcept>
 
 #ifdef WIN32
 #pragma warning( push )
@@ -63,6 +65,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Profiler.h"
 
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#include <boost/serialization/string.hpp>
+#endif
+
 #include <boost/python.hpp>
 using namespace boost::python;
 using namespace std;
@@ -240,11 +247,23 @@ void ProfileDataElem::output_line(std::ostream &o,
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+/*! \param name Name of the profile
+    \param exec_conf Execution configuration whose thread utilization is reported (optional)
+*/
+Profiler::Profiler(const std::string& name, boost::shared_ptr<const ExecutionConfiguration> exec_conf)
+    : m_name(name), m_exec_conf(exec_conf), m_trace_enabled(false), m_trace_head(0), m_trace_count(0),
+      m_trace_step(0), m_trace_in_step(false), m_trace_origin(0)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
 
+    // the thread utilization and memory pool statistics are measured over the lifetime of the profile
+    if (m_exec_conf)
+        {
+        m_exec_conf->getThreadPool().resetStats();
+        m_exec_conf->getHostMemoryPool().resetStats();
+        }
+
     // record the start of this profile
     m_root.m_start_time = m_clk.getTime();
 
@@ -270,6 +289,235 @@ void Profiler::output(std::ostream &o)
 
     // startup the recursive output process
     m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size());
+
+    if (m_exec_conf && m_exec_conf->getNumThreads() > 1)
+        {
+        const ThreadPool& pool = m_exec_conf->getThreadPool();
+        double sec = double(pool.getRunTime())/1e9;
+        double perc = double(pool.getRunTime())/double(m_root.m_elapsed_time) * 100.0;
+
+        o << setiosflags(ios::fixed);
+        o << "Threads: " << m_exec_conf->getNumThreads() << " per rank, " << setprecision(4) << sec << "s in "
+          << pool.getNumRuns() << " parallel regions (" << setprecision(3) << perc << "% of the total), "
+          << setprecision(3) << pool.getUtilization()*100.0 << "% utilization" << endl;
+        }
+
+    if (m_exec_conf && m_exec_conf->getHostMemoryPool().getNumAllocations() > 0)
+        {
+        const HostMemoryPool& pool = m_exec_conf->getHostMemoryPool();
+        double perc = double(pool.getNumHits())/double(pool.getNumAllocations()) * 100.0;
+
+        o << setiosflags(ios::fixed);
+        o << "Host memory: " << pool.getNumAllocations() << " allocations (" << setprecision(3) << perc
+          << "% from the pool cache), " << setprecision(2) << double(pool.getBytesInUse())/1024.0/1024.0
+          << " MB in use, " << double(pool.getBytesCached())/1024.0/1024.0 << " MB cached, "
+          << double(pool.getPeakBytes())/1024.0/1024.0 << " MB peak" << endl;
+        }
+    }
+
+/*! \param capacity Maximum number of events kept in the ring buffer
+
+    All ranks must call enableTrace() together, they synchronize so that the time stamps of all ranks share the same
+    origin.
+*/
+void Profiler::enableTrace(unsigned int capacity)
+    {
+    if (capacity == 0)
+        throw runtime_error("Error enabling profiler trace: capacity must be positive");
+
+    m_trace.resize(capacity);
+    m_trace_head = 0;
+    m_trace_count = 0;
+    m_trace_in_step = false;
+
+    // name 0 is reserved for the time steps
+    m_trace_names.clear();
+    m_trace_names.push_back("Step");
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf && m_exec_conf->getNRanks() > 1)
+        MPI_Barrier(m_exec_conf->getMPICommunicator());
+    #endif
+
+    m_trace_origin = m_clk.getTime();
+    m_trace_enabled = true;
+    }
+
+/*! \param elem Element that is traced for the first time
+    \param name Name of the element
+    \returns The new trace id of \a elem
+
+    Names are only stored per element, not per path, so elements of the same name in different branches of the tree
+    get separate entries of the same name.
+*/
+unsigned int Profiler::registerTraceName(ProfileDataElem& elem, const std::string& name)
+    {
+    // the last available id is shared by all elements beyond the capacity of the name table
+    if (m_trace_names.size() >= ProfileDataElem::NO_TRACE_ID - 1)
+        {
+        if (m_trace_names.size() == ProfileDataElem::NO_TRACE_ID - 1)
+            m_trace_names.push_back("Other");
+        elem.m_trace_id = ProfileDataElem::NO_TRACE_ID - 1;
+        return elem.m_trace_id;
+        }
+
+    elem.m_trace_id = (unsigned int)m_trace_names.size();
+    m_trace_names.push_back(name);
+    return elem.m_trace_id;
+    }
+
+//! Helper function to escape a string for output in JSON
+static string json_escape(const string& str)
+    {
+    string out;
+    for (unsigned int i = 0; i < str.size(); i++)
+        {
+        if (str[i] == '"' || str[i] == '\\')
+            out += '\\';
+        out += str[i];
+        }
+    return out;
+    }
+
+//! Helper function to append the bytes of a value to a binary buffer
+template<class T> static void append_binary(string& buf, const T& val)
+    {
+    buf.append((const char *)&val, sizeof(T));
+    }
+
+/*! \param format Either "json" or "binary"
+    \param rank Rank that recorded the trace
+    \returns The events of this rank, in the order they were recorded
+
+    For JSON, the events are formatted as comma separated trace event objects, without the enclosing array. End events
+    whose begin was overwritten in the ring buffer are dropped, and regions still open are closed at the time of
+    the last event, so that every begin is matched.
+*/
+std::string Profiler::formatTrace(const std::string& format, unsigned int rank)
+    {
+    unsigned int capacity = (unsigned int)m_trace.size();
+    unsigned int first = (m_trace_head + capacity - m_trace_count) % capacity;
+
+    // select the events to output
+    std::vector<ProfileTraceEvent> events;
+    events.reserve(m_trace_count + 16);
+    std::stack<unsigned short> open;
+    for (unsigned int i = 0; i < m_trace_count; i++)
+        {
+        const ProfileTraceEvent& ev = m_trace[(first + i) % capacity];
+        if (ev.m_type == TRACE_BEGIN)
+            open.push(ev.m_name);
+        else
+            {
+            if (open.empty())
+                continue;
+            open.pop();
+            }
+        events.push_back(ev);
+        }
+
+    while (!open.empty())
+        {
+        ProfileTraceEvent ev = events.back();
+        ev.m_name = open.top();
+        ev.m_type = TRACE_END;
+        events.push_back(ev);
+        open.pop();
+        }
+
+    string out;
+    if (format == "json")
+        {
+        ostringstream o;
+        o << setiosflags(ios::fixed) << setprecision(3);
+        o << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+          << ",\"tid\":0,\"args\":{\"name\":\"rank " << rank << "\"}}";
+        for (unsigned int i = 0; i < events.size(); i++)
+            {
+            const ProfileTraceEvent& ev = events[i];
+            o << ",\n{\"name\":\"" << json_escape(m_trace_names[ev.m_name]) << "\",\"ph\":\""
+              << (ev.m_type == TRACE_BEGIN ? "B" : "E") << "\",\"ts\":" << double(ev.m_time - m_trace_origin)/1e3
+              << ",\"pid\":" << rank << ",\"tid\":0";
+            if (ev.m_type == TRACE_BEGIN)
+                o << ",\"args\":{\"step\":" << ev.m_timestep << "}";
+            o << "}";
+            }
+        out = o.str();
+        }
+    else
+        {
+        append_binary(out, (uint32_t)rank);
+        append_binary(out, (uint32_t)m_trace_names.size());
+        for (unsigned int i = 0; i < m_trace_names.size(); i++)
+            {
+            append_binary(out, (uint32_t)m_trace_names[i].size());
+            out.append(m_trace_names[i]);
+            }
+        append_binary(out, (uint64_t)events.size());
+        for (unsigned int i = 0; i < events.size(); i++)
+            {
+            ProfileTraceEvent ev = events[i];
+            ev.m_time -= m_trace_origin;
+            append_binary(out, ev);
+            }
+        }
+    return out;
+    }
+
+/*! \param fname File to write
+    \param format Either "json" (Chrome trace event format) or "binary" (see the Profiler documentation)
+
+    This is a collective call, the root rank writes the traces of all ranks.
+*/
+void Profiler::writeTrace(const std::string& fname, const std::string& format)
+    {
+    if (format != "json" && format != "binary")
+        throw runtime_error("Error writing profiler trace: unknown format " + format);
+    if (!m_trace_enabled)
+        throw runtime_error("Error writing profiler trace: tracing is not enabled");
+
+    unsigned int rank = 0;
+    std::vector<string> traces;
+    #ifdef ENABLE_MPI
+    if (m_exec_conf && m_exec_conf->getNRanks() > 1)
+        {
+        rank = m_exec_conf->getRank();
+        gather_v(formatTrace(format, rank), traces, 0, m_exec_conf->getMPICommunicator());
+        }
+    else
+    #endif
+        traces.push_back(formatTrace(format, rank));
+
+    if (rank != 0)
+        return;
+
+    ofstream f(fname.c_str(), ios_base::out | ios_base::binary);
+    if (!f.good())
+        throw runtime_error("Error writing profiler trace: cannot open " + fname);
+
+    if (format == "json")
+        {
+        f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        for (unsigned int i = 0; i < traces.size(); i++)
+            {
+            if (i > 0)
+                f << ",\n";
+            f << traces[i];
+            }
+        f << "\n]}\n";
+        }
+    else
+        {
+        string header("HTRC");
+        append_binary(header, (uint32_t)1);
+        append_binary(header, (uint32_t)traces.size());
+        f.write(header.data(), header.size());
+        for (unsigned int i = 0; i < traces.size(); i++)
+            f.write(traces[i].data(), traces[i].size());
+        }
+
+    if (!f.good())
+        throw runtime_error("Error writing profiler trace to " + fname);
     }
 
 /*! \param o Stream to output to
@@ -72,6 +72,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <stack>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <cassert>
 
@@ -107,7 +108,8 @@ class ProfileDataElem
     {
     public:
         //! Constructs an element with zeroed counters
-        ProfileDataElem() : m_start_time(0), m_elapsed_time(0), m_flop_count(0), m_mem_byte_count(0)
+        ProfileDataElem() : m_start_time(0), m_elapsed_time(0), m_flop_count(0), m_mem_byte_count(0),
+                            m_trace_id(NO_TRACE_ID)
             #ifdef SCOREP_USER_ENABLE
             , m_scorep_region(SCOREP_USER_INVALID_REGION)
             #endif
@@ -137,6 +139,10 @@ class ProfileDataElem
         int64_t m_elapsed_time; //!< A running total of elapsed running time
         int64_t m_flop_count;   //!< A running total of floating point operations
         int64_t m_mem_byte_count;   //!< A running total of memory bytes transferred
+        unsigned int m_trace_id;    //!< Index of this element in the trace name table
+
+        //! Value of m_trace_id for elements that have not been traced yet
+        static const unsigned int NO_TRACE_ID = 0xffff;
 
         #ifdef SCOREP_USER_ENABLE
         SCOREP_User_RegionHandle m_scorep_region;   //!< ScoreP region identifier
@@ -144,6 +150,17 @@ class ProfileDataElem
     };
 
 
+//! Single record in the trace of a Profiler
+/*! Records are 16 bytes, so a trace of a million events fits in 16 MB.
+    \ingroup utils
+*/
+struct ProfileTraceEvent
+    {
+    int64_t m_time;             //!< Time stamp in ns
+    unsigned int m_timestep;    //!< Time step during which the event was recorded
+    unsigned short m_name;      //!< Index into the name table of the Profiler
+    unsigned short m_type;      //!< Profiler::TRACE_BEGIN or Profiler::TRACE_END
+    };
 
 //! A class for doing coarse-level profiling of code
 /*! Stores and organizes a tree of profiles that can be created with a simple push/pop
@@ -162,13 +179,34 @@ class ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    When constructed with an ExecutionConfiguration that runs more than one CPU thread, the output ends with the
+    utilization of its ThreadPool over the lifetime of the profile. With any ExecutionConfiguration, it also reports
+    the number of host memory allocations in that time and the fraction of them served by the HostMemoryPool cache.
+
+    <b>Tracing</b>
+
+    The accumulated tree hides variations between time steps and between ranks. After enableTrace(), every push()
+    and pop() additionally stores a time stamped begin or end event in a ring buffer that is allocated once, and
+    traceStep() marks the start of each time step. When the buffer is full, the oldest events are overwritten, so
+    the trace always holds the most recent events. Recording an event is a store of 16 bytes, cheap enough to leave
+    tracing on for production runs on the CPU. writeTrace() collects the events of all ranks on the root rank and
+    writes them to one file, either as Chrome trace event JSON (viewable in chrome://tracing or Perfetto) or in a
+    compact binary format.
+
+    The binary format is native endian and starts with the 4 characters \c HTRC, followed by the uint32 format
+    version (1) and the uint32 number of ranks. For every rank follow the uint32 rank, the uint32 number of names,
+    each name as a uint32 length and its characters, the uint64 number of events, and the events as
+    ProfileTraceEvent records. Name 0 is always \c Step, it spans each time step. Time stamps are in ns since
+    enableTrace() was called, which happens after a barrier on all ranks.
     \ingroup utils
     */
 class Profiler
     {
     public:
         //! Constructs an empty profiler and starts its timer ticking
-        Profiler(const std::string& name = "Profile");
+        Profiler(const std::string& name = "Profile",
+                 boost::shared_ptr<const ExecutionConfiguration> exec_conf = boost::shared_ptr<const ExecutionConfiguration>());
         //! Pushes a new sub-category into the current category
         void push(const std::string& name);
         //! Pops back up to the next super-category
@@ -179,11 +217,52 @@ class Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(boost::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Types of trace events
+        enum TraceEventType
+            {
+            TRACE_BEGIN = 0,    //!< A region was entered
+            TRACE_END           //!< A region was left
+            };
+
+        //! Starts recording trace events
+        void enableTrace(unsigned int capacity);
+
+        //! Marks the start of a new time step in the trace
+        void traceStep(unsigned int timestep);
+
+        //! Writes the trace to a file
+        void writeTrace(const std::string& fname, const std::string& format);
+
+        //! Returns the number of trace events currently held in the buffer
+        unsigned int getNumTraceEvents() const
+            {
+            return m_trace_count;
+            }
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration (may be NULL)
+
+        bool m_trace_enabled;                       //!< True if trace events are recorded
+        std::vector<ProfileTraceEvent> m_trace;     //!< Ring buffer of trace events
+        unsigned int m_trace_head;                  //!< Index of the next event to write
+        unsigned int m_trace_count;                 //!< Number of valid events in the buffer
+        unsigned int m_trace_step;                  //!< Current time step
+        bool m_trace_in_step;                       //!< True if a Step begin event is open
+        int64_t m_trace_origin;                     //!< Time at which the trace was enabled
+        std::vector<std::string> m_trace_names;     //!< Names of the traced regions
+
+        //! Assigns a trace id to a profile element
+        unsigned int registerTraceName(ProfileDataElem& elem, const std::string& name);
+
+        //! Appends an event to the ring buffer
+        void recordTraceEvent(unsigned int name_id, int64_t t, unsigned short type);
+
+        //! Formats the local trace in the requested format
+        std::string formatTrace(const std::string& format, unsigned int rank);
 
         //! Output helper function
         void output(std::ostream &o);
@@ -236,10 +315,19 @@ inline void Profiler::push(const std::string& name)
     ProfileDataElem *cur = m_stack.top();
 
     // then creating (or accessing) the named sample and setting the start time
-    cur->m_children[name].m_start_time = t;
+    ProfileDataElem& elem = cur->m_children[name];
+    elem.m_start_time = t;
 
     // and updating the stack
-    m_stack.push(&cur->m_children[name]);
+    m_stack.push(&elem);
+
+    if (m_trace_enabled)
+        {
+        unsigned int id = elem.m_trace_id;
+        if (id == ProfileDataElem::NO_TRACE_ID)
+            id = registerTraceName(elem, name);
+        recordTraceEvent(id, t, TRACE_BEGIN);
+        }
 
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
@@ -267,6 +355,10 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     #endif
     cur->m_elapsed_time += t - cur->m_start_time;
 
+    // elements pushed before the trace was enabled have no id, their begin event is missing anyway
+    if (m_trace_enabled && cur->m_trace_id != ProfileDataElem::NO_TRACE_ID)
+        recordTraceEvent(cur->m_trace_id, t, TRACE_END);
+
     // and increasing the flop and mem counters
     cur->m_flop_count += flop_count;
     cur->m_mem_byte_count += byte_count;
@@ -275,4 +367,40 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     m_stack.pop();
     }
 
+/*! \param name_id Index of the region in the name table
+    \param t Time stamp of the event
+    \param type TRACE_BEGIN or TRACE_END
+*/
+inline void Profiler::recordTraceEvent(unsigned int name_id, int64_t t, unsigned short type)
+    {
+    ProfileTraceEvent& ev = m_trace[m_trace_head];
+    ev.m_time = t;
+    ev.m_timestep = m_trace_step;
+    ev.m_name = (unsigned short)name_id;
+    ev.m_type = type;
+
+    if (++m_trace_head == m_trace.size())
+        m_trace_head = 0;
+    if (m_trace_count < m_trace.size())
+        m_trace_count++;
+    }
+
+/*! \param timestep Time step that is about to be executed
+
+    Closes the Step region of the previous time step and opens a new one. Call only at the root of the profile tree.
+*/
+inline void Profiler::traceStep(unsigned int timestep)
+    {
+    if (!m_trace_enabled)
+        return;
+
+    int64_t t = m_clk.getTime();
+    if (m_trace_in_step)
+        recordTraceEvent(0, t, TRACE_END);
+
+    m_trace_step = timestep;
+    recordTraceEvent(0, t, TRACE_BEGIN);
+    m_trace_in_step = true;
+    }
+
 #endif
@@ -0,0 +1,289 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ThreadPool.cc
+    \brief Defines the ThreadPool class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "ThreadPool.h"
+
+#include <stdexcept>
+#include <boost/bind.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+/*! \param n_threads Number of threads in the pool, including the calling thread
+    \param pin_threads If true, pin every thread to one of the CPUs the calling thread may run on
+
+    n_threads-1 worker threads are started and wait for tasks to be submitted with run(). If the CPUs cannot be
+    determined, the threads are not pinned, which can be checked with isPinned().
+*/
+ThreadPool::ThreadPool(unsigned int n_threads, bool pin_threads)
+    : m_n_threads(n_threads), m_task(NULL), m_generation(0), m_n_busy(0), m_active(false), m_shutdown(false),
+      m_run_time(0), m_n_runs(0)
+    {
+    if (m_n_threads == 0)
+        m_n_threads = 1;
+
+    m_busy_time.resize(m_n_threads, 0);
+
+#ifdef __linux__
+    if (pin_threads)
+        {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask) == 0)
+            {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                if (CPU_ISSET(cpu, &mask))
+                    m_cpus.push_back(cpu);
+            }
+
+        if (!m_cpus.empty())
+            pinThread(0);
+        }
+#endif
+
+    for (unsigned int i = 1; i < m_n_threads; i++)
+        m_workers.create_thread(boost::bind(&ThreadPool::workerLoop, this, i));
+    }
+
+/*! Signals all worker threads to terminate and joins them
+*/
+ThreadPool::~ThreadPool()
+    {
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_shutdown = true;
+        }
+    m_start_cond.notify_all();
+    m_workers.join_all();
+
+#ifdef __linux__
+    // give the calling thread back all the CPUs it was allowed to run on
+    if (!m_cpus.empty())
+        {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (unsigned int i = 0; i < m_cpus.size(); i++)
+            CPU_SET(m_cpus[i], &mask);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+        }
+#endif
+    }
+
+/*! \param task Task to execute
+
+    \a task is called once on every thread in the pool with the index of the thread as an argument. The calling
+    thread executes the task as thread 0. run() returns after all threads have completed the task.
+
+    If a task throws an exception on any thread, a std::runtime_error with the same message is thrown from run()
+    after all threads have completed.
+*/
+void ThreadPool::run(const task_type& task)
+    {
+    if (m_n_threads == 1)
+        {
+        // a single thread is always fully utilized
+        task(0);
+        m_n_runs++;
+        return;
+        }
+
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+        if (m_active)
+            {
+            // nested call from within a task, execute serially on this thread
+            lock.unlock();
+            for (unsigned int i = 0; i < m_n_threads; i++)
+                task(i);
+            return;
+            }
+
+        m_active = true;
+        m_task = &task;
+        m_n_busy = m_n_threads - 1;
+        m_error.clear();
+        m_generation++;
+        }
+    int64_t start_time = m_clk.getTime();
+    m_start_cond.notify_all();
+
+    // the calling thread takes part in the work
+    string error;
+    try
+        {
+        task(0);
+        }
+    catch (const std::exception& e)
+        {
+        error = e.what();
+        }
+    m_busy_time[0] += m_clk.getTime() - start_time;
+
+    // wait for the workers to finish
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (m_n_busy > 0)
+        m_done_cond.wait(lock);
+
+    m_run_time += m_clk.getTime() - start_time;
+    m_n_runs++;
+
+    m_task = NULL;
+    m_active = false;
+
+    if (error.empty())
+        error = m_error;
+
+    if (!error.empty())
+        throw runtime_error(error);
+    }
+
+/*! \returns The time all threads spent executing tasks divided by the number of threads times the wall time spent
+    in run(), or 1.0 if no time was spent in run() with more than one thread
+*/
+double ThreadPool::getUtilization() const
+    {
+    if (m_run_time == 0)
+        return 1.0;
+
+    int64_t busy_time = 0;
+    for (unsigned int i = 0; i < m_n_threads; i++)
+        busy_time += m_busy_time[i];
+
+    return double(busy_time) / (double(m_n_threads) * double(m_run_time));
+    }
+
+/*! Must not be called while a task is executing
+*/
+void ThreadPool::resetStats()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_run_time = 0;
+    m_n_runs = 0;
+    std::fill(m_busy_time.begin(), m_busy_time.end(), 0);
+    }
+
+/*! \param thread_idx Index of the thread in the pool
+
+    A failure to set the affinity is ignored, the thread then keeps running on any of the allowed CPUs.
+*/
+void ThreadPool::pinThread(unsigned int thread_idx)
+    {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(m_cpus[thread_idx % m_cpus.size()], &mask);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+#endif
+    }
+
+/*! \param thread_idx Index of this worker thread
+
+    Waits for new tasks to be submitted, executes them and notifies the calling thread on completion.
+*/
+void ThreadPool::workerLoop(unsigned int thread_idx)
+    {
+    if (!m_cpus.empty())
+        pinThread(thread_idx);
+
+    unsigned int generation = 0;
+
+    while (true)
+        {
+        const task_type *task = NULL;
+            {
+            boost::mutex::scoped_lock lock(m_mutex);
+            while (!m_shutdown && m_generation == generation)
+                m_start_cond.wait(lock);
+
+            if (m_shutdown)
+                return;
+
+            generation = m_generation;
+            task = m_task;
+            }
+
+        int64_t start_time = m_clk.getTime();
+        string error;
+        try
+            {
+            (*task)(thread_idx);
+            }
+        catch (const std::exception& e)
+            {
+            error = e.what();
+            }
+        int64_t busy_time = m_clk.getTime() - start_time;
+
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_busy_time[thread_idx] += busy_time;
+        if (!error.empty())
+            m_error = error;
+        if (--m_n_busy == 0)
+            m_done_cond.notify_one();
+        }
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
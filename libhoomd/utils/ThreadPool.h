@@ -0,0 +1,187 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ThreadPool.h
+    \brief Declares the ThreadPool class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/utility.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include "ClockSource.h"
+
+//! A pool of persistent worker threads for shared memory parallel execution on the CPU
+/*! ThreadPool starts n_threads-1 worker threads on construction and keeps them waiting on a condition variable
+    until work is submitted with run(). The calling thread always participates in the work as thread 0, so a pool
+    with a single thread has no workers and run() reduces to a plain function call.
+
+    A task is a function that takes the index of the thread it executes on. Every thread in the pool executes the
+    task exactly once per call to run(), and run() returns only after all threads have completed it. Tasks are
+    expected to divide their work by the thread index, getRange() provides a simple static partition for this.
+
+    Calling run() from within a task (nested parallelism) is allowed, the inner task is then executed serially
+    on the calling thread for all thread indices.
+
+    The ThreadPool is owned by the ExecutionConfiguration and shared by all computes on this rank.
+
+    To judge how well the threads are used, the pool measures the wall time spent in run() and the time every thread
+    spends executing tasks. getUtilization() is the ratio of the two, averaged over all threads. A low utilization
+    indicates load imbalance or serial sections inside the tasks.
+
+    Optionally, every thread is pinned to one CPU (on Linux only). The CPUs are taken in order from the set the
+    calling thread may run on when the pool is constructed, so binding every MPI rank to its own cores with the
+    launcher (or \c taskset) and pinning the threads within that set keeps each thread on the same core and NUMA
+    node for its lifetime. Thread i runs on the i-th CPU of the set, wrapping around if there are more threads than
+    CPUs. The affinity of the calling thread is restored when the pool is destroyed.
+    \ingroup utils
+*/
+class ThreadPool : boost::noncopyable
+    {
+    public:
+        //! The type of a task, called with the index of the executing thread
+        typedef boost::function<void (unsigned int)> task_type;
+
+        //! Construct a thread pool
+        ThreadPool(unsigned int n_threads, bool pin_threads=false);
+
+        //! Destructor
+        ~ThreadPool();
+
+        //! Get the number of threads in the pool (including the calling thread)
+        unsigned int getNumThreads() const
+            {
+            return m_n_threads;
+            }
+
+        //! Returns true if the threads are pinned to CPUs
+        bool isPinned() const
+            {
+            return !m_cpus.empty();
+            }
+
+        //! Execute a task on all threads and wait for its completion
+        void run(const task_type& task);
+
+        //! Get the wall time spent in run() since the last call to resetStats(), in nanoseconds
+        int64_t getRunTime() const
+            {
+            return m_run_time;
+            }
+
+        //! Get the number of calls to run() since the last call to resetStats()
+        unsigned int getNumRuns() const
+            {
+            return m_n_runs;
+            }
+
+        //! Get the average fraction of the time in run() that the threads spent executing tasks
+        double getUtilization() const;
+
+        //! Reset the timing statistics
+        void resetStats();
+
+        //! Get the range of items assigned to a thread when N items are distributed evenly
+        /*! \param N Total number of work items
+            \param thread_idx Index of the thread
+            \param n_threads Total number of threads
+            \param first (output) First item assigned to this thread
+            \param last (output) One past the last item assigned to this thread
+        */
+        static void getRange(unsigned int N, unsigned int thread_idx, unsigned int n_threads,
+                             unsigned int& first, unsigned int& last)
+            {
+            unsigned int chunk = N / n_threads;
+            unsigned int rem = N % n_threads;
+            first = thread_idx*chunk + std::min(thread_idx, rem);
+            last = first + chunk + ((thread_idx < rem) ? 1 : 0);
+            }
+
+    private:
+        unsigned int m_n_threads;               //!< Number of threads in the pool
+        boost::thread_group m_workers;          //!< The worker threads
+        boost::mutex m_mutex;                   //!< Mutex protecting the pool state
+        boost::condition_variable m_start_cond; //!< Signals the workers that a new task is available
+        boost::condition_variable m_done_cond;  //!< Signals the calling thread that all workers are done
+        const task_type *m_task;                //!< The task currently being executed
+        unsigned int m_generation;              //!< Incremented each time a new task is submitted
+        unsigned int m_n_busy;                  //!< Number of workers still executing the current task
+        bool m_active;                          //!< True while a task is executing
+        bool m_shutdown;                        //!< Set to true to terminate the workers
+        std::string m_error;                    //!< Error message of an exception thrown by a worker
+
+        ClockSource m_clk;                      //!< Clock for the timing statistics
+        int64_t m_run_time;                     //!< Total wall time spent in run()
+        unsigned int m_n_runs;                  //!< Number of calls to run()
+        std::vector<int64_t> m_busy_time;       //!< Time every thread spent executing tasks
+        std::vector<int> m_cpus;                //!< CPUs the threads are pinned to, empty if they are not pinned
+
+        //! Pin the calling thread to the CPU of thread \a thread_idx
+        void pinThread(unsigned int thread_idx);
+
+        //! Main loop of the worker threads
+        void workerLoop(unsigned int thread_idx);
+    };
+
+#endif
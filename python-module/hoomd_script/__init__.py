@@ -143,6 +143,8 @@ def get_hoomd_script_version():
 # \param callback     (if set) Sets a Python function to be called regularly during a run.
 # \param callback_period Sets the period, in time steps, between calls made to \a callback
 # \param quiet Set to True to eliminate the status information printed to the screen by the run
+# \param trace (if set) File name to write a per step timing trace of the run to
+# \param trace_events Maximum number of events kept in the trace per MPI rank
 #
 # \b Examples:
 # \code
@@ -150,6 +152,7 @@ def get_hoomd_script_version():
 # run(10e6)
 # run(10000, profile=True)
 # run(1e9, limit_hours=11)
+# run(10000, trace='trace.json')
 #
 # def py_cb(cur_tstep):
 #     print "callback called at step: ", str(cur_tstep)
@@ -176,6 +179,14 @@ def get_hoomd_script_version():
 # can slow the simulation on the GPU significantly; so only enable profiling for testing
 # and troubleshooting purposes.
 #
+# When \a trace is set, the begin and end of every profiled region are recorded with a time stamp, the time step
+# and the MPI rank, and written to the file \a trace at the end of the run. Unlike the profile, the trace shows
+# imbalance between ranks and individual slow steps (e.g. neighbor list rebuilds). A file name ending in \c .json
+# selects the Chrome trace event format, which can be opened in chrome://tracing or https://ui.perfetto.dev; any
+# other name selects a compact binary format (see the Profiler class documentation). Only the last \a trace_events
+# events of each rank are kept, so long runs show the steps at their end. Recording the trace is cheap on the CPU,
+# but on the GPU it synchronizes with the device like \a profile does.
+#
 # If \a limit_hours is changed from the default of None, the run will continue until either
 # the specified number of time steps has been reached, or the given number of hours has
 # elapsed. This option can be useful in shared machines where the queuing system limits
@@ -199,7 +210,8 @@ def get_hoomd_script_version():
 # once at the end of the run. Otherwise the callback is executed whenever the current
 # time step number is a multiple of \a callback_period.
 #
-def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False):
+def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False,
+        trace=None, trace_events=1000000):
     if not quiet:
         _util.print_status_line();
     # check if initialization has occured
@@ -224,6 +236,17 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
     for logger in globals.loggers:
         logger.update_quantities();
     globals.system.enableProfiler(profile);
+    if trace is None:
+        globals.system.enableTrace("", "json", 0);
+    else:
+        if int(trace_events) <= 0:
+            globals.msg.error("trace_events must be positive\n");
+            raise RuntimeError('Error running');
+        if trace.endswith('.json'):
+            trace_format = "json";
+        else:
+            trace_format = "binary";
+        globals.system.enableTrace(trace, trace_format, int(trace_events));
     globals.system.enableQuietRun(quiet);
 
     if globals.neighbor_list:
@@ -240,6 +263,10 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
     if not quiet:
         globals.msg.notice(1, "** starting run **\n");
     globals.system.run(int(tsteps), callback_period, callback, limit_hours, int(limit_multiple));
+
+    # write out rows still buffered by the loggers
+    for logger in globals.loggers:
+        logger.cpp_analyzer.flush();
     if not quiet:
         globals.msg.notice(1, "** run complete **\n");
 
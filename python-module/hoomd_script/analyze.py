@@ -429,6 +429,8 @@ class log(_analyzer):
     # \param header_prefix (optional) Specify a string to print before the header
     # \param overwrite When False (the default) an existing log will be appended to.
     #                  If True, an existing log file will be overwritten instead.
+    # \param buffer_rows Number of rows to collect in memory before they are written to the file
+    # \param binary Set to True to write a compact binary file instead of text
     #
     # \b Examples:
     # \code
@@ -445,6 +447,8 @@ class log(_analyzer):
     #             period=10, header_prefix='Log of harmonic energy, run 5\n')
     # logger = analyze.log(filename='mylog.log', period=100,
     #                      quantities=['pair_lj_energy'], overwrite=True)
+    # analyze.log(filename='thermo.bin', period=10, quantities=['potential_energy', 'temperature'],
+    #             buffer_rows=1000, binary=True)
     # \endcode
     #
     # By default, columns in the log file are separated by tabs, suitable for importing as a
@@ -456,19 +460,33 @@ class log(_analyzer):
     # automatically. Another use-case would be to specify a descriptive line containing
     # details of the current run. Examples of each of these cases are given above.
     #
+    # By default, every logged row is written and flushed to the file immediately. When \a buffer_rows is larger than 1,
+    # rows are collected in memory and written in blocks of \a buffer_rows rows by a background thread, so that
+    # frequent logging does not slow down the simulation. Buffered rows are always written at the end of every run().
+    #
+    # With \a binary=True, the values are stored as double precision numbers in blocks of columns, which is both
+    # smaller and faster to write than text. The layout of the file is described in the documentation of the
+    # Logger class. Binary logs are always buffered.
+    #
     # \warning When an existing log is appended to, the header is not printed. For the log to
     # remain consistent with the header already in the file, you must specify the same quantities
     # to log and in the same order for all runs of hoomd that append to the same log.
     #
     # \a period can be a function: see \ref variable_period_docs for details
-    def __init__(self, filename, quantities, period, header_prefix='', overwrite=False):
+    def __init__(self, filename, quantities, period, header_prefix='', overwrite=False, buffer_rows=1, binary=False):
         util.print_status_line();
 
         # initialize base class
         _analyzer.__init__(self);
 
+        if int(buffer_rows) < 1:
+            globals.msg.error("analyze.log: buffer_rows must be at least 1\n");
+            raise RuntimeError('Error creating log');
+
         # create the c++ mirror class
         self.cpp_analyzer = hoomd.Logger(globals.system_definition, filename, header_prefix, overwrite);
+        self.cpp_analyzer.setBinary(binary);
+        self.cpp_analyzer.setFlushPeriod(int(buffer_rows));
         self.setupAnalyzer(period);
 
         # set the logged quantities
@@ -484,6 +502,7 @@ class log(_analyzer):
     #
     # \param quantities New list of quantities to log (if specified)
     # \param delimiter New delimiter between columns in the output file (if specified)
+    # \param buffer_rows New number of rows to collect before writing (if specified)
     #
     # Using set_params() requires that the specified logger was saved in a variable when created.
     # i.e.
@@ -498,8 +517,9 @@ class log(_analyzer):
     # logger.set_params(quantities=['bond_harmonic_energy'])
     # logger.set_params(delimiter=',');
     # logger.set_params(quantities=['bond_harmonic_energy'], delimiter=',');
+    # logger.set_params(buffer_rows=100);
     # \endcode
-    def set_params(self, quantities=None, delimiter=None):
+    def set_params(self, quantities=None, delimiter=None, buffer_rows=None):
         util.print_status_line();
 
         if quantities is not None:
@@ -512,6 +532,12 @@ class log(_analyzer):
         if delimiter:
             self.cpp_analyzer.setDelimiter(delimiter);
 
+        if buffer_rows is not None:
+            if int(buffer_rows) < 1:
+                globals.msg.error("analyze.log: buffer_rows must be at least 1\n");
+                raise RuntimeError('Error setting log parameters');
+            self.cpp_analyzer.setFlushPeriod(int(buffer_rows));
+
     ## Retrieve a cached value of a monitored quantity from the last update of the logger.
     # \param quantity Name of the quantity to return.
     #
@@ -103,7 +103,10 @@ from math import sqrt
 #       (group.charged). However, note that this group is static and determined at the time charge.pppm() is specified.
 #       If you are going to add charged particles at a later point in the simulation with the data access API,
 #       ensure that this group includes those particles as well.
-# \MPI_NOT_SUPPORTED
+# \note In multi-processor simulations, the mesh is divided among the domains. The number of grid points along every
+#       direction must be a multiple of the number of domains along that direction. Multi-processor simulations
+#       with charge.pppm are only supported on the CPU.
+# \MPI_SUPPORTED
 class pppm(force._force):
     ## Specify long-ranged electrostatic interactions between particles
     #
@@ -118,10 +121,10 @@ class pppm(force._force):
     def __init__(self, group):
         util.print_status_line();
 
-        # Error out in MPI simulations
+        # Error out in multi-GPU simulations
         if (hoomd.is_MPI_available()):
-            if globals.system_definition.getParticleData().getDomainDecomposition():
-                globals.msg.error("charge.pppm is not supported in multi-processor simulations.\n\n")
+            if globals.system_definition.getParticleData().getDomainDecomposition() and globals.exec_conf.isCUDAEnabled():
+                globals.msg.error("charge.pppm is not supported in multi-processor simulations on the GPU.\n\n")
                 raise RuntimeError("Error initializing PPPM.")
 
         # initialize the base class
@@ -192,11 +195,11 @@ class pppm(force._force):
 
         self.params_set = True;
         q2 = 0
-        N = globals.system_definition.getParticleData().getN()
+        N = globals.system_definition.getParticleData().getNGlobal()
         for i in range(0,N):
             q = globals.system_definition.getParticleData().getCharge(i)
             q2 += q*q
-        box = globals.system_definition.getParticleData().getBox()
+        box = globals.system_definition.getParticleData().getGlobalBox()
         Lx = box.getL().x
         Ly = box.getL().y
         Lz = box.getL().z
@@ -759,6 +759,16 @@ def _perform_common_init_tasks():
             globals.system.setCommunicator(cpp_communicator)
 
 
+## \internal
+# \brief Get the host allocation flags selected in the options
+def _get_host_alloc_flags():
+    flags = 0;
+    if globals.options.huge_pages:
+        flags |= int(hoomd.ExecutionConfiguration.host_alloc.huge_pages);
+    if globals.options.first_touch:
+        flags |= int(hoomd.ExecutionConfiguration.host_alloc.first_touch);
+    return flags;
+
 ## Initializes the execution configuration
 #
 # \internal
@@ -800,6 +810,18 @@ def _create_exec_conf():
     if globals.options.gpu_error_checking:
        exec_conf.setCUDAErrorChecking(True);
 
+    # an explicitly requested number of threads overrides the environment
+    if globals.options.nthreads is not None:
+        exec_conf.setNumThreads(globals.options.nthreads);
+
+    if globals.options.pin_threads:
+        exec_conf.setPinThreads(True);
+
+    exec_conf.setHostAllocFlags(_get_host_alloc_flags());
+
+    if globals.options.host_pool is not None:
+        exec_conf.getHostMemoryPool().setMaxCachedBytes(int(float(globals.options.host_pool)*1024*1024));
+
     globals.exec_conf = exec_conf;
 
     return exec_conf;
@@ -125,6 +125,9 @@ class _integrator:
         self.cpp_integrator = None;
         self.supports_methods = False;
 
+        # forces evaluated only every few time steps, and their multiples
+        self.force_multiples = {};
+
         # save ourselves in the global variable
         globals.integrator = self;
 
@@ -138,6 +141,10 @@ class _integrator:
     # \note If hoomd ever needs to support multiple TYPES of methods, we could just change this to a string naming the
     # type that is supported and add a type string to each of the integration_methods.
 
+    ## \var force_multiples
+    # \internal
+    # \brief Maps forces to the number of time steps between their evaluations, for those with a multiple above 1
+
     ## \internal
     # \brief Checks that proper initialization has completed
     def check_initialization(self):
@@ -162,7 +169,10 @@ class _integrator:
                 f.update_coeffs();
 
             if f.enabled:
-                self.cpp_integrator.addForceCompute(f.cpp_force);
+                if f in self.force_multiples:
+                    self.cpp_integrator.addSlowForceCompute(f.cpp_force, self.force_multiples[f]);
+                else:
+                    self.cpp_integrator.addForceCompute(f.cpp_force);
 
         # set the constraint forces
         for f in globals.constraint_forces:
@@ -362,6 +372,46 @@ class mode_standard(_integrator):
         if dt is not None:
             self.cpp_integrator.setDeltaT(dt);
 
+    ## Evaluates a force only every few time steps (multiple time step integration)
+    # \param force Force to evaluate less often
+    # \param multiple Number of time steps between evaluations of \a force
+    #
+    # Slowly varying forces, such as long range electrostatics or soft pair potentials, can be evaluated less often
+    # than stiff bonded forces with the impulse form of the r-RESPA algorithm \cite Tuckerman1992. The time steps are
+    # grouped into intervals of \a multiple steps. At the beginning and at the end of each interval, the velocities
+    # of all integrated particles are changed by the impulse of \a force over half of the interval. The integration
+    # methods only see the remaining forces and integrate them with the time step \a dt. Different forces can be given
+    # different multiples.
+    #
+    # The intervals are aligned to multiples of \a multiple in the time step. When a multiple is set or changed between
+    # runs, the intervals of \a force begin at the start of the next run(), with a shortened first interval if needed.
+    # An interval of the previous multiple that is still open at that point is not completed, so preferably change
+    # multiples at time steps that are multiples of both. Energies and pressures computed by compute.thermo include the
+    # slow forces only on time steps that are multiples of all multiples, so set the period of analyze.log accordingly.
+    # Thermostats and barostats act on the inner time step. Forces with a multiple cannot be used with rigid bodies or
+    # constraint forces.
+    #
+    # \b Examples:
+    # \code
+    # integrator_mode = integrate.mode_standard(dt=0.002)
+    # integrator_mode.set_multiple(pppm, 4)
+    # integrator_mode.set_multiple(lj, 2)
+    # integrator_mode.set_multiple(lj, 1)
+    # \endcode
+    def set_multiple(self, force, multiple):
+        util.print_status_line();
+        self.check_initialization();
+
+        multiple = int(multiple);
+        if multiple < 1:
+            globals.msg.error("integrate.mode_standard: multiple must be at least 1\n");
+            raise RuntimeError('Error setting force multiple');
+
+        if multiple == 1:
+            self.force_multiples.pop(force, None);
+        else:
+            self.force_multiples[force] = multiple;
+
 ## NVT Integration via the Nos&eacute;-Hoover thermostat
 #
 # integrate.nvt performs constant volume, constant temperature simulations using the Nos&eacute;-Hoover thermostat.
@@ -86,6 +86,12 @@ class options:
         self.nz = None;
         self.linear = None;
         self.onelevel = None;
+        self.nlist = 'binned';
+        self.nthreads = None;
+        self.pin_threads = False;
+        self.huge_pages = False;
+        self.first_touch = False;
+        self.host_pool = None;
         self.autotuner_enable = True;
         self.autotuner_period = 100000;
 
@@ -104,7 +110,13 @@ class options:
                    ny=self.ny,
                    nz=self.nz,
                    linear=self.linear,
-                   onelevel=self.onelevel)
+                   onelevel=self.onelevel,
+                   nlist=self.nlist,
+                   nthreads=self.nthreads,
+                   pin_threads=self.pin_threads,
+                   huge_pages=self.huge_pages,
+                   first_touch=self.first_touch,
+                   host_pool=self.host_pool)
         return str(tmp);
 
 ## Parses command line options
@@ -127,6 +139,12 @@ def _parse_command_line():
     parser.add_option("--nz", dest="nz", help="(MPI) Number of domains along the z-direction");
     parser.add_option("--linear", dest="linear", action="store_true", default=False, help="(MPI only) Force a slab (1D) decomposition along the z-direction");
     parser.add_option("--onelevel", dest="onelevel", action="store_true", default=False, help="(MPI only) Disable two-level (node-local) decomposition");
+    parser.add_option("--nlist", dest="nlist", help="CPU neighbor list algorithm (binned or cluster)", default='binned');
+    parser.add_option("--nthreads", dest="nthreads", help="Number of CPU threads per rank (default: $HOOMD_NUM_THREADS, $OMP_NUM_THREADS or 1)");
+    parser.add_option("--pin-threads", dest="pin_threads", action="store_true", default=False, help="Pin every CPU thread to one of the cores of this rank");
+    parser.add_option("--huge-pages", dest="huge_pages", action="store_true", default=False, help="Back large arrays with transparent huge pages");
+    parser.add_option("--first-touch", dest="first_touch", action="store_true", default=False, help="Place the pages of new arrays on the NUMA node of the threads processing them");
+    parser.add_option("--host-pool", dest="host_pool", help="Maximum size of the host memory pool cache in MB (default: 256)");
     parser.add_option("--user", dest="user", help="User options");
 
     (cmd_options, args) = parser.parse_args();
@@ -137,6 +155,9 @@ def _parse_command_line():
             parser.error("--mode must be either cpu, gpu, or auto");
 
     # check for sane options
+    if not (cmd_options.nlist == "binned" or cmd_options.nlist == "cluster"):
+        parser.error("--nlist must be either binned or cluster");
+
     if cmd_options.mode == "cpu" and (cmd_options.gpu is not None):
         parser.error("--mode=cpu cannot be specified along with --gpu")
 
@@ -158,6 +179,16 @@ def _parse_command_line():
         except ValueError:
             parser.error('--notice-level must be an integer')
 
+    # convert nthreads to an integer
+    if cmd_options.nthreads is not None:
+        try:
+            cmd_options.nthreads = int(cmd_options.nthreads);
+        except ValueError:
+            parser.error('--nthreads must be an integer')
+
+        if cmd_options.nthreads < 1:
+            parser.error('--nthreads must be at least 1')
+
     # Convert nx to an integer
     if cmd_options.nx is not None:
         if not hoomd.is_MPI_available():
@@ -200,6 +231,12 @@ def _parse_command_line():
     globals.options.nz = cmd_options.nz;
     globals.options.linear = cmd_options.linear
     globals.options.onelevel = cmd_options.onelevel
+    globals.options.nlist = cmd_options.nlist;
+    globals.options.nthreads = cmd_options.nthreads;
+    globals.options.pin_threads = cmd_options.pin_threads;
+    globals.options.huge_pages = cmd_options.huge_pages;
+    globals.options.first_touch = cmd_options.first_touch;
+    globals.options.host_pool = cmd_options.host_pool;
 
     if cmd_options.notice_level is not None:
         globals.options.notice_level = cmd_options.notice_level;
@@ -287,6 +324,110 @@ def set_gpu_error_checking(gpu_error_checking):
 
     globals.options.gpu_error_checking = gpu_error_checking;
 
+## Set the number of CPU threads per rank
+#
+# \param nthreads Number of threads the CPU code paths use on every MPI rank (an integer >= 1)
+#
+# All multithreaded CPU computes share one pool of \a nthreads threads per rank. Running one rank per socket (or NUMA
+# domain) with one thread per core reduces the number of ghost particles compared to one rank per core.
+#
+# \note Overrides --nthreads on the command line. Without either, the number of threads is taken from the
+# environment variable HOOMD_NUM_THREADS or OMP_NUM_THREADS, or is 1.
+# \note Can also be called after initialization, but not during a run.
+# \sa \ref page_command_line_options
+#
+def set_num_threads(nthreads):
+    try:
+        nthreads = int(nthreads);
+    except ValueError:
+        globals.msg.error("nthreads must be an integer\n");
+        raise RuntimeError('Error setting option');
+
+    if nthreads < 1:
+        globals.msg.error("nthreads must be at least 1\n");
+        raise RuntimeError('Error setting option');
+
+    globals.options.nthreads = nthreads;
+
+    # apply immediately if the execution configuration exists already
+    if globals.exec_conf is not None:
+        globals.exec_conf.setNumThreads(nthreads);
+
+## Pin the CPU threads to cores
+#
+# \param pin_threads If True, pin every CPU thread of a rank to one core
+#
+# The cores are taken in order from the set of cores the rank is allowed to run on, thread \a i runs on the \a i-th
+# core of the set. Bind every rank to its own cores with the options of the MPI launcher or with \c taskset, otherwise
+# the threads of all ranks on a node are pinned to the same cores. Pinning is only supported on Linux.
+#
+# \note Overrides --pin-threads on the command line.
+# \note Can also be called after initialization, but not during a run.
+# \sa \ref page_command_line_options
+#
+def set_pin_threads(pin_threads=True):
+    globals.options.pin_threads = bool(pin_threads);
+
+    # apply immediately if the execution configuration exists already
+    if globals.exec_conf is not None:
+        globals.exec_conf.setPinThreads(globals.options.pin_threads);
+
+## Set how host memory is allocated
+#
+# \param huge_pages If True, advise the kernel to back arrays of 2 MiB or more with transparent huge pages
+# \param first_touch If True, new arrays are cleared by the CPU threads, each writing the part that belongs to the
+#                    particles it processes
+#
+# Large particle, neighbor list and cell list arrays on multi-socket nodes benefit from both options: huge pages reduce
+# TLB misses, and since the operating system places a page on the NUMA node of the thread that writes to it first,
+# \a first_touch keeps most memory accesses of a thread on its own node. \a first_touch has an effect only with
+# more than one thread (see set_num_threads()), and only if the threads are pinned to cores with set_pin_threads().
+#
+# \note Overrides --huge-pages and --first-touch on the command line.
+# \note Can also be called after initialization, it then applies to arrays that are allocated or resized afterwards.
+# \sa \ref page_command_line_options
+#
+def set_host_alloc(huge_pages=False, first_touch=False):
+    globals.options.huge_pages = bool(huge_pages);
+    globals.options.first_touch = bool(first_touch);
+
+    # apply immediately if the execution configuration exists already
+    if globals.exec_conf is not None:
+        globals.exec_conf.setHostAllocFlags(init._get_host_alloc_flags());
+
+## Set the size of the host memory pool cache
+#
+# \param max_cached_mb Maximum amount of freed host memory kept for reuse, in MB
+#
+# Particle data, neighbor list and communication buffers are resized often, in MPI simulations every time particles
+# migrate between ranks. Instead of returning the memory of a resized array to the operating system, hoomd keeps it
+# in a pool and reuses it for the next array of a similar size. This saves the system calls and page faults of
+# allocating new pages, at the price of holding up to \a max_cached_mb of memory that is not in use. Reused memory is
+# still cleared. Set \a max_cached_mb to 0 to disable the cache. Arrays allocated with huge pages or first touch
+# placement (see set_host_alloc()) always get new pages and do not use the cache.
+# The pool statistics are printed at the end of the profile output (see run()).
+#
+# \note Overrides --host-pool on the command line.
+# \note Can also be called after initialization.
+# \sa \ref page_command_line_options
+#
+def set_host_pool(max_cached_mb):
+    try:
+        max_cached_mb = float(max_cached_mb);
+    except ValueError:
+        globals.msg.error("max_cached_mb must be a number\n");
+        raise RuntimeError('Error setting option');
+
+    if max_cached_mb < 0:
+        globals.msg.error("max_cached_mb must not be negative\n");
+        raise RuntimeError('Error setting option');
+
+    globals.options.host_pool = max_cached_mb;
+
+    # apply immediately if the execution configuration exists already
+    if globals.exec_conf is not None:
+        globals.exec_conf.getHostMemoryPool().setMaxCachedBytes(int(max_cached_mb*1024*1024));
+
 ## Set the minimize CPU usage flag
 #
 # \param min_cpu Specifies whether GPU synchronization blocks to minimize CPU usage. (True or False)
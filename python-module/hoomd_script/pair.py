@@ -344,7 +344,11 @@ class nlist:
             if mode == "binned":
                 cl_c = hoomd.CellList(globals.system_definition);
                 globals.system.addCompute(cl_c, "auto_cl")
-                self.cpp_nlist = hoomd.NeighborListBinned(globals.system_definition, r_cut, default_r_buff, cl_c)
+                # the cluster list lets pair potentials evaluate groups of pairs at once (--nlist=cluster)
+                if globals.options.nlist == "cluster":
+                    self.cpp_nlist = hoomd.NeighborListCluster(globals.system_definition, r_cut, default_r_buff, cl_c)
+                else:
+                    self.cpp_nlist = hoomd.NeighborListBinned(globals.system_definition, r_cut, default_r_buff, cl_c)
             else:
                 globals.msg.error("Invalid neighbor list mode\n");
                 raise RuntimeError("Error creating neighbor list");
@@ -386,6 +390,9 @@ class nlist:
         for c in self.subscriber_callbacks:
             r_cut_max = max(r_cut_max, c());
 
+        # r_buff may have been changed by tune.r_buff_online()
+        self.r_buff = self.cpp_nlist.getRBuff();
+
         self.r_cut = r_cut_max;
         self.cpp_nlist.setRCut(self.r_cut, self.r_buff);
 
@@ -411,6 +418,11 @@ class nlist:
     #        run() commands. (in distance units)
     # \param dist_check When set to False, disable the distance checking logic and always regenerate the nlist every
     #        \a check_period steps
+    # \param compact (if set) When True, store the neighbor list in a compact form that uses memory in proportion to
+    #        the actual number of neighbors instead of reserving room for the maximum number of neighbors for every
+    #        particle (CPU only)
+    # \param incremental (if set) When True, rebuild only the neighbor lists around the particles that have moved too
+    #        far, instead of the whole list (CPU only, single rank)
     #
     # set_params() changes one or more parameters of the neighbor list. \a r_buff and \a check_period
     # can have a significant effect on performance. As \a r_buff is made larger, the neighbor list needs
@@ -442,6 +454,11 @@ class nlist:
     # than necessary if
     # d_max is greater than 1.0.
     #
+    # With \a incremental = True, every particle is checked against its own position at its last update. Particles
+    # that have moved more than \a r_buff/4.0 only trigger a rebuild of the neighbor lists of the particles near them.
+    # This pays off when only a small fraction of the particles is mobile, such as in glasses or in a solvent around a
+    # crystal. When more than a tenth of the particles has moved, or the box changes, the whole list is rebuilt as usual.
+    #
     # A single global neighbor list is created for the entire simulation.
     #
     # \b Examples:
@@ -450,8 +467,10 @@ class nlist:
     # nlist.set_params(check_period = 11)
     # nlist.set_params(r_buff = 0.7, check_period = 4)
     # nlist.set_params(d_max = 3.0)
+    # nlist.set_params(compact = True)
+    # nlist.set_params(incremental = True)
     # \endcode
-    def set_params(self, r_buff=None, check_period=None, d_max=None, dist_check=True):
+    def set_params(self, r_buff=None, check_period=None, d_max=None, dist_check=True, compact=None, incremental=None):
         util.print_status_line();
 
         if self.cpp_nlist is None:
@@ -469,6 +488,12 @@ class nlist:
         if d_max is not None:
             self.cpp_nlist.setMaximumDiameter(d_max);
 
+        if compact is not None:
+            self.cpp_nlist.setCompactStorage(compact);
+
+        if incremental is not None:
+            self.cpp_nlist.setIncremental(incremental);
+
     ## Resets all exclusions in the neighborlist
     #
     # \param exclusions Select which interactions should be excluded from the %pair interaction calculation.
@@ -637,6 +662,7 @@ def _update_global_nlist(r_cut):
         # otherwise, we need to update r_cut
         new_r_cut = max(r_cut, globals.neighbor_list.r_cut);
         globals.neighbor_list.r_cut = new_r_cut;
+        globals.neighbor_list.r_buff = globals.neighbor_list.cpp_nlist.getRBuff();
         globals.neighbor_list.cpp_nlist.setRCut(new_r_cut, globals.neighbor_list.r_buff);
 
     return globals.neighbor_list;
@@ -146,3 +146,53 @@ def r_buff(warmup=200000, r_min=0.05, r_max=1.0, jumps=20, steps=5000, set_max_c
 
     # return the results to the script
     return (fastest_r_buff, globals.neighbor_list.query_update_period());
+
+## Continuously tune r_buff and check_period during the following runs
+# \param enable Set to False to stop tuning, keeping the current r_buff and check_period
+# \param r_min Smallest value of r_buff to test
+# \param r_max Largest value of r_buff to test
+# \param jumps Number of different r_buff values to test
+# \param steps Number of time steps timed for each sample
+# \param max_check_period Largest check_period that will be set
+# \param period Number of \a steps long windows after which the r_buff values are timed again
+#
+# Unlike tune.r_buff(), tune.r_buff_online() does not run any time steps itself. The tuning is performed by the
+# neighbor list during the following run() commands. Every \a steps time steps, the next \a r_buff value in the
+# range from \a r_min to \a r_max is set, and the wall-clock time spent on those steps is recorded (with
+# check_period = 1). When all \a jumps values have been timed 3 times, the one with the median fastest time is set.
+# Then the shortest period between two neighbor list updates is measured, and half of it (at most
+# \a max_check_period) is set as the check_period.
+#
+# The values are timed again when the simulation conditions change (the number of neighbors per particle changes by
+# more than 10%, the neighbor list updates twice as rarely as at the time of tuning, or a dangerous build occurs) and
+# otherwise every \a period windows. The tuned values are printed on the notice stream at level 2.
+#
+# \note The r_buff values are timed during the production run. Steps that are slowed down by analyzers that only
+# run every so often will end up in the samples. Choose \a steps large compared to their periods.
+#
+# \b Examples:
+# \code
+# tune.r_buff_online()
+# tune.r_buff_online(r_min=0.2, r_max=0.8, jumps=7, steps=500)
+# tune.r_buff_online(enable=False)
+# \endcode
+#
+# \MPI_SUPPORTED
+def r_buff_online(enable=True, r_min=0.05, r_max=1.0, jumps=20, steps=200, max_check_period=20, period=100):
+    util.print_status_line();
+
+    # check if initialization has occurred
+    if not init.is_initialized():
+        globals.msg.error("Cannot tune r_buff before initialization\n");
+        raise RuntimeError('Error tuning r_buff');
+
+    # check that there is a nlist
+    if globals.neighbor_list is None:
+        globals.msg.error("Cannot tune r_buff when there is no neighbor list\n");
+        raise RuntimeError('Error tuning r_buff');
+
+    if enable:
+        globals.neighbor_list.cpp_nlist.enableBufferTuning(float(r_min), float(r_max), int(jumps), int(steps),
+                                                           int(max_check_period), int(period));
+    else:
+        globals.neighbor_list.cpp_nlist.disableBufferTuning();
@@ -549,5 +549,87 @@ class box_resize(_updater):
         if scale_particles is not None:
             self.cpp_updater.setParams(scale_particles);
 
+## Balances the number of particles between the MPI ranks
+#
+# Every \a period time steps, the boundaries of the domains are moved to even out the number of particles per rank.
+# The domains are separated by split planes along every direction. When the most loaded slab of domains along a
+# direction holds more than \a tolerance times the average number of particles, the width of every slab is scaled
+# by the ratio of the average to its particle count. The scale factor is limited to 1 +/- \a max_scale per update,
+# so inhomogeneous systems are balanced over several updates. A domain never becomes narrower than twice the
+# ghost layer width.
+#
+# update.balance can only be used in multi-processor simulations. It cannot be combined with charge.pppm.
+#
+# \MPI_SUPPORTED
+class balance(_updater):
+    ## Initialize the load balancer
+    #
+    # \param period The domains are balanced every \a period time steps
+    # \param tolerance Maximum tolerated ratio of the largest particle count of a slab to the average
+    # \param max_scale Maximum relative change of a domain width per update
+    # \param x If True, balance along the x direction
+    # \param y If True, balance along the y direction
+    # \param z If True, balance along the z direction
+    #
+    # \b Examples:
+    # \code
+    # update.balance()
+    # balancer = update.balance(period=500, tolerance=1.1, z=False)
+    # \endcode
+    #
+    # \a period can be a function: see \ref variable_period_docs for details
+    def __init__(self, period=1000, tolerance=1.05, max_scale=0.05, x=True, y=True, z=True):
+        util.print_status_line();
+
+        # initialize base class
+        _updater.__init__(self);
+
+        decomposition = None;
+        if hoomd.is_MPI_available():
+            decomposition = globals.system_definition.getParticleData().getDomainDecomposition();
+
+        if decomposition is None:
+            globals.msg.error("update.balance requires a multi-processor simulation.\n");
+            raise RuntimeError('Error creating load balancer');
+
+        # create the c++ mirror class
+        self.cpp_updater = hoomd.LoadBalancer(globals.system_definition, decomposition);
+        self.setupUpdater(period);
+
+        util._disable_status_lines = True;
+        self.set_params(tolerance=tolerance, max_scale=max_scale, x=x, y=y, z=z);
+        util._disable_status_lines = False;
+
+    ## Change load balancer parameters
+    #
+    # \param tolerance Maximum tolerated ratio of the largest particle count of a slab to the average (if set)
+    # \param max_scale Maximum relative change of a domain width per update (if set)
+    # \param x If True, balance along the x direction (if set)
+    # \param y If True, balance along the y direction (if set)
+    # \param z If True, balance along the z direction (if set)
+    #
+    # \b Examples:
+    # \code
+    # balancer.set_params(tolerance=1.02)
+    # balancer.set_params(max_scale=0.1, x=False)
+    # \endcode
+    def set_params(self, tolerance=None, max_scale=None, x=None, y=None, z=None):
+        util.print_status_line();
+        self.check_initialization();
+
+        if tolerance is not None:
+            self.cpp_updater.setTolerance(tolerance);
+        if max_scale is not None:
+            if max_scale <= 0 or max_scale >= 1:
+                globals.msg.error("update.balance: max_scale must be between 0 and 1\n");
+                raise RuntimeError('Error setting load balancer parameters');
+            self.cpp_updater.setMaxScale(max_scale);
+        if x is not None:
+            self.cpp_updater.enableDimension(0, x);
+        if y is not None:
+            self.cpp_updater.enableDimension(1, y);
+        if z is not None:
+            self.cpp_updater.enableDimension(2, z);
+
 # Global current id counter to assign updaters unique names
 _updater.cur_id = 0;
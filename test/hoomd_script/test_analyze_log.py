@@ -4,6 +4,7 @@
 from hoomd_script import *
 import unittest
 import os
+import struct
 
 # unit tests for analyze.log
 class analyze_log_tests (unittest.TestCase):
@@ -33,6 +34,71 @@ class analyze_log_tests (unittest.TestCase):
         ana = analyze.log(quantities = ['test1', 'test2', 'test3'], period = lambda n: n*10, filename="test_analyze_log.log");
         run(100);
 
+    # test buffered text output, all rows must be in the file after the run
+    def test_buffered(self):
+        ana = analyze.log(quantities = ['test1', 'test2'], period = 10, filename="test_analyze_log.log", overwrite=True,
+                          buffer_rows=4);
+        run(100);
+        if (comm.get_rank()==0):
+            f = open("test_analyze_log.log");
+            lines = f.readlines();
+            f.close();
+            self.assertEqual(len(lines), 11);
+        ana.set_params(buffer_rows=1);
+        run(10);
+        self.assertRaises(RuntimeError, ana.set_params, buffer_rows=0);
+
+    # test binary output, parse the whole file and check every row
+    def test_binary(self):
+        analyze.log(quantities = ['num_particles', 'test1', 'time'], period = 10, filename="test_analyze_log.log",
+                    overwrite=True, buffer_rows=3, binary=True);
+        run(100);
+        if (comm.get_rank()==0):
+            f = open("test_analyze_log.log", 'rb');
+            data = f.read();
+            f.close();
+
+            self.assertEqual(data[0:4], b'HLOG');
+            (version,) = struct.unpack_from('=I', data, 4);
+            self.assertEqual(version, 1);
+            pos = 8;
+
+            # header record
+            (tag, n_quantities) = struct.unpack_from('=II', data, pos);
+            pos += 8;
+            self.assertEqual(tag, 1);
+            names = [];
+            for i in range(n_quantities):
+                (length,) = struct.unpack_from('=I', data, pos);
+                pos += 4;
+                names.append(data[pos:pos+length].decode());
+                pos += length;
+            self.assertEqual(names, ['num_particles', 'test1', 'time']);
+
+            # data records, in blocks of 3 rows and the remaining row written by the flush at the end of the run
+            block_rows = [];
+            timesteps = [];
+            columns = [[], [], []];
+            while pos < len(data):
+                (tag, n_rows, n_columns) = struct.unpack_from('=III', data, pos);
+                pos += 12;
+                self.assertEqual(tag, 2);
+                self.assertEqual(n_columns, 3);
+                block_rows.append(n_rows);
+                timesteps += list(struct.unpack_from('=%dI' % n_rows, data, pos));
+                pos += 4*n_rows;
+                for c in range(n_columns):
+                    columns[c] += list(struct.unpack_from('=%dd' % n_rows, data, pos));
+                    pos += 8*n_rows;
+            self.assertEqual(pos, len(data));
+
+            self.assertEqual(block_rows, [3, 3, 3, 1]);
+            self.assertEqual(timesteps, list(range(0, 100, 10)));
+            self.assertEqual(columns[0], [100.0]*10);
+            self.assertEqual(columns[1], [0.0]*10);
+            self.assertEqual(columns[2], sorted(columns[2]));
+            self.assertTrue(columns[2][0] >= 0.0);
+
     # test the initialization checks
     def test_init_checks(self):
         ana = analyze.log(quantities = ['test1', 'test2', 'test3'], period = 10, filename="test_analyze_log.log");
@@ -38,6 +38,17 @@ class integrate_nve_tests (unittest.TestCase):
         nve.set_params(limit=0.1);
         nve.set_params(zero_force=False);
 
+    # test forces with a multiple
+    def test_set_multiple(self):
+        all = group.all();
+        fc = force.constant(fx=0.0, fy=0.2, fz=0.0);
+        mode = integrate.mode_standard(dt=0.005);
+        mode.set_multiple(fc, 4);
+        integrate.nve(all);
+        run(12);
+        mode.set_multiple(fc, 1);
+        run(4);
+
     # test w/ empty group
     def test_empty(self):
         empty = group.cuboid(name="empty", xmin=-100, xmax=-100, ymin=-100, ymax=-100, zmin=-100, zmax=-100)
@@ -634,3 +634,101 @@ BOOST_AUTO_TEST_CASE( CellListGPU_large )
     celllist_large_test<CellListGPU>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 #endif
+
+//! Validate that the compact layout holds the same cells as the default layout
+void celllist_compact_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    unsigned int N = 5000;
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap;
+    snap = rand_init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // pack a quarter of the particles into a small droplet to get an inhomogeneous occupancy
+    for (unsigned int i = 0; i < N/4; i++)
+        pdata->setPosition(i, make_scalar3(Scalar(0.1)*Scalar(i % 10), Scalar(0.1)*Scalar((i/10) % 10), Scalar(0.01)*Scalar(i/100)));
+
+    boost::shared_ptr<CellList> cl1(new CellList(sysdef));
+    boost::shared_ptr<CellList> cl2(new CellList(sysdef));
+    cl2->setCompact(true);
+    BOOST_CHECK(cl2->getCompact());
+
+    boost::shared_ptr<CellList> cls[2] = {cl1, cl2};
+    for (unsigned int i = 0; i < 2; i++)
+        {
+        cls[i]->setNominalWidth(Scalar(3.0));
+        cls[i]->setRadius(1);
+        cls[i]->setComputeTDB(true);
+        cls[i]->setComputeOrientation(true);
+        cls[i]->setComputeIdx(true);
+        cls[i]->setFlagType();
+        cls[i]->compute(0);
+        }
+
+    // the compact layout is sized by the number of particles
+    BOOST_CHECK(cl2->getXYZFArray().getNumElements() < cl1->getXYZFArray().getNumElements());
+
+    unsigned int ncell = cl1->getCellIndexer().getNumElements();
+    BOOST_REQUIRE_EQUAL_UINT(cl2->getCellIndexer().getNumElements(), ncell);
+
+    ArrayHandle<unsigned int> h_cell_size1(cl1->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start1(cl1->getCellStartArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf1(cl1->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_tdb1(cl1->getTDBArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation1(cl1->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_idx1(cl1->getIndexArray(), access_location::host, access_mode::read);
+
+    ArrayHandle<unsigned int> h_cell_size2(cl2->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_start2(cl2->getCellStartArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf2(cl2->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_tdb2(cl2->getTDBArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation2(cl2->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_idx2(cl2->getIndexArray(), access_location::host, access_mode::read);
+
+    // the default layout is also accessible through cell_start
+    Index2D cli = cl1->getCellListIndexer();
+    BOOST_CHECK_EQUAL_UINT(h_cell_start1.data[7], cli(0, 7));
+
+    unsigned int total = 0;
+    for (unsigned int cell = 0; cell < ncell; cell++)
+        {
+        BOOST_REQUIRE_EQUAL_UINT(h_cell_size1.data[cell], h_cell_size2.data[cell]);
+        BOOST_REQUIRE_EQUAL_UINT(h_cell_start2.data[cell], total);
+        total += h_cell_size2.data[cell];
+
+        // both layouts store the members of a cell in the order of the particle index
+        for (unsigned int offset = 0; offset < h_cell_size1.data[cell]; offset++)
+            {
+            unsigned int k1 = h_cell_start1.data[cell] + offset;
+            unsigned int k2 = h_cell_start2.data[cell] + offset;
+            BOOST_CHECK_EQUAL_UINT(h_idx1.data[k1], h_idx2.data[k2]);
+            BOOST_CHECK_EQUAL(h_xyzf1.data[k1].x, h_xyzf2.data[k2].x);
+            BOOST_CHECK_EQUAL(h_xyzf1.data[k1].y, h_xyzf2.data[k2].y);
+            BOOST_CHECK_EQUAL(h_xyzf1.data[k1].z, h_xyzf2.data[k2].z);
+            BOOST_CHECK_EQUAL(h_xyzf1.data[k1].w, h_xyzf2.data[k2].w);
+            BOOST_CHECK_EQUAL(h_tdb1.data[k1].x, h_tdb2.data[k2].x);
+            BOOST_CHECK_EQUAL(h_tdb1.data[k1].y, h_tdb2.data[k2].y);
+            BOOST_CHECK_EQUAL(__scalar_as_int(h_tdb1.data[k1].z), __scalar_as_int(h_tdb2.data[k2].z));
+            BOOST_CHECK_EQUAL(h_orientation1.data[k1].x, h_orientation2.data[k2].x);
+            BOOST_CHECK_EQUAL(h_orientation1.data[k1].w, h_orientation2.data[k2].w);
+            }
+        }
+
+    BOOST_CHECK_EQUAL_UINT(total, N);
+    BOOST_CHECK_EQUAL_UINT(h_cell_start2.data[ncell], N);
+    }
+
+//! boost test case for the compact layout
+BOOST_AUTO_TEST_CASE( CellList_compact )
+    {
+    celllist_compact_test(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! boost test case for the multithreaded build of the compact layout
+BOOST_AUTO_TEST_CASE( CellList_compact_threads )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(3);
+    celllist_compact_test(exec_conf);
+    }
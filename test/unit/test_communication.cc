@@ -65,10 +65,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ExecutionConfiguration.h"
 #include "Communicator.h"
 #include "DomainDecomposition.h"
+#include "LoadBalancer.h"
 
 #include "ConstForceCompute.h"
 #include "TwoStepNVE.h"
 #include "IntegratorTwoStep.h"
+#include "ComputeThermo.h"
+#include "Logger.h"
+#include "AllPairPotentials.h"
+#include "NeighborListBinned.h"
 
 #ifdef ENABLE_CUDA
 #include "CommunicatorGPU.h"
@@ -221,6 +226,91 @@ void test_domain_decomposition(boost::shared_ptr<ExecutionConfiguration> exec_co
     BOOST_CHECK_CLOSE(pos.z,  0.5, tol);
     }
 
+//! Test that the LoadBalancer moves the split planes and the particles follow
+void test_load_balancer(communicator_creator comm_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    BOOST_REQUIRE_EQUAL(size,8);
+
+    // create a system with sixteen particles
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(16,          // number of particles
+                                                             BoxDim(2.0), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    boost::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    // four particles in every column of domains along x, three of them in the lower half
+    Scalar x[4] = {-0.8, -0.6, -0.05, 0.5};
+    for (unsigned int q = 0; q < 4; ++q)
+        for (unsigned int i = 0; i < 4; ++i)
+            pdata->setPosition(4*q+i, make_scalar3(x[i], (q % 2) ? 0.5 : -0.5, (q / 2) ? 0.5 : -0.5), false);
+
+    SnapshotParticleData snap(16);
+    pdata->takeSnapshot(snap);
+
+    // initialize a 2x2x2 domain decomposition on processor with rank 0
+    boost::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(),2,2,2));
+
+    boost::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+    comm->setGhostLayerWidth(Scalar(0.1));
+
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    unsigned int grid_x = decomposition->getGridPos().x;
+    BOOST_CHECK_EQUAL(pdata->getN(), grid_x ? 1 : 3);
+
+    boost::shared_ptr<LoadBalancer> balancer(new LoadBalancer(sysdef, decomposition));
+    balancer->setCommunicator(comm);
+    balancer->setMaxScale(Scalar(0.5));
+    balancer->update(0);
+
+    // the lower slab shrinks by a factor 2/3, the upper one grows by the maximum factor 1.5
+    Scalar frac = (Scalar(0.5)*Scalar(2.0/3.0))/(Scalar(0.5)*Scalar(2.0/3.0) + Scalar(0.5)*Scalar(1.5));
+    const std::vector<Scalar>& cum_frac_x = decomposition->getCumulativeFractions(0);
+    BOOST_REQUIRE_EQUAL(cum_frac_x.size(), 3);
+    BOOST_CHECK_SMALL(cum_frac_x[0], tol_small);
+    BOOST_CHECK_CLOSE(cum_frac_x[1], frac, tol);
+    BOOST_CHECK_CLOSE(cum_frac_x[2], 1.0, tol);
+
+    // the y and z directions are balanced already
+    BOOST_CHECK_CLOSE(decomposition->getCumulativeFractions(1)[1], 0.5, tol);
+    BOOST_CHECK_CLOSE(decomposition->getCumulativeFractions(2)[1], 0.5, tol);
+    BOOST_CHECK(! decomposition->isUniform());
+
+    // the local box follows the split planes
+    Scalar split = Scalar(-1.0) + Scalar(2.0)*frac;
+    if (grid_x)
+        BOOST_CHECK_CLOSE(pdata->getBox().getLo().x, split, tol);
+    else
+        BOOST_CHECK_CLOSE(pdata->getBox().getHi().x, split, tol);
+
+    // migrate atoms
+    comm->migrateParticles();
+
+    // the particles close to the old boundary have moved into the upper slab
+    BOOST_CHECK_EQUAL(pdata->getN(), 2);
+    for (unsigned int q = 0; q < 4; ++q)
+        {
+        BOOST_CHECK_EQUAL(pdata->getOwnerRank(4*q+0) % 2, 0);
+        BOOST_CHECK_EQUAL(pdata->getOwnerRank(4*q+1) % 2, 0);
+        BOOST_CHECK_EQUAL(pdata->getOwnerRank(4*q+2) % 2, 1);
+        BOOST_CHECK_EQUAL(pdata->getOwnerRank(4*q+3) % 2, 1);
+        }
+
+    // a balanced system is left alone
+    balancer->update(1);
+    BOOST_CHECK_CLOSE(decomposition->getCumulativeFractions(0)[1], frac, tol);
+    }
+
 //! Test particle migration of Communicator
 void test_communicator_migrate(communicator_creator comm_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf,
     BoxDim dest_box)
@@ -2649,6 +2739,210 @@ boost::shared_ptr<Communicator> gpu_communicator_creator(boost::shared_ptr<Syste
     }
 #endif
 
+//! Helper callback for test_reduction_buffer, stores the reduced value
+void store_reduced(double *dest, const double *values)
+    {
+    *dest = values[0];
+    }
+
+//! Test that the ReductionBuffer sums all posted values with one collective
+void test_reduction_buffer(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    BOOST_REQUIRE_EQUAL(size,8);
+
+    double rank = exec_conf->getRank();
+    int key_a, key_b;
+    double callback_value = 0.0;
+
+    ReductionBuffer buf(exec_conf);
+    BOOST_CHECK(!buf.isCollecting());
+
+    buf.begin();
+    BOOST_CHECK(buf.isCollecting());
+    double a[2] = {rank, 1.0};
+    buf.post(&key_a, a, 2);
+    double b = 2.0*rank;
+    buf.post(&key_b, &b, 1, bind(store_reduced, &callback_value, _1));
+    // posting the same key again is ignored
+    buf.post(&key_a, a, 2);
+
+    // no results before the reduction
+    BOOST_CHECK(buf.getResult(&key_a) == NULL);
+
+    buf.reduce();
+    BOOST_CHECK_EQUAL(buf.getNumReductions(), 1);
+
+    const double *result_a = buf.getResult(&key_a);
+    const double *result_b = buf.getResult(&key_b);
+    BOOST_REQUIRE(result_a);
+    BOOST_REQUIRE(result_b);
+    BOOST_CHECK_CLOSE(result_a[0], 28.0, tol_small);
+    BOOST_CHECK_CLOSE(result_a[1], 8.0, tol_small);
+    BOOST_CHECK_CLOSE(result_b[0], 56.0, tol_small);
+    BOOST_CHECK_CLOSE(callback_value, 56.0, tol_small);
+
+    buf.end();
+    BOOST_CHECK(buf.getResult(&key_a) == NULL);
+
+    // an empty buffer does not communicate
+    buf.begin();
+    buf.reduce();
+    buf.end();
+    BOOST_CHECK_EQUAL(buf.getNumReductions(), 1);
+    }
+
+//! Compute for test_logger_reduction that throws when its log quantity is requested
+class ThrowingLogCompute : public Compute
+    {
+    public:
+        //! Constructor
+        ThrowingLogCompute(boost::shared_ptr<SystemDefinition> sysdef)
+            : Compute(sysdef)
+            {
+            }
+
+        //! Does nothing
+        virtual void compute(unsigned int timestep)
+            {
+            }
+
+        //! Provides the quantity "throws"
+        virtual std::vector< std::string > getProvidedLogQuantities()
+            {
+            return std::vector< std::string >(1, "throws");
+            }
+
+        //! Always throws
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep)
+            {
+            throw runtime_error("Error getting log value");
+            }
+    };
+
+//! Test that the Logger logs the same global sums with the fused reduction as the computes do on their own
+void test_logger_reduction(communicator_creator comm_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    BOOST_REQUIRE_EQUAL(size,8);
+
+    // a slightly distorted simple cubic lattice, 27 particles in every domain
+    unsigned int n = 216;
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n,           // number of particles
+                                                             BoxDim(7.2), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    SnapshotParticleData snap(n);
+    snap.type_mapping.push_back("A");
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        snap.pos[i] = make_scalar3(Scalar(-3.0) + Scalar(1.2)*Scalar(i % 6) + Scalar(0.01)*Scalar(i % 3),
+                                   Scalar(-3.0) + Scalar(1.2)*Scalar((i / 6) % 6) - Scalar(0.02)*Scalar(i % 5),
+                                   Scalar(-3.0) + Scalar(1.2)*Scalar(i / 36) + Scalar(0.03)*Scalar(i % 7));
+        snap.vel[i] = make_scalar3(Scalar(0.1)*Scalar(i % 3), -Scalar(0.2)*Scalar(i % 2), Scalar(0.05)*Scalar(i % 5));
+        }
+
+    boost::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(),2,2,2));
+    boost::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+    comm->setGhostLayerWidth(Scalar(1.6));
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    boost::shared_ptr<NeighborList> nlist(new NeighborListBinned(sysdef, Scalar(1.5), Scalar(0.1)));
+    nlist->setCommunicator(comm);
+    boost::shared_ptr<PotentialPairLJ> fc(new PotentialPairLJ(sysdef, nlist));
+    fc->setRcut(0, 0, Scalar(1.5));
+    fc->setParams(0, 0, make_scalar2(Scalar(4.0), Scalar(4.0)));
+    fc->setCommunicator(comm);
+
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, n-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    // the thermo logged with the fused reduction, and one that reduces its own sums
+    boost::shared_ptr<ComputeThermo> thermo(new ComputeThermo(sysdef, group_all));
+    boost::shared_ptr<ComputeThermo> thermo_ref(new ComputeThermo(sysdef, group_all, "_ref"));
+    thermo->setCommunicator(comm);
+    thermo_ref->setCommunicator(comm);
+
+    boost::shared_ptr<IntegratorTwoStep> integrator(new IntegratorTwoStep(sysdef, Scalar(0.001)));
+    integrator->addIntegrationMethod(boost::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef, group_all)));
+    integrator->addForceCompute(fc);
+    integrator->setCommunicator(comm);
+    integrator->prepRun(0);
+
+    boost::shared_ptr<Logger> logger(new Logger(sysdef, "test_logger_reduction.log", "", true));
+    logger->setCommunicator(comm);
+    logger->registerCompute(fc);
+    logger->registerCompute(thermo);
+
+    std::vector<std::string> quantities;
+    quantities.push_back("pair_lj_energy");
+    quantities.push_back("potential_energy");
+    quantities.push_back("kinetic_energy");
+    quantities.push_back("temperature");
+    quantities.push_back("pressure");
+    quantities.push_back("pressure_xx");
+    quantities.push_back("pressure_xy");
+    quantities.push_back("pressure_zz");
+    logger->setLoggedQuantities(quantities);
+
+    ReductionBuffer& reduction_buffer = comm->getReductionBuffer();
+    for (unsigned int step = 0; step < 3; step++)
+        {
+        unsigned int n_reductions = reduction_buffer.getNumReductions();
+        logger->analyze(step);
+
+        // the pair energy and the thermo are resolved by a single collective
+        BOOST_CHECK_EQUAL(reduction_buffer.getNumReductions(), n_reductions + 1);
+        BOOST_CHECK(!reduction_buffer.isCollecting());
+
+        // values of the computes outside of the Logger, every one with its own reduction
+        thermo_ref->compute(step);
+        BOOST_CHECK_CLOSE(logger->getCachedQuantity("pair_lj_energy"), fc->getLogValue("pair_lj_energy", step), tol_small);
+        BOOST_CHECK(fabs(logger->getCachedQuantity("pair_lj_energy")) > Scalar(0.1));
+        for (unsigned int i = 1; i < quantities.size(); i++)
+            {
+            Scalar ref = thermo_ref->getLogValue(quantities[i] + "_ref", step);
+            Scalar logged = logger->getCachedQuantity(quantities[i]);
+            if (fabs(ref) > tol_small)
+                BOOST_CHECK_CLOSE(logged, ref, tol_small);
+            else
+                BOOST_CHECK_SMALL(fabs(logged), tol_small);
+            }
+
+        integrator->update(step);
+        }
+
+    // a quantity that throws while the partial sums are collected must leave the buffer usable
+    boost::shared_ptr<ThrowingLogCompute> thrower(new ThrowingLogCompute(sysdef));
+    logger->registerCompute(thrower);
+    quantities.push_back("throws");
+    logger->setLoggedQuantities(quantities);
+    BOOST_CHECK_THROW(logger->analyze(3), runtime_error);
+    BOOST_CHECK(!reduction_buffer.isCollecting());
+
+    // the computes reduce their own sums again
+    thermo->compute(4);
+    thermo_ref->compute(4);
+    BOOST_CHECK_CLOSE(thermo->getLogValue("kinetic_energy", 4), thermo_ref->getLogValue("kinetic_energy_ref", 4), tol_small);
+    BOOST_CHECK(thermo->getLogValue("kinetic_energy", 4) > Scalar(0.1));
+
+    logger.reset();
+    if (exec_conf->isRoot())
+        unlink("test_logger_reduction.log");
+    }
+
 //! Tests particle distribution
 BOOST_AUTO_TEST_CASE( DomainDecomposition_test )
     {
@@ -2668,6 +2962,23 @@ BOOST_AUTO_TEST_CASE( communicator_migrate_test )
     test_communicator_migrate(communicator_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),BoxDim(1.0,-0.5,0.7,0.3));
     }
 
+BOOST_AUTO_TEST_CASE( load_balancer_test )
+    {
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_load_balancer(communicator_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+BOOST_AUTO_TEST_CASE( reduction_buffer_test )
+    {
+    test_reduction_buffer(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+BOOST_AUTO_TEST_CASE( logger_reduction_test )
+    {
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_logger_reduction(communicator_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 BOOST_AUTO_TEST_CASE( communicator_ghosts_test )
     {
     communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
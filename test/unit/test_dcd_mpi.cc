@@ -0,0 +1,178 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! name the boost unit test module
+#define BOOST_TEST_MODULE DCDDumpWriterTestsMPI
+#include "boost_utf_configure.h"
+
+#include "HOOMDMath.h"
+#include "ExecutionConfiguration.h"
+#include "SystemDefinition.h"
+#include "SnapshotSystemData.h"
+#include "ParticleGroup.h"
+#include "DCDDumpWriter.h"
+
+#include <boost/python.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <fstream>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Communicator.h"
+#include "DomainDecomposition.h"
+
+using namespace std;
+using namespace boost;
+
+/*! \file test_dcd_mpi.cc
+    \brief Compares DCD files written collectively by a decomposed system against the serial writer
+    \ingroup unit_tests
+*/
+
+//! Read a whole file into memory
+vector<char> read_file(const string& fname)
+    {
+    ifstream f(fname.c_str(), ios::in | ios::binary);
+    return vector<char>((istreambuf_iterator<char>(f)), istreambuf_iterator<char>());
+    }
+
+//! Write two frames, then append two more frames (one of them already in the file) with a new writer
+/*! \param sysdef System to write
+    \param group Group of particles to write
+    \param comm Communicator of the decomposed system, or NULL for the serial writer
+    \param fname File to write
+*/
+void write_dcd(boost::shared_ptr<SystemDefinition> sysdef,
+               boost::shared_ptr<ParticleGroup> group,
+               boost::shared_ptr<Communicator> comm,
+               const string& fname)
+    {
+        {
+        boost::shared_ptr<DCDDumpWriter> writer(new DCDDumpWriter(sysdef, fname, 10, group, true));
+        writer->setUnwrapFull(true);
+        if (comm)
+            writer->setCommunicator(comm);
+        writer->analyze(0);
+        writer->analyze(10);
+        }
+
+    boost::shared_ptr<DCDDumpWriter> writer(new DCDDumpWriter(sysdef, fname, 10, group, false));
+    writer->setUnwrapFull(true);
+    if (comm)
+        writer->setCommunicator(comm);
+    writer->analyze(10);
+    writer->analyze(20);
+    }
+
+//! Write a group of every third particle on 8 ranks and compare the file to the one of a single rank
+BOOST_AUTO_TEST_CASE( DCDDumpWriter_MPI_group_append )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // a random system with particles in all images, identical on all ranks
+    unsigned int N = 1000;
+    BoxDim box(10.0, 12.0, 14.0);
+    boost::shared_ptr<SnapshotSystemData> snap(new SnapshotSystemData());
+    snap->global_box = box;
+    snap->particle_data.resize(N);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.type_mapping.push_back("B");
+    snap->particle_data.type_mapping.push_back("C");
+
+    srand(12345);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        Scalar3 f = make_scalar3(Scalar(rand())/Scalar(RAND_MAX), Scalar(rand())/Scalar(RAND_MAX),
+                                 Scalar(rand())/Scalar(RAND_MAX));
+        Scalar3 pos = box.makeCoordinates(f);
+        int3 img = make_int3(0,0,0);
+        box.wrap(pos, img);
+        snap->particle_data.pos[i] = pos;
+        snap->particle_data.image[i] = make_int3(rand() % 3 - 1, rand() % 3 - 1, rand() % 3 - 1);
+        snap->particle_data.type[i] = i % 3;
+        }
+
+    // the group members are spread over all domains, and their tags are not contiguous
+    boost::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL()));
+    boost::shared_ptr<SystemDefinition> sysdef_1(new SystemDefinition(snap, exec_conf, decomposition));
+    boost::shared_ptr<Communicator> comm(new Communicator(sysdef_1, decomposition));
+    boost::shared_ptr<ParticleSelector> selector_1(new ParticleSelectorType(sysdef_1, 1, 1));
+    boost::shared_ptr<ParticleGroup> group_1(new ParticleGroup(sysdef_1, selector_1));
+    BOOST_REQUIRE_EQUAL(group_1->getNumMembersGlobal(), N/3);
+
+    write_dcd(sysdef_1, group_1, comm, "test_dcd_mpi.dcd");
+
+    // the reference file is written on rank 0 only
+    if (exec_conf->getRank() == 0)
+        {
+        boost::shared_ptr<SystemDefinition> sysdef_2(new SystemDefinition(snap, exec_conf));
+        boost::shared_ptr<ParticleSelector> selector_2(new ParticleSelectorType(sysdef_2, 1, 1));
+        boost::shared_ptr<ParticleGroup> group_2(new ParticleGroup(sysdef_2, selector_2));
+
+        write_dcd(sysdef_2, group_2, boost::shared_ptr<Communicator>(), "test_dcd_serial.dcd");
+
+        vector<char> data_1 = read_file("test_dcd_mpi.dcd");
+        vector<char> data_2 = read_file("test_dcd_serial.dcd");
+
+        // file header, 3 frames of a frame header and 3 coordinate records
+        unsigned int n_members = N/3;
+        BOOST_REQUIRE_EQUAL(data_2.size(), 276 + 3*(56 + 3*(8 + 4*n_members)));
+        BOOST_REQUIRE_EQUAL(data_1.size(), data_2.size());
+
+        // the remark at bytes 180-259 holds the creation time, which may differ by a minute
+        for (unsigned int i = 0; i < data_1.size(); i++)
+            if (i < 180 || i >= 260)
+                BOOST_REQUIRE_EQUAL(int(data_1[i]), int(data_2[i]));
+
+        remove("test_dcd_mpi.dcd");
+        remove("test_dcd_serial.dcd");
+        }
+    }
@@ -139,6 +139,137 @@ BOOST_AUTO_TEST_CASE( GPUArray_basic_tests )
 
     }
 
+//! test the host allocation flags
+BOOST_AUTO_TEST_CASE( GPUArray_host_alloc_tests )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(3);
+    exec_conf->setHostAllocFlags(host_alloc::huge_pages | host_alloc::first_touch);
+
+    // a 2D array larger than a huge page, cleared by all threads
+    GPUArray<Scalar> a(1000, 300, exec_conf);
+    BOOST_CHECK_EQUAL(a.getHostAllocFlags(), (unsigned int)(host_alloc::huge_pages | host_alloc::first_touch));
+        {
+        ArrayHandle<Scalar> h_a(a, access_location::host, access_mode::readwrite);
+        BOOST_CHECK_EQUAL((size_t)h_a.data % 64, (size_t)0);
+        for (unsigned int i = 0; i < a.getNumElements(); i++)
+            {
+            BOOST_REQUIRE_EQUAL(h_a.data[i], Scalar(0.0));
+            h_a.data[i] = Scalar(i);
+            }
+        }
+
+    // the flags of a single array can be overridden, the contents are kept
+    a.setHostAllocFlags(host_alloc::none);
+    BOOST_CHECK_EQUAL(a.getHostAllocFlags(), (unsigned int)host_alloc::none);
+    a.resize(1100, 300);
+        {
+        ArrayHandle<Scalar> h_a(a, access_location::host, access_mode::read);
+        BOOST_CHECK_EQUAL((size_t)h_a.data % 64, (size_t)0);
+        unsigned int pitch = a.getPitch();
+        for (unsigned int j = 0; j < 300; j++)
+            for (unsigned int i = 0; i < 1100; i++)
+                BOOST_REQUIRE_EQUAL(h_a.data[j*pitch+i], (i < 1008) ? Scalar(j*1008+i) : Scalar(0.0));
+        }
+
+    // resizing a vector follows the flags of the execution configuration
+    GPUVector<unsigned int> v(exec_conf);
+    for (unsigned int i = 0; i < 100000; i++)
+        v.push_back(i);
+        {
+        ArrayHandle<unsigned int> h_v(v, access_location::host, access_mode::read);
+        BOOST_CHECK_EQUAL((size_t)h_v.data % 64, (size_t)0);
+        for (unsigned int i = 0; i < 100000; i++)
+            BOOST_REQUIRE_EQUAL(h_v.data[i], i);
+        }
+    }
+
+//! test the host memory pool
+BOOST_AUTO_TEST_CASE( HostMemoryPool_tests )
+    {
+    // four size classes per power of two
+    BOOST_CHECK_EQUAL(HostMemoryPool::getSizeClass(1), (size_t)64);
+    BOOST_CHECK_EQUAL(HostMemoryPool::getSizeClass(64), (size_t)64);
+    BOOST_CHECK_EQUAL(HostMemoryPool::getSizeClass(65), (size_t)80);
+    BOOST_CHECK_EQUAL(HostMemoryPool::getSizeClass(128), (size_t)128);
+    BOOST_CHECK_EQUAL(HostMemoryPool::getSizeClass(1000), (size_t)1024);
+    BOOST_CHECK_EQUAL(HostMemoryPool::getSizeClass(1025), (size_t)1280);
+
+    HostMemoryPool pool(4096);
+    void *a = pool.allocate(1000, 64);
+    BOOST_REQUIRE(a != NULL);
+    BOOST_CHECK_EQUAL((size_t)a % 64, (size_t)0);
+    BOOST_CHECK_EQUAL(pool.getBytesInUse(), (size_t)1024);
+
+    // a freed block serves requests of the same class and alignment
+    pool.deallocate(a);
+    BOOST_CHECK_EQUAL(pool.getBytesInUse(), (size_t)0);
+    BOOST_CHECK_EQUAL(pool.getBytesCached(), (size_t)1024);
+    void *b = pool.allocate(900, 64);
+    BOOST_CHECK_EQUAL(b, a);
+    void *c = pool.allocate(900, 128);
+    BOOST_CHECK(c != a);
+    BOOST_CHECK_EQUAL((size_t)c % 128, (size_t)0);
+    BOOST_CHECK_EQUAL(pool.getNumAllocations(), 3u);
+    BOOST_CHECK_EQUAL(pool.getNumHits(), 1u);
+    BOOST_CHECK_EQUAL(pool.getPeakBytes(), (size_t)2048);
+
+    // the cache is limited, the largest blocks are released first
+    void *d = pool.allocate(4000, 64);
+    pool.deallocate(b);
+    pool.deallocate(c);
+    pool.deallocate(d);
+    BOOST_CHECK_EQUAL(pool.getBytesCached(), (size_t)2048);
+    pool.setMaxCachedBytes(1024);
+    BOOST_CHECK_EQUAL(pool.getBytesCached(), (size_t)1024);
+    pool.releaseCache();
+    BOOST_CHECK_EQUAL(pool.getBytesCached(), (size_t)0);
+
+    // fresh blocks bypass the cache in both directions
+    void *g = pool.allocate(1000, 64);
+    pool.deallocate(g);
+    pool.resetStats();
+    void *h = pool.allocate(1000, 64, true);
+    BOOST_CHECK_EQUAL(pool.getNumHits(), 0u);
+    pool.deallocate(h);
+    BOOST_CHECK_EQUAL(pool.getBytesCached(), (size_t)1024);
+    pool.releaseCache();
+
+    // arrays that are resized back and forth reuse their blocks, reused memory is cleared
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    HostMemoryPool& exec_pool = exec_conf->getHostMemoryPool();
+    GPUArray<unsigned int> e(1000, exec_conf);
+    exec_pool.resetStats();
+    for (unsigned int n = 0; n < 10; n++)
+        {
+            {
+            ArrayHandle<unsigned int> h_e(e, access_location::host, access_mode::readwrite);
+            for (unsigned int i = 0; i < e.getNumElements(); i++)
+                h_e.data[i] = 1;
+            }
+
+        e.resize((n % 2) ? 1000 : 2000);
+        }
+    BOOST_CHECK_EQUAL(exec_pool.getNumAllocations(), 10u);
+    BOOST_CHECK_EQUAL(exec_pool.getNumHits(), 9u);
+
+    GPUArray<unsigned int> f(2000, exec_conf);
+    BOOST_CHECK_EQUAL(exec_pool.getNumHits(), 10u);
+        {
+        ArrayHandle<unsigned int> h_f(f, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < f.getNumElements(); i++)
+            BOOST_REQUIRE_EQUAL(h_f.data[i], 0u);
+        }
+
+    // arrays placed by first touch never reuse a block
+    exec_pool.resetStats();
+    GPUArray<unsigned int> q(2000, exec_conf);
+    q.setHostAllocFlags(host_alloc::first_touch);
+    q.resize(1000);
+    q.resize(2000);
+    BOOST_CHECK_EQUAL(exec_pool.getNumHits(), 0u);
+    }
+
 #ifdef ENABLE_CUDA
 //! boost test case for testing device to/from host transfers
 BOOST_AUTO_TEST_CASE( GPUArray_transfer_tests )
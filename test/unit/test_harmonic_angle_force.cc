@@ -53,6 +53,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <iostream>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
@@ -67,6 +68,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Initializers.h"
 #include "SnapshotSystemData.h"
+#include "SFCPackUpdater.h"
 
 using namespace std;
 using namespace boost;
@@ -437,6 +439,78 @@ void angle_force_comparison_tests(angleforce_creator af_creator1, angleforce_cre
     }
     }
 
+//! Compare the forces computed on several threads and after a particle sort to the single threaded result
+void angle_force_threads_test(angleforce_creator af_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    snap->angle_data.type_mapping.push_back("A");
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    boost::shared_ptr<HarmonicAngleForceCompute> fc = af_creator(sysdef);
+    fc->setParams(0, Scalar(1.0), Scalar(1.348));
+
+    // a chain, plus angles between distant tags so that some of them cross the particle ranges of the threads
+    for (unsigned int i = 0; i < N-2; i++)
+        sysdef->getAngleData()->addBondedGroup(Angle(0, i, i+1, i+2));
+    for (unsigned int i = 0; i < N; i += 10)
+        sysdef->getAngleData()->addBondedGroup(Angle(0, i, (i+333) % N, (i+667) % N));
+
+    exec_conf->setNumThreads(1);
+    fc->compute(0);
+    std::vector<Scalar3> ref_force(N);
+    std::vector<Scalar> ref_energy(N);
+    std::vector<Scalar> ref_virial(6*N);
+    for (unsigned int tag = 0; tag < N; tag++)
+        {
+        ref_force[tag] = fc->getForce(tag);
+        ref_energy[tag] = fc->getEnergy(tag);
+        for (unsigned int l = 0; l < 6; l++)
+            ref_virial[6*tag+l] = fc->getVirial(tag, l);
+        }
+
+    // the second pass uses the angle table rebuilt after the sort
+    SFCPackUpdater sorter(sysdef);
+    for (unsigned int pass = 0; pass < 2; pass++)
+        {
+        if (pass == 1)
+            sorter.update(0);
+
+        for (unsigned int n_threads = 1; n_threads <= 4; n_threads++)
+            {
+            exec_conf->setNumThreads(n_threads);
+            fc->forceCompute(0);
+
+            // the summation order differs between thread counts, compare the average deviation
+            double deltaf2 = 0.0;
+            double deltape2 = 0.0;
+            double deltav2 = 0.0;
+            for (unsigned int tag = 0; tag < N; tag++)
+                {
+                Scalar3 f = fc->getForce(tag);
+                deltaf2 += double(f.x - ref_force[tag].x) * double(f.x - ref_force[tag].x);
+                deltaf2 += double(f.y - ref_force[tag].y) * double(f.y - ref_force[tag].y);
+                deltaf2 += double(f.z - ref_force[tag].z) * double(f.z - ref_force[tag].z);
+                Scalar pe = fc->getEnergy(tag);
+                deltape2 += double(pe - ref_energy[tag]) * double(pe - ref_energy[tag]);
+                for (unsigned int l = 0; l < 6; l++)
+                    {
+                    Scalar v = fc->getVirial(tag, l);
+                    deltav2 += double(v - ref_virial[6*tag+l]) * double(v - ref_virial[6*tag+l]);
+                    }
+                }
+            BOOST_CHECK_SMALL(deltaf2 / double(N), double(tol_small));
+            BOOST_CHECK_SMALL(deltape2 / double(N), double(tol_small));
+            BOOST_CHECK_SMALL(deltav2 / double(N), double(tol_small));
+            }
+        }
+    exec_conf->setNumThreads(1);
+    }
+
 //! HarmonicAngleForceCompute creator for angle_force_basic_tests()
 boost::shared_ptr<HarmonicAngleForceCompute> base_class_af_creator(boost::shared_ptr<SystemDefinition> sysdef)
     {
@@ -461,6 +535,13 @@ BOOST_AUTO_TEST_CASE( HarmonicAngleForceCompute_basic )
     angle_force_basic_tests(af_creator, exec_conf);
     }
 
+//! boost test case for the multithreaded CPU code path
+BOOST_AUTO_TEST_CASE( HarmonicAngleForceCompute_threads )
+    {
+    angleforce_creator af_creator = bind(base_class_af_creator, _1);
+    angle_force_threads_test(af_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! boost test case for angle forces on the GPU
 BOOST_AUTO_TEST_CASE( HarmonicAngleForceComputeGPU_basic )
@@ -61,6 +61,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AllBondPotentials.h"
 #include "ConstForceCompute.h"
 #include "SnapshotSystemData.h"
+#include "SFCPackUpdater.h"
 
 #include "Initializers.h"
 
@@ -431,6 +432,79 @@ void bond_force_comparison_tests(bondforce_creator bf_creator1, bondforce_creato
     }
     }
 
+//! Compare the forces computed on several threads and after a particle sort to the single threaded result
+void bond_force_threads_test(bondforce_creator bf_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    snap->bond_data.type_mapping.push_back("A");
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    boost::shared_ptr<PotentialBondHarmonic> fc = bf_creator(sysdef);
+    fc->setParams(0, make_scalar2(Scalar(300.0), Scalar(1.6)));
+
+    // a chain, plus bonds to distant tags so that some bonds cross the particle ranges of the threads
+    // (the odd offset never bonds a particle to itself)
+    for (unsigned int i = 0; i < N-1; i++)
+        sysdef->getBondData()->addBondedGroup(Bond(0, i, i+1));
+    for (unsigned int i = 0; i < N; i += 10)
+        sysdef->getBondData()->addBondedGroup(Bond(0, i, (i*7919 + 501) % N));
+
+    exec_conf->setNumThreads(1);
+    fc->compute(0);
+    std::vector<Scalar3> ref_force(N);
+    std::vector<Scalar> ref_energy(N);
+    std::vector<Scalar> ref_virial(6*N);
+    for (unsigned int tag = 0; tag < N; tag++)
+        {
+        ref_force[tag] = fc->getForce(tag);
+        ref_energy[tag] = fc->getEnergy(tag);
+        for (unsigned int l = 0; l < 6; l++)
+            ref_virial[6*tag+l] = fc->getVirial(tag, l);
+        }
+
+    // the second pass uses the bond table rebuilt after the sort
+    SFCPackUpdater sorter(sysdef);
+    for (unsigned int pass = 0; pass < 2; pass++)
+        {
+        if (pass == 1)
+            sorter.update(0);
+
+        for (unsigned int n_threads = 1; n_threads <= 4; n_threads++)
+            {
+            exec_conf->setNumThreads(n_threads);
+            fc->forceCompute(0);
+
+            // the summation order differs between thread counts, compare the average deviation
+            double deltaf2 = 0.0;
+            double deltape2 = 0.0;
+            double deltav2 = 0.0;
+            for (unsigned int tag = 0; tag < N; tag++)
+                {
+                Scalar3 f = fc->getForce(tag);
+                deltaf2 += double(f.x - ref_force[tag].x) * double(f.x - ref_force[tag].x);
+                deltaf2 += double(f.y - ref_force[tag].y) * double(f.y - ref_force[tag].y);
+                deltaf2 += double(f.z - ref_force[tag].z) * double(f.z - ref_force[tag].z);
+                Scalar pe = fc->getEnergy(tag);
+                deltape2 += double(pe - ref_energy[tag]) * double(pe - ref_energy[tag]);
+                for (unsigned int l = 0; l < 6; l++)
+                    {
+                    Scalar v = fc->getVirial(tag, l);
+                    deltav2 += double(v - ref_virial[6*tag+l]) * double(v - ref_virial[6*tag+l]);
+                    }
+                }
+            BOOST_CHECK_SMALL(deltaf2 / double(N), double(tol_small));
+            BOOST_CHECK_SMALL(deltape2 / double(N), double(tol_small));
+            BOOST_CHECK_SMALL(deltav2 / double(N), double(tol_small));
+            }
+        }
+    exec_conf->setNumThreads(1);
+    }
+
 //! Check ConstForceCompute to see that it operates properly
 void const_force_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
     {
@@ -514,6 +588,13 @@ BOOST_AUTO_TEST_CASE( PotentialBondHarmonic_basic )
     bond_force_basic_tests(bf_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for bond forces on several threads of the CPU
+BOOST_AUTO_TEST_CASE( PotentialBondHarmonic_threads )
+    {
+    bondforce_creator bf_creator = bind(base_class_bf_creator, _1);
+    bond_force_threads_test(bf_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! boost test case for bond forces on the GPU
 BOOST_AUTO_TEST_CASE( PotentialBondHarmonicGPU_basic )
@@ -60,9 +60,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include <vector>
+
 #include "AllPairPotentials.h"
 
 #include "NeighborListBinned.h"
+#include "NeighborListCluster.h"
 #include "Initializers.h"
 
 #include <math.h>
@@ -411,6 +414,148 @@ void lj_force_comparison_test(ljforce_creator lj_creator1, ljforce_creator lj_cr
     }
     }
 
+//! Copy the forces and virials of the first \a N particles of a force compute
+void copy_forces(boost::shared_ptr<ForceCompute> fc,
+                 unsigned int N,
+                 std::vector<Scalar4>& force,
+                 std::vector<Scalar>& virial)
+    {
+    ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+    unsigned int pitch = fc->getVirialArray().getPitch();
+
+    force.resize(N);
+    virial.resize(6*N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        force[i] = h_force.data[i];
+        for (unsigned int l = 0; l < 6; l++)
+            virial[6*i+l] = h_virial.data[l*pitch+i];
+        }
+    }
+
+//! Check the forces, energies and virials of a force compute against a reference from copy_forces()
+/*! The summation order differs between thread counts and kernels, so the average deviation is compared.
+*/
+void check_forces_close(boost::shared_ptr<ForceCompute> fc,
+                        unsigned int N,
+                        const std::vector<Scalar4>& ref_force,
+                        const std::vector<Scalar>& ref_virial)
+    {
+    ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+    unsigned int pitch = fc->getVirialArray().getPitch();
+
+    double deltaf2 = 0.0;
+    double deltape2 = 0.0;
+    double deltav2 = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        deltaf2 += double(h_force.data[i].x - ref_force[i].x) * double(h_force.data[i].x - ref_force[i].x);
+        deltaf2 += double(h_force.data[i].y - ref_force[i].y) * double(h_force.data[i].y - ref_force[i].y);
+        deltaf2 += double(h_force.data[i].z - ref_force[i].z) * double(h_force.data[i].z - ref_force[i].z);
+        deltape2 += double(h_force.data[i].w - ref_force[i].w) * double(h_force.data[i].w - ref_force[i].w);
+        for (unsigned int l = 0; l < 6; l++)
+            deltav2 += double(h_virial.data[l*pitch+i] - ref_virial[6*i+l])
+                       * double(h_virial.data[l*pitch+i] - ref_virial[6*i+l]);
+        }
+    BOOST_CHECK_SMALL(deltaf2 / double(N), double(tol_small));
+    BOOST_CHECK_SMALL(deltape2 / double(N), double(tol_small));
+    BOOST_CHECK_SMALL(deltav2 / double(N), double(tol_small));
+    }
+
+//! Test that the multithreaded CPU computation gives the same result as a single thread
+void lj_force_threads_test(ljforce_creator lj_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 2000;
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    boost::shared_ptr<NeighborListBinned> nlist(new NeighborListBinned(sysdef, Scalar(3.0), Scalar(0.8)));
+    boost::shared_ptr<PotentialPairLJ> fc = lj_creator(sysdef, nlist);
+    fc->setRcut(0, 0, Scalar(3.0));
+    fc->setParams(0,0,make_scalar2(Scalar(4.0), Scalar(4.0)));
+
+    // test both the third law (scattered) and the full neighbor list code paths
+    for (unsigned int mode = 0; mode < 2; mode++)
+        {
+        nlist->setStorageMode(mode == 0 ? NeighborList::half : NeighborList::full);
+
+        // reference result on a single thread
+        exec_conf->setNumThreads(1);
+        fc->forceCompute(0);
+        std::vector<Scalar4> ref_force;
+        std::vector<Scalar> ref_virial;
+        copy_forces(fc, N, ref_force, ref_virial);
+
+        for (unsigned int n_threads = 2; n_threads <= 4; n_threads++)
+            {
+            exec_conf->setNumThreads(n_threads);
+            fc->forceCompute(0);
+            check_forces_close(fc, N, ref_force, ref_virial);
+            }
+        }
+
+    exec_conf->setNumThreads(1);
+    }
+
+//! Test that the cluster pair kernel computes the same forces as the per particle neighbor list
+void lj_force_cluster_test(ljforce_creator lj_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 2000;
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    boost::shared_ptr<NeighborListBinned> nlist_ref(new NeighborListBinned(sysdef, Scalar(3.0), Scalar(0.8)));
+    boost::shared_ptr<NeighborListCluster> nlist_cluster(new NeighborListCluster(sysdef, Scalar(3.0), Scalar(0.8)));
+
+    // exclusions are masked in the cluster kernel
+    for (unsigned int i = 0; i < N-1; i += 2)
+        {
+        nlist_ref->addExclusion(i, i+1);
+        nlist_cluster->addExclusion(i, i+1);
+        }
+
+    boost::shared_ptr<PotentialPairLJ> fc_ref = lj_creator(sysdef, nlist_ref);
+    boost::shared_ptr<PotentialPairLJ> fc_cluster = lj_creator(sysdef, nlist_cluster);
+    fc_ref->setRcut(0, 0, Scalar(3.0));
+    fc_cluster->setRcut(0, 0, Scalar(3.0));
+    fc_ref->setParams(0,0,make_scalar2(Scalar(4.0), Scalar(4.0)));
+    fc_cluster->setParams(0,0,make_scalar2(Scalar(4.0), Scalar(4.0)));
+    fc_ref->setShiftMode(PotentialPairLJ::shift);
+    fc_cluster->setShiftMode(PotentialPairLJ::shift);
+
+    // test both the third law (scattered) and the full neighbor list code paths, on one and several threads
+    for (unsigned int mode = 0; mode < 4; mode++)
+        {
+        nlist_ref->setStorageMode(mode % 2 == 0 ? NeighborList::half : NeighborList::full);
+        nlist_cluster->setStorageMode(mode % 2 == 0 ? NeighborList::half : NeighborList::full);
+        exec_conf->setNumThreads(mode < 2 ? 1 : 3);
+
+        fc_ref->forceCompute(0);
+        fc_cluster->forceCompute(0);
+
+        BOOST_CHECK(nlist_cluster->getNClusters() >= N / NLIST_CLUSTER_SIZE);
+
+        std::vector<Scalar4> ref_force;
+        std::vector<Scalar> ref_virial;
+        copy_forces(fc_ref, N, ref_force, ref_virial);
+        check_forces_close(fc_cluster, N, ref_force, ref_virial);
+        }
+
+    exec_conf->setNumThreads(1);
+    }
+
 //! Test the ability of the lj force compute to compute forces with different shift modes
 void lj_force_shift_test(ljforce_creator lj_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
     {
@@ -577,6 +722,50 @@ void lj_force_shift_test(ljforce_creator lj_creator, boost::shared_ptr<Execution
     }
     }
 
+//! Test that the batch interface of EvaluatorPairLJ matches the per pair evaluation
+void lj_batch_test()
+    {
+    // fill the lanes with pairs inside and outside the cutoff and with two different parameter sets, one of which
+    // has lj1 == 0
+    Scalar rsq[PAIR_BATCH_SIZE];
+    Scalar rcutsq[PAIR_BATCH_SIZE];
+    Scalar2 params[PAIR_BATCH_SIZE];
+    for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+        {
+        rsq[l] = Scalar(0.8) + Scalar(0.15) * Scalar(l);
+        rcutsq[l] = (l % 2) ? Scalar(2.5*2.5) : Scalar(1.5*1.5);
+        if (l % 5 == 4)
+            params[l] = make_scalar2(Scalar(0.0), Scalar(0.0));
+        else
+            params[l] = make_scalar2(Scalar(4.0*1.15), Scalar(4.0*1.15));
+        }
+
+    for (unsigned int shift = 0; shift < 2; shift++)
+        {
+        bool energy_shift = (shift == 1);
+        Scalar force_divr[PAIR_BATCH_SIZE];
+        Scalar pair_eng[PAIR_BATCH_SIZE];
+        EvaluatorPairLJ::evalForceAndEnergyBatch(rsq, rcutsq, params, force_divr, pair_eng, energy_shift);
+
+        for (unsigned int l = 0; l < PAIR_BATCH_SIZE; l++)
+            {
+            Scalar ref_force_divr = Scalar(0.0);
+            Scalar ref_pair_eng = Scalar(0.0);
+            EvaluatorPairLJ eval(rsq[l], rcutsq[l], params[l]);
+            if (eval.evalForceAndEnergy(ref_force_divr, ref_pair_eng, energy_shift))
+                {
+                MY_BOOST_CHECK_CLOSE(force_divr[l], ref_force_divr, tol);
+                MY_BOOST_CHECK_CLOSE(pair_eng[l], ref_pair_eng, tol);
+                }
+            else
+                {
+                BOOST_CHECK_EQUAL(force_divr[l], Scalar(0.0));
+                BOOST_CHECK_EQUAL(pair_eng[l], Scalar(0.0));
+                }
+            }
+        }
+    }
+
 //! LJForceCompute creator for unit tests
 boost::shared_ptr<PotentialPairLJ> base_class_lj_creator(boost::shared_ptr<SystemDefinition> sysdef,
                                                   boost::shared_ptr<NeighborList> nlist)
@@ -616,6 +805,26 @@ BOOST_AUTO_TEST_CASE( PotentialPairLJ_shift )
     lj_force_shift_test(lj_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for the multithreaded CPU code path
+BOOST_AUTO_TEST_CASE( PotentialPairLJ_threads )
+    {
+    ljforce_creator lj_creator_base = bind(base_class_lj_creator, _1, _2);
+    lj_force_threads_test(lj_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! boost test case for the cluster pair kernel
+BOOST_AUTO_TEST_CASE( PotentialPairLJ_cluster )
+    {
+    ljforce_creator lj_creator_base = bind(base_class_lj_creator, _1, _2);
+    lj_force_cluster_test(lj_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! boost test case for the batch interface of EvaluatorPairLJ
+BOOST_AUTO_TEST_CASE( EvaluatorPairLJ_batch )
+    {
+    lj_batch_test();
+    }
+
 # ifdef ENABLE_CUDA
 //! boost test case for particle test on GPU
 BOOST_AUTO_TEST_CASE( LJForceGPU_particle )
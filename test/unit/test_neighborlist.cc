@@ -55,6 +55,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <iostream>
 #include <algorithm>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
@@ -62,6 +63,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "NeighborList.h"
 #include "NeighborListBinned.h"
+#include "NeighborListCluster.h"
 #include "Initializers.h"
 
 #ifdef ENABLE_CUDA
@@ -395,6 +397,22 @@ void neighborlist_body_filter_tests(boost::shared_ptr<ExecutionConfiguration> ex
         }
     }
 
+//! Get the neighbors of a particle in ascending order
+/*! Not all neighbor list implementations list the neighbors in index order.
+*/
+std::vector<unsigned int> get_sorted_neighbors(boost::shared_ptr<NeighborList> nlist, unsigned int i)
+    {
+    ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(nlist->getNListArray(), access_location::host, access_mode::read);
+    Index2D nli = nlist->getNListIndexer();
+
+    std::vector<unsigned int> neighbors(h_n_neigh.data[i]);
+    for (unsigned int k = 0; k < h_n_neigh.data[i]; k++)
+        neighbors[k] = h_nlist.data[nli(i,k)];
+    std::sort(neighbors.begin(), neighbors.end());
+    return neighbors;
+    }
+
 //! Tests the ability of the neighbor list to filter by diameter
 template <class NL>
 void neighborlist_diameter_filter_tests(boost::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -434,20 +452,19 @@ void neighborlist_diameter_filter_tests(boost::shared_ptr<ExecutionConfiguration
 
     // 0 and 1 should be neighbors now, as well as 0 and 2
         {
-        ArrayHandle<unsigned int> h_n_neigh(nlist_2->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(nlist_2->getNListArray(), access_location::host, access_mode::read);
-        Index2D nli = nlist_2->getNListIndexer();
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[0], 3);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,0)], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,1)], 2);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,2)], 3);
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[1], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(1,0)], 0);
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[2], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(2,0)], 0);
+        std::vector<unsigned int> nb0 = get_sorted_neighbors(nlist_2, 0);
+        BOOST_REQUIRE_EQUAL_UINT(nb0.size(), 3);
+        BOOST_CHECK_EQUAL_UINT(nb0[0], 1);
+        BOOST_CHECK_EQUAL_UINT(nb0[1], 2);
+        BOOST_CHECK_EQUAL_UINT(nb0[2], 3);
+
+        std::vector<unsigned int> nb1 = get_sorted_neighbors(nlist_2, 1);
+        BOOST_REQUIRE_EQUAL_UINT(nb1.size(), 1);
+        BOOST_CHECK_EQUAL_UINT(nb1[0], 0);
+
+        std::vector<unsigned int> nb2 = get_sorted_neighbors(nlist_2, 2);
+        BOOST_REQUIRE_EQUAL_UINT(nb2.size(), 1);
+        BOOST_CHECK_EQUAL_UINT(nb2[0], 0);
         }
 
     // bump it up to 3.0
@@ -456,22 +473,21 @@ void neighborlist_diameter_filter_tests(boost::shared_ptr<ExecutionConfiguration
 
     // should be the same as above
         {
-        ArrayHandle<unsigned int> h_n_neigh(nlist_2->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(nlist_2->getNListArray(), access_location::host, access_mode::read);
-        Index2D nli = nlist_2->getNListIndexer();
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[0], 3);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,0)], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,1)], 2);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,2)], 3);
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[1], 2);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(1,0)], 0);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(1,1)], 3);
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[2], 2);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(2,0)], 0);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(2,1)], 3);
+        std::vector<unsigned int> nb0 = get_sorted_neighbors(nlist_2, 0);
+        BOOST_REQUIRE_EQUAL_UINT(nb0.size(), 3);
+        BOOST_CHECK_EQUAL_UINT(nb0[0], 1);
+        BOOST_CHECK_EQUAL_UINT(nb0[1], 2);
+        BOOST_CHECK_EQUAL_UINT(nb0[2], 3);
+
+        std::vector<unsigned int> nb1 = get_sorted_neighbors(nlist_2, 1);
+        BOOST_REQUIRE_EQUAL_UINT(nb1.size(), 2);
+        BOOST_CHECK_EQUAL_UINT(nb1[0], 0);
+        BOOST_CHECK_EQUAL_UINT(nb1[1], 3);
+
+        std::vector<unsigned int> nb2 = get_sorted_neighbors(nlist_2, 2);
+        BOOST_REQUIRE_EQUAL_UINT(nb2.size(), 2);
+        BOOST_CHECK_EQUAL_UINT(nb2[0], 0);
+        BOOST_CHECK_EQUAL_UINT(nb2[1], 3);
         }
 
     // enable diameter filtering and verify the result is still correct
@@ -480,19 +496,18 @@ void neighborlist_diameter_filter_tests(boost::shared_ptr<ExecutionConfiguration
 
     // the particle 0 should now be neighbors with 1 and 2
         {
-        ArrayHandle<unsigned int> h_n_neigh(nlist_2->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(nlist_2->getNListArray(), access_location::host, access_mode::read);
-        Index2D nli = nlist_2->getNListIndexer();
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[0], 2);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,0)], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(0,1)], 2);
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[1], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(1,0)], 0);
-
-        BOOST_REQUIRE_EQUAL_UINT(h_n_neigh.data[2], 1);
-        BOOST_CHECK_EQUAL_UINT(h_nlist.data[nli(2,0)], 0);
+        std::vector<unsigned int> nb0 = get_sorted_neighbors(nlist_2, 0);
+        BOOST_REQUIRE_EQUAL_UINT(nb0.size(), 2);
+        BOOST_CHECK_EQUAL_UINT(nb0[0], 1);
+        BOOST_CHECK_EQUAL_UINT(nb0[1], 2);
+
+        std::vector<unsigned int> nb1 = get_sorted_neighbors(nlist_2, 1);
+        BOOST_REQUIRE_EQUAL_UINT(nb1.size(), 1);
+        BOOST_CHECK_EQUAL_UINT(nb1[0], 0);
+
+        std::vector<unsigned int> nb2 = get_sorted_neighbors(nlist_2, 2);
+        BOOST_REQUIRE_EQUAL_UINT(nb2.size(), 1);
+        BOOST_CHECK_EQUAL_UINT(nb2[0], 0);
         }
     }
 
@@ -561,6 +576,242 @@ void neighborlist_comparison_test(boost::shared_ptr<ExecutionConfiguration> exec
         }
     }
 
+//! Test that the compact storage layout holds the same neighbors as the dense one
+template <class NL>
+void neighborlist_compact_test(boost::shared_ptr<ExecutionConfiguration> exec_conf, NeighborList::storageMode mode)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    boost::shared_ptr<NeighborList> nlist1(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist1->setStorageMode(mode);
+
+    boost::shared_ptr<NeighborList> nlist2(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->setStorageMode(mode);
+    nlist2->setCompactStorage(true);
+    BOOST_CHECK(nlist2->getCompactStorage());
+
+    for (unsigned int i=0; i < pdata->getN()-2; i++)
+        {
+        nlist1->addExclusion(i,i+1);
+        nlist1->addExclusion(i,i+2);
+
+        nlist2->addExclusion(i,i+1);
+        nlist2->addExclusion(i,i+2);
+        }
+
+    // build twice: the second build re-fits the capacities to the counts of the first
+    for (unsigned int step = 0; step < 2; step++)
+        {
+        nlist1->forceUpdate();
+        nlist2->forceUpdate();
+        nlist1->compute(step);
+        nlist2->compute(step);
+
+        BOOST_CHECK_EQUAL(nlist2->getNListStride(), (unsigned int)1);
+        BOOST_CHECK(nlist2->getNListArray().getNumElements() < nlist1->getNListArray().getNumElements());
+
+        ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+        unsigned int stride1 = nlist1->getNListStride();
+        unsigned int stride2 = nlist2->getNListStride();
+
+        // the dense layout is also accessible through the head list
+        Index2D nli = nlist1->getNListIndexer();
+        BOOST_CHECK_EQUAL(h_head_list1.data[5] + 3*stride1, nli(5,3));
+
+        std::vector<unsigned int> tmp_list1;
+        std::vector<unsigned int> tmp_list2;
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            BOOST_REQUIRE_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+            // the neighbors fit in the row of particle i
+            BOOST_REQUIRE(h_head_list2.data[i] + h_n_neigh2.data[i] <= h_head_list2.data[i+1]);
+
+            tmp_list1.resize(h_n_neigh1.data[i]);
+            tmp_list2.resize(h_n_neigh1.data[i]);
+
+            for (unsigned int j = 0; j < h_n_neigh1.data[i]; j++)
+                {
+                tmp_list1[j] = h_nlist1.data[h_head_list1.data[i] + j*stride1];
+                tmp_list2[j] = h_nlist2.data[h_head_list2.data[i] + j*stride2];
+                }
+
+            sort(tmp_list1.begin(), tmp_list1.end());
+            sort(tmp_list2.begin(), tmp_list2.end());
+
+            for (unsigned int j = 0; j < tmp_list1.size(); j++)
+                {
+                BOOST_CHECK_EQUAL(tmp_list1[j], tmp_list2[j]);
+                }
+            }
+        }
+
+    // switching back to the dense layout restores the indexer based access
+    nlist2->setCompactStorage(false);
+    nlist2->compute(2);
+    BOOST_CHECK_EQUAL(nlist2->getNListStride(), nlist2->getNListArray().getPitch());
+    }
+
+//! Move the particles \a first to \a last by \a delta in x
+static void displace_particles(boost::shared_ptr<ParticleData> pdata, unsigned int first, unsigned int last, Scalar delta)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::readwrite);
+    const BoxDim& box = pdata->getBox();
+    for (unsigned int i = first; i < last; i++)
+        {
+        h_pos.data[i].x += delta;
+        box.wrap(h_pos.data[i], h_image.data[i]);
+        }
+    }
+
+//! Test that the incremental updates keep every interacting pair in the list
+template <class NL>
+void neighborlist_incremental_test(boost::shared_ptr<ExecutionConfiguration> exec_conf, NeighborList::storageMode mode)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    Scalar r_cut(3.0);
+
+    boost::shared_ptr<NeighborList> nlist1(new NL(sysdef, r_cut, Scalar(0.4)));
+    nlist1->setStorageMode(mode);
+    nlist1->setIncremental(true);
+    BOOST_CHECK(nlist1->getIncremental());
+    nlist1->setEvery(1);
+
+    for (unsigned int i=0; i < pdata->getN()-2; i++)
+        nlist1->addExclusion(i,i+1);
+
+    nlist1->compute(0);
+    unsigned int n_updates = nlist1->getNumUpdates();
+
+    // moves below a quarter of the buffer do not touch the list
+    displace_particles(pdata, 0, 20, Scalar(0.05));
+    nlist1->compute(1);
+    BOOST_CHECK_EQUAL(nlist1->getNumUpdates(), n_updates);
+
+    for (unsigned int step = 2; step < 6; step++)
+        {
+        // a few particles that keep moving trigger partial updates
+        displace_particles(pdata, 10, 20, Scalar(0.07));
+        nlist1->compute(step);
+        }
+    BOOST_CHECK_EQUAL(nlist1->getNumPartialUpdates(), (unsigned int)2);
+    BOOST_CHECK(nlist1->hasBeenUpdated(4));
+
+    // compare against a list built from scratch
+    boost::shared_ptr<NeighborList> nlist2(new NL(sysdef, r_cut, Scalar(0.4)));
+    nlist2->setStorageMode(mode);
+    for (unsigned int i=0; i < pdata->getN()-2; i++)
+        nlist2->addExclusion(i,i+1);
+    nlist2->compute(5);
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+        unsigned int stride1 = nlist1->getNListStride();
+        unsigned int stride2 = nlist2->getNListStride();
+        const BoxDim& box = pdata->getBox();
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            std::vector<unsigned int> list1(h_n_neigh1.data[i]);
+            for (unsigned int k = 0; k < h_n_neigh1.data[i]; k++)
+                list1[k] = h_nlist1.data[h_head_list1.data[i] + k*stride1];
+
+            // every pair within the cutoff must be present
+            for (unsigned int k = 0; k < h_n_neigh2.data[i]; k++)
+                {
+                unsigned int j = h_nlist2.data[h_head_list2.data[i] + k*stride2];
+                Scalar3 dx = make_scalar3(h_pos.data[i].x - h_pos.data[j].x,
+                                          h_pos.data[i].y - h_pos.data[j].y,
+                                          h_pos.data[i].z - h_pos.data[j].z);
+                dx = box.minImage(dx);
+                if (dot(dx,dx) <= r_cut*r_cut)
+                    BOOST_CHECK(std::find(list1.begin(), list1.end(), j) != list1.end());
+                }
+            }
+        }
+
+    // displacing many particles at once falls back to a full update
+    unsigned int n_partial = nlist1->getNumPartialUpdates();
+    displace_particles(pdata, 0, pdata->getN(), Scalar(0.15));
+    nlist1->compute(6);
+    nlist2->forceUpdate();
+    nlist2->compute(6);
+    BOOST_CHECK_EQUAL(nlist1->getNumPartialUpdates(), n_partial);
+
+    ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        BOOST_REQUIRE_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+    }
+
+//! Test that the buffer tuning sweeps over the r_buff values and then settles on one of them
+template <class NL>
+void neighborlist_buffer_tuning_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    boost::shared_ptr<NeighborList> nlist(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist->setEvery(5);
+
+    // 3 values, 2 steps per window, at most a check period of 10
+    nlist->enableBufferTuning(Scalar(0.2), Scalar(0.6), 3, 2, 10, 1000);
+
+    // each value is timed in 3 windows
+    nlist->compute(0);
+    MY_BOOST_CHECK_CLOSE(nlist->getRBuff(), 0.2, tol);
+    BOOST_CHECK_EQUAL(nlist->getEvery(), (unsigned int)1);
+    nlist->compute(1);
+    nlist->compute(2);
+    MY_BOOST_CHECK_CLOSE(nlist->getRBuff(), 0.2, tol);
+
+    for (unsigned int step = 3; step <= 6; step++)
+        nlist->compute(step);
+    MY_BOOST_CHECK_CLOSE(nlist->getRBuff(), 0.4, tol);
+
+    for (unsigned int step = 7; step <= 12; step++)
+        nlist->compute(step);
+    MY_BOOST_CHECK_CLOSE(nlist->getRBuff(), 0.6, tol);
+
+    // after the sweep and one more window to measure the rebuild period, the tuned values are set
+    for (unsigned int step = 13; step <= 21; step++)
+        nlist->compute(step);
+
+    Scalar r_buff = nlist->getRBuff();
+    BOOST_CHECK(fabs(r_buff - Scalar(0.2)) < tol_small ||
+                fabs(r_buff - Scalar(0.4)) < tol_small ||
+                fabs(r_buff - Scalar(0.6)) < tol_small);
+    BOOST_CHECK(nlist->getEvery() >= 1 && nlist->getEvery() <= 10);
+
+    // the list is valid for the tuned r_buff
+    nlist->disableBufferTuning();
+    nlist->compute(22);
+    BOOST_CHECK_CLOSE(nlist->getRBuff(), r_buff, tol);
+    }
+
 //! Test that a NeighborList can successfully exclude a ridiculously large number of particles
 template <class NL>
 void neighborlist_large_ex_tests(boost::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -624,6 +875,11 @@ BOOST_AUTO_TEST_CASE( NeighborList_body_filter)
     {
     neighborlist_body_filter_tests<NeighborList>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! compact storage test case for base class
+BOOST_AUTO_TEST_CASE( NeighborList_compact )
+    {
+    neighborlist_compact_test<NeighborList>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), NeighborList::full);
+    }
 //! diameter filter test case for base class
 BOOST_AUTO_TEST_CASE( NeighborList_diameter_filter )
     {
@@ -661,6 +917,86 @@ BOOST_AUTO_TEST_CASE( NeighborListBinned_comparison )
     neighborlist_comparison_test<NeighborList, NeighborListBinned>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for the multithreaded build of NeighborListBinned
+BOOST_AUTO_TEST_CASE( NeighborListBinned_threads )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(3);
+    neighborlist_basic_tests<NeighborListBinned>(exec_conf);
+    neighborlist_body_filter_tests<NeighborListBinned>(exec_conf);
+    neighborlist_diameter_filter_tests<NeighborListBinned>(exec_conf);
+    neighborlist_comparison_test<NeighborList, NeighborListBinned>(exec_conf);
+    }
+
+//! test case for the compact storage of NeighborListBinned
+BOOST_AUTO_TEST_CASE( NeighborListBinned_compact )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    neighborlist_compact_test<NeighborListBinned>(exec_conf, NeighborList::full);
+    neighborlist_compact_test<NeighborListBinned>(exec_conf, NeighborList::half);
+    exec_conf->setNumThreads(3);
+    neighborlist_compact_test<NeighborListBinned>(exec_conf, NeighborList::half);
+    }
+
+//! test case for the incremental updates of NeighborListBinned
+BOOST_AUTO_TEST_CASE( NeighborListBinned_incremental )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    neighborlist_incremental_test<NeighborListBinned>(exec_conf, NeighborList::full);
+    neighborlist_incremental_test<NeighborListBinned>(exec_conf, NeighborList::half);
+    exec_conf->setNumThreads(3);
+    neighborlist_incremental_test<NeighborListBinned>(exec_conf, NeighborList::half);
+    }
+
+//! test case for the buffer tuning of NeighborListBinned
+BOOST_AUTO_TEST_CASE( NeighborListBinned_buffer_tuning )
+    {
+    neighborlist_buffer_tuning_test<NeighborListBinned>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! basic test case for cluster class
+BOOST_AUTO_TEST_CASE( NeighborListCluster_basic )
+    {
+    neighborlist_basic_tests<NeighborListCluster>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! exclusion test case for cluster class
+BOOST_AUTO_TEST_CASE( NeighborListCluster_exclusion )
+    {
+    neighborlist_exclusion_tests<NeighborListCluster>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! body filter test case for cluster class
+BOOST_AUTO_TEST_CASE( NeighborListCluster_body_filter)
+    {
+    neighborlist_body_filter_tests<NeighborListCluster>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! diameter filter test case for cluster class
+BOOST_AUTO_TEST_CASE( NeighborListCluster_diameter_filter )
+    {
+    neighborlist_diameter_filter_tests<NeighborListCluster>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! comparison test case for cluster class
+BOOST_AUTO_TEST_CASE( NeighborListCluster_comparison )
+    {
+    neighborlist_comparison_test<NeighborListBinned, NeighborListCluster>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test case for the multithreaded build of NeighborListCluster
+BOOST_AUTO_TEST_CASE( NeighborListCluster_threads )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(3);
+    neighborlist_basic_tests<NeighborListCluster>(exec_conf);
+    neighborlist_comparison_test<NeighborListBinned, NeighborListCluster>(exec_conf);
+    }
+
+//! test case for the compact storage of NeighborListCluster
+BOOST_AUTO_TEST_CASE( NeighborListCluster_compact )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    neighborlist_compact_test<NeighborListCluster>(exec_conf, NeighborList::full);
+    neighborlist_compact_test<NeighborListCluster>(exec_conf, NeighborList::half);
+    }
+
 #ifdef ENABLE_CUDA
 
 //! basic test case for GPU class
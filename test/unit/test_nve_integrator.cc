@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <iostream>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
@@ -296,6 +297,107 @@ void nve_updater_boundary_tests(twostepnve_creator nve_creator, boost::shared_pt
     }
     }
 
+//! Compare the 2 particles of nve_updater_respa_tests to the analytical solution at time \a t
+/*! \param pdata Particle data
+    \param t Time since the start of the integration
+    \param tz Time since the force in z direction was added
+*/
+void nve_respa_check(boost::shared_ptr<ParticleData> pdata, Scalar t, Scalar tz)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+
+    MY_BOOST_CHECK_CLOSE(h_pos.data[0].x, 0.0 + 3.0 * t + 1.0/2.0 * 1.5 * t*t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_vel.data[0].x, 3.0 + 1.5 * t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_pos.data[0].y, 1.0 + 2.0 * t + 1.0/2.0 * 2.5 * t*t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_vel.data[0].y, 2.0 + 2.5 * t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_pos.data[0].z, 2.0 + 1.0 * t + 1.0/2.0 * 0.5 * tz*tz, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_vel.data[0].z, 1.0 + 0.5 * tz, loose_tol);
+
+    MY_BOOST_CHECK_CLOSE(h_pos.data[1].x, 10.0 + 13.0 * t + 1.0/2.0 * 0.75 * t*t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_vel.data[1].x, 13.0 + 0.75 * t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_pos.data[1].y, 11.0 + 12.0 * t + 1.0/2.0 * 1.25 * t*t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_vel.data[1].y, 12.0 + 1.25 * t, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_pos.data[1].z, 12.0 + 11.0 * t + 1.0/2.0 * 0.25 * tz*tz, loose_tol);
+    MY_BOOST_CHECK_CLOSE(h_vel.data[1].z, 11.0 + 0.25 * tz, loose_tol);
+
+    // at the end of an outer step, the net force includes the slow force
+    MY_BOOST_CHECK_CLOSE(h_net_force.data[0].x, 1.5, tol);
+    MY_BOOST_CHECK_CLOSE(h_net_force.data[0].y, 2.5, tol);
+    if (tz > Scalar(0.0))
+        MY_BOOST_CHECK_CLOSE(h_net_force.data[0].z, 0.5, tol);
+    }
+
+//! Integrate 2 particles with a fast and a slow force and compare to an analytical solution
+void nve_updater_respa_tests(twostepnve_creator nve_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // the impulse RESPA scheme is exact for constant forces at the ends of the outer steps
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(2, BoxDim(1000.0), 4, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata->getN()-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_pos.data[0].x = 0.0;
+    h_pos.data[0].y = 1.0;
+    h_pos.data[0].z = 2.0;
+    h_vel.data[0].x = 3.0;
+    h_vel.data[0].y = 2.0;
+    h_vel.data[0].z = 1.0;
+
+    h_pos.data[1].x = 10.0;
+    h_pos.data[1].y = 11.0;
+    h_pos.data[1].z = 12.0;
+    h_vel.data[1].x = 13.0;
+    h_vel.data[1].y = 12.0;
+    h_vel.data[1].z = 11.0;
+    h_vel.data[1].w = 2.0;
+    }
+
+    Scalar deltaT = Scalar(0.0001);
+    boost::shared_ptr<TwoStepNVE> two_step_nve = nve_creator(sysdef, group_all);
+    boost::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, deltaT));
+    nve_up->addIntegrationMethod(two_step_nve);
+
+    boost::shared_ptr<ConstForceCompute> fc1(new ConstForceCompute(sysdef, 1.5, 0.0, 0.0));
+    nve_up->addForceCompute(fc1);
+    boost::shared_ptr<ConstForceCompute> fc2(new ConstForceCompute(sysdef, 0.0, 2.5, 0.0));
+    nve_up->addSlowForceCompute(fc2, 4);
+
+    // start in the middle of an outer step, the first one is shortened to end at time step 4
+    unsigned int start = 2;
+    unsigned int second_start = 251;
+    nve_up->prepRun(start);
+
+    for (unsigned int i = start; i < second_start; i++)
+        {
+        if (i % 4 == 0 || i == start)
+            nve_respa_check(pdata, Scalar(i - start) * deltaT, Scalar(0.0));
+
+        nve_up->update(i);
+        }
+
+    // a second run in the middle of an outer step of fc2, which continues its interval, while fc3 is added with a
+    // multiple (the forces are added again like hoomd_script does before every run)
+    boost::shared_ptr<ConstForceCompute> fc3(new ConstForceCompute(sysdef, 0.0, 0.0, 0.5));
+    nve_up->removeForceComputes();
+    nve_up->addForceCompute(fc1);
+    nve_up->addSlowForceCompute(fc2, 4);
+    nve_up->addSlowForceCompute(fc3, 3);
+    nve_up->prepRun(second_start);
+
+    for (unsigned int i = second_start; i < second_start + 500; i++)
+        {
+        if (i % 12 == 0)
+            nve_respa_check(pdata, Scalar(i - start) * deltaT, Scalar(i - second_start) * deltaT);
+
+        nve_up->update(i);
+        }
+    }
+
 //! Compares the output from one TwoStepNVE to another
 void nve_updater_compare_test(twostepnve_creator nve_creator1,
                               twostepnve_creator nve_creator2,
@@ -388,6 +490,94 @@ void nve_updater_compare_test(twostepnve_creator nve_creator1,
         }
     }
 
+//! Integrates a random system with constant forces on \a n_threads threads and returns the final state
+void nve_updater_threads_run(twostepnve_creator nve_creator,
+                             boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                             unsigned int n_threads,
+                             std::vector<Scalar4>& pos,
+                             std::vector<Scalar4>& vel,
+                             std::vector<int3>& image)
+    {
+    const unsigned int N = 1000;
+    exec_conf->setNumThreads(n_threads);
+
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    rand_init.setSeed(12345);
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // integrate only half of the particles, with the movement limit active for the fast ones
+    boost::shared_ptr<ParticleSelector> selector(new ParticleSelectorTag(sysdef, 0, N/2-1));
+    boost::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef, selector));
+
+    {
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_vel.data[i].x = Scalar((i % 7)) - Scalar(3.0);
+        h_vel.data[i].y = Scalar((i % 5)) - Scalar(2.0);
+        h_vel.data[i].z = Scalar((i % 3)) - Scalar(1.0);
+        }
+    }
+
+    boost::shared_ptr<ConstForceCompute> fc(new ConstForceCompute(sysdef, Scalar(0.0), Scalar(0.0), Scalar(0.0)));
+    for (unsigned int i = 0; i < N; i++)
+        fc->setParticleForce(i, Scalar(i % 11) - Scalar(5.0), Scalar(0.5), -Scalar(i % 4));
+
+    boost::shared_ptr<TwoStepNVE> two_step_nve = nve_creator(sysdef, group);
+    two_step_nve->setLimit(Scalar(0.015));
+    boost::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, Scalar(0.005)));
+    nve_up->addIntegrationMethod(two_step_nve);
+    nve_up->addForceCompute(fc);
+    nve_up->prepRun(0);
+
+    for (unsigned int i = 0; i < 200; i++)
+        nve_up->update(i);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+    pos.assign(h_pos.data, h_pos.data + N);
+    vel.assign(h_vel.data, h_vel.data + N);
+    image.assign(h_image.data, h_image.data + N);
+
+    exec_conf->setNumThreads(1);
+    }
+
+//! Test that the integration on several threads gives exactly the same result as on a single thread
+void nve_updater_threads_test(twostepnve_creator nve_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::vector<Scalar4> ref_pos, ref_vel, pos, vel;
+    std::vector<int3> ref_image, image;
+    nve_updater_threads_run(nve_creator, exec_conf, 1, ref_pos, ref_vel, ref_image);
+
+    // the particles must have crossed the boundaries for the test to be meaningful
+    bool wrapped = false;
+    for (unsigned int i = 0; i < ref_image.size(); i++)
+        wrapped |= (ref_image[i].x != 0 || ref_image[i].y != 0 || ref_image[i].z != 0);
+    BOOST_CHECK(wrapped);
+
+    for (unsigned int n_threads = 2; n_threads <= 4; n_threads++)
+        {
+        nve_updater_threads_run(nve_creator, exec_conf, n_threads, pos, vel, image);
+
+        // every particle is integrated independently, so the results are bitwise identical
+        for (unsigned int i = 0; i < ref_pos.size(); i++)
+            {
+            BOOST_CHECK_EQUAL(pos[i].x, ref_pos[i].x);
+            BOOST_CHECK_EQUAL(pos[i].y, ref_pos[i].y);
+            BOOST_CHECK_EQUAL(pos[i].z, ref_pos[i].z);
+            BOOST_CHECK_EQUAL(vel[i].x, ref_vel[i].x);
+            BOOST_CHECK_EQUAL(vel[i].y, ref_vel[i].y);
+            BOOST_CHECK_EQUAL(vel[i].z, ref_vel[i].z);
+            BOOST_CHECK_EQUAL(image[i].x, ref_image[i].x);
+            BOOST_CHECK_EQUAL(image[i].y, ref_image[i].y);
+            BOOST_CHECK_EQUAL(image[i].z, ref_image[i].z);
+            }
+        }
+    }
+
 //! TwoStepNVE factory for the unit tests
 boost::shared_ptr<TwoStepNVE> base_class_nve_creator(boost::shared_ptr<SystemDefinition> sysdef, boost::shared_ptr<ParticleGroup> group)
     {
@@ -423,6 +613,20 @@ BOOST_AUTO_TEST_CASE( TwoStepNVE_boundary_tests )
     twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
     nve_updater_boundary_tests(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+
+//! boost test case for multiple time step integration
+BOOST_AUTO_TEST_CASE( TwoStepNVE_respa_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_respa_tests(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! boost test case for the multithreaded CPU code path
+BOOST_AUTO_TEST_CASE( TwoStepNVE_threads_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_threads_test(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! Need work on NVEUpdaterGPU with rigid bodies to test these cases
 #ifdef ENABLE_CUDA
 //! boost test case for base class integration tests
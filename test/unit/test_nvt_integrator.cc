@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <iostream>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
@@ -1272,12 +1273,100 @@ void nvt_updater_compare_test(twostepnvt_creator nvt_creator1, twostepnvt_creato
         }
     }
 
+//! Integrates a random system with constant forces on \a n_threads threads and returns the final state
+void nvt_updater_threads_run(twostepnvt_creator nvt_creator,
+                             boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                             unsigned int n_threads,
+                             std::vector<Scalar4>& pos,
+                             std::vector<Scalar4>& vel,
+                             std::vector<int3>& image)
+    {
+    const unsigned int N = 1000;
+    exec_conf->setNumThreads(n_threads);
+
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    rand_init.setSeed(12345);
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata->getN()-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_vel.data[i].x = Scalar((i % 7)) - Scalar(3.0);
+        h_vel.data[i].y = Scalar((i % 5)) - Scalar(2.0);
+        h_vel.data[i].z = Scalar((i % 3)) - Scalar(1.0);
+        }
+    }
+
+    boost::shared_ptr<ConstForceCompute> fc(new ConstForceCompute(sysdef, Scalar(0.0), Scalar(0.0), Scalar(0.0)));
+    for (unsigned int i = 0; i < N; i++)
+        fc->setParticleForce(i, Scalar(i % 11) - Scalar(5.0), Scalar(0.5), -Scalar(i % 4));
+
+    boost::shared_ptr<ComputeThermo> thermo(new ComputeThermo(sysdef, group_all));
+    thermo->setNDOF(3*N-3);
+    boost::shared_ptr<TwoStepNVT> two_step_nvt = nvt_creator(sysdef, group_all, thermo, Scalar(0.5), Scalar(1.2));
+    boost::shared_ptr<IntegratorTwoStep> nvt_up(new IntegratorTwoStep(sysdef, Scalar(0.005)));
+    nvt_up->addIntegrationMethod(two_step_nvt);
+    nvt_up->addForceCompute(fc);
+    nvt_up->prepRun(0);
+
+    for (unsigned int i = 0; i < 200; i++)
+        nvt_up->update(i);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+    pos.assign(h_pos.data, h_pos.data + N);
+    vel.assign(h_vel.data, h_vel.data + N);
+    image.assign(h_image.data, h_image.data + N);
+
+    exec_conf->setNumThreads(1);
+    }
+
+//! Test that the integration on several threads gives exactly the same result as on a single thread
+void nvt_updater_threads_test(twostepnvt_creator nvt_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::vector<Scalar4> ref_pos, ref_vel, pos, vel;
+    std::vector<int3> ref_image, image;
+    nvt_updater_threads_run(nvt_creator, exec_conf, 1, ref_pos, ref_vel, ref_image);
+
+    for (unsigned int n_threads = 2; n_threads <= 4; n_threads++)
+        {
+        nvt_updater_threads_run(nvt_creator, exec_conf, n_threads, pos, vel, image);
+
+        // every particle is integrated independently and the thermostat is advanced serially, so the results are
+        // bitwise identical
+        for (unsigned int i = 0; i < ref_pos.size(); i++)
+            {
+            BOOST_CHECK_EQUAL(pos[i].x, ref_pos[i].x);
+            BOOST_CHECK_EQUAL(pos[i].y, ref_pos[i].y);
+            BOOST_CHECK_EQUAL(pos[i].z, ref_pos[i].z);
+            BOOST_CHECK_EQUAL(vel[i].x, ref_vel[i].x);
+            BOOST_CHECK_EQUAL(vel[i].y, ref_vel[i].y);
+            BOOST_CHECK_EQUAL(vel[i].z, ref_vel[i].z);
+            BOOST_CHECK_EQUAL(image[i].x, ref_image[i].x);
+            BOOST_CHECK_EQUAL(image[i].y, ref_image[i].y);
+            BOOST_CHECK_EQUAL(image[i].z, ref_image[i].z);
+            }
+        }
+    }
+
 //! Compares the output of NVTUpdater to a mathematica solution of a 1D problem
 BOOST_AUTO_TEST_CASE( TwoStepNVT_mathematica_compare )
     {
     nvt_updater_integrate_tests(bind(base_class_nvt_creator, _1, _2, _3, _4, _5), boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for the multithreaded CPU code path
+BOOST_AUTO_TEST_CASE( TwoStepNVT_threads_tests )
+    {
+    nvt_updater_threads_test(bind(base_class_nvt_creator, _1, _2, _3, _4, _5), boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 
 #ifdef ENABLE_CUDA
 //! Compares the output of NVTUpdaterGPU to a mathematica solution of a 1D problem
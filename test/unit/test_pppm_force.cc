@@ -64,6 +64,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fstream>
 
 #include "PPPMForceCompute.h"
+#include "FFTBackend.h"
 #ifdef ENABLE_CUDA
 #include "PPPMForceComputeGPU.h"
 #endif
@@ -235,6 +236,89 @@ void pppm_force_particle_test_triclinic(pppmforce_creator pppm_creator, boost::s
     }
 
 
+//! Test that the threaded charge assignment and force interpolation agree with a single thread
+void pppm_force_thread_test(pppmforce_creator pppm_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a random neutral system, high assignment orders with stencils wider than the mesh planes of some threads
+    const unsigned int N = 400;
+    Scalar L = 10.0;
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L), 1, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::readwrite);
+
+    srand(4321);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_pos.data[i].x = (Scalar(rand())/Scalar(RAND_MAX) - Scalar(0.5))*L;
+        h_pos.data[i].y = (Scalar(rand())/Scalar(RAND_MAX) - Scalar(0.5))*L;
+        h_pos.data[i].z = (Scalar(rand())/Scalar(RAND_MAX) - Scalar(0.5))*L;
+        h_charge.data[i] = (i % 2) ? Scalar(-1.0) : Scalar(1.0);
+        }
+    }
+
+    boost::shared_ptr<NeighborList> nlist(new NeighborList(sysdef, Scalar(1.0), Scalar(0.4)));
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, N-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    for (int order = 5; order <= 7; order++)
+        {
+        boost::shared_ptr<PPPMForceCompute> fc = pppm_creator(sysdef, nlist, group_all);
+        fc->setParams(20, 18, 16, order, Scalar(2.0), Scalar(1.0));
+
+        exec_conf->setNumThreads(1);
+        fc->compute(0);
+
+        std::vector<Scalar4> ref_force(N);
+            {
+            ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+            for (unsigned int i = 0; i < N; i++)
+                ref_force[i] = h_force.data[i];
+            }
+        Scalar ref_energy = fc->calcEnergySum();
+
+        for (unsigned int n_threads = 2; n_threads <= 4; n_threads++)
+            {
+            exec_conf->setNumThreads(n_threads);
+            fc->forceCompute(0);
+
+                {
+                ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+                for (unsigned int i = 0; i < N; i++)
+                    {
+                    MY_BOOST_CHECK_SMALL(h_force.data[i].x - ref_force[i].x, tol_small);
+                    MY_BOOST_CHECK_SMALL(h_force.data[i].y - ref_force[i].y, tol_small);
+                    MY_BOOST_CHECK_SMALL(h_force.data[i].z - ref_force[i].z, tol_small);
+                    }
+                }
+            MY_BOOST_CHECK_CLOSE(fc->calcEnergySum(), ref_energy, tol_small);
+
+            // repeated evaluations with the same number of threads are bitwise identical
+            std::vector<Scalar4> thread_force(N);
+                {
+                ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+                for (unsigned int i = 0; i < N; i++)
+                    thread_force[i] = h_force.data[i];
+                }
+
+            for (unsigned int rep = 0; rep < 3; rep++)
+                {
+                fc->forceCompute(0);
+                ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+                for (unsigned int i = 0; i < N; i++)
+                    {
+                    BOOST_CHECK_EQUAL(h_force.data[i].x, thread_force[i].x);
+                    BOOST_CHECK_EQUAL(h_force.data[i].y, thread_force[i].y);
+                    BOOST_CHECK_EQUAL(h_force.data[i].z, thread_force[i].z);
+                    }
+                }
+            }
+        }
+    }
+
 //! PPPMForceCompute creator for unit tests
 boost::shared_ptr<PPPMForceCompute> base_class_pppm_creator(boost::shared_ptr<SystemDefinition> sysdef,
                                                      boost::shared_ptr<NeighborList> nlist,
@@ -269,6 +353,86 @@ BOOST_AUTO_TEST_CASE( PPPMForceCompute_triclinic )
     pppm_force_particle_test_triclinic(pppm_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for the threaded mesh assignment on the CPU
+BOOST_AUTO_TEST_CASE( PPPMForceCompute_threads )
+    {
+    pppmforce_creator pppm_creator = bind(base_class_pppm_creator, _1, _2, _3);
+    pppm_force_thread_test(pppm_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+
+//! Compare the transforms of an FFTBackend to kiss_fftnd
+template<class Backend>
+void fft_backend_test(boost::shared_ptr<ExecutionConfiguration> exec_conf, int Nx, int Ny, int Nz)
+    {
+    const unsigned int n_batch = 3;
+    Backend fft(exec_conf, Nx, Ny, Nz, n_batch);
+    unsigned int NNN = Nx*Ny*Nz;
+    int Nz_half = Nz/2+1;
+    BOOST_REQUIRE_EQUAL(fft.getNumComplex(), (unsigned int)(Nx*Ny*Nz_half));
+
+    // fill the meshes with random values and compute the reference with a complex transform
+    std::vector<Scalar> orig(NNN*n_batch);
+    std::vector<kiss_fft_cpx> ref(NNN*n_batch);
+    int dim[3] = {Nx, Ny, Nz};
+    kiss_fftnd_cfg cfg = kiss_fftnd_alloc(dim, 3, 0, NULL, NULL);
+    srand(12345);
+    for (unsigned int b = 0; b < n_batch; b++)
+        {
+        std::vector<kiss_fft_cpx> in(NNN);
+        for (unsigned int i = 0; i < NNN; i++)
+            {
+            orig[b*NNN+i] = fft.getRealData(b)[i] = Scalar(rand())/Scalar(RAND_MAX) - Scalar(0.5);
+            in[i].r = orig[b*NNN+i];
+            in[i].i = Scalar(0.0);
+            }
+        kiss_fftnd(cfg, &in[0], &ref[b*NNN]);
+        }
+    kiss_fft_free(cfg);
+
+    fft.forward(n_batch);
+
+    for (unsigned int b = 0; b < n_batch; b++)
+        for (int x = 0; x < Nx; x++)
+            for (int y = 0; y < Ny; y++)
+                for (int z = 0; z < Nz_half; z++)
+                    {
+                    const kiss_fft_cpx& v = fft.getComplexData(b)[z + Nz_half*(y + Ny*x)];
+                    const kiss_fft_cpx& v_ref = ref[b*NNN + z + Nz*(y + Ny*x)];
+                    MY_BOOST_CHECK_SMALL(v.r - v_ref.r, Scalar(1e-4));
+                    MY_BOOST_CHECK_SMALL(v.i - v_ref.i, Scalar(1e-4));
+                    }
+
+    // the round trip gives back the original meshes times the number of mesh points
+    fft.inverse(n_batch);
+
+    for (unsigned int b = 0; b < n_batch; b++)
+        for (unsigned int i = 0; i < NNN; i++)
+            MY_BOOST_CHECK_SMALL(fft.getRealData(b)[i]/Scalar(NNN) - orig[b*NNN+i], Scalar(1e-5));
+    }
+
+//! boost test case for the kiss_fft backend with odd and even mesh sizes on several threads
+BOOST_AUTO_TEST_CASE( FFTBackendKiss_compare )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    for (unsigned int n_threads = 1; n_threads <= 3; n_threads += 2)
+        {
+        exec_conf->setNumThreads(n_threads);
+        fft_backend_test<FFTBackendKiss>(exec_conf, 8, 6, 10);
+        fft_backend_test<FFTBackendKiss>(exec_conf, 5, 7, 9);
+        fft_backend_test<FFTBackendKiss>(exec_conf, 3, 1, 1);
+        }
+    }
+
+#ifdef ENABLE_FFTW
+//! boost test case for the FFTW backend
+BOOST_AUTO_TEST_CASE( FFTBackendFFTW_compare )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    fft_backend_test<FFTBackendFFTW>(exec_conf, 8, 6, 10);
+    fft_backend_test<FFTBackendFFTW>(exec_conf, 5, 7, 9);
+    }
+#endif
 
 #ifdef ENABLE_CUDA
 //! boost test case for bond forces on the GPU
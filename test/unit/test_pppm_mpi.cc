@@ -0,0 +1,185 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+//! name the boost unit test module
+#define BOOST_TEST_MODULE PPPMTestsMPI
+#include "boost_utf_configure.h"
+
+#include "HOOMDMath.h"
+#include "ExecutionConfiguration.h"
+#include "SystemDefinition.h"
+#include "SnapshotSystemData.h"
+#include "ParticleGroup.h"
+#include "PPPMForceCompute.h"
+#include "NeighborList.h"
+
+#include <boost/python.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "Communicator.h"
+#include "DomainDecomposition.h"
+
+using namespace boost;
+
+/*! \file test_pppm_mpi.cc
+    \brief Compares the domain decomposed PPPMForceCompute against a single processor computation
+    \ingroup unit_tests
+*/
+
+//! Compare the PPPM forces, energy and virial of a decomposed and a single-rank system
+/*! \param exec_conf Execution configuration
+    \param box Global simulation box
+    \param Nx Number of mesh points along x
+    \param Ny Number of mesh points along y
+    \param Nz Number of mesh points along z
+*/
+void test_pppm_mpi(boost::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& box, int Nx, int Ny, int Nz)
+    {
+    // a random, neutral system of unit charges, identical on all ranks
+    unsigned int N = 500;
+    boost::shared_ptr<SnapshotSystemData> snap(new SnapshotSystemData());
+    snap->global_box = box;
+    snap->particle_data.resize(N);
+    snap->particle_data.type_mapping.push_back("A");
+
+    srand(12345);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        Scalar3 f = make_scalar3(Scalar(rand())/Scalar(RAND_MAX), Scalar(rand())/Scalar(RAND_MAX),
+                                 Scalar(rand())/Scalar(RAND_MAX));
+        Scalar3 pos = box.makeCoordinates(f);
+        int3 img = make_int3(0,0,0);
+        box.wrap(pos, img);
+        snap->particle_data.pos[i] = pos;
+        snap->particle_data.charge[i] = (i % 2) ? Scalar(-1.0) : Scalar(1.0);
+        }
+
+    boost::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL()));
+    boost::shared_ptr<SystemDefinition> sysdef_1(new SystemDefinition(snap, exec_conf, decomposition));
+    boost::shared_ptr<ParticleData> pdata_1 = sysdef_1->getParticleData();
+    pdata_1->setFlags(~PDataFlags(0));
+
+    boost::shared_ptr<Communicator> comm(new Communicator(sysdef_1, decomposition));
+
+    boost::shared_ptr<NeighborList> nlist_1(new NeighborList(sysdef_1, Scalar(1.0), Scalar(0.4)));
+    nlist_1->setCommunicator(comm);
+    boost::shared_ptr<ParticleSelector> selector_all_1(new ParticleSelectorTag(sysdef_1, 0, N-1));
+    boost::shared_ptr<ParticleGroup> group_all_1(new ParticleGroup(sysdef_1, selector_all_1));
+
+    boost::shared_ptr<PPPMForceCompute> pppm_1(new PPPMForceCompute(sysdef_1, nlist_1, group_all_1));
+    pppm_1->setCommunicator(comm);
+
+    int order = 5;
+    Scalar kappa = 1.0;
+    Scalar rcut = 1.0;
+    pppm_1->setParams(Nx, Ny, Nz, order, kappa, rcut);
+    pppm_1->compute(0);
+
+    // the reference system lives on rank 0 only
+    boost::shared_ptr<SystemDefinition> sysdef_2;
+    boost::shared_ptr<PPPMForceCompute> pppm_2;
+    if (exec_conf->getRank() == 0)
+        {
+        sysdef_2 = boost::shared_ptr<SystemDefinition>(new SystemDefinition(snap, exec_conf));
+        sysdef_2->getParticleData()->setFlags(~PDataFlags(0));
+        boost::shared_ptr<NeighborList> nlist_2(new NeighborList(sysdef_2, Scalar(1.0), Scalar(0.4)));
+        boost::shared_ptr<ParticleSelector> selector_all_2(new ParticleSelectorTag(sysdef_2, 0, N-1));
+        boost::shared_ptr<ParticleGroup> group_all_2(new ParticleGroup(sysdef_2, selector_all_2));
+        pppm_2 = boost::shared_ptr<PPPMForceCompute>(new PPPMForceCompute(sysdef_2, nlist_2, group_all_2));
+        pppm_2->setParams(Nx, Ny, Nz, order, kappa, rcut);
+        pppm_2->compute(0);
+        }
+
+    Scalar abs_tol = Scalar(1e-4);
+    Scalar virial_1[6] = {0, 0, 0, 0, 0, 0};
+    Scalar virial_2[6] = {0, 0, 0, 0, 0, 0};
+    for (unsigned int tag = 0; tag < N; ++tag)
+        {
+        // collective calls
+        Scalar3 f_1 = pppm_1->getForce(tag);
+        for (unsigned int k = 0; k < 6; ++k)
+            virial_1[k] += pppm_1->getVirial(tag, k);
+
+        if (exec_conf->getRank() == 0)
+            {
+            Scalar3 f_2 = pppm_2->getForce(tag);
+            for (unsigned int k = 0; k < 6; ++k)
+                virial_2[k] += pppm_2->getVirial(tag, k);
+
+            BOOST_CHECK_SMALL(fabs(f_1.x - f_2.x), abs_tol);
+            BOOST_CHECK_SMALL(fabs(f_1.y - f_2.y), abs_tol);
+            BOOST_CHECK_SMALL(fabs(f_1.z - f_2.z), abs_tol);
+            }
+        }
+
+    Scalar energy_1 = pppm_1->calcEnergySum();
+    if (exec_conf->getRank() == 0)
+        {
+        MY_BOOST_CHECK_CLOSE(energy_1, pppm_2->calcEnergySum(), tol);
+        for (unsigned int k = 0; k < 6; ++k)
+            MY_BOOST_CHECK_CLOSE(virial_1[k], virial_2[k], tol);
+        }
+    }
+
+//! Tests the decomposed PPPM in a cubic box
+BOOST_AUTO_TEST_CASE( PPPMForceCompute_MPI_cubic )
+    {
+    test_pppm_mpi(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),
+                  BoxDim(12.0), 16, 16, 16);
+    }
+
+//! Tests the decomposed PPPM with different mesh and box dimensions along every direction
+BOOST_AUTO_TEST_CASE( PPPMForceCompute_MPI_anisotropic )
+    {
+    test_pppm_mpi(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),
+                  BoxDim(12.0, 14.0, 16.0), 16, 20, 24);
+    }
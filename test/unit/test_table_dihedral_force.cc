@@ -53,6 +53,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <iostream>
+#include <vector>
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
@@ -67,6 +68,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Initializers.h"
 #include "SnapshotSystemData.h"
+#include "SFCPackUpdater.h"
 
 using namespace std;
 using namespace boost;
@@ -423,6 +425,88 @@ void dihedral_force_comparison_tests(dihedralforce_creator tf_creator1,
     }
 
 #endif
+//! Compare the forces computed on several threads and after a particle sort to the single threaded result
+void dihedral_force_threads_test(dihedralforce_creator tf_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    snap->dihedral_data.type_mapping.push_back("A");
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    // a harmonic potential in the table
+    unsigned int width = 100;
+    boost::shared_ptr<TableDihedralForceCompute> fc = tf_creator(sysdef, width);
+    std::vector<Scalar> V, T;
+    Scalar kappa = 3;
+    for (unsigned int i = 0; i < width; ++i)
+        {
+        Scalar phi = -M_PI+(Scalar)i/(Scalar)(width-1)*Scalar(2*M_PI);
+        V.push_back(0.5*kappa*phi*phi);
+        T.push_back(-kappa*phi);
+        }
+    fc->setTable(0, V, T);
+
+    // a chain, plus dihedrals between distant tags so that some of them cross the particle ranges of the threads
+    for (unsigned int i = 0; i < N-3; i++)
+        sysdef->getDihedralData()->addBondedGroup(Dihedral(0, i, i+1, i+2, i+3));
+    for (unsigned int i = 0; i < N; i += 10)
+        sysdef->getDihedralData()->addBondedGroup(Dihedral(0, i, (i+251) % N, (i+502) % N, (i+753) % N));
+
+    exec_conf->setNumThreads(1);
+    fc->compute(0);
+    std::vector<Scalar3> ref_force(N);
+    std::vector<Scalar> ref_energy(N);
+    std::vector<Scalar> ref_virial(6*N);
+    for (unsigned int tag = 0; tag < N; tag++)
+        {
+        ref_force[tag] = fc->getForce(tag);
+        ref_energy[tag] = fc->getEnergy(tag);
+        for (unsigned int l = 0; l < 6; l++)
+            ref_virial[6*tag+l] = fc->getVirial(tag, l);
+        }
+
+    // the second pass uses the dihedral table rebuilt after the sort
+    SFCPackUpdater sorter(sysdef);
+    for (unsigned int pass = 0; pass < 2; pass++)
+        {
+        if (pass == 1)
+            sorter.update(0);
+
+        for (unsigned int n_threads = 1; n_threads <= 4; n_threads++)
+            {
+            exec_conf->setNumThreads(n_threads);
+            fc->forceCompute(0);
+
+            // the summation order differs between thread counts, compare the average deviation
+            double deltaf2 = 0.0;
+            double deltape2 = 0.0;
+            double deltav2 = 0.0;
+            for (unsigned int tag = 0; tag < N; tag++)
+                {
+                Scalar3 f = fc->getForce(tag);
+                deltaf2 += double(f.x - ref_force[tag].x) * double(f.x - ref_force[tag].x);
+                deltaf2 += double(f.y - ref_force[tag].y) * double(f.y - ref_force[tag].y);
+                deltaf2 += double(f.z - ref_force[tag].z) * double(f.z - ref_force[tag].z);
+                Scalar pe = fc->getEnergy(tag);
+                deltape2 += double(pe - ref_energy[tag]) * double(pe - ref_energy[tag]);
+                for (unsigned int l = 0; l < 6; l++)
+                    {
+                    Scalar v = fc->getVirial(tag, l);
+                    deltav2 += double(v - ref_virial[6*tag+l]) * double(v - ref_virial[6*tag+l]);
+                    }
+                }
+            BOOST_CHECK_SMALL(deltaf2 / double(N), double(tol_small));
+            BOOST_CHECK_SMALL(deltape2 / double(N), double(tol_small));
+            BOOST_CHECK_SMALL(deltav2 / double(N), double(tol_small));
+            }
+        }
+    exec_conf->setNumThreads(1);
+    }
+
 //! TableDihedralForceCompute creator for dihedral_force_basic_tests()
 boost::shared_ptr<TableDihedralForceCompute> base_class_tf_creator(boost::shared_ptr<SystemDefinition> sysdef,unsigned int width)
     {
@@ -445,6 +529,13 @@ BOOST_AUTO_TEST_CASE( TableDihedralForceCompute_basic )
     dihedral_force_basic_tests(tf_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for the multithreaded CPU code path
+BOOST_AUTO_TEST_CASE( TableDihedralForceCompute_threads )
+    {
+    dihedralforce_creator tf_creator = bind(base_class_tf_creator, _1, _2);
+    dihedral_force_threads_test(tf_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! boost test case for dihedral forces on the GPU
 BOOST_AUTO_TEST_CASE( TableDihedralForceComputeGPU_basic )
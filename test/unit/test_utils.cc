@@ -54,18 +54,30 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <cstdlib>
 
 #include <math.h>
 #include "ClockSource.h"
 #include "Profiler.h"
 #include "Variant.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <boost/bind.hpp>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 //! Name the unit test module
 #define BOOST_TEST_MODULE UtilityClassesTests
 #include "boost_utf_configure.h"
 
 /*! \file utils_test.cc
-    \brief Unit tests for ClockSource, Profiler, and Variant
+    \brief Unit tests for ClockSource, Profiler, Variant, and ThreadPool
     \ingroup unit_tests
 */
 
@@ -194,6 +206,242 @@ BOOST_AUTO_TEST_CASE(Profiler_test)
 
     }
 
+//! Helper function for Profiler_trace_test, returns the raw value of \a key in a single line JSON object
+string trace_json_value(const string& line, const string& key)
+    {
+    size_t pos = line.find("\"" + key + "\":");
+    if (pos == string::npos)
+        return string();
+    pos += key.size() + 3;
+    if (line[pos] == '"')
+        return line.substr(pos+1, line.find('"', pos+1) - pos - 1);
+    return line.substr(pos, line.find_first_of(",}", pos) - pos);
+    }
+
+//! Helper function for Profiler_trace_test, reads a value from a binary trace
+template<class T> T read_trace_binary(ifstream& f)
+    {
+    T val;
+    f.read((char *)&val, sizeof(T));
+    return val;
+    }
+
+//! check that the trace ring buffer keeps the most recent events and can be written out
+BOOST_AUTO_TEST_CASE(Profiler_trace_test)
+    {
+    Profiler prof("Main");
+    prof.enableTrace(16);
+    BOOST_CHECK_EQUAL(prof.getNumTraceEvents(), 0);
+
+    // the first step records the Step begin event and 4 region events, the Step end event follows with the next step
+    prof.traceStep(0);
+    prof.push("Pair");
+    prof.push("Work");
+    prof.pop();
+    prof.pop();
+    BOOST_CHECK_EQUAL(prof.getNumTraceEvents(), 5);
+
+    // every further step records 6 events, 61 in total after the Step begin event of step 10
+    for (unsigned int step = 1; step < 10; step++)
+        {
+        prof.traceStep(step);
+        prof.push("Pair");
+        prof.push("Work");
+        prof.pop();
+        prof.pop();
+        }
+    prof.traceStep(10);
+    BOOST_CHECK_EQUAL(prof.getNumTraceEvents(), 16);
+
+    // the buffer holds the newest 16 events, starting with the Work and Pair end events and the Step end event of
+    // step 7, whose begin events were overwritten. These are dropped, the open Step 10 is closed at the end.
+    const char *ref_name[] = {"Step", "Pair", "Work", "Work", "Pair", "Step",
+                              "Step", "Pair", "Work", "Work", "Pair", "Step",
+                              "Step", "Step"};
+    const unsigned int ref_type[] = {Profiler::TRACE_BEGIN, Profiler::TRACE_BEGIN, Profiler::TRACE_BEGIN,
+                                     Profiler::TRACE_END, Profiler::TRACE_END, Profiler::TRACE_END,
+                                     Profiler::TRACE_BEGIN, Profiler::TRACE_BEGIN, Profiler::TRACE_BEGIN,
+                                     Profiler::TRACE_END, Profiler::TRACE_END, Profiler::TRACE_END,
+                                     Profiler::TRACE_BEGIN, Profiler::TRACE_END};
+    const unsigned int ref_step[] = {8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 10, 10};
+    const unsigned int n_ref = sizeof(ref_step)/sizeof(unsigned int);
+
+    // check the JSON output, which holds one event per line
+    prof.writeTrace("test_profiler_trace.json", "json");
+        {
+        ifstream f("test_profiler_trace.json");
+        BOOST_REQUIRE(f.good());
+        string line;
+        getline(f, line);
+        BOOST_CHECK_EQUAL(line, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        getline(f, line);
+        BOOST_CHECK_EQUAL(trace_json_value(line, "name"), "process_name");
+        BOOST_CHECK_EQUAL(trace_json_value(line, "ph"), "M");
+
+        unsigned int n_events = 0;
+        double last_ts = 0.0;
+        while (getline(f, line) && line != "]}")
+            {
+            BOOST_REQUIRE(n_events < n_ref);
+            BOOST_CHECK_EQUAL(trace_json_value(line, "name"), ref_name[n_events]);
+            BOOST_CHECK_EQUAL(trace_json_value(line, "ph"), ref_type[n_events] == Profiler::TRACE_BEGIN ? "B" : "E");
+            BOOST_CHECK_EQUAL(trace_json_value(line, "pid"), "0");
+            if (ref_type[n_events] == Profiler::TRACE_BEGIN)
+                BOOST_CHECK_EQUAL(atoi(trace_json_value(line, "step").c_str()), (int)ref_step[n_events]);
+
+            double ts = atof(trace_json_value(line, "ts").c_str());
+            BOOST_CHECK(ts >= last_ts);
+            last_ts = ts;
+            n_events++;
+            }
+        BOOST_CHECK_EQUAL(line, "]}");
+        BOOST_CHECK_EQUAL(n_events, n_ref);
+        }
+    unlink("test_profiler_trace.json");
+
+    // check the binary output
+    prof.writeTrace("test_profiler_trace.bin", "binary");
+        {
+        ifstream f("test_profiler_trace.bin", ios_base::in | ios_base::binary);
+        BOOST_REQUIRE(f.good());
+        char magic[4];
+        f.read(magic, 4);
+        BOOST_CHECK_EQUAL(string(magic, 4), "HTRC");
+        BOOST_CHECK_EQUAL(read_trace_binary<uint32_t>(f), (uint32_t)1);
+        BOOST_CHECK_EQUAL(read_trace_binary<uint32_t>(f), (uint32_t)1);
+        BOOST_CHECK_EQUAL(read_trace_binary<uint32_t>(f), (uint32_t)0);
+
+        uint32_t n_names = read_trace_binary<uint32_t>(f);
+        BOOST_REQUIRE_EQUAL(n_names, (uint32_t)3);
+        std::vector<string> names(n_names);
+        for (unsigned int i = 0; i < n_names; i++)
+            {
+            uint32_t len = read_trace_binary<uint32_t>(f);
+            names[i].resize(len);
+            f.read(&names[i][0], len);
+            }
+        BOOST_CHECK_EQUAL(names[0], "Step");
+        BOOST_CHECK_EQUAL(names[1], "Pair");
+        BOOST_CHECK_EQUAL(names[2], "Work");
+
+        BOOST_CHECK_EQUAL(sizeof(ProfileTraceEvent), (size_t)16);
+        uint64_t n_events = read_trace_binary<uint64_t>(f);
+        BOOST_REQUIRE_EQUAL(n_events, (uint64_t)n_ref);
+        int64_t last_time = 0;
+        for (unsigned int i = 0; i < n_ref; i++)
+            {
+            ProfileTraceEvent ev = read_trace_binary<ProfileTraceEvent>(f);
+            BOOST_REQUIRE(ev.m_name < n_names);
+            BOOST_CHECK_EQUAL(names[ev.m_name], ref_name[i]);
+            BOOST_CHECK_EQUAL(ev.m_type, ref_type[i]);
+            BOOST_CHECK_EQUAL(ev.m_timestep, ref_step[i]);
+            BOOST_CHECK(ev.m_time >= last_time);
+            last_time = ev.m_time;
+            }
+
+        // nothing follows the events
+        BOOST_CHECK(f.good());
+        f.peek();
+        BOOST_CHECK(f.eof());
+        }
+    unlink("test_profiler_trace.bin");
+
+    BOOST_CHECK_THROW(prof.writeTrace("test_profiler_trace.bin", "xml"), runtime_error);
+    }
+
+//! Helper task for ThreadPool_test, fills the range of the array assigned to a thread
+void fill_range(unsigned int thread_idx, unsigned int n_threads, std::vector<unsigned int> *v)
+    {
+    unsigned int first, last;
+    ThreadPool::getRange((unsigned int)v->size(), thread_idx, n_threads, first, last);
+    for (unsigned int i = first; i < last; i++)
+        (*v)[i] += thread_idx+1;
+    }
+
+//! check that every item is processed exactly once by the thread pool
+BOOST_AUTO_TEST_CASE(ThreadPool_test)
+    {
+    for (unsigned int n_threads = 1; n_threads <= 4; n_threads++)
+        {
+        ThreadPool pool(n_threads);
+        BOOST_CHECK_EQUAL(pool.getNumThreads(), n_threads);
+
+        std::vector<unsigned int> v(1001, 0);
+        // run several times to exercise reuse of the worker threads
+        for (unsigned int iter = 0; iter < 10; iter++)
+            pool.run(boost::bind(fill_range, _1, n_threads, &v));
+
+        // every item must have been visited 10 times by the thread that owns it
+        unsigned int first, last;
+        for (unsigned int t = 0; t < n_threads; t++)
+            {
+            ThreadPool::getRange((unsigned int)v.size(), t, n_threads, first, last);
+            for (unsigned int i = first; i < last; i++)
+                BOOST_REQUIRE_EQUAL(v[i], 10*(t+1));
+            }
+        BOOST_CHECK_EQUAL(last, v.size());
+
+        // every call to run() is counted, and the threads cannot be busy for longer than the pool ran
+        BOOST_CHECK_EQUAL(pool.getNumRuns(), 10);
+        BOOST_CHECK(pool.getUtilization() >= 0.0);
+        BOOST_CHECK(pool.getUtilization() <= 1.0);
+
+        pool.resetStats();
+        BOOST_CHECK_EQUAL(pool.getNumRuns(), 0);
+        BOOST_CHECK_EQUAL(pool.getRunTime(), 0);
+        }
+    }
+
+#ifdef __linux__
+//! Helper task for ThreadPool_pin_test, records the CPUs a thread may run on
+void get_affinity(unsigned int thread_idx, std::vector<cpu_set_t> *masks)
+    {
+    CPU_ZERO(&(*masks)[thread_idx]);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &(*masks)[thread_idx]);
+    }
+
+//! check that pinned threads run on a single CPU each, and that the calling thread gets its CPUs back
+BOOST_AUTO_TEST_CASE(ThreadPool_pin_test)
+    {
+    cpu_set_t initial_mask;
+    CPU_ZERO(&initial_mask);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &initial_mask);
+
+    for (unsigned int n_threads = 1; n_threads <= 4; n_threads++)
+        {
+            {
+            ThreadPool pool(n_threads, true);
+            BOOST_REQUIRE(pool.isPinned());
+
+            std::vector<cpu_set_t> masks(n_threads);
+            pool.run(boost::bind(get_affinity, _1, &masks));
+
+            unsigned int n_cpus = CPU_COUNT(&initial_mask);
+            for (unsigned int t = 0; t < n_threads; t++)
+                {
+                BOOST_CHECK_EQUAL(CPU_COUNT(&masks[t]), 1);
+
+                // threads with different indices share a CPU only when there are more threads than CPUs
+                cpu_set_t both;
+                CPU_AND(&both, &masks[t], &initial_mask);
+                BOOST_CHECK_EQUAL(CPU_COUNT(&both), 1);
+                for (unsigned int u = 0; u < t; u++)
+                    BOOST_CHECK(CPU_EQUAL(&masks[t], &masks[u]) == (t % n_cpus == u % n_cpus));
+                }
+            }
+
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+        BOOST_CHECK(CPU_EQUAL(&mask, &initial_mask));
+        }
+
+    // an unpinned pool leaves the affinity alone
+    ThreadPool pool(2);
+    BOOST_CHECK(!pool.isPinned());
+    }
+#endif
+
 //! perform some simple checks on the variant types
 BOOST_AUTO_TEST_CASE(Variant_test)
     {